@@ -0,0 +1,118 @@
+#pragma once
+
+// ============================================================
+//  AdsScheduler.h  —  Non-blocking ADS1115 conversion scheduler
+//
+//  Each channel is a row (device, input, gain, data rate,
+//  interval).  Call add() once per row, then poll() every
+//  ADS_POLL_MS: each device runs its own single-shot cycle
+//  (IDLE → CONVERTING → result to the sink) and re-probes every
+//  retryMs while DOWN, so devices convert in parallel and the
+//  caller only waits for the I²C transactions.  kMaxTimeouts
+//  conversions in a row that do not finish take a device DOWN.
+//
+//  The bus is behind AdsBus (Adafruit_ADS1115 in the firmware, a
+//  scripted fake in the native tests).
+// ============================================================
+
+#include <cstdint>
+
+struct AdsChannel {
+    uint8_t  device;       // index of the ADS1115 (0 … kMaxDevices-1)
+    uint8_t  mux;          // single-ended input 0–3
+    uint16_t gain;         // PGA bits of the config register (adsGain_t)
+    uint16_t rate;         // DR bits of the config register (RATE_ADS1115_*)
+    uint32_t intervalMs;
+};
+
+/// Full-scale volts per count for PGA bits `gain`.
+float adsVoltsPerCount(uint16_t gain);
+/// Conversion time for DR bits `rate`, with the 10 % oscillator tolerance.
+uint32_t adsConversionUs(uint16_t rate);
+
+class AdsBus {
+public:
+    virtual bool    begin(uint8_t device) = 0;                         // probe + configure
+    virtual void    start(uint8_t device, const AdsChannel& ch) = 0;   // single-shot conversion
+    virtual bool    ready(uint8_t device) = 0;                         // OS bit set
+    virtual int16_t result(uint8_t device) = 0;                        // conversion register
+
+protected:
+    ~AdsBus() = default;
+};
+
+/// Receives each completed conversion, stamped with the middle of
+/// the conversion (the ADC integrates over the whole of it).
+using AdsSink    = void (*)(void* ctx, int channel, int16_t raw, uint32_t acquiredMs);
+using AdsClockUs = uint32_t (*)();
+
+class AdsScheduler {
+public:
+    static constexpr int kMaxDevices  = 4;
+    static constexpr int kMaxChannels = 16;
+    static constexpr int kMaxTimeouts = 3;
+
+    enum class State : uint8_t { DOWN, IDLE, CONVERTING };
+
+    struct Device {
+        State    state        = State::DOWN;
+        bool     used         = false;     // has at least one channel
+        int8_t   active       = -1;        // channel converting
+        uint8_t  timeoutRun   = 0;         // consecutive timeouts
+        uint32_t startUs      = 0;
+        uint32_t startMs      = 0;
+        uint32_t convUs       = 0;
+        uint32_t retryAtMs    = 0;
+        // Statistics
+        uint32_t samples      = 0;
+        uint32_t timeouts     = 0;
+        uint32_t failedBegins = 0;
+        uint32_t downs        = 0;         // times taken DOWN after timeouts
+        uint32_t transactions = 0;         // I²C transactions (begin, start, ready, result)
+        uint32_t busUs        = 0;         // time spent in them
+        uint32_t maxTxUs      = 0;
+    };
+
+    struct Channel {
+        AdsChannel spec;
+        uint32_t   nextDueMs = 0;
+        uint32_t   lastMs    = 0;          // last completed sample; 0 = none
+        int16_t    raw       = 0;
+        uint32_t   samples   = 0;
+        uint32_t   late      = 0;          // started more than one interval behind
+    };
+
+    AdsScheduler(AdsBus& bus, AdsClockUs clock, AdsSink sink, void* ctx, uint32_t retryMs);
+
+    /// Register a channel.  Returns its id, or -1 when full or the
+    /// device index is out of range.
+    int add(const AdsChannel& ch, uint32_t nowMs);
+
+    /// Advance every device; call every ADS_POLL_MS.  Wrap-safe.
+    void poll(uint32_t nowMs);
+
+    /// Every device with channels is answering.
+    bool allUp() const;
+    uint32_t failedBegins() const;
+
+    int            channels()          const { return _nChannels; }
+    const Channel& channel(int id)     const { return _ch[id]; }
+    const Device&  device(int index)   const { return _dev[index]; }
+    /// Mean I²C time per completed sample on a device, µs.
+    uint32_t       usPerSample(int index) const;
+
+private:
+    void pollDevice(int index, uint32_t nowMs);
+    bool startNext(int index, uint32_t nowMs);
+    void account(Device& d, uint32_t t0Us);   // one I²C transaction since t0Us
+
+    AdsBus&    _bus;
+    AdsClockUs _clock;
+    AdsSink    _sink;
+    void*      _ctx;
+    uint32_t   _retryMs;
+
+    Device  _dev[kMaxDevices];
+    Channel _ch[kMaxChannels];
+    int     _nChannels = 0;
+};
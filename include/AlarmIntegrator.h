@@ -0,0 +1,56 @@
+#pragma once
+
+// ============================================================
+//  AlarmIntegrator.h  —  Time-based debounce for switch inputs
+//
+//  Integrates how long the input has actually been active instead
+//  of sampling it: time at the opposite level counts up, time back
+//  at the output's level counts down drainRatio× faster.  The
+//  output asserts once the accumulated active time reaches assertUs
+//  and releases once the accumulated inactive time reaches
+//  releaseUs.  The fast drain stops a dense train of short spikes
+//  from summing to an alarm.  A glitch shorter than assertUs can
+//  never assert, however it lines up with the polling tick, and a
+//  real switch closure is seen assertUs after the edge rather than
+//  after several sample periods.
+// ============================================================
+
+#include <cstdint>
+
+class AlarmIntegrator {
+public:
+    AlarmIntegrator(uint32_t assertUs, uint32_t releaseUs, uint8_t drainRatio = 4);
+
+    void setTimes(uint32_t assertUs, uint32_t releaseUs);
+
+    /// Start at a known level (no integration).
+    void reset(bool level, uint32_t nowUs);
+
+    /// Input changed to `level` at tUs (edge timestamp from the ISR).
+    /// Returns true if the output changed.
+    bool edge(bool level, uint32_t tUs);
+
+    /// Advance to nowUs at the current input level (wrap-safe).
+    /// Returns true if the output changed.
+    bool update(uint32_t nowUs);
+
+    bool     asserted()     const { return _asserted; }
+    bool     level()        const { return _level; }
+    /// Active pulses that ended before they could assert
+    uint32_t rejected()     const { return _rejected; }
+    /// tUs at which the output last changed
+    uint32_t lastChangeUs() const { return _changeUs; }
+
+private:
+    bool advance(uint32_t toUs);
+
+    uint32_t _assertUs;
+    uint32_t _releaseUs;
+    uint8_t  _drainRatio;
+    uint32_t _accUs     = 0;      // toward the opposite state
+    uint32_t _lastUs    = 0;
+    uint32_t _changeUs  = 0;
+    uint32_t _rejected  = 0;
+    bool     _level     = false;
+    bool     _asserted  = false;
+};
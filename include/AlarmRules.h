@@ -0,0 +1,130 @@
+#pragma once
+
+// ============================================================
+//  AlarmRules.h  —  Incremental threshold / rate-of-rise / stale
+//                   alarm rules with rate-limited notifications
+//
+//  Each rule watches one input (a small integer the caller maps
+//  to an EngineState field or a 1-Wire destination) and is one of:
+//
+//    ABOVE  value ≥ warn / alarm
+//    BELOW  value ≤ warn / alarm
+//    RISE   rate of rise ≥ warn / alarm (units per minute over
+//           windowMs), evaluated only with the value above armAbove
+//    STALE  no valid sample for warn / alarm seconds (open sender,
+//           lost ADS, dead probe)
+//
+//  A raised level steps down only once the quantity is back past
+//  its threshold by `hysteresis`, so a reading hovering at the
+//  threshold does not flip NORMAL/WARN on every sample.  An
+//  invalid (NaN) sample leaves ABOVE/BELOW/RISE where they are —
+//  a failed sensor must not clear an alarm — and is what STALE
+//  rules catch.  A RUNNING-gated rule is held NORMAL while the
+//  engine is stopped, and its stale clock starts at the start.
+//
+//  sample() touches only the rules on that input (a per-input
+//  list), each at constant cost: the rise rate is an EWMA of the
+//  value against its own value one window earlier, kept in
+//  kRiseSlots slots.
+//
+//  Notifications go to the sink, rate limited per rule: a rise
+//  to a higher level is sent at once; a step down is sent only
+//  once minNotifyMs has passed since the rule's previous one, and
+//  flips inside that time coalesce into the level that holds at
+//  its end.  A rule therefore emits at most two notifications per
+//  minNotifyMs.
+// ============================================================
+
+#include <cstdint>
+
+enum class AlarmKind : uint8_t { ABOVE, BELOW, RISE, STALE };
+enum class AlarmGate : uint8_t { ALWAYS, RUNNING };
+
+enum class AlarmLevel : uint8_t {
+    NORMAL = 0,
+    WARN   = 1,
+    ALARM  = 2,
+};
+
+const char* alarmLevelName(AlarmLevel l);   // "normal" / "warn" / "alarm"
+
+struct AlarmRule {
+    uint8_t   input;
+    AlarmKind kind;
+    AlarmGate gate;
+    float     warn;         // ABOVE/BELOW: value; RISE: units/min; STALE: s.  NAN = no warn level
+    float     alarm;        // same units; NAN = no alarm level
+    float     hysteresis;   // same units; not used by STALE
+    float     armAbove;     // RISE: evaluated only above this value (NAN = always)
+    uint32_t  windowMs;     // RISE: slope window
+};
+
+/// Receives each notification: the rule, its new level and the
+/// quantity that set it (value, rate per minute or age in s).
+using AlarmSink = void (*)(void* ctx, int rule, AlarmLevel level, float value, uint32_t nowMs);
+
+class AlarmRules {
+public:
+    static constexpr int kMaxRules  = 24;
+    static constexpr int kMaxInputs = 32;
+    static constexpr int kRiseSlots = 8;
+
+    struct State {
+        AlarmRule  rule;
+        AlarmLevel level       = AlarmLevel::NORMAL;
+        AlarmLevel sent        = AlarmLevel::NORMAL;   // last level notified
+        bool       active      = true;                  // gate open
+        float      value       = 0.0f;                  // last evaluated quantity (NAN = none yet)
+        uint32_t   sentMs      = 0;
+        uint32_t   validMs     = 0;                     // STALE: last valid sample or gate opening
+        uint32_t   transitions = 0;                     // level changes
+        uint32_t   notified    = 0;                     // notifications emitted
+        // RISE
+        float      ewma        = 0.0f;
+        uint32_t   ewmaMs      = 0;
+        uint8_t    slotHead    = 0;                     // next slot to write
+        uint8_t    slotCount   = 0;
+        float      slotV[kRiseSlots];
+        uint32_t   slotMs[kRiseSlots];
+    };
+
+    AlarmRules(AlarmSink sink, void* ctx, uint32_t minNotifyMs);
+
+    /// Register a rule.  Returns its id, or -1 when full or the
+    /// input is out of range.
+    int add(const AlarmRule& r, uint32_t nowMs);
+
+    /// Change a rule's thresholds (web UI config).
+    void setThresholds(int id, float warn, float alarm);
+
+    /// A sample of `input` taken at nowMs; NaN = invalid reading.
+    void sample(uint8_t input, float value, uint32_t nowMs);
+
+    /// Engine running state for RUNNING-gated rules.
+    void setRunning(bool running, uint32_t nowMs);
+
+    /// Ages STALE rules (wrap-safe) and sends deferred
+    /// notifications; call every few hundred ms.
+    void tick(uint32_t nowMs);
+
+    int          rules()         const { return _n; }
+    AlarmLevel   level(int id)   const { return _s[id].level; }
+    const State& state(int id)   const { return _s[id]; }
+
+private:
+    void         evaluate(int id, float q, uint32_t nowMs);
+    void         notify(int id, uint32_t nowMs);
+    static void  setLevel(State& s, AlarmLevel l);
+    static float riseRate(State& s, float v, uint32_t nowMs);   // per minute, NAN until half a window
+    static void  resetRise(State& s);
+
+    AlarmSink _sink;
+    void*     _ctx;
+    uint32_t  _minNotifyMs;
+    bool      _running = false;
+
+    State  _s[kMaxRules];
+    int8_t _next[kMaxRules];             // next rule on the same input
+    int8_t _first[kMaxInputs];           // first rule on each input, -1 = none
+    int    _n = 0;
+};
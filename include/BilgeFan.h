@@ -1,7 +1,8 @@
 #pragma once
 
 #include <Arduino.h>
-#include <functional>
+
+#include "InplaceFunction.h"
 
 // ============================================================
 //  BilgeFan.h  —  Engine-stop bilge fan purge controller
@@ -53,8 +54,11 @@ public:
     /// expires — whichever comes first.
     void manualOn();
 
+    using RelayCallback = InplaceFunction<void(bool)>;
+
     /// Register a callback invoked whenever relay state changes.
-    void onRelayChange(std::function<void(bool)> cb) { _onChange = cb; }
+    /// Stored in place — captures must fit RelayCallback (two pointers).
+    void onRelayChange(RelayCallback cb) { _onChange = cb; }
 
 private:
     void setRelay(bool on);
@@ -66,5 +70,5 @@ private:
     float    _timerSec       = 0.0f;
     bool     _manualOverride = false;
 
-    std::function<void(bool)> _onChange;
+    RelayCallback _onChange;
 };
@@ -0,0 +1,58 @@
+#pragma once
+
+// ============================================================
+//  BusTime.h  —  UTC from NMEA 2000 PGN 126992 (System Time)
+//
+//  The board has no RTC; millis() is uptime.  When a GPS or
+//  chartplotter on the bus sends System Time, update() ties the
+//  local clock to UTC and utcMs() converts any millis() stamp —
+//  e.g. a sample's acquisition time — to milliseconds since 1970.
+//
+//  The reference is a (local, UTC) pair, so conversion is
+//  wrap-safe within ±24 days of the last update.  Each later
+//  reading moves the reference 1/8 of the way to what it
+//  measured (bus and handler delay jitter), unless the two
+//  disagree by more than stepMs — a new fix, a changed clock, a
+//  millis() wrap — which steps it.  Only one sender is followed:
+//  readings from another address are ignored while the followed
+//  one is still current (within validMs), so two time sources on
+//  one bus do not pull the clock back and forth.
+// ============================================================
+
+#include <cstdint>
+
+class BusTime {
+public:
+    BusTime(uint32_t validMs, uint32_t stepMs);
+
+    /// A System Time reading from bus address `source`, received at
+    /// rxMs: days since 1970-01-01 and seconds since midnight.
+    /// Returns false when it was ignored (fields not available, or
+    /// another sender is being followed).
+    bool update(uint16_t days, double seconds, uint8_t source, uint32_t rxMs);
+
+    /// A reading was accepted within the last validMs.
+    bool synced(uint32_t nowMs) const;
+
+    /// UTC of local time localMs in ms since 1970; -1 before the
+    /// first reading.  Keeps extrapolating after validMs — check
+    /// synced() to know whether it is still being corrected.
+    int64_t utcMs(uint32_t localMs) const;
+
+    uint8_t  source()  const { return _source; }
+    uint32_t updates() const { return _updates; }
+    uint32_t steps()   const { return _steps; }
+    uint32_t ignored() const { return _ignored; }
+
+private:
+    uint32_t _validMs;
+    uint32_t _stepMs;
+    bool     _set        = false;
+    uint8_t  _source     = 0xFF;
+    uint32_t _refLocalMs = 0;
+    int64_t  _refUtcMs   = 0;
+    uint32_t _lastRxMs   = 0;
+    uint32_t _updates    = 0;
+    uint32_t _steps      = 0;
+    uint32_t _ignored    = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  CompactEncoder.h  —  CBOR / MessagePack writer
+//
+//  Writes the subset both formats share — maps, arrays, integers,
+//  float32, booleans, null, UTF-8 text — into a caller's buffer,
+//  choosing the shortest integer form.  The two formats differ
+//  only in the header bytes, so one writer serves both:
+//
+//    CompactEncoder e(buf, sizeof(buf), CompactFormat::CBOR);
+//    e.beginMap(2);
+//    e.putStr("rpm");  e.putUint(1500);
+//    e.putStr("c");    e.putNull();
+//
+//  Map and array sizes are definite (MessagePack has no other
+//  kind), so the caller counts entries up front.  Writing past the
+//  end sets overflowed() and stops; size() is then meaningless.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+enum class CompactFormat : uint8_t {
+    CBOR    = 0,   // RFC 8949
+    MSGPACK = 1,
+};
+
+class CompactEncoder {
+public:
+    CompactEncoder(uint8_t* buf, size_t capacity, CompactFormat fmt);
+
+    void beginMap(uint32_t pairs);
+    void beginArray(uint32_t items);
+    void putUint(uint64_t v);
+    void putInt(int64_t v);
+    void putFloat(float v);
+    void putBool(bool v);
+    void putNull();
+    void putStr(const char* s);
+
+    /// round(v × scale) as an integer, or null when v is NaN — the
+    /// compact form for a measurement with a fixed resolution.
+    void putScaled(float v, float scale);
+
+    CompactFormat format()     const { return _fmt; }
+    size_t        size()       const { return _len; }
+    bool          overflowed() const { return _overflow; }
+    const uint8_t* data()      const { return _buf; }
+
+private:
+    void put(uint8_t b);
+    void putBE(uint64_t v, int bytes);
+    void cborHead(uint8_t major, uint64_t v);
+
+    uint8_t*      _buf;
+    size_t        _cap;
+    size_t        _len      = 0;
+    bool          _overflow = false;
+    CompactFormat _fmt;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+// ============================================================
+//  CoolantCurve.h  —  A1 sender voltage → coolant temperature
+//
+//  Piecewise-linear interpolation over TEMP_CURVE_POINTS (knots
+//  in descending voltage, clamped at both ends).  Outside
+//  COOLANT_VOLT_MIN_V … COOLANT_VOLT_MAX_V the sender is taken
+//  as open or shorted and the result is NAN.
+// ============================================================
+
+namespace CoolantCurve {
+
+float voltageToCelsius(float volt);
+
+}  // namespace CoolantCurve
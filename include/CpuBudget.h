@@ -0,0 +1,38 @@
+#pragma once
+
+// ============================================================
+//  CpuBudget.h  —  Token bucket for background CPU time
+//
+//  Credit accrues at pct % of wall time, up to burstUs saved up.
+//  Before an optional piece of work the caller asks allow(); after
+//  it, spend() the micros() it took.  Spending can overdraw: the
+//  next allow() then waits until the debt is repaid, so over any
+//  long window the work uses at most pct % (+ one burst).
+// ============================================================
+
+#include <cstdint>
+
+class CpuBudget {
+public:
+    CpuBudget(uint32_t pct, uint32_t burstUs);
+
+    /// Credit is available at nowUs.  Wrap-safe between calls up
+    /// to ~35 minutes apart.
+    bool allow(uint32_t nowUs);
+
+    /// Charge busyUs of work done.
+    void spend(uint32_t busyUs);
+
+    uint64_t busyUs()  const { return _busyUs; }   // total spent
+    int64_t  creditUs() const { return _creditUs; }
+
+private:
+    void accrue(uint32_t nowUs);
+
+    uint32_t _pct;
+    int64_t  _burstUs;
+    int64_t  _creditUs;
+    uint32_t _lastUs  = 0;
+    bool     _started = false;
+    uint64_t _busyUs  = 0;
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+// ============================================================
+//  DsThermBatch.h  —  Broadcast-convert DS18B20 batch reader
+//
+//  Built directly on OneWireNg's DSTherm driver.  Probes are
+//  grouped by sampling profile (resolution + read interval);
+//  each group sweeps on its own timer:
+//
+//    1. Convert T for the whole group — Skip-ROM when the group
+//       is every sampled probe on the bus, else one Match-ROM per member
+//    2. event-loop delay for the group's conversion time
+//       (93.75 ms at 9 bit … 750 ms at 12 bit), no blocking
+//    3. one pass of Read Scratchpad per member, CRC-checked
+//
+//  A fast low-resolution group (e.g. exhaust, 10 bit @ 1 s) and a
+//  slow high-resolution group (cabin, 12 bit @ 30 s) therefore
+//  never wait on each other.  Bus time is measured with micros()
+//  on every sweep and exposed via stats() / groupStats().
+//
+//  Per probe: a CRC failure is re-read up to ONEWIRE_READ_RETRIES
+//  times; an all-0xFF scratchpad counts as a presence miss; an
+//  85.000 °C power-on-reset value is discarded (and the resolution
+//  rewritten).  After ONEWIRE_BACKOFF_AFTER failed sweeps in a row a
+//  probe is skipped for 1, 2, 4 … ONEWIRE_BACKOFF_MAX_SWEEPS sweeps,
+//  so a dead probe stops costing bus time.  See sensorStats().
+//
+//  One instance per physical bus.  Call scan() and addSensor()
+//  during setup, then begin() once.  Probes can be added, moved to
+//  another profile or removed at any time afterwards (hot re-bind
+//  from the web UI); a probe keeps its output object for the life
+//  of the driver.  With several buses, begin(phaseMs) staggers each
+//  bus's timers so their Convert T / read passes interleave
+//  instead of landing in the same event-loop tick.
+// ============================================================
+
+#include <Arduino.h>
+#include <vector>
+#include <OneWireNg_CurrentPlatform.h>
+#include <drivers/DSTherm.h>
+#include "halmet_config.h"
+#include "OneWireRegistry.h"
+
+struct DsThermBusStats {
+    uint32_t sweeps      = 0;
+    uint32_t convertUs   = 0;   ///< last Convert T transaction(s), any group
+    uint32_t readUs      = 0;   ///< last scratchpad pass, any group
+    uint32_t sweepBusUs  = 0;   ///< convertUs + readUs
+    uint32_t maxSweepUs  = 0;   ///< worst sweepBusUs since boot
+    uint64_t totalBusUs  = 0;   ///< cumulative bus time since boot
+    uint32_t crcErrors   = 0;   ///< cumulative scratchpad CRC failures
+    uint32_t busErrors   = 0;   ///< cumulative presence/bus failures
+};
+
+struct DsThermSensorStats {
+    uint32_t reads          = 0;   ///< good readings
+    uint32_t crcErrors      = 0;   ///< scratchpad CRC failures (incl. retried)
+    uint32_t presenceMisses = 0;   ///< no response to Match ROM / all-0xFF read
+    uint32_t porReads       = 0;   ///< 85 °C power-on-reset values discarded
+    uint32_t retries        = 0;   ///< extra scratchpad reads after a CRC failure
+    uint32_t lastReadUs     = 0;   ///< read latency incl. retries
+    uint32_t maxReadUs      = 0;
+    uint16_t failStreak     = 0;   ///< consecutive failed sweeps
+    uint16_t backoffSweeps  = 0;   ///< sweeps still to skip (0 = sampled)
+};
+
+struct DsThermGroupStats {
+    uint8_t  resolutionBits;
+    uint32_t intervalMs;
+    size_t   sensors;
+    uint32_t sweeps;
+    uint32_t lastBusUs;
+};
+
+class DsThermBatch {
+public:
+    explicit DsThermBatch(uint8_t pin);
+
+    uint8_t pin() const { return _pin; }
+
+    /// Enumerate DS18B20-family devices on the bus.
+    size_t scan(std::vector<OneWireRom>& out);
+
+    /// Incremental form of scan() for background use: scanBegin(),
+    /// then one scanNext() per event-loop tick (one ROM search, ~13 ms
+    /// at standard speed) until it returns false.
+    void scanBegin();
+    bool scanNext(OneWireRom& rom);
+
+    /// Register a probe with its sampling profile; returns its output
+    /// (Kelvin, NAN until the first good read).  Probes with the same
+    /// (resolutionBits, intervalMs) share one conversion.  Calling it
+    /// again for a known ROM moves the probe to the new profile and
+    /// returns the same output.  Output objects live as long as the driver.
+    sensesp::ObservableValue<float>* addSensor(const OneWireRom& rom,
+                                               uint8_t  resolutionBits = 12,
+                                               uint32_t intervalMs     = INTERVAL_1WIRE_MS);
+
+    /// Stop sampling a probe; its output keeps the last value.
+    void removeSensor(const OneWireRom& rom);
+
+    /// Program probe resolutions and start one timer per group,
+    /// the first sweep delayed by phaseMs.
+    void begin(uint32_t phaseMs = 0);
+
+    const DsThermBusStats& stats()       const { return _stats; }
+    size_t                 sensorCount() const { return _active; }
+    size_t                 groupCount()  const { return _groups.size(); }
+    DsThermGroupStats      groupStats(size_t g) const;
+
+    /// Quality counters for one probe; false if the ROM is unknown.
+    bool sensorStats(const OneWireRom& rom, DsThermSensorStats& out) const;
+
+    /// Conversion time for a DS18B20 resolution (9–12 bit).
+    static uint32_t convTimeMs(uint8_t resolutionBits);
+
+    /// millis() the values being emitted were acquired (middle of
+    /// their sweep's conversion); read it from an output's observer.
+    uint32_t acquiredMs() const { return _acquiredMs; }
+
+private:
+    struct Sensor {
+        OneWireNg::Id                    id;
+        sensesp::ObservableValue<float>* out;
+        int                              group = -1;   // -1 = not sampled
+        bool                             unconverted = true;  // joined mid-sweep
+        DsThermSensorStats               q;
+    };
+
+    struct Group {
+        uint8_t             resolutionBits;
+        uint32_t            intervalMs;
+        std::vector<size_t> members;      // indices into _sensors
+        bool                active    = false;
+        uint32_t            convertMs = 0;    // millis() of the Convert T
+        uint32_t            convertUs = 0;
+        uint32_t            lastBusUs = 0;
+        uint32_t            sweeps    = 0;
+    };
+
+    int    findSensor(const OneWireRom& rom) const;
+    size_t groupFor(uint8_t resolutionBits, uint32_t intervalMs);
+    void   detach(size_t si);
+    void   writeResolution(size_t si);
+    void   startTimer(size_t gi);
+    void   startSweep(size_t gi);
+    void   readGroup(size_t gi);
+    bool   readSensor(size_t si);
+    bool   respondsAbsent(const Sensor& s);
+
+    uint8_t                   _pin;
+    OneWireNg_CurrentPlatform _ow;
+    DSTherm                   _drv;
+    std::vector<Sensor>       _sensors;
+    std::vector<Group>        _groups;    // only grows; timers hold indices
+    bool                      _scanDone = true;
+    size_t                    _active  = 0;   // sensors currently in a group
+    bool                      _started = false;
+    uint32_t                  _acquiredMs = 0;   // group being read (acquiredMs())
+    DsThermBusStats           _stats;
+};
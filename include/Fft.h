@@ -0,0 +1,29 @@
+#pragma once
+
+// ============================================================
+//  Fft.h  —  In-place radix-2 complex FFT
+//
+//  fft() uses the esp-dsp kernels (dsps_fft2r_fc32, assembler-
+//  optimised for the ESP32's FPU) when the firmware is built with
+//  the esp-dsp component, and fftReference() — the same transform
+//  in portable C++ — everywhere else, including the native tests,
+//  which check one against a plain DFT.
+//
+//  Data is n interleaved (re, im) float pairs, n a power of two up
+//  to kMaxFft.  Forward transform, no scaling; output in natural
+//  order.
+// ============================================================
+
+#include <cstddef>
+
+constexpr int kMaxFft = 1024;
+
+/// Transform data[0 .. 2n-1] in place.  Returns false (data
+/// untouched) when n is not a power of two in [2, kMaxFft].
+bool fft(float* data, int n);
+
+/// Portable radix-2 reference; same contract as fft().
+bool fftReference(float* data, int n);
+
+/// "esp-dsp" or "reference" — which one fft() runs.
+const char* fftBackend();
@@ -0,0 +1,88 @@
+#pragma once
+
+// ============================================================
+//  FlashJournal.h  —  Append-only, wear-levelled record journal
+//
+//  Stores fixed-size snapshot records in a raw flash area that
+//  is used as a ring of erase sectors.  Each append goes to the
+//  next blank slot; when the head reaches the end of a sector
+//  the next (oldest) sector is erased and the head moves into
+//  it, so every sector is erased equally often.
+//
+//  Every record is a full snapshot, so compaction is just the
+//  erase of the oldest sector on entry: nothing in it is needed
+//  once a newer record exists elsewhere.
+//
+//  Slot layout (little-endian):
+//    uint16_t magic          kFlashJournalMagic
+//    uint16_t payloadLen
+//    uint32_t seq            +1 per append, never reused
+//    uint8_t  payload[payloadLen]
+//    uint32_t crc32          over magic … payload
+//    0xFF padding to slotSize()
+//
+//  Recovery scans every slot and keeps the valid record with the
+//  highest seq.  A write torn by power loss fails its CRC and is
+//  skipped; an interrupted erase leaves the previous sector (and
+//  the newest record in it) intact.  Either way recovery returns
+//  the last record that was completely written.
+//
+//  The flash backend is a JournalFlash implementation (ESP32
+//  partition in engine_hours, RAM with erase counters in
+//  tools/journal_wear_sim.cpp).
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint16_t kFlashJournalMagic = 0x4A48;   // "HJ"
+
+// ----------------------------------------------------------
+//  Raw NOR flash: erase sets a sector to 0xFF, write only
+//  clears bits.  Addresses are relative to the journal area.
+// ----------------------------------------------------------
+class JournalFlash {
+public:
+    virtual ~JournalFlash() = default;
+    virtual size_t sectorSize()  const = 0;
+    virtual size_t sectorCount() const = 0;
+    virtual bool   read(size_t addr, void* dst, size_t len)        = 0;
+    virtual bool   write(size_t addr, const void* src, size_t len) = 0;
+    virtual bool   erase(size_t sector)                            = 0;
+};
+
+class FlashJournal {
+public:
+    FlashJournal(JournalFlash& flash, size_t payloadLen);
+
+    /// Scan the area and position the head after the newest valid
+    /// record.  Copies its payload to `payload` and returns true, or
+    /// returns false if the area holds no valid record.
+    bool recover(void* payload);
+
+    /// Write one record.  recover() must have been called first.
+    bool append(const void* payload);
+
+    size_t   slotSize()     const { return _slotSize; }
+    size_t   capacity()     const { return _slotsPerSector * _flash.sectorCount(); }
+    uint32_t seq()          const { return _seq; }         // of the newest record
+    uint32_t appends()      const { return _appends; }     // since recover()
+    uint32_t erases()       const { return _erases; }      // since recover()
+    uint32_t corruptSlots() const { return _corrupt; }     // found by recover()
+
+private:
+    bool   readSlot(size_t slot, void* payload, uint32_t& seq);
+    bool   slotBlank(size_t slot);
+    size_t slotAddr(size_t slot) const;
+
+    JournalFlash& _flash;
+    size_t   _payloadLen;
+    size_t   _slotSize;
+    size_t   _slotsPerSector;
+    size_t   _head      = 0;     // next slot to write
+    uint32_t _seq       = 0;
+    uint32_t _appends   = 0;
+    uint32_t _erases    = 0;
+    uint32_t _corrupt   = 0;
+    bool     _recovered = false;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  InplaceFunction.h  —  Non-allocating callback holder
+//
+//  A std::function replacement for callbacks registered once at
+//  boot: the callable is stored inside the object, in Capacity
+//  bytes, so assigning a lambda never touches the heap.  A callable
+//  that is too big, over-aligned, or not trivially copyable and
+//  destructible is a compile error rather than a silent allocation
+//  — capture pointers and scalars, not Strings or containers.
+//
+//    InplaceFunction<void(bool)> cb = [sk](bool on) { sk->set(on); };
+//    if (cb) cb(true);
+//
+//  Header-only, no Arduino dependencies.
+// ============================================================
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 2 * sizeof(void*)>
+class InplaceFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() = default;
+    InplaceFunction(std::nullptr_t) {}
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InplaceFunction>::value>>
+    InplaceFunction(F f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "callable does not fit; raise Capacity or capture less");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable is over-aligned");
+        static_assert(std::is_trivially_copyable<Fn>::value &&
+                      std::is_trivially_destructible<Fn>::value,
+                      "captures must be trivially copyable (pointers, scalars)");
+        new (_buf) Fn(f);
+        _call = [](const void* buf, Args... args) -> R {
+            return (*static_cast<Fn*>(const_cast<void*>(buf)))(std::forward<Args>(args)...);
+        };
+    }
+
+    InplaceFunction(const InplaceFunction&)            = default;
+    InplaceFunction& operator=(const InplaceFunction&) = default;
+
+    explicit operator bool() const { return _call != nullptr; }
+
+    R operator()(Args... args) const { return _call(_buf, std::forward<Args>(args)...); }
+
+private:
+    using Invoker = R (*)(const void*, Args...);
+
+    alignas(std::max_align_t) unsigned char _buf[Capacity] = {};
+    Invoker _call = nullptr;
+};
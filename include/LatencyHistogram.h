@@ -0,0 +1,47 @@
+#pragma once
+
+// ============================================================
+//  LatencyHistogram.h  —  Log-bucketed data-age histogram
+//
+//  One per published signal: each transmit records how old the
+//  value was (transmit time − acquisition time).  Bucket 0 holds
+//  ages under 1 ms, bucket i ≥ 1 holds [2^(i-1), 2^i) ms and the
+//  last bucket everything from 2^(kBuckets-2) ms up, so a 10 Hz
+//  RPM value and a 30 s cabin probe fit the same 16 counters with
+//  the same relative resolution.
+//
+//  Percentiles interpolate linearly inside the bucket that holds
+//  them and are clamped to the largest age seen — a factor-of-two
+//  bucket is plenty to tell a 200 ms scheduling change from a 1 s
+//  one.  Counts are since boot.  Fixed memory, constant work per
+//  record().
+// ============================================================
+
+#include <cstdint>
+
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 16;
+
+    void record(uint32_t ageMs);
+
+    uint32_t count()  const { return _count; }
+    uint32_t lastMs() const { return _lastMs; }
+    uint32_t maxMs()  const { return _maxMs; }
+    uint32_t meanMs() const { return _count ? static_cast<uint32_t>(_sumMs / _count) : 0; }
+
+    /// Age below which a fraction p (0–1) of the records fall; 0
+    /// while empty.
+    uint32_t percentileMs(float p) const;
+
+    uint32_t bucket(int i) const { return _bucket[i]; }
+    static int      bucketOf(uint32_t ageMs);
+    static uint32_t bucketLowMs(int i);    // inclusive lower bound
+
+private:
+    uint32_t _bucket[kBuckets] = {};
+    uint32_t _count  = 0;
+    uint32_t _lastMs = 0;
+    uint32_t _maxMs  = 0;
+    uint64_t _sumMs  = 0;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+// ============================================================
+//  LogRing.h  —  Deferred binary log records
+//
+//  A log call stores a format ID and up to kLogMaxArgs raw 32-bit
+//  arguments — no text is formatted and nothing is written to the
+//  UART at the call site.  The record goes into a bounded
+//  multi-producer, single-consumer ring (Vyukov's sequence-
+//  numbered slots): push() is lock-free and never waits, so it is
+//  safe from any task on either core and from ISRs; when the ring
+//  is full the record is counted in dropped() and discarded.  One
+//  consumer — the dlog drain task — pops records and formats them
+//  with formatLogRecord(), or sends them as binary frames
+//  (encodeLogFrame()) for tools/log_decode.py to format on a PC.
+// ============================================================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+constexpr int kLogMaxArgs = 4;
+
+struct LogRecord {
+    uint32_t ms;                  // millis() at the log call
+    uint16_t fmt;                 // LogFmt
+    uint8_t  nargs;
+    uint8_t  reserved;
+    uint32_t args[kLogMaxArgs];   // raw: ints as is, floats bit-cast
+};
+static_assert(sizeof(LogRecord) == 24, "LogRecord is part of the wire format");
+
+/// Argument conversion for the log call templates.
+inline uint32_t toLogArg(float v) {
+    uint32_t u;
+    std::memcpy(&u, &v, sizeof(u));
+    return u;
+}
+inline uint32_t toLogArg(double v) { return toLogArg(static_cast<float>(v)); }
+inline uint32_t toLogArg(bool v)   { return v ? 1u : 0u; }
+template <typename T>
+inline uint32_t toLogArg(T v) {
+    static_assert(sizeof(T) <= 4 && !std::is_pointer<T>::value, "log arguments are 32-bit values, not strings");
+    return static_cast<uint32_t>(v);
+}
+
+class LogRing {
+public:
+    static constexpr uint32_t kCapacity = 128;   // power of two
+
+    LogRing();
+
+    /// Append a record.  Any context; false (and dropped() + 1)
+    /// when the ring is full.
+    bool push(const LogRecord& r);
+
+    /// Take the oldest record.  Single consumer only.
+    bool pop(LogRecord& out);
+
+    uint32_t pushed()   const { return _pushed.load(std::memory_order_relaxed); }
+    uint32_t dropped()  const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t popped()   const { return _tail; }
+    uint32_t maxDepth() const { return _maxDepth; }   // most records waiting at one pop
+
+private:
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "kCapacity must be a power of two");
+
+    struct Slot {
+        std::atomic<uint32_t> seq;
+        LogRecord             rec;
+    };
+    Slot                  _slots[kCapacity];
+    std::atomic<uint32_t> _head{0};
+    uint32_t              _tail = 0;       // consumer only
+    std::atomic<uint32_t> _pushed{0};
+    std::atomic<uint32_t> _dropped{0};
+    uint32_t              _maxDepth = 0;
+};
+
+/// Render a record with its printf-style format: %d %i %u %x %X %c
+/// with flags / width, %f %e %g with precision (argument bit-cast
+/// back to float), %B (ON / OFF) and %%.  Missing arguments print
+/// as "?".  Returns the length written (always NUL-terminated).
+size_t formatLogRecord(const char* fmt, const LogRecord& r, char* out, size_t len);
+
+// ----------------------------------------------------------
+//  Binary frame: sync, version, record, CRC-16/CCITT-FALSE over
+//  everything before it.  Little-endian, as the record sits in RAM.
+// ----------------------------------------------------------
+constexpr uint8_t kLogSync0        = 0xA5;
+constexpr uint8_t kLogSync1        = 0x4C;   // 'L'
+constexpr uint8_t kLogFrameVersion = 1;
+constexpr size_t  kLogFrameSize    = 3 + sizeof(LogRecord) + 2;
+
+/// Write one frame to out[kLogFrameSize].
+void encodeLogFrame(const LogRecord& r, uint8_t* out);
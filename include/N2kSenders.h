@@ -11,6 +11,11 @@
 //  Fields not measurable on this engine (Volvo Penta MD7A):
 //    boost pressure, trim, oil pressure — omitted; library
 //    receives N2kDoubleNA / N2kInt8NA internally.
+//
+//  Each PGN has a build*() that only encodes into a tN2kMsg (no
+//  CAN driver — used by the native tests and benchmarks) and a
+//  send*() that builds and hands the message to the driver; a
+//  send*() returns false if the driver did not accept the frame.
 // ============================================================
 
 #include <Arduino.h>
@@ -22,19 +27,37 @@ namespace N2kSenders {
 // ----------------------------------------------------------
 //  PGN 127488 — Engine Rapid Update  (10 Hz recommended)
 //  Sends: engine RPM only (boost/trim not available on MD7A)
+//  Returns false if the CAN driver did not accept the frame
+//  (e.g. address claim still in progress).
 // ----------------------------------------------------------
-void sendEngineRapidUpdate(tNMEA2000& nmea2000,
+void buildEngineRapidUpdate(tN2kMsg& msg,
+                            uint8_t  engineInstance,
+                            double   rpmValue);
+
+bool sendEngineRapidUpdate(tNMEA2000& nmea2000,
                            uint8_t    engineInstance,
                            double     rpmValue);
 
 // ----------------------------------------------------------
 //  PGN 127489 — Engine Dynamic Parameters  (1 Hz)
-//  Sends: coolant temperature, oil/overheat alarm status bits
-//  (oil pressure not measurable on MD7A — digital alarm only)
+//  Sends: coolant temperature, engine hours, fuel rate (from the
+//  tank level, TankEstimator), oil/overheat alarm
+//  status bits (oil pressure not measurable on MD7A — digital
+//  alarm only)
 // ----------------------------------------------------------
-void sendEngineDynamic(tNMEA2000& nmea2000,
+void buildEngineDynamic(tN2kMsg& msg,
+                        uint8_t  engineInstance,
+                        double   coolantTempK,
+                        double   engineHoursS,
+                        double   fuelRateLph,
+                        bool     oilPressureLow,
+                        bool     overTemperature);
+
+bool sendEngineDynamic(tNMEA2000& nmea2000,
                        uint8_t    engineInstance,
                        double     coolantTempK,
+                       double     engineHoursS,      // seconds, N2kDoubleNA if unknown
+                       double     fuelRateLph,       // L/h, N2kDoubleNA if unknown
                        bool       oilPressureLow,
                        bool       overTemperature);
 
@@ -43,6 +66,10 @@ void sendEngineDynamic(tNMEA2000& nmea2000,
 //  Reports relay on/off state so MFDs stay in sync with the
 //  bilge fan.  Switch bank instance 0, switch index 1.
 // ----------------------------------------------------------
+void buildBinaryStatus(tN2kMsg& msg,
+                       uint8_t  bankInstance,
+                       bool     relayOn);
+
 void sendBinaryStatus(tNMEA2000& nmea2000,
                       uint8_t    bankInstance,
                       bool       relayOn);
@@ -51,7 +78,13 @@ void sendBinaryStatus(tNMEA2000& nmea2000,
 //  PGN 127505 — Fluid Level  (1 Hz)
 //  Sends: tank fluid level as 0.0–100.0 percent
 // ----------------------------------------------------------
-void sendFluidLevel(tNMEA2000&      nmea2000,
+void buildFluidLevel(tN2kMsg&      msg,
+                     uint8_t       tankInstance,
+                     tN2kFluidType fluidType,
+                     double        levelPct,
+                     double        capacityL);
+
+bool sendFluidLevel(tNMEA2000&      nmea2000,
                     uint8_t         tankInstance,
                     tN2kFluidType   fluidType,
                     double          levelPct,       // 0.0–100.0
@@ -59,12 +92,29 @@ void sendFluidLevel(tNMEA2000&      nmea2000,
 
 // ----------------------------------------------------------
 //  PGN 130316 — Temperature Extended Range  (0.1 Hz suggested)
-//  Used for DS18B20 engine-room probes
+//  Used for DS18B20 engine-room probes.  sid from sidFor() ties
+//  readings converted together (one DS18B20 sweep).
 // ----------------------------------------------------------
-void sendTemperatureExtended(tNMEA2000&             nmea2000,
+void buildTemperatureExtended(tN2kMsg&       msg,
+                              uint8_t        sid,
+                              uint8_t        sensorInstance,
+                              tN2kTempSource source,
+                              double         actualTempK,
+                              double         setTempK = N2kDoubleNA);
+
+bool sendTemperatureExtended(tNMEA2000&             nmea2000,
+                             uint8_t                sid,
                              uint8_t                sensorInstance,
                              tN2kTempSource         source,
                              double                 actualTempK,
                              double                 setTempK = N2kDoubleNA);
 
+// ----------------------------------------------------------
+//  Sequence ID for a reading acquired at acquiredMs: readings
+//  from the same periodMs slot share one (0–252; 253–255 are
+//  reserved / not available).  Of the PGNs sent here only 130316
+//  has a SID field.
+// ----------------------------------------------------------
+uint8_t sidFor(uint32_t acquiredMs, uint32_t periodMs);
+
 }  // namespace N2kSenders
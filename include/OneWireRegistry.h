@@ -0,0 +1,71 @@
+#pragma once
+
+// ============================================================
+//  OneWireRegistry.h  —  ROM-keyed 1-Wire sensor registry
+//
+//  Dynamically sized table of every detected probe across all
+//  1-Wire buses.  Lookup by ROM code is O(1) on average via an
+//  open-addressed hash index (linear probing, load ≤ 1/2) over
+//  the entry vector.  Entries are never removed, so indices are
+//  stable and safe to hold in callbacks.
+//
+//  The publishers (n2k_publisher, blackbox, diagnostics) iterate
+//  entries directly; only bound entries (dest > 0 with a value)
+//  carry any per-cycle cost.
+// ============================================================
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sensesp {
+template <typename T> class ObservableValue;
+}
+
+/// 64-bit 1-Wire ROM code (family, serial ×6, CRC).
+using OneWireRom = std::array<uint8_t, 8>;
+
+struct OneWireEntry {
+    OneWireRom                       rom;
+    uint8_t                          bus        = 0;        ///< index into ONEWIRE_BUS_PINS
+    int                              dest       = 0;        ///< kTempDests index, 0 = not used
+    int                              instance   = -1;       ///< PGN 130316 instance, -1 = unbound
+    sensesp::ObservableValue<float>* value      = nullptr;  ///< Kelvin, NAN until first read
+    uint32_t                         sampleMs   = 0;        ///< acquisition millis() of the last valid read, 0 = none
+    uint32_t                         lastSentMs = 0;        ///< PGN 130316 publisher bookkeeping
+
+    bool bound() const { return dest > 0 && value != nullptr; }
+
+    /// A valid read within ONEWIRE_STALE_INTERVALS of the destination's
+    /// read interval — the rule for PGN 130316 and the MQTT batch.
+    bool fresh(uint32_t now) const;
+};
+
+class OneWireRegistry {
+public:
+    /// Insert a probe (or return the existing index if the ROM is
+    /// already known, e.g. the same probe seen on two scans).
+    size_t add(const OneWireRom& rom, uint8_t bus);
+
+    /// Index of the ROM, or -1.
+    int find(const OneWireRom& rom) const;
+
+    size_t              size()               const { return _entries.size(); }
+    OneWireEntry&       operator[](size_t i)       { return _entries[i]; }
+    const OneWireEntry& operator[](size_t i) const { return _entries[i]; }
+
+    std::vector<OneWireEntry>::iterator       begin()       { return _entries.begin(); }
+    std::vector<OneWireEntry>::iterator       end()         { return _entries.end(); }
+    std::vector<OneWireEntry>::const_iterator begin() const { return _entries.begin(); }
+    std::vector<OneWireEntry>::const_iterator end()   const { return _entries.end(); }
+
+    /// Hash of the ROM's 48-bit serial, used for the index.
+    static uint32_t romHash(const OneWireRom& rom);
+
+private:
+    void rebuildIndex(size_t buckets);
+
+    std::vector<OneWireEntry> _entries;
+    std::vector<int32_t>      _index;   // bucket → entry index, -1 = empty
+};
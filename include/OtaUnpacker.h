@@ -0,0 +1,116 @@
+#pragma once
+
+// ============================================================
+//  OtaUnpacker.h  —  Streaming decoder for compressed OTA images
+//
+//  A compressed image (tools/ota_pack.py) is an OtaImageHeader
+//  followed by payloadLen bytes of payload:
+//
+//    algo 0  stored — the firmware image as is
+//    algo 1  LZSS, 4 KB window: a flag byte, LSB first, then
+//            eight items; flag 1 = one literal byte, flag 0 = a
+//            back-reference of two bytes
+//              b0 = (dist-1) & 0xFF
+//              b1 = ((dist-1) >> 8) | ((len-3) << 4)
+//            dist 1…4096, len 3…18
+//
+//  feed() takes the body in whatever pieces the transport
+//  delivers, keeps a running CRC-32 of the payload and decodes
+//  into the 4 KB history window, which doubles as the output
+//  buffer: the sink sees whole 4 KB blocks (one flash sector)
+//  and a final partial block from finish().  No allocation.
+//
+//  The CRC only covers the transfer; the sink hashes the image
+//  it is given against header().imageSha256 (mbedtls on the
+//  device), so a wrong build is caught as well as a bad link.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint32_t kOtaImageMagic   = 0x315A4F48;   // "HOZ1"
+constexpr uint8_t  kOtaImageVersion = 1;
+
+enum class OtaAlgo : uint8_t {
+    STORED = 0,
+    LZSS   = 1,
+};
+
+struct __attribute__((packed)) OtaImageHeader {
+    uint32_t magic;            // kOtaImageMagic
+    uint8_t  version;          // kOtaImageVersion
+    uint8_t  algo;             // OtaAlgo
+    uint8_t  windowBits;       // 12 (LZSS), 0 (stored)
+    uint8_t  reserved;
+    uint32_t imageLen;         // decompressed firmware size
+    uint32_t payloadLen;       // bytes after this header
+    uint32_t payloadCrc;       // CRC-32 (IEEE) of the payload
+    uint8_t  imageSha256[32];  // of the decompressed firmware
+};
+
+static_assert(sizeof(OtaImageHeader) == 52, "OtaImageHeader layout is shared with ota_pack.py");
+
+enum class OtaStatus : uint8_t {
+    OK = 0,
+    BAD_MAGIC,          // not a compressed image
+    BAD_VERSION,        // header version or window size not supported
+    TOO_LARGE,          // imageLen does not fit the partition
+    CORRUPT_STREAM,     // back-reference before the start of the image
+    OVERRUN,            // more payload or output than the header declares
+    TRUNCATED,          // finish() before the whole payload / image arrived
+    CRC_MISMATCH,       // payload damaged in transfer
+    WRITE_FAILED,       // sink returned false
+};
+
+const char* otaStatusName(OtaStatus s);
+
+/// Receives decompressed image bytes in order.  Return false to abort.
+using OtaSink = bool (*)(void* ctx, const uint8_t* data, size_t len);
+
+class OtaUnpacker {
+public:
+    static constexpr size_t kWindow = 4096;
+
+    OtaUnpacker(OtaSink sink, void* ctx, uint32_t maxImageLen);
+
+    /// Consume the next piece of the body.  Returns the first error;
+    /// once an error is returned every later call returns it too.
+    OtaStatus feed(const uint8_t* data, size_t len);
+
+    /// End of body: flush the last block and check length and CRC.
+    OtaStatus finish();
+
+    bool                  headerDone() const { return _hdrGot == sizeof(OtaImageHeader); }
+    const OtaImageHeader& header()     const { return _hdr; }
+    uint32_t              payloadIn()  const { return _payloadIn; }
+    uint32_t              imageOut()   const { return _out; }
+    OtaStatus             status()     const { return _status; }
+
+private:
+    OtaStatus fail(OtaStatus s) { return _status = s; }
+    OtaStatus checkHeader();
+    bool      put(uint8_t b);
+    bool      flush();
+    OtaStatus decode(uint8_t b);
+
+    OtaSink  _sink;
+    void*    _ctx;
+    uint32_t _maxImageLen;
+
+    OtaImageHeader _hdr       = {};
+    size_t         _hdrGot    = 0;
+    uint32_t       _payloadIn = 0;
+    uint32_t       _crc       = 0xFFFFFFFFu;
+    OtaStatus      _status    = OtaStatus::OK;
+
+    // LZSS state
+    uint8_t  _flags     = 0;
+    uint8_t  _flagsLeft = 0;      // items left under the current flag byte
+    bool     _haveB0    = false;  // first byte of a back-reference read
+    uint8_t  _b0        = 0;
+
+    // History window / output buffer
+    uint8_t  _win[kWindow];
+    uint32_t _out     = 0;        // bytes produced
+    uint32_t _flushed = 0;        // bytes handed to the sink
+};
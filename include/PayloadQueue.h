@@ -0,0 +1,50 @@
+#pragma once
+
+// ============================================================
+//  PayloadQueue.h  —  Bounded FIFO of encoded messages
+//
+//  Fixed slots over a caller's buffer; each slot holds one
+//  payload up to slotBytes − 2 (a 16-bit length prefix).  When
+//  every slot is full the OLDEST payload is dropped to make room:
+//  after a broker outage the newest telemetry goes out first and
+//  memory never grows.  A payload too big for a slot is rejected.
+//
+//  Single producer, single consumer on the same task (the event
+//  loop).
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+class PayloadQueue {
+public:
+    PayloadQueue(uint8_t* buf, size_t slots, size_t slotBytes);
+
+    /// Copy a payload in; false if it can never fit a slot.
+    bool push(const uint8_t* data, size_t len);
+
+    /// Oldest payload, or nullptr when empty.
+    const uint8_t* front(size_t& len) const;
+    void           pop();
+
+    size_t   depth()      const { return _depth; }
+    size_t   slots()      const { return _slots; }
+    size_t   maxPayload() const { return _slotBytes - 2; }
+    uint32_t pushed()     const { return _pushed; }
+    uint32_t dropped()    const { return _dropped; }    // oldest evicted
+    uint32_t rejected()   const { return _rejected; }   // too big
+    size_t   maxDepth()   const { return _maxDepth; }
+
+private:
+    uint8_t* slot(size_t i) const { return _buf + i * _slotBytes; }
+
+    uint8_t* _buf;
+    size_t   _slots;
+    size_t   _slotBytes;
+    size_t   _head     = 0;   // oldest
+    size_t   _depth    = 0;
+    uint32_t _pushed   = 0;
+    uint32_t _dropped  = 0;
+    uint32_t _rejected = 0;
+    size_t   _maxDepth = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// ============================================================
+//  RevAnalyzer.h  —  Crank-speed variation from W-terminal edges
+//
+//  Edge intervals are the crank's speed sampled evenly in crank
+//  angle, so their spectrum is in engine orders (0.5 = one
+//  cylinder weaker than the other, 1 = firing pulses).
+//
+//  feed() collects edges into blocks of kBlock intervals.  A full
+//  block waits until analyze(), or is dropped if the previous one
+//  is still waiting, so the caller decides when to spend the CPU.
+//  analyze() rejects blocks with a missing or extra edge or below
+//  minRpm, then windows and FFTs the speed; result() holds the
+//  amplitudes per order.
+// ============================================================
+
+#include <cstdint>
+
+class RevAnalyzer {
+public:
+    static constexpr int kBlock  = 256;   // edge intervals per block (power of two)
+    static constexpr int kOrders = 6;     // orders 0.5, 1.0 … 3.0
+
+    struct Result {
+        uint32_t endUs     = 0;   // micros() of the block's last edge
+        float    rpm       = 0;   // block mean
+        float    roughness = 0;   // RMS speed variation, orders 0.25–4.25, / mean speed
+        float    orderRpm[kOrders] = {};   // amplitude (peak) of each order, RPM
+    };
+
+    /// @param minRpm   blocks slower than this are rejected
+    explicit RevAnalyzer(float minRpm);
+
+    /// Append edge timestamps (micros(), in order; intervals are
+    /// wrap-safe).  A gap longer than kMaxGapUs — engine stopped —
+    /// restarts the block.
+    void feed(const uint32_t* edgesUs, int n);
+
+    /// Forget the partial block: the next edge does not follow the
+    /// last one (edges were lost).
+    void restart();
+
+    /// A full block is waiting for analyze().
+    bool pending() const { return _pending; }
+
+    /// Analyse the waiting block; true when result() was updated.
+    bool analyze(float pulsesPerRev);
+
+    /// Drop the waiting block unanalysed.
+    void discard();
+
+    const Result& result() const { return _result; }
+
+    /// Crank order reported in orderRpm[i].
+    static float order(int i) { return 0.5f * (i + 1); }
+
+    uint32_t analysed() const { return _analysed; }
+    uint32_t rejected() const { return _rejected; }   // glitch or below minRpm
+    uint32_t dropped()  const { return _dropped; }    // overwritten or discarded
+
+    static constexpr uint32_t kMaxGapUs = 200000;   // 30 RPM at 10 ppr
+
+private:
+    float    _minRpm;
+    bool     _haveEdge = false;
+    uint32_t _lastUs   = 0;
+    int      _fill     = 0;
+    uint32_t _collect[kBlock] = {};   // intervals being collected, µs
+    uint32_t _block[kBlock]   = {};   // full block waiting for analyze()
+    uint32_t _blockEndUs      = 0;
+    bool     _pending  = false;
+    float    _work[2 * kBlock] = {};  // FFT buffer (re, im)
+    float    _window[kBlock]   = {};
+    Result   _result;
+    uint32_t _analysed = 0;
+    uint32_t _rejected = 0;
+    uint32_t _dropped  = 0;
+};
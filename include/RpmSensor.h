@@ -10,6 +10,10 @@
 //  call RpmSensor::begin() once in setup().
 //  call RpmSensor::getRpm()  each INTERVAL_RPM_MS to get the
 //  latest smoothed engine RPM.
+//
+//  The ISR also keeps the micros() of the last REV_EDGE_RING
+//  edges for the per-revolution analysis (rev_analysis), which
+//  drains them from its own task with readEdges().
 // ============================================================
 
 #include <Arduino.h>
@@ -31,11 +35,24 @@ public:
     float update();
 
     float getRpm()          const { return _smoothedRpm; }
+    float getInstantRpm()   const { return _instantRpm; }   ///< last un-smoothed tick
+
+    /// millis() the smoothed value stands for: the middle of the
+    /// pulse-counting intervals it averages (half the window behind
+    /// the last update()).
+    uint32_t acquiredMs()   const { return _acquiredMs; }
     float getPulsesPerRev() const { return _pulsesPerRev; }
 
     /// Allow runtime reconfiguration (from web UI parameter)
     void  setPulsesPerRev(float p) { _pulsesPerRev = p; }
 
+    /// Copy the edge timestamps (micros()) captured since `cursor`
+    /// into out[], oldest first, and advance the cursor.  Returns
+    /// how many were copied; edges the ring overwrote before they
+    /// were read are skipped and added to `lost`.  Safe to call from
+    /// another task or core.
+    static size_t readEdges(uint32_t& cursor, uint32_t* out, size_t max, uint32_t& lost);
+
     // ISR — must be public so attachInterrupt() can reach it
     static void IRAM_ATTR isrHandler();
 
@@ -44,16 +61,24 @@ private:
     float   _pulsesPerRev;
     int     _smoothingSamples;
     float   _smoothedRpm  = 0.0f;
+    float   _instantRpm   = 0.0f;
 
     // Circular buffer for moving average
     static constexpr int kMaxSamples = 20;
-    float   _samples[kMaxSamples] = {};
-    int     _sampleIdx = 0;
-    int     _sampleCount = 0;
+    float    _samples[kMaxSamples] = {};
+    uint32_t _startMs[kMaxSamples] = {};   // millis() each sample's counting interval began
+    int      _sampleIdx = 0;
+    int      _sampleCount = 0;
+    uint32_t _acquiredMs = 0;
 
     // Shared with ISR — must be volatile
     static volatile uint32_t _pulseCount;
     static volatile uint32_t _lastPulseTime;  // micros() at last edge
 
+    // Edge timestamp ring; _edgeHead counts every edge since boot
+    static_assert((REV_EDGE_RING & (REV_EDGE_RING - 1)) == 0, "REV_EDGE_RING must be a power of two");
+    static volatile uint32_t _edgeUs[REV_EDGE_RING];
+    static volatile uint32_t _edgeHead;
+
     unsigned long _lastUpdateMs = 0;
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+// ============================================================
+//  StaticArena.h  —  Bump allocator over a fixed buffer
+//
+//  Long-lived objects built once at boot (SK outputs, persisted
+//  config values, schedulers) are carved out of one buffer sized
+//  at build time instead of the heap.  Nothing is ever freed, so
+//  there is no fragmentation and no per-object header: the cost
+//  of an object is its size plus alignment padding.
+//
+//  Every allocation is charged to the current module (setModule),
+//  giving bytes and object count per module.  After seal() the
+//  arena still allocates but counts each one as late, so a report
+//  can show that nothing was added once boot finished.  When the
+//  buffer is full allocate() returns nullptr and the request is
+//  counted against its module as failed.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+class StaticArena {
+public:
+    static constexpr int kMaxModules = 24;
+
+    struct Module {
+        const char* name;
+        uint32_t    bytes;          // including alignment padding
+        uint16_t    objects;
+        uint16_t    failed;         // requests that did not fit
+        uint32_t    failedBytes;
+    };
+
+    StaticArena(void* buf, size_t capacity);
+
+    /// Charge later allocations to `name` (a string literal; compared
+    /// by content, so the same name always maps to one entry).
+    /// Returns the previous module so a scope can restore it.
+    const char* setModule(const char* name);
+
+    /// size bytes aligned to align (a power of two), or nullptr when
+    /// the buffer is full.
+    void* allocate(size_t size, size_t align);
+
+    /// Boot is over: later allocations count as late.
+    void seal() { _sealed = true; }
+
+    size_t capacity()  const { return _capacity; }
+    size_t used()      const { return _used; }
+    size_t available() const { return _capacity - _used; }
+    bool   sealed()    const { return _sealed; }
+    uint32_t lateAllocs() const { return _late; }
+    uint32_t lateBytes()  const { return _lateBytes; }
+
+    int           modules()      const { return _nModules; }
+    const Module& module(int i)  const { return _modules[i]; }
+
+    /// Entry for `name`, or nullptr if nothing was charged to it.
+    const Module* find(const char* name) const;
+
+private:
+    Module* entry(const char* name);
+
+    uint8_t*    _buf;
+    size_t      _capacity;
+    size_t      _used      = 0;
+    bool        _sealed    = false;
+    uint32_t    _late      = 0;
+    uint32_t    _lateBytes = 0;
+    const char* _current   = nullptr;
+    Module      _modules[kMaxModules] = {};
+    int         _nModules  = 0;
+};
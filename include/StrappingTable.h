@@ -0,0 +1,73 @@
+#pragma once
+
+// ============================================================
+//  StrappingTable.h  —  Tank sender resistance → height → litres
+//
+//  A strapping table is the tank's own calibration: sender
+//  resistance, fuel height and volume at each measured fill step.
+//  compile() (when the table is loaded or saved, not per reading)
+//  resamples it onto uniform grids of kGridSize nodes, so
+//  litres(), heightMm() and ohmsFor() cost one multiply and a
+//  lerp whatever the table size.
+//
+//  Height and volume must both rise, or both fall, with
+//  resistance (VDO: 10 Ω empty; US: 240 Ω empty).  Fixed memory
+//  (3 × kGridSize floats).
+// ============================================================
+
+#include <cstdint>
+
+enum class StrappingStatus : uint8_t {
+    OK = 0,
+    TOO_FEW_POINTS,     // fewer than 2
+    TOO_MANY_POINTS,    // more than kMaxPoints
+    BAD_VALUE,          // NaN / infinite, or negative resistance
+    DUPLICATE_OHMS,     // two points at the same resistance
+    NOT_MONOTONIC,      // height or volume turns back, or they disagree
+};
+
+const char* strappingStatusName(StrappingStatus s);
+
+class StrappingTable {
+public:
+    static constexpr int kGridSize  = 512;
+    static constexpr int kMaxPoints = 1024;
+
+    struct Point {
+        float ohms;
+        float heightMm;
+        float litres;
+    };
+
+    /// Sort pts by resistance (in place), check it and rebuild the
+    /// grids.  On an error the previously compiled grids are kept.
+    StrappingStatus compile(Point* pts, int n);
+
+    bool  valid()      const { return _valid; }
+    int   points()     const { return _points; }
+    float minOhms()    const { return _r0; }
+    float maxOhms()    const { return _r0 + _rStep * (kGridSize - 1); }
+    float minLitres()  const { return _v0; }
+    float maxLitres()  const { return _v0 + _vStep * (kGridSize - 1); }
+    float gridErrorL() const { return _gridErrL; }
+
+    /// End values are held outside the table.  NAN until a table
+    /// has compiled, or for a NAN reading.
+    float litres(float ohms)   const { return lookup(_fwdLitres, _r0, _rInv, ohms); }
+    float heightMm(float ohms) const { return lookup(_fwdHeight, _r0, _rInv, ohms); }
+    /// Sender resistance expected at a volume (diagnostics).
+    float ohmsFor(float litres) const { return lookup(_invOhms, _v0, _vInv, litres); }
+
+private:
+    float lookup(const float* grid, float x0, float inv, float x) const;
+
+    bool  _valid    = false;
+    int   _points   = 0;
+    float _r0       = 0.0f, _rStep = 0.0f, _rInv = 0.0f;
+    float _v0       = 0.0f, _vStep = 0.0f, _vInv = 0.0f;
+    float _gridErrL = 0.0f;
+
+    float _fwdHeight[kGridSize] = {};
+    float _fwdLitres[kGridSize] = {};
+    float _invOhms[kGridSize]   = {};
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+// ============================================================
+//  TankEstimator.h  —  Slosh-resistant tank level & fuel rate
+//
+//  Each sender reading goes through a running median and then a
+//  two-state Kalman filter (level %, consumption %/h).  The rate
+//  moves only while the engine runs and restarts from 0 at each
+//  start; a sustained jump (refuelling) re-seeds the level.
+//
+//  call update() with every valid reading, then read levelPct(),
+//  and ratePctH() once rateValid().  Fixed memory, constant work
+//  per sample.
+// ============================================================
+
+#include <cstdint>
+
+class TankEstimator {
+public:
+    static constexpr int kMaxWindow = 15;
+
+    struct Tuning {
+        int   medianWindow;      // readings, odd, ≤ kMaxWindow
+        float levelSigmaPct;     // measurement noise after the median
+        float levelWalkPct;      // level random walk, %/√h (unmodelled loss)
+        float rateWalkPctH;      // rate random walk while running, (%/h)/√h
+        float rateInitSigmaPctH; // rate uncertainty at each engine start
+        float rateSettleS;       // running time before the rate is reported
+        float jumpSigma;         // innovation threshold for a level jump
+        int   jumpSamples;       // consecutive outliers that re-seed the level
+    };
+
+    explicit TankEstimator(const Tuning& t);
+
+    /// One sender reading (% of capacity), dtS after the previous one.
+    void update(float levelPct, bool engineRunning, float dtS);
+
+    bool  valid()        const { return _seeded; }
+    float levelPct()     const { return _level; }
+    float medianPct()    const { return _median; }
+    /// Consumption in %/h (≥ 0 after clamping); see rateValid().
+    float ratePctH()     const { return _rate > 0.0f ? _rate : 0.0f; }
+    bool  rateValid()    const { return _seeded && (!_running || _runS >= _t.rateSettleS); }
+    /// 1σ of the rate estimate, %/h
+    float rateSigmaPctH() const;
+    /// Hours to empty at the current rate, or < 0 if not known
+    float enduranceH(float minRatePctH) const;
+    uint32_t jumps()     const { return _jumps; }
+
+private:
+    float median() const;
+
+    Tuning   _t;
+    float    _ring[kMaxWindow] = {};
+    int      _n      = 0;       // readings in the ring (≤ window)
+    int      _head   = 0;
+    float    _median = 0.0f;
+
+    bool     _seeded  = false;
+    bool     _running = false;
+    float    _runS    = 0.0f;
+    float    _level   = 0.0f;
+    float    _rate    = 0.0f;
+    float    _p00 = 0.0f, _p01 = 0.0f, _p11 = 0.0f;   // covariance
+    int      _outliers = 0;
+    uint32_t _jumps    = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// ============================================================
+//  TankStrapping.h  —  Tank strapping table as a web UI config
+//
+//  Holds the strapping points (sender Ω, fuel height mm, volume L)
+//  at its config path and compiles them into a StrappingTable
+//  whenever they are loaded at boot or saved from the web UI — the
+//  per-reading cost stays one grid lookup however long the table.
+//
+//  A table that does not compile (see StrappingStatus) is refused:
+//  from_json() returns false, the web UI reports the save as
+//  failed, and the last good table stays in use.  With nothing
+//  saved the table is the European VDO sender, 10 Ω empty to
+//  180 Ω full, linear up to the given full volume; setFullLitres()
+//  rebuilds it when the tank capacity changes.
+// ============================================================
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include <sensesp/system/saveable.h>
+#include <sensesp/system/serializable.h>
+
+#include "StrappingTable.h"
+
+class TankStrapping : public sensesp::FileSystemSaveable,
+                      virtual public sensesp::Serializable {
+public:
+    TankStrapping(float fullLitres, const String& configPath);
+
+    bool to_json(JsonObject& root) override;
+    bool from_json(const JsonObject& root) override;
+
+    /// Rebuild the default table for a new capacity; no-op once a
+    /// table has been loaded or saved.
+    void setFullLitres(float fullLitres);
+
+    const StrappingTable& table()     const { return _table; }
+    bool                  isDefault() const { return _default; }
+    StrappingStatus       status() const { return _status; }   // of the last compile attempt
+
+private:
+    bool compile(std::vector<StrappingTable::Point> pts);
+    void compileDefault(float fullLitres);
+
+    std::vector<StrappingTable::Point> _points;   // sorted by resistance
+    StrappingTable                     _table;
+    StrappingStatus                    _status  = StrappingStatus::OK;
+    bool                               _default = true;   // VDO table, nothing saved
+};
+
+const String ConfigSchema(const TankStrapping& obj);
@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  TaskSupervisor.h  —  Liveness deadlines for periodic tasks
+//
+//  Each supervised task checks in every time it runs.  check()
+//  compares the time since each task's last check-in with its
+//  deadline and returns false while any critical task is
+//  overdue — the caller feeds the hardware watchdog only on
+//  true, so a stalled task turns into a reset within
+//  deadline + watchdog timeout instead of frozen data.
+//
+//  A critical task is held to its deadline from add() on, so a
+//  task that never starts is caught too.  A non-critical task
+//  is only watched once it has checked in (e.g. a 1-Wire bus
+//  with no probes never does); its misses are counted and
+//  reported but never starve the watchdog.
+// ============================================================
+
+#include <cstdint>
+
+class TaskSupervisor {
+public:
+    static constexpr int kMaxTasks = 8;
+
+    struct Task {
+        const char* name;
+        uint32_t    deadlineMs;
+        bool        critical;
+        bool        started;       // checked in at least once
+        bool        overdue;       // at the last check()
+        uint32_t    lastMs;        // last check-in (or add()/restart())
+        uint32_t    maxGapMs;      // worst interval between check-ins
+        uint32_t    misses;        // times it went overdue
+    };
+
+    /// Register a task.  Returns its id, or -1 when full.
+    int add(const char* name, uint32_t deadlineMs, bool critical, uint32_t nowMs);
+
+    void checkIn(int id, uint32_t nowMs);
+
+    /// True while no critical task is overdue.  Each transition
+    /// into overdue counts one miss.  Ages are wrap-safe.
+    bool check(uint32_t nowMs);
+
+    /// Start every deadline afresh (after a suspension).
+    void restart(uint32_t nowMs);
+
+    /// The critical task that is furthest past its deadline at the
+    /// last check(), or -1.
+    int  worstOverdue() const { return _worst; }
+
+    int         count()        const { return _count; }
+    const Task& task(int id)   const { return _tasks[id]; }
+    uint32_t    ageMs(int id, uint32_t nowMs) const { return nowMs - _tasks[id].lastMs; }
+
+private:
+    Task _tasks[kMaxTasks] = {};
+    int  _count = 0;
+    int  _worst = -1;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  TelemetryBatch.h  —  Samples batched per MQTT publish
+//
+//  Collects one row of column values per sample and writes the
+//  whole batch as one CBOR / MessagePack map:
+//
+//    { "v": 1, "t0": <uptime ms of row 0>, "utc": <UTC ms of row 0
+//      or null>, "f": [names…], "s": [scales…],
+//      "r": [[dt ms, round(value × scale)…], …], <caller's pairs> }
+//
+//  Names and scales go out once per batch, not once per value;
+//  each value is an integer at its column's resolution (1 RPM,
+//  0.1 °C …), null when NaN, so a row of six values is typically
+//  15–20 bytes against ~500 for the equivalent Signal K delta.
+//  The caller adds its own pairs (1-Wire, diagnostics) after
+//  encode() and counts them in extraPairs.  Fixed memory, no
+//  allocation.
+// ============================================================
+
+#include <cstdint>
+
+class CompactEncoder;
+
+class TelemetryBatch {
+public:
+    static constexpr int      kMaxRecords = 32;
+    static constexpr int      kMaxColumns = 8;
+    static constexpr uint32_t kVersion    = 1;
+    static constexpr uint32_t kBatchKeys  = 6;   // pairs encode() writes itself
+
+    struct Column {
+        const char* name;
+        float       scale;   // value × scale is sent, rounded
+    };
+
+    TelemetryBatch(const Column* cols, int nCols);
+
+    /// Append a row sampled at ms (nCols values); false when full.
+    bool add(uint32_t ms, const float* values);
+
+    /// Write the batch map: kBatchKeys + extraPairs entries, of which
+    /// the caller writes the last extraPairs.  utcMs < 0 = unknown.
+    void encode(CompactEncoder& e, int64_t utcMs, uint32_t extraPairs) const;
+
+    void clear() { _n = 0; }
+
+    int      count()   const { return _n; }
+    bool     full()    const { return _n >= kMaxRecords; }
+    uint32_t firstMs() const { return _firstMs; }
+    int      columns() const { return _nCols; }
+
+private:
+    const Column* _cols;
+    int           _nCols;
+    int           _n       = 0;
+    uint32_t      _firstMs = 0;
+    uint32_t      _dtMs[kMaxRecords];
+    float         _v[kMaxRecords][kMaxColumns];
+};
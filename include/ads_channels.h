@@ -0,0 +1,45 @@
+#pragma once
+
+// ============================================================
+//  ads_channels.h — ADS1115 analog channel map
+//
+//  One row per analog input: which ADS1115 (I²C address), which
+//  input, PGA gain, data rate and interval, how the raw code is
+//  converted (pipeline) and where the value goes (destination).
+//  analog_inputs hands the table to AdsScheduler, which converts
+//  on every listed device in parallel without blocking the event
+//  loop.  Up to AdsScheduler::kMaxDevices addresses (0x48–0x4B)
+//  and kMaxChannels rows.
+// ============================================================
+
+#include <cstdint>
+#include "halmet_config.h"
+
+enum class AdsPipeline : uint8_t {
+    VOLTS = 0,     // code × volts per count at the row's gain
+    CCS_OHMS,      // volts / TANK_MEASUREMENT_CURRENT; NAN outside 0…TANK_RESISTANCE_MAX_OHM
+};
+
+enum class AdsDest : uint8_t {
+    COOLANT = 0,   // VDO NTC sender → coolantK + alert (volts)
+    TANK_SENDER,   // resistive tank sender → strapping table (ohms)
+    GOBIUS_3Q,     // Gobius "below 3/4" output (volts)
+    GOBIUS_1Q,     // Gobius "below 1/4" output (volts)
+    SK_ONLY,       // value to skPath only
+};
+
+struct AdsChannelDef {
+    const char* name;          // diagnostics label
+    uint8_t     addr;          // I²C address of the ADS1115
+    uint8_t     mux;           // single-ended input 0–3
+    uint16_t    gain;          // adsGain_t
+    uint16_t    rate;          // RATE_ADS1115_*
+    uint32_t    intervalMs;
+    AdsPipeline pipeline;
+    AdsDest     dest;
+    const char* skPath;        // also publish the pipeline value here, or nullptr
+};
+
+/// Rows in kAdsChannels (src/ads_channels.cpp).
+extern const AdsChannelDef kAdsChannels[];
+extern const int           kNumAdsChannels;
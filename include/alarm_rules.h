@@ -0,0 +1,73 @@
+#pragma once
+
+// ============================================================
+//  alarm_rules.h — Alarm rule table + Signal K notifications
+//
+//  Every alarm is a row in kAlarmRules (src/alarm_rule_defs.cpp):
+//  an input (an EngineState field or a 1-Wire destination), a
+//  rule (AlarmRules.h: threshold with hysteresis, rate of rise or
+//  stale sensor) and the notification path it raises.  Each
+//  INTERVAL_ALARM_RULES_MS tick feeds the rules every sample taken
+//  since the previous tick; notifications are rate limited per
+//  rule (ALARM_NOTIFY_MIN_MS).
+//
+//  Row kCoolantAlertRule takes its thresholds from the
+//  /coolant/*_threshold_c config and drives
+//  EngineState::coolantAlertState (blackbox, telemetry).
+//
+//  Each rule's level, last value and counts:
+//    design.halmet.diagnostics.alarms   (JSON, INTERVAL_DIAG_MS)
+// ============================================================
+
+#include <cstdint>
+
+#include "AlarmRules.h"
+#include "onewire_setup.h"
+
+struct EngineState;
+class OneWireRegistry;
+
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
+enum class AlarmInput : uint8_t {
+    COOLANT_C = 0,    // coolantK in °C
+    TANK_PCT,         // tankLevelPct
+    FUEL_RATE_LPH,    // fuelRateLph
+    RPM,              // rpm
+    ONEWIRE_0 = 8,    // + kTempDests index, °C
+};
+
+constexpr uint8_t alarmInput(AlarmInput i)    { return static_cast<uint8_t>(i); }
+constexpr uint8_t oneWireAlarmInput(int dest) { return static_cast<uint8_t>(static_cast<int>(AlarmInput::ONEWIRE_0) + dest); }
+
+static_assert(static_cast<int>(AlarmInput::ONEWIRE_0) + kNumTempDests <= AlarmRules::kMaxInputs,
+              "1-Wire destinations do not fit the alarm inputs");
+
+struct AlarmRuleDef {
+    const char* name;      // diagnostics key
+    const char* label;     // notification message subject
+    const char* unit;
+    AlarmRule   rule;
+    const char* skPath;    // notifications.* path
+};
+
+/// Entries in kAlarmRules (src/alarm_rule_defs.cpp).
+constexpr int kNumAlarmRules = 8;
+constexpr int kCoolantAlertRule = 0;
+
+extern const AlarmRuleDef kAlarmRules[kNumAlarmRules];
+
+namespace alarm_rules {
+
+struct InitParams {
+    EngineState*                               state;
+    OneWireRegistry*                           owRegistry;      // may be nullptr
+    sensesp::PersistingObservableValue<float>* coolantWarnC;
+    sensesp::PersistingObservableValue<float>* coolantAlarmC;
+};
+
+void init(const InitParams& p);
+
+}  // namespace alarm_rules
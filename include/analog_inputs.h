@@ -2,13 +2,24 @@
 
 // ============================================================
 //  analog_inputs.h — Coolant temp, tank level, ADS1115 recovery
+//
+//  Every analog input is a row in kAdsChannels (ads_channels.h),
+//  converted by AdsScheduler without blocking the event loop; the
+//  devices, their bus cost per sample and each channel's state go
+//  to design.halmet.diagnostics.ads.
+//
+//  The resistive tank sender goes through the strapping table
+//  (TankStrapping, /tank/strapping) to litres, then TankEstimator:
+//  the filtered level feeds PGN 127505, tanks.fuel.0.currentLevel
+//  and .currentVolume; the burn feeds PGN 127489 FuelRate,
+//  propulsion.0.fuel.rate and design.halmet.engine.fuelEndurance
+//  (s, INTERVAL_DIAG_MS).  design.halmet.diagnostics.tank shows
+//  the sender against the table.
 // ============================================================
 
 struct EngineState;
-class Adafruit_ADS1115;
 
 namespace sensesp {
-class SKOutputRawJson;
 template <typename T> class PersistingObservableValue;
 }
 
@@ -16,10 +27,7 @@ namespace analog_inputs {
 
 struct InitParams {
     EngineState*                                    state;
-    Adafruit_ADS1115*                               ads;
-    sensesp::SKOutputRawJson*                       skCoolantNotification;
-    sensesp::PersistingObservableValue<float>*       coolantWarnC;
-    sensesp::PersistingObservableValue<float>*       coolantAlarmC;
+    sensesp::PersistingObservableValue<float>*       tankCapacityL;   // % → litres for the fuel rate
 };
 
 void init(const InitParams& p);
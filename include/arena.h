@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  arena.h — Static arena for setup-time objects + RAM report
+//
+//    arena::Scope scope("analogInputs");
+//    auto* sk = arena::make<SKOutputFloat>("tanks.fuel.0.currentLevel");
+//
+//  builds the object in a StaticArena of ARENA_BYTES instead of
+//  on the heap, charged to the module named by the innermost
+//  Scope.  Objects are never destroyed — only use it for what
+//  lives until reset.  A request that does not fit is logged and
+//  falls back to operator new, so an undersized arena costs heap,
+//  not a crash; the report counts it per module.
+//
+//  main.cpp calls seal() once stage 2 is up: the free heap at that
+//  point is the baseline, and anything built from the arena later
+//  counts as a late allocation.  seal() logs the per-module table
+//  and init() publishes it with the heap figures:
+//    design.halmet.diagnostics.ram   (JSON, INTERVAL_DIAG_MS)
+//  Static RAM (.data/.bss) per module comes from the link map —
+//  tools/ram_report.py.
+// ============================================================
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+class StaticArena;
+
+namespace arena {
+
+/// size bytes at align from the arena, or from the heap if full.
+void* allocate(size_t size, size_t align);
+
+template <typename T, typename... A>
+T* make(A&&... a) {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<A>(a)...);
+}
+
+/// Charges make() to `module` until the end of the scope.
+class Scope {
+public:
+    explicit Scope(const char* module);
+    ~Scope();
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* _prev;
+};
+
+/// Boot is done: log the table and take the heap baseline.
+void seal();
+
+/// Start the SK report.  make() works before it.
+void init();
+
+const StaticArena& get();
+
+}  // namespace arena
@@ -0,0 +1,89 @@
+#pragma once
+
+// ============================================================
+//  blackbox.h — Alarm-triggered pre/post-trigger event recorder
+//
+//  Samples RPM, raw ADS codes, coolant and alarm bits at the
+//  RPM tick rate into a RAM ring.  When an alarm asserts or the
+//  coolant alert escalates, the ring keeps running for the
+//  post-trigger window, then a low-priority task persists the
+//  whole event to LittleFS as /blackbox/evNNNNN.bin.
+//
+//  HTTP (SensESP web server):
+//    GET /api/blackbox/events              → JSON list of events
+//    GET /api/blackbox/event?name=<file>   → raw event file
+//
+//  File layout (little-endian, packed):
+//    BlackboxFileHeader
+//    BlackboxOneWireEntry × header.numOneWire
+//    BlackboxSample       × header.sampleCount
+// ============================================================
+
+#include <cstdint>
+
+struct EngineState;
+class OneWireRegistry;
+
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
+enum class BlackboxReason : uint8_t {
+    OIL_ALARM     = 1,
+    TEMP_ALARM    = 2,
+    COOLANT_WARN  = 3,
+    COOLANT_ALARM = 4,
+};
+
+struct __attribute__((packed)) BlackboxSample {
+    uint32_t ms;              // millis() at sample time
+    uint16_t rpmX4;           // smoothed RPM × 4
+    int16_t  adsRaw[4];       // raw ADS1115 codes, ch0–ch3
+    int16_t  coolantCx100;    // coolant °C × 100, INT16_MIN = not available
+    uint8_t  oilHistory;      // debounce shift registers
+    uint8_t  tempHistory;
+    uint8_t  flags;           // see kBlackboxFlag* below
+    uint8_t  reserved;
+};
+
+constexpr uint8_t kBlackboxFlagOilAlarm      = 0x01;
+constexpr uint8_t kBlackboxFlagTempAlarm     = 0x02;
+constexpr uint8_t kBlackboxFlagCoolantShift  = 2;     // bits 2–3: CoolantAlertState
+constexpr uint8_t kBlackboxFlagEngineRunning = 0x10;
+constexpr uint8_t kBlackboxFlagAdsOk         = 0x20;
+
+struct __attribute__((packed)) BlackboxOneWireEntry {
+    uint8_t dest;             // kTempDests index
+    uint8_t slot;             // PGN 130316 instance
+    int16_t tempCx100;        // INT16_MIN = no reading
+};
+
+struct __attribute__((packed)) BlackboxFileHeader {
+    uint32_t magic;           // kBlackboxMagic
+    uint16_t version;
+    uint16_t sampleBytes;     // sizeof(BlackboxSample)
+    uint32_t seq;
+    uint32_t triggerMs;
+    uint16_t sampleCount;
+    uint16_t triggerIndex;    // index of the sample that tripped the trigger
+    uint16_t periodMs;
+    uint8_t  reason;          // BlackboxReason
+    uint8_t  numOneWire;
+};
+
+constexpr uint32_t kBlackboxMagic   = 0x31424248;   // "HBB1"
+constexpr uint16_t kBlackboxVersion = 1;
+
+namespace blackbox {
+
+struct InitParams {
+    const EngineState*                           state;
+    const OneWireRegistry*                       owRegistry;   // first BLACKBOX_MAX_ONEWIRE bound
+    sensesp::PersistingObservableValue<float>*   postTriggerS;
+};
+
+/// Call after the SensESP app is built: init() also registers
+/// the HTTP handlers on the SensESP web server.
+void init(const InitParams& p);
+
+}  // namespace blackbox
@@ -0,0 +1,39 @@
+#pragma once
+
+// ============================================================
+//  boot_profile.h — Boot phase timestamps
+//
+//  setup() is staged so engine-critical PGNs go out as soon as
+//  CAN is open; slower subsystems come up from the event loop
+//  afterwards.  Each stage records millis() once via mark(); the
+//  table is logged and published to Signal K so time-to-first-
+//  127488 can be tracked across firmware releases.
+// ============================================================
+
+#include <cstdint>
+
+enum class BootPhase : uint8_t {
+    SETUP_ENTRY = 0,    // setup() entered (ROM bootloader + core init before this)
+    CAN_OPEN,           // NMEA 2000 driver open, address claim started
+    APP_BUILT,          // SensESP app built, filesystem mounted
+    ENGINE_ARMED,       // RPM / alarm / coolant publishers registered
+    FIRST_127488,       // first Engine Rapid Update accepted by the CAN driver
+    ONEWIRE_BOUND,      // 1-Wire probes bound (ROM cache or full scan)
+    SUBSYSTEMS_UP,      // diagnostics, black box, telemetry running
+    ONEWIRE_VALIDATED,  // background 1-Wire rescan finished
+    COUNT
+};
+
+namespace boot_profile {
+
+/// Record the first time a phase is reached (later calls are ignored).
+void mark(BootPhase phase);
+
+/// millis() at which the phase was reached, or 0 if not yet.
+uint32_t at(BootPhase phase);
+
+/// Start the SK publisher (design.halmet.diagnostics.bootPhases).
+/// Needs the SensESP app; mark() works from the first line of setup().
+void init();
+
+}  // namespace boot_profile
@@ -1,13 +1,25 @@
 #pragma once
 
 // ============================================================
-//  digital_alarms.h — Oil/temp alarm input debounce
+//  digital_alarms.h — Oil/temp alarm inputs (edge-captured,
+//  time-integrated debounce; see AlarmIntegrator.h)
 // ============================================================
 
 struct EngineState;
 
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
 namespace digital_alarms {
 
-void init(EngineState* state);
+struct InitParams {
+    EngineState*                                state;
+    sensesp::PersistingObservableValue<float>*   assertMs;    // net active time to assert
+    sensesp::PersistingObservableValue<float>*   releaseMs;   // net inactive time to release
+    void                                       (*onChange)(); // alarm state changed (event loop)
+};
+
+void init(const InitParams& p);
 
 }  // namespace digital_alarms
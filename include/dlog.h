@@ -0,0 +1,52 @@
+#pragma once
+
+// ============================================================
+//  dlog.h — Deferred logging for runtime paths
+//
+//    dlog::log(LogFmt::RELAY_CHANGE, on);
+//
+//  stores a 24-byte LogRecord (format ID, millis(), raw args) in
+//  a lock-free LogRing and returns — safe from any task, either
+//  core and ISRs, and never blocks on the UART.  A task at idle + 1
+//  priority on core 0 drains the ring every DLOG_DRAIN_MS and
+//  prints each record through ESP_LOGx as
+//      I (<drain ms>) BilgeFan: [<record ms>] Relay -> ON
+//  With -D DLOG_BINARY_UART it instead writes the raw records as
+//  framed binary to Serial; tools/log_decode.py formats them on the
+//  PC and passes the surrounding ESP_LOG text through.
+//
+//  Records that find the ring full are dropped and counted; the
+//  drain task reports new drops, and
+//    design.halmet.diagnostics.log  (JSON, INTERVAL_DIAG_MS)
+//  carries the counters.  Boot-time messages stay on ESP_LOGx.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LogRing.h"
+#include "log_formats.h"
+
+namespace dlog {
+
+/// Start the drain task and the diagnostics output.  log() works
+/// before it; records wait in the ring.
+void init();
+
+/// Queue one record; false when the ring was full.
+bool write(LogFmt f, const uint32_t* args, int nargs);
+
+template <typename... A>
+__attribute__((always_inline)) inline bool log(LogFmt f, A... a) {
+    static_assert(sizeof...(A) <= kLogMaxArgs, "too many log arguments");
+    const uint32_t args[] = { toLogArg(a)..., 0u };
+    return write(f, args, static_cast<int>(sizeof...(A)));
+}
+
+/// Format and emit up to `max` queued records; returns how many.
+/// The drain task's body — native tests call it directly.
+size_t drain(size_t max);
+
+const LogRing& ring();
+
+}  // namespace dlog
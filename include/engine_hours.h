@@ -0,0 +1,57 @@
+#pragma once
+
+// ============================================================
+//  engine_hours.h — Engine hours & RPM load profile
+//
+//  While EngineState::engineRunning is set, running time and
+//  time per RPM band (ENGINE_RPM_BAND_WIDTH wide, last band open-
+//  ended) accumulate once per second from the smoothed RPM.  The
+//  counters are journaled to the "journal" flash partition every
+//  ENGINE_HOURS_SAVE_S while running and on every engine stop.
+//
+//  Outputs:
+//    EngineState::engineSeconds       → PGN 127489 EngineHours
+//    propulsion.0.runTime             (s)
+//    design.halmet.engine.loadProfile (bands, starts, journal stats)
+//
+//  Journal record payload (little-endian, naturally aligned, no
+//  padding): EngineHoursRecord
+// ============================================================
+
+#include <cstdint>
+
+#include "halmet_config.h"
+
+struct EngineState;
+
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
+struct EngineHoursRecord {
+    uint8_t  version;                         // kEngineHoursVersion
+    uint8_t  numBands;                        // ENGINE_RPM_BANDS
+    uint16_t bandWidthRpm;                    // ENGINE_RPM_BAND_WIDTH
+    uint32_t runS;                            // total running time
+    uint32_t starts;                          // stopped → running transitions
+    uint32_t bandS[ENGINE_RPM_BANDS];         // running time per RPM band
+};
+
+static_assert(sizeof(EngineHoursRecord) == 12 + 4 * ENGINE_RPM_BANDS,
+              "EngineHoursRecord must have no padding (journal layout)");
+
+constexpr uint8_t kEngineHoursVersion = 1;
+
+namespace engine_hours {
+
+struct InitParams {
+    EngineState*                                 state;
+    sensesp::PersistingObservableValue<float>*   hoursPreset;   // hour-meter reading (h)
+};
+
+/// Recover the counters from the journal and start accumulating.
+/// Without the journal partition the counters still run but are
+/// lost at reset; engineSeconds stays N2kDoubleNA.
+void init(const InitParams& p);
+
+}  // namespace engine_hours
@@ -6,35 +6,116 @@
 //  A single flat struct replacing scattered file-scope globals.
 //  One static instance lives in main.cpp and is passed by
 //  pointer to each module's init() function.
+//
+//  Measured fields are Sampled<T>: write them through set(),
+//  check staleness with fresh()/freshOr(), and let each publisher
+//  keep a cursor for takeChanges(cursor) to send only what changed.
 // ============================================================
 
 #include <cstdint>
 
+#include "halmet_config.h"
+
 enum class CoolantAlertState : uint8_t {
     NORMAL = 0,
     WARN   = 1,
     ALARM  = 2,
 };
 
+enum class EngineField : uint8_t {
+    COOLANT = 0,      // coolantK
+    COOLANT_ALERT,    // coolantAlertState
+    TANK_LEVEL,       // tankLevelPct
+    OIL_ALARM,        // oilAlarm
+    TEMP_ALARM,       // tempAlarm
+    RPM,              // rpm
+    RUNNING,          // engineRunning
+    ENGINE_HOURS,     // engineSeconds
+    FUEL_RATE,        // fuelRateLph
+    COUNT
+};
+
+constexpr uint32_t fieldBit(EngineField f) { return 1u << static_cast<uint8_t>(f); }
+
+template <typename T>
+struct Sampled {
+    EngineField field;
+    T           value;
+    uint32_t    sampleMs = 0;   // acquisition millis() of the last set(), changed or not; 0 = never
+};
+
 struct EngineState {
     // Written by analog_inputs
-    double            coolantK            = -1e9;   // N2kDoubleNA sentinel
-    uint32_t          coolantLastUpdateMs = 0;
-    float             tankLevelPct        = 0.0f;   // updated by tank sensor within first tick
-    CoolantAlertState coolantAlertState   = CoolantAlertState::NORMAL;
+    Sampled<double>            coolantK          = { EngineField::COOLANT, -1e9 };   // N2kDoubleNA sentinel
+    Sampled<CoolantAlertState> coolantAlertState = { EngineField::COOLANT_ALERT, CoolantAlertState::NORMAL };
+    Sampled<float>             tankLevelPct      = { EngineField::TANK_LEVEL, 0.0f };     // filtered (TankEstimator)
+    Sampled<double>            fuelRateLph       = { EngineField::FUEL_RATE, -1e9 };      // N2kDoubleNA while settling
+    int16_t                    adsRaw[4]         = {};     // last raw code per input of the 0x4B ADS1115
+    float                      adsVolts[4]       = {};     // the same, in volts at the channel's gain
 
-    // Written by digital_alarms
-    bool     oilAlarm        = false;
-    bool     tempAlarm       = false;
-    uint8_t  oilAlarmHistory  = 0;
-    uint8_t  tempAlarmHistory = 0;
+    // Written by digital_alarms (sampled every integrator tick)
+    Sampled<bool> oilAlarm         = { EngineField::OIL_ALARM, false };
+    Sampled<bool> tempAlarm        = { EngineField::TEMP_ALARM, false };
+    uint8_t       oilAlarmHistory  = 0;
+    uint8_t       tempAlarmHistory = 0;
 
     // Written by engine_state_machine
-    bool     engineRunning    = false;
-    bool     engineRunningRaw = false;
-    uint32_t engineStateMs    = 0;
+    Sampled<float> rpm              = { EngineField::RPM, 0.0f };       // latest smoothed RPM (10 Hz)
+    Sampled<bool>  engineRunning    = { EngineField::RUNNING, false };
+    bool           engineRunningRaw = false;
+    uint32_t       engineStateMs    = 0;
+
+    // Written by engine_hours
+    Sampled<double> engineSeconds = { EngineField::ENGINE_HOURS, -1e9 };   // N2kDoubleNA until the journal is recovered
+
+    // Written by analog_inputs (ADS scheduler)
+    bool     adsOk        = false;   // every ADS1115 in kAdsChannels answering
+    uint32_t adsFailCount = 0;       // failed probes, all devices
+
+    // ---- Versioning ----
+    uint32_t seq = 0;                                                    // bumped by every change
+    uint32_t changeSeq[static_cast<uint8_t>(EngineField::COUNT)] = {};  // seq of each field's last change
+
+    /// Record a sample of field f acquired at nowMs — the physical
+    /// acquisition time, not when the callback ran.  Returns true
+    /// when the value changed (and only then bumps seq).
+    template <typename T, typename V>
+    bool set(Sampled<T>& f, V v, uint32_t nowMs) {
+        T    nv      = static_cast<T>(v);
+        bool changed = !(f.value == nv);
+        f.value    = nv;
+        f.sampleMs = nowMs;
+        if (changed) changeSeq[static_cast<uint8_t>(f.field)] = ++seq;
+        return changed;
+    }
+
+    /// Sampled within the last STALE_DATA_TIMEOUT_MS.
+    template <typename T>
+    bool fresh(const Sampled<T>& f, uint32_t nowMs) const {
+        return f.sampleMs != 0 && (nowMs - f.sampleMs) <= STALE_DATA_TIMEOUT_MS;
+    }
+
+    /// The value while fresh, otherwise `stale`.
+    template <typename T>
+    T freshOr(const Sampled<T>& f, T stale, uint32_t nowMs) const {
+        return fresh(f, nowMs) ? f.value : stale;
+    }
+
+    /// Fields changed after sequence number sinceSeq (fieldBit mask).
+    /// Once every 2^32 changes, when seq passes zero, a field that
+    /// never changed is reported too — an extra send, nothing lost.
+    uint32_t changedSince(uint32_t sinceSeq) const {
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < static_cast<uint8_t>(EngineField::COUNT); i++) {
+            if (changeSeq[i] - sinceSeq - 1 < seq - sinceSeq) mask |= 1u << i;   // sinceSeq < changeSeq ≤ seq, wrap-safe
+        }
+        return mask;
+    }
 
-    // Written by analog_inputs (ADS recovery)
-    bool     adsOk        = false;
-    uint32_t adsFailCount = 0;
+    /// Fields changed since the caller's cursor; moves the cursor to now.
+    uint32_t takeChanges(uint32_t& cursor) const {
+        uint32_t mask = changedSince(cursor);
+        cursor        = seq;
+        return mask;
+    }
 };
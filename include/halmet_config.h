@@ -45,12 +45,13 @@
 //  Tank sensor — resistive mode (DEFAULT)
 //
 //  Uses HALMET constant-current source (10 mA) on A2 / ADS ch1.
-//  Resistance = V_adc / I.  Level ratio derived from a runtime-
-//  configurable CurveInterpolator (web UI calibration table).
+//  Resistance = V_adc / I.  Volume from the tank's strapping table
+//  (web UI, /tank/strapping: Ω → fuel height → litres, compiled to
+//  a constant-time lookup on save); level % = volume / capacity.
 //
-//  Default curve: European VDO fuel sender
-//    10 Ω → 0.0 (empty)
-//   180 Ω → 1.0 (full)
+//  Default table: European VDO fuel sender, linear
+//    10 Ω → 0 L (empty)
+//   180 Ω → /tank/capacity_l (full)
 //
 //  To switch to Gobius Pro sensors instead, define TANK_SENSOR_GOBIUS
 //  in platformio.ini build_flags.
@@ -60,8 +61,20 @@
 #define TANK_RESISTANCE_MAX_OHM     320.0f      // hardware limit; above = fault
 #define TANK_RESISTANCE_EMPTY_OHM   10.0f       // VDO: empty
 #define TANK_RESISTANCE_FULL_OHM    180.0f      // VDO: full
+#define DEFAULT_TANK_HEIGHT_MM      300.0f      // default table only (diagnostics)
 #define INTERVAL_TANK_MS            500         // resistive sender read interval
 
+// Level / fuel-rate estimator (TankEstimator, resistive sender only)
+#define TANK_MEDIAN_WINDOW          9           // readings (4.5 s)
+#define TANK_LEVEL_SIGMA_PCT        1.5f        // sender noise left after the median
+#define TANK_LEVEL_WALK_PCT         0.2f        // %/√h not explained by the burn
+#define TANK_RATE_WALK_PCT_H        0.5f        // (%/h)/√h — how fast the burn may change
+#define TANK_RATE_INIT_SIGMA_PCT_H  5.0f        // burn uncertainty at each start
+#define TANK_RATE_SETTLE_S          1800.0f     // running time before the rate is sent
+#define TANK_JUMP_SIGMA             4.0f        // innovation σ for a level jump …
+#define TANK_JUMP_SAMPLES           20          // … this many in a row (10 s) = refuelled
+#define TANK_ENDURANCE_MIN_LPH      0.2f        // below: endurance not reported
+
 // ----------------------------------------------------------
 //  Tank sensor — Gobius Pro mode (optional, define TANK_SENSOR_GOBIUS)
 //
@@ -119,15 +132,30 @@
 #define ADS1115_I2C_ADDRESS     0x4B
 
 // ----------------------------------------------------------
-//  Alarm debouncing (shift-register majority vote)
+//  Alarm debouncing (edge-captured time integrator, D2/D3)
+//
+//  Assert after ALARM_ASSERT_MS of accumulated active time, release
+//  after ALARM_RELEASE_MS of accumulated inactive time (both runtime-
+//  configurable).  Time back at the output's level drains the
+//  accumulator ALARM_DRAIN_RATIO× faster.  The assert time must
+//  outlast overlapping ignition spikes (≈ 20 ms each); 60 ms beats
+//  the old 4-of-5 vote on noise in the simulator.
+//  The legacy 4-of-5 shift register is kept only as the raw-input
+//  history in EngineState and as the baseline in
+//  tools/alarm_debounce_sim.cpp.
 // ----------------------------------------------------------
-#define ALARM_DEBOUNCE_SAMPLES      5
-#define ALARM_DEBOUNCE_THRESHOLD    4       // 4-of-5 = alarm asserted
+#define DEFAULT_ALARM_ASSERT_MS     60
+#define DEFAULT_ALARM_RELEASE_MS    500
+#define ALARM_DRAIN_RATIO           4
+#define ALARM_INTEGRATOR_TICK_MS    5       // edge replay / integrator tick
+#define ALARM_DEBOUNCE_SAMPLES      5       // raw history bits (and legacy scheme)
+#define ALARM_DEBOUNCE_THRESHOLD    4       // legacy 4-of-5 vote (simulator baseline)
 
 // ----------------------------------------------------------
 //  I2C / ADS1115 recovery
 // ----------------------------------------------------------
 #define INTERVAL_ADS_RETRY_MS       5000
+#define ADS_POLL_MS                 5       // scheduler tick: finish / start conversions
 
 // ----------------------------------------------------------
 //  Coolant sensor fault detection
@@ -136,29 +164,191 @@
 #define COOLANT_VOLT_MAX_V          3.50f   // above = open/shorted sender
 
 // ----------------------------------------------------------
-//  Coolant temperature threshold alerting
+//  Alarm rules (kAlarmRules) and Signal K notifications
 // ----------------------------------------------------------
 #define DEFAULT_COOLANT_WARN_C      95.0f   // Signal K "warn" notification
 #define DEFAULT_COOLANT_ALARM_C     105.0f  // Signal K "alarm" notification
+#define ALARM_COOLANT_RISE_ARM_C    88.0f   // rate of rise watched above the thermostat
+#define ALARM_NOTIFY_MIN_MS         30000   // per rule: a step down waits this long after the last notification
+#define INTERVAL_ALARM_RULES_MS     100     // new samples → rules, stale check
 
 // ----------------------------------------------------------
-//  Stale data guard
+//  Stale data guard — any EngineState field without a sample for
+//  this long is sent as N/A (EngineState::freshOr)
 // ----------------------------------------------------------
 #define STALE_DATA_TIMEOUT_MS       5000
 
 // ----------------------------------------------------------
-//  1-Wire → N2K/SK temperature source assignment
+//  Sample timestamps, PGN SIDs and bus time (latency module)
+// ----------------------------------------------------------
+#define N2K_SID_PERIOD_MS           250     // readings acquired in one slot share a PGN SID
+#define BUS_TIME_VALID_MS           10000   // no PGN 126992 for this long → bus time not synced
+#define BUS_TIME_STEP_MS            2000    // larger disagreement steps the clock, smaller slews it
+
+// ----------------------------------------------------------
+//  1-Wire buses → N2K/SK temperature source assignment
+//
+//  Every probe found on any bus lands in the ROM-keyed registry;
+//  there is no fixed slot count.  Extra buses are added by
+//  overriding the pin list from platformio.ini, e.g.
+//    -D 'ONEWIRE_BUS_PINS={HALMET_PIN_1WIRE,13}'
+//  Assigned probes get consecutive PGN 130316 instances.
+// ----------------------------------------------------------
+#ifndef ONEWIRE_BUS_PINS
+#define ONEWIRE_BUS_PINS            { HALMET_PIN_1WIRE }
+#endif
+#define ONEWIRE_MAX_INSTANCES       253     // 8-bit instance; 254/255 reserved
+
+// Boot binds probes from a ROM list cached in NVS, then validates it
+// with a background search (one ROM per step) once the system is up.
+#define ONEWIRE_CACHE_NVS_NS        "onewire"
+#define ONEWIRE_RESCAN_DELAY_MS     5000    // after boot, before the first search
+#define ONEWIRE_RESCAN_STEP_MS      20      // between single-ROM search steps
+
+// Per-probe error handling (DsThermBatch)
+#define ONEWIRE_READ_RETRIES        2       // extra scratchpad reads after a CRC failure
+#define ONEWIRE_BACKOFF_AFTER       3       // failed sweeps in a row before backing off
+#define ONEWIRE_BACKOFF_MAX_SWEEPS  32      // skip cap: 1, 2, 4 … 32 sweeps
+#define ONEWIRE_POR_PLAUSIBLE_C     5.0f    // 85 °C accepted only within this of the last read
+#define ONEWIRE_STALE_INTERVALS     3       // no valid read for this many read intervals → PGN 130316 stops
+#define INTERVAL_ONEWIRE_N2K_MS     1000    // publisher tick; each slot is sent at
+                                            // its destination's read interval
+
+// ----------------------------------------------------------
+//  Black-box recorder (alarm-triggered capture to LittleFS)
+//
+//  A RAM ring holds the last BLACKBOX_PRE_TRIGGER_S seconds of
+//  10 Hz samples.  An oil/temp alarm or coolant alert escalation
+//  freezes the ring after the configurable post-trigger window
+//  and a background task writes the event to /blackbox/.
+// ----------------------------------------------------------
+#define BLACKBOX_PRE_TRIGGER_S      30
+#define BLACKBOX_MAX_POST_TRIGGER_S 30      // upper bound for the web UI value
+#define DEFAULT_BLACKBOX_POST_S     10.0f
+#define BLACKBOX_MAX_EVENTS         8       // oldest event file deleted beyond this
+#define BLACKBOX_MAX_ONEWIRE        8       // 1-Wire snapshot entries per event
+
+// ----------------------------------------------------------
+//  Engine hours & RPM load profile (flash journal)
+//
+//  Journaled to its own data partition (partitions_halmet_8MB.csv):
+//  16 × 4 KB sectors of 64-byte records = 1024 records, so at one
+//  record per ENGINE_HOURS_SAVE_S each sector is erased about once
+//  per 17 h of running.  tools/journal_wear_sim.cpp checks the
+//  budget over years of use.
+// ----------------------------------------------------------
+#define ENGINE_HOURS_PARTITION_LABEL    "journal"
+#define ENGINE_HOURS_PARTITION_SUBTYPE  0x40    // first custom data subtype
+#define ENGINE_HOURS_SAVE_S             60      // journal period while running
+#define DEFAULT_ENGINE_HOURS_PRESET_H   -1.0f   // < 0 = no preset pending (one-shot)
+#define ENGINE_RPM_BAND_WIDTH           500     // load-profile band width (RPM)
+#define ENGINE_RPM_BANDS                8       // last band open-ended (≥ 3500)
+
+// ----------------------------------------------------------
+//  Commissioning telemetry stream (opt-in, web UI toggle)
+//
+//  Binary frames at the RPM tick rate on a plain TCP port.
+//  Decode on the host with tools/telemetry_decode.py.
+// ----------------------------------------------------------
+#define TELEMETRY_STREAM_PORT       8765
+#define TELEMETRY_ACCEPT_POLL_MS    500     // listener poll while no client
+
+// ----------------------------------------------------------
+//  MQTT telemetry export (opt-in: set the broker URI in the web UI)
+//
+//  EngineState is sampled every MQTT_SAMPLE_MS and the rows are
+//  published as one CBOR (or MessagePack) batch every
+//  MQTT_PUBLISH_MS, with the 1-Wire temperatures and diagnostics.
+//  Batches wait in a queue of MQTT_QUEUE_SLOTS while the broker is
+//  away (oldest dropped first); none are handed to the MQTT client
+//  while its outbox holds more than MQTT_OUTBOX_MAX_BYTES.
+//  Decode with tools/mqtt_decode.py.
+// ----------------------------------------------------------
+#define DEFAULT_MQTT_BROKER_URI     ""      // e.g. "mqtt://192.168.1.10"; empty = off
+#define DEFAULT_MQTT_QOS            1       // 0, 1 or 2
+#define MQTT_TOPIC                  "halmet/engine/telemetry"
+#define MQTT_CLIENT_ID              "halmet-engine"
+#define MQTT_SAMPLE_MS              1000
+#define MQTT_PUBLISH_MS             10000
+#define MQTT_PUMP_MS                200     // queue → client hand-off
+#define MQTT_QUEUE_SLOTS            6
+#define MQTT_PAYLOAD_MAX            1024    // bytes per batch
+#define MQTT_OUTBOX_MAX_BYTES       4096
+
+// ----------------------------------------------------------
+//  Per-revolution speed analysis (rev_analysis)
+//
+//  The RPM ISR timestamps every W-terminal edge.  A low-priority
+//  task cuts the edge intervals into blocks of
+//  RevAnalyzer::kBlock, FFTs the speed variation within each and
+//  reports crank-order harmonics and a roughness index.  Its CPU
+//  time is capped at REV_CPU_BUDGET_PCT of core 0; a block that
+//  completes while the budget is spent is dropped.
+// ----------------------------------------------------------
+#define REV_EDGE_RING               512     // ISR timestamps (power of two) — 1 s at 3000 RPM × 10 ppr
+#define REV_POLL_MS                 100     // analysis task wake-up
+#define REV_CPU_BUDGET_PCT          2       // long-run share of core 0
+#define REV_CPU_BURST_MS            20      // budget that may be saved up for one block
+#define REV_MIN_RPM                 400.0f  // slower blocks are not analysed
+#define INTERVAL_REV_SK_MS          5000    // harmonics + roughness to Signal K
+
+// ----------------------------------------------------------
+//  Deferred logging (dlog)
+//
+//  Runtime log calls queue binary records in a LogRing; a task at
+//  idle + 1 priority formats them onto the UART.  Define
+//  DLOG_BINARY_UART in build_flags to send the records as binary
+//  frames instead and format them with tools/log_decode.py.
+// ----------------------------------------------------------
+#define DLOG_DRAIN_MS               50      // drain task wake-up
+
+// ----------------------------------------------------------
+//  Static arena (setup-time objects)
+//
+//  SK outputs, persisted config values and other objects built
+//  once at boot are placed in one static buffer instead of the
+//  heap (arena::make).  The arena is sealed when stage 2 is done;
+//  design.halmet.diagnostics.ram reports its use per module and
+//  the heap since then.  Raise ARENA_BYTES if the report shows
+//  failed allocations (those fall back to the heap).
+// ----------------------------------------------------------
+#define ARENA_BYTES                 (24 * 1024)
+
+// ----------------------------------------------------------
+//  OTA
+//
+//  ota_stream accepts images packed by tools/ota_pack.py on
+//  POST /api/ota; ArduinoOTA (espota) remains as the fallback.
+//  Both use the same password.
+// ----------------------------------------------------------
+#define OTA_PASSWORD                "SomeOTAPassword"
+#define OTA_SWAP_DELAY_MS           1500    // relay off → restart (HTTP reply, 127501 out)
+#define OTA_RECV_TIMEOUTS_MAX       4       // consecutive httpd receive timeouts (5 s each) → abort
+
+// ----------------------------------------------------------
+//  Task supervisor & watchdog
+//
+//  The task watchdog is fed only while every critical task has
+//  checked in within its deadline.  Worst-case detection and
+//  reset time = deadline + SUPERVISOR_TICK_MS + watchdog timeout.
 // ----------------------------------------------------------
-#define NUM_ONEWIRE_SLOTS           6
-#define INTERVAL_ONEWIRE_N2K_MS     10000   // match 1-Wire read interval
+#define SUPERVISOR_WDT_TIMEOUT_S    8
+#define SUPERVISOR_TICK_MS          500
+#define DEADLINE_RPM_TICK_MS        1000    // 10 × INTERVAL_RPM_MS
+#define DEADLINE_ADS_MS             2000    // ADS scheduler tick (every ADS_POLL_MS)
+#define DEADLINE_N2K_PUMP_MS        1000    // ParseMessages runs every 1 ms
+#define DEADLINE_SLOW_PGNS_MS       3000    // 3 × the 1 s publisher
+#define DEADLINE_ONEWIRE_MS         90000   // 3 × the slowest kTempDests interval (reported only)
 
 // ----------------------------------------------------------
 //  Polling intervals (ms)
 // ----------------------------------------------------------
 #define INTERVAL_ANALOG_MS              200     // A1 coolant temp read
-#define INTERVAL_DIGITAL_ALARM_MS       500     // D2/D3 alarm inputs
-#define INTERVAL_1WIRE_MS               10000   // DS18B20 chain (slow)
+#define INTERVAL_DIGITAL_ALARM_MS       500     // D2/D3 raw history sample
+#define INTERVAL_1WIRE_MS               10000   // DS18B20 default read interval
+                                                // (per-destination in kTempDests)
 #define INTERVAL_RPM_MS                 100     // RPM counter update
 #define INTERVAL_FAN_MS                 1000    // Fan state machine tick
+#define INTERVAL_ENGINE_HOURS_MS        1000    // Engine hours / load profile tick
 #define INTERVAL_DIAG_MS                10000   // Diagnostics heartbeat
 #define INTERVAL_ONEWIRE_DIAG_MS        10000   // 1-Wire sensor list to SK
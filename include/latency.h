@@ -0,0 +1,53 @@
+#pragma once
+
+// ============================================================
+//  latency.h — Sample age at transmit + bus time (PGN 126992)
+//
+//  Every EngineState field and 1-Wire registry entry is stamped
+//  with the millis() its value was acquired — the middle of the
+//  ADS1115 conversion, of the RPM averaging window, of the DS18B20
+//  conversion — not when the callback ran.  The PGN senders call
+//  record() with that stamp as each value goes out, and the age
+//  lands in one LatencyHistogram per signal:
+//    design.halmet.diagnostics.latency   (JSON, INTERVAL_DIAG_MS)
+//
+//  When something on the bus sends System Time (PGN 126992),
+//  n2k_publisher hands it to onSystemTime() and utcMs() converts
+//  any millis() stamp to UTC (BusTime); the diagnostics then carry
+//  the UTC of each signal's last acquisition.  Without it every
+//  time stays uptime — nothing else depends on it.
+// ============================================================
+
+#include <cstdint>
+
+class LatencyHistogram;
+
+enum class LatencySignal : uint8_t {
+    RPM = 0,       // PGN 127488
+    COOLANT,       // PGN 127489
+    FUEL_RATE,     // PGN 127489
+    TANK_LEVEL,    // PGN 127505
+    ONEWIRE,       // PGN 130316, every destination
+    COUNT
+};
+
+namespace latency {
+
+/// Start the diagnostics output.  record() and onSystemTime() work
+/// before it.
+void init();
+
+/// A value acquired at acquiredMs went out on the bus at nowMs.
+void record(LatencySignal s, uint32_t acquiredMs, uint32_t nowMs);
+
+/// PGN 126992 from bus address `source`, received at rxMs.
+void onSystemTime(uint16_t days, double seconds, uint8_t source, uint32_t rxMs);
+
+/// UTC of a millis() stamp in ms since 1970; -1 until the bus has
+/// sent System Time.
+int64_t utcMs(uint32_t localMs);
+
+/// Ages recorded for one signal since boot.
+const LatencyHistogram& histogram(LatencySignal s);
+
+}  // namespace latency
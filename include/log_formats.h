@@ -0,0 +1,47 @@
+#pragma once
+
+// ============================================================
+//  log_formats.h — Format table for deferred log records (dlog)
+//
+//  A record carries only the LogFmt ID and its raw arguments;
+//  the text lives here, looked up when the drain task formats it
+//  on the device — or by tools/log_decode.py, which reads this
+//  enum and src/log_formats.cpp to format binary frames on a PC.
+//  So: append new IDs at the end, never renumber, keep the table
+//  in enum order (the tests check).
+//
+//  Arguments are 32-bit values (at most kLogMaxArgs); no strings.
+//  Conversions: %d %i %u %x %X %c %f %e %g, %B = ON / OFF.
+// ============================================================
+
+#include <cstdint>
+
+enum class LogFmt : uint16_t {
+    RELAY_CHANGE = 0,
+    FAN_SK_PUT,
+    SWITCH_BANK_CONTROL,
+    N2K_ADDRESS_CLAIMED,
+    ADS_FOUND,
+    ADS_NOT_ANSWERING,
+    ALARM_INPUTS,
+    ALARM_EDGE_OVERFLOW,
+    JOURNAL_APPEND_FAILED,
+    BLACKBOX_TRIGGER,
+    BUS_TIME_SOURCE,
+    MQTT_CONNECTED,
+    MQTT_DISCONNECTED,
+    BLACKBOX_TRIGGER_OIL,            // BLACKBOX_TRIGGER is kept for unknown reasons
+    BLACKBOX_TRIGGER_TEMP,
+    BLACKBOX_TRIGGER_COOLANT_WARN,
+    BLACKBOX_TRIGGER_COOLANT_ALARM,
+    COUNT
+};
+
+struct LogFormat {
+    LogFmt      id;
+    char        level;   // 'E', 'W', 'I' — as ESP_LOGx
+    const char* tag;
+    const char* fmt;
+};
+
+extern const LogFormat kLogFormats[static_cast<int>(LogFmt::COUNT)];
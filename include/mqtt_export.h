@@ -0,0 +1,54 @@
+#pragma once
+
+// ============================================================
+//  mqtt_export.h — Compact telemetry batches to an MQTT broker
+//
+//  Opt-in: nothing runs until a broker URI is saved in the web
+//  UI.  Every MQTT_SAMPLE_MS one row of EngineState (RPM, coolant,
+//  tank, fuel rate, engine hours, alarm/state flags) goes into a
+//  TelemetryBatch; every MQTT_PUBLISH_MS the batch is encoded as
+//  CBOR — or MessagePack — together with the bound 1-Wire probes
+//  (instance, °C) and a few diagnostics, and queued for
+//  MQTT_TOPIC.  See TelemetryBatch.h for the layout.
+//
+//  The queue (PayloadQueue, MQTT_QUEUE_SLOTS) is fixed: while
+//  the broker is away the oldest batches are dropped.  Batches
+//  are handed to the esp-mqtt client with esp_mqtt_client_enqueue()
+//  — the client's own task does the network I/O, so the event
+//  loop never waits on the broker — and only while its outbox of
+//  unacknowledged messages is under MQTT_OUTBOX_MAX_BYTES.
+//    design.halmet.diagnostics.mqtt   (JSON, INTERVAL_DIAG_MS)
+//
+//  Host side:
+//    mosquitto_sub -h <broker> -t 'halmet/#' -F '%t %x' | python3 tools/mqtt_decode.py -
+// ============================================================
+
+#include <cstdint>
+
+class String;
+struct EngineState;
+class OneWireRegistry;
+class PayloadQueue;
+
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
+namespace mqtt_export {
+
+struct InitParams {
+    const EngineState*                          state;
+    const OneWireRegistry*                      owRegistry;
+    sensesp::PersistingObservableValue<String>* brokerUri;   // empty = off
+    sensesp::PersistingObservableValue<int>*    qos;
+    sensesp::PersistingObservableValue<bool>*   msgpack;     // false = CBOR
+};
+
+void init(const InitParams& p);
+
+/// Batches waiting for the broker.
+const PayloadQueue& queue();
+
+bool connected();
+
+}  // namespace mqtt_export
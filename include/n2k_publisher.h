@@ -8,26 +8,27 @@ class tNMEA2000;
 class BilgeFan;
 struct EngineState;
 struct TempDestination;
+class OneWireRegistry;
 
 namespace sensesp {
+template <typename T> class ObservableValue;
 template <typename T> class PersistingObservableValue;
 }
 
-namespace sensesp::onewire {
-class OneWireTemperature;
-}
-
 namespace n2k_publisher {
 
 struct InitParams {
     EngineState*                                state;
     tNMEA2000*                                  nmea2000;
     sensesp::PersistingObservableValue<float>*   tankCapacityL;
-    int*                                         owDest;       // array[NUM_ONEWIRE_SLOTS]
-    sensesp::onewire::OneWireTemperature**       owSensors;    // array[NUM_ONEWIRE_SLOTS]
+    OneWireRegistry*                             owRegistry;   // bound entries → PGN 130316
     BilgeFan*                                    bilgeFan;
 };
 
 void init(const InitParams& p);
 
+/// Send PGN 127489 now, out of the 1 s cycle (e.g. on an alarm edge).
+/// No-op before init().
+void publishEngineDynamic();
+
 }  // namespace n2k_publisher
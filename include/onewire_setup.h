@@ -4,28 +4,28 @@
 //  onewire_setup.h — 1-Wire temperature destination table + setup
 // ============================================================
 
+#include <cstdint>
 #include "halmet_config.h"
 
-namespace sensesp::onewire {
-class OneWireTemperature;
-}
+class OneWireRegistry;
 
 struct TempDestination {
-    const char* label;     // web UI display name
-    int         n2kSource; // tN2kTempSource enum, or -1 for SK-only / disabled
-    const char* skPath;    // SK path, or nullptr for raw sensor index
+    const char* label;          // web UI display name
+    int         n2kSource;      // tN2kTempSource enum, or -1 for SK-only / disabled
+    const char* skPath;         // SK path, or nullptr for environment.inside.temperature.<index>
+    uint8_t     resolutionBits; // DS18B20 resolution, 9–12 bit
+    uint32_t    intervalMs;     // read (and PGN 130316) interval
 };
 
-extern const TempDestination kTempDests[];
-extern const int kNumTempDests;
+/// Entries in kTempDests (src/onewire_dests.cpp) — bump when appending.
+constexpr int kNumTempDests = 12;
 
-namespace onewire_setup {
+extern const TempDestination kTempDests[kNumTempDests];
 
-struct Outputs {
-    int                                      owDest[NUM_ONEWIRE_SLOTS];
-    sensesp::onewire::OneWireTemperature*    owSensors[NUM_ONEWIRE_SLOTS];
-};
+namespace onewire_setup {
 
-void init(Outputs& out);
+/// Scan every bus in ONEWIRE_BUS_PINS into the registry, bind each
+/// probe to its configured destination and start the sweeps.
+void init(OneWireRegistry& reg);
 
 }  // namespace onewire_setup
@@ -0,0 +1,34 @@
+#pragma once
+
+// ============================================================
+//  ota_stream.h — Compressed OTA upload without an N2K outage
+//
+//  Accepts an image packed by tools/ota_pack.py (OtaUnpacker.h)
+//  on the SensESP web server and decompresses it straight into
+//  the inactive app partition as it arrives.  The transfer runs
+//  in the httpd task, so the event loop — and every N2K/SK
+//  publisher with it — carries on; the bilge relay is forced off
+//  only once the image is verified, just before the restart.
+//
+//  HTTP (SensESP web server):
+//    POST /api/ota   body = packed image, header X-OTA-Password
+//                    → JSON result; restarts into the new image
+//    GET  /api/ota   → JSON state of the current / last transfer
+//
+//  Host side:  python3 tools/ota_pack.py firmware.bin --upload halmet-engine.local
+//
+//  The legacy ArduinoOTA (espota) path stays available; it still
+//  blocks loop() for the whole transfer.
+// ============================================================
+
+class BilgeFan;
+
+namespace ota_stream {
+
+struct InitParams {
+    BilgeFan* bilgeFan;   // forced off before the restart
+};
+
+void init(const InitParams& p);
+
+}  // namespace ota_stream
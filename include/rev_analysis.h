@@ -0,0 +1,32 @@
+#pragma once
+
+// ============================================================
+//  rev_analysis.h — Per-revolution speed variation (vibration,
+//                   misfire) from the W-terminal edge timing
+//
+//  A task at idle + 1 priority on core 0 drains the edge
+//  timestamps the RPM ISR captures, cuts them into blocks and
+//  runs RevAnalyzer (windowed FFT, esp-dsp where available) on
+//  each.  Its CPU time — draining included — is capped by a
+//  CpuBudget at REV_CPU_BUDGET_PCT of the core; a block that
+//  completes while the budget is spent is dropped, never queued.
+//
+//  Signal K, every INTERVAL_REV_SK_MS while blocks are analysed:
+//    design.halmet.engine.roughness            (ratio, RMS speed
+//                                               variation / mean)
+//    design.halmet.engine.revolutionAnalysis   (JSON: crank-order
+//                                               amplitudes, block
+//                                               counts, CPU use)
+// ============================================================
+
+class RpmSensor;
+
+namespace rev_analysis {
+
+struct InitParams {
+    RpmSensor* rpm;   ///< source of the current pulses-per-rev setting
+};
+
+void init(const InitParams& p);
+
+}  // namespace rev_analysis
@@ -0,0 +1,49 @@
+#pragma once
+
+// ============================================================
+//  supervisor.h — Per-task deadlines feeding the task watchdog
+//
+//  The periodic tasks below check in each time they run.  Every
+//  SUPERVISOR_TICK_MS the supervisor feeds the ESP32 task
+//  watchdog (the loop task is subscribed, SUPERVISOR_WDT_TIMEOUT_S)
+//  only if every critical task is within its deadline.  A stalled
+//  task — a hung I²C read, a wedged CAN driver — therefore resets
+//  the board after at most deadline + tick + watchdog timeout; a
+//  hung event loop stops the feeding outright.
+//
+//  The task that missed is logged, kept in RTC memory across the
+//  reset and published after the reboot:
+//    design.halmet.diagnostics.tasks   (JSON, INTERVAL_DIAG_MS)
+//
+//  ArduinoOTA blocks loop() for the whole transfer, so its
+//  onStart unsubscribes the loop task (suspend()) and onError
+//  subscribes it again (resume()).
+// ============================================================
+
+#include <cstdint>
+
+enum class SupervisedTask : uint8_t {
+    RPM_TICK = 0,   // engine_state_machine, PGN 127488 (critical)
+    ADS,            // analog_inputs ADS scheduler tick (critical)
+    N2K_PUMP,       // ParseMessages (critical)
+    SLOW_PGNS,      // PGN 127489 / 127505 / 127501 (critical)
+    ONEWIRE,        // DS18B20 sweep completed (reported only)
+    COUNT
+};
+
+namespace supervisor {
+
+/// Register the tasks and subscribe the calling (loop) task to the
+/// watchdog.  Call from setup() before the supervised callbacks.
+void init();
+
+/// Called by each supervised task every time it runs.
+void checkIn(SupervisedTask t);
+
+/// Unsubscribe from the watchdog (ArduinoOTA.onStart).
+void suspend();
+
+/// Subscribe again and restart every deadline (ArduinoOTA.onError).
+void resume();
+
+}  // namespace supervisor
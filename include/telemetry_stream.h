@@ -0,0 +1,59 @@
+#pragma once
+
+// ============================================================
+//  telemetry_stream.h — Live binary telemetry for commissioning
+//
+//  When enabled in the web UI, listens on TELEMETRY_STREAM_PORT
+//  and, while a client is connected, pushes one TelemetryFrame
+//  per RPM tick (10 Hz).  With no client connected the frame
+//  callback is not registered at all; with the stream disabled
+//  the listening socket is closed.
+//
+//  Host side:  python3 tools/telemetry_decode.py halmet-engine.local
+// ============================================================
+
+#include <cstdint>
+
+struct EngineState;
+class RpmSensor;
+
+namespace sensesp {
+template <typename T> class PersistingObservableValue;
+}
+
+constexpr uint8_t kTelemetrySync0   = 0xA5;
+constexpr uint8_t kTelemetrySync1   = 0x5A;
+constexpr uint8_t kTelemetryVersion = 1;
+
+/// Wire format, little-endian.  crc is CRC-16/CCITT-FALSE over
+/// every byte before it (sync included).
+struct __attribute__((packed)) TelemetryFrame {
+    uint8_t  sync[2];
+    uint8_t  version;
+    uint8_t  flags;          // same bit layout as BlackboxSample::flags
+    uint16_t seq;            // wraps; gaps = frames dropped on the device
+    uint32_t ms;             // millis() at sample time
+    float    rpmInstant;     // RPM from the last 100 ms pulse count
+    float    rpmSmoothed;    // moving-average RPM (as sent in PGN 127488)
+    float    pulsesPerRev;
+    int16_t  adsRaw[4];      // raw ADS1115 codes, ch0–ch3
+    float    adsVolts[4];    // the same codes converted at the configured gain
+    float    coolantC;       // NAN when out of range / not available
+    float    tankOhm;        // NAN when the sender reads as open/short
+    uint8_t  oilHistory;     // alarm debounce shift registers
+    uint8_t  tempHistory;
+    uint16_t crc;
+};
+static_assert(sizeof(TelemetryFrame) == 58, "TelemetryFrame layout is shared with tools/telemetry_decode.py");
+
+namespace telemetry_stream {
+
+struct InitParams {
+    const EngineState*                        state;
+    RpmSensor*                                rpm;
+    sensesp::PersistingObservableValue<bool>* enabled;
+};
+
+void init(const InitParams& p);
+
+}  // namespace telemetry_stream
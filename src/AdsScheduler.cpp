@@ -0,0 +1,162 @@
+#include "AdsScheduler.h"
+
+// ============================================================
+//  AdsScheduler.cpp
+// ============================================================
+
+float adsVoltsPerCount(uint16_t gain) {
+    switch (gain & 0x0E00) {
+        case 0x0000: return 6.144f / 32768.0f;   // GAIN_TWOTHIRDS
+        case 0x0200: return 4.096f / 32768.0f;   // GAIN_ONE
+        case 0x0400: return 2.048f / 32768.0f;   // GAIN_TWO
+        case 0x0600: return 1.024f / 32768.0f;   // GAIN_FOUR
+        case 0x0800: return 0.512f / 32768.0f;   // GAIN_EIGHT
+        default:     return 0.256f / 32768.0f;   // GAIN_SIXTEEN
+    }
+}
+
+uint32_t adsConversionUs(uint16_t rate) {
+    static const uint16_t kSps[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+    uint32_t us = 1000000u / kSps[(rate >> 5) & 0x07];
+    return us + us / 10;
+}
+
+AdsScheduler::AdsScheduler(AdsBus& bus, AdsClockUs clock, AdsSink sink, void* ctx, uint32_t retryMs)
+    : _bus(bus), _clock(clock), _sink(sink), _ctx(ctx), _retryMs(retryMs) {}
+
+int AdsScheduler::add(const AdsChannel& ch, uint32_t nowMs) {
+    if (_nChannels >= kMaxChannels || ch.device >= kMaxDevices || ch.mux > 3) return -1;
+    Channel& c  = _ch[_nChannels];
+    c           = Channel{};
+    c.spec      = ch;
+    c.nextDueMs = nowMs;
+    Device& d = _dev[ch.device];
+    if (!d.used) {
+        d.used      = true;
+        d.retryAtMs = nowMs;   // probe on the first poll
+    }
+    return _nChannels++;
+}
+
+void AdsScheduler::account(Device& d, uint32_t t0Us) {
+    uint32_t us = _clock() - t0Us;
+    d.transactions++;
+    d.busUs += us;
+    if (us > d.maxTxUs) d.maxTxUs = us;
+}
+
+void AdsScheduler::poll(uint32_t nowMs) {
+    for (int i = 0; i < kMaxDevices; i++) {
+        if (_dev[i].used) pollDevice(i, nowMs);
+    }
+}
+
+void AdsScheduler::pollDevice(int index, uint32_t nowMs) {
+    Device& d = _dev[index];
+
+    if (d.state == State::DOWN) {
+        if (static_cast<int32_t>(nowMs - d.retryAtMs) < 0) return;
+        uint32_t t0 = _clock();
+        bool     ok = _bus.begin(static_cast<uint8_t>(index));
+        account(d, t0);
+        if (!ok) {
+            d.failedBegins++;
+            d.retryAtMs = nowMs + _retryMs;
+            return;
+        }
+        d.state      = State::IDLE;
+        d.timeoutRun = 0;
+        // Channels start afresh rather than all at once as "late"
+        for (int c = 0; c < _nChannels; c++) {
+            if (_ch[c].spec.device == index) _ch[c].nextDueMs = nowMs;
+        }
+    }
+
+    if (d.state == State::CONVERTING) {
+        uint32_t elapsed = _clock() - d.startUs;
+        if (elapsed < d.convUs) return;
+
+        uint32_t t0    = _clock();
+        bool     ready = _bus.ready(static_cast<uint8_t>(index));
+        account(d, t0);
+        if (!ready) {
+            if (elapsed < 2 * d.convUs) return;          // running slow; look again
+            d.timeouts++;
+            d.active = -1;
+            if (++d.timeoutRun >= kMaxTimeouts) {
+                d.state     = State::DOWN;
+                d.downs++;
+                d.retryAtMs = nowMs + _retryMs;
+                return;
+            }
+            d.state = State::IDLE;                        // next due channel starts below
+        } else {
+            t0          = _clock();
+            int16_t raw = _bus.result(static_cast<uint8_t>(index));
+            account(d, t0);
+            d.timeoutRun = 0;
+            d.samples++;
+            Channel& c = _ch[d.active];
+            c.raw      = raw;
+            c.lastMs   = nowMs;
+            c.samples++;
+            int id   = d.active;
+            d.active = -1;
+            d.state  = State::IDLE;
+            if (_sink) _sink(_ctx, id, raw, d.startMs + d.convUs / 2000);
+        }
+    }
+
+    if (d.state == State::IDLE) startNext(index, nowMs);
+}
+
+bool AdsScheduler::startNext(int index, uint32_t nowMs) {
+    Device& d    = _dev[index];
+    int     best = -1;
+    int32_t most = -1;
+    for (int c = 0; c < _nChannels; c++) {
+        if (_ch[c].spec.device != index) continue;
+        int32_t overdue = static_cast<int32_t>(nowMs - _ch[c].nextDueMs);
+        if (overdue > most) {
+            most = overdue;
+            best = c;
+        }
+    }
+    if (best < 0) return false;
+
+    Channel& c = _ch[best];
+    if (most >= static_cast<int32_t>(c.spec.intervalMs)) {
+        c.late++;
+        c.nextDueMs = nowMs + c.spec.intervalMs;
+    } else {
+        c.nextDueMs += c.spec.intervalMs;
+    }
+
+    uint32_t t0 = _clock();
+    _bus.start(static_cast<uint8_t>(index), c.spec);
+    account(d, t0);
+    d.active  = static_cast<int8_t>(best);
+    d.startUs = _clock();
+    d.startMs = nowMs;
+    d.convUs  = adsConversionUs(c.spec.rate);
+    d.state   = State::CONVERTING;
+    return true;
+}
+
+bool AdsScheduler::allUp() const {
+    for (const Device& d : _dev) {
+        if (d.used && d.state == State::DOWN) return false;
+    }
+    return true;
+}
+
+uint32_t AdsScheduler::failedBegins() const {
+    uint32_t n = 0;
+    for (const Device& d : _dev) n += d.failedBegins;
+    return n;
+}
+
+uint32_t AdsScheduler::usPerSample(int index) const {
+    const Device& d = _dev[index];
+    return d.samples ? d.busUs / d.samples : 0;
+}
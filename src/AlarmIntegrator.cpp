@@ -0,0 +1,65 @@
+#include "AlarmIntegrator.h"
+
+// ============================================================
+//  AlarmIntegrator.cpp
+// ============================================================
+
+AlarmIntegrator::AlarmIntegrator(uint32_t assertUs, uint32_t releaseUs, uint8_t drainRatio)
+    : _assertUs(assertUs ? assertUs : 1),
+      _releaseUs(releaseUs ? releaseUs : 1),
+      _drainRatio(drainRatio ? drainRatio : 1) {}
+
+void AlarmIntegrator::setTimes(uint32_t assertUs, uint32_t releaseUs) {
+    _assertUs  = assertUs  ? assertUs  : 1;
+    _releaseUs = releaseUs ? releaseUs : 1;
+}
+
+void AlarmIntegrator::reset(bool level, uint32_t nowUs) {
+    _level    = level;
+    _asserted = level;
+    _accUs    = 0;
+    _lastUs   = nowUs;
+    _changeUs = nowUs;
+}
+
+// ----------------------------------------------------------
+//  Integrate the current level over [_lastUs, toUs].  While the
+//  level agrees with the output the accumulator drains (faster);
+//  while it disagrees it fills, and the output flips at the exact
+//  moment the threshold is crossed.
+// ----------------------------------------------------------
+bool AlarmIntegrator::advance(uint32_t toUs) {
+    uint32_t dt = toUs - _lastUs;
+    if (static_cast<int32_t>(dt) <= 0) return false;   // out-of-order / same instant
+    _lastUs = toUs;
+
+    if (_level == _asserted) {
+        uint64_t drain = static_cast<uint64_t>(dt) * _drainRatio;
+        _accUs = (drain >= _accUs) ? 0 : _accUs - static_cast<uint32_t>(drain);
+        return false;
+    }
+
+    uint32_t threshold = _asserted ? _releaseUs : _assertUs;
+    uint32_t need      = threshold - _accUs;
+    if (dt < need) {
+        _accUs += dt;
+        return false;
+    }
+    _asserted = _level;
+    _accUs    = 0;
+    _changeUs = toUs - (dt - need);
+    return true;
+}
+
+bool AlarmIntegrator::edge(bool level, uint32_t tUs) {
+    bool changed = advance(tUs);
+    if (level == _level) return changed;
+    // An active pulse ending while still unasserted was rejected noise
+    if (_level && !_asserted && _accUs > 0) _rejected++;
+    _level = level;
+    return changed;
+}
+
+bool AlarmIntegrator::update(uint32_t nowUs) {
+    return advance(nowUs);
+}
@@ -0,0 +1,174 @@
+#include "AlarmRules.h"
+
+#include <cmath>
+
+// ============================================================
+//  AlarmRules.cpp
+// ============================================================
+
+const char* alarmLevelName(AlarmLevel l) {
+    switch (l) {
+        case AlarmLevel::WARN:  return "warn";
+        case AlarmLevel::ALARM: return "alarm";
+        default:                return "normal";
+    }
+}
+
+AlarmRules::AlarmRules(AlarmSink sink, void* ctx, uint32_t minNotifyMs)
+    : _sink(sink), _ctx(ctx), _minNotifyMs(minNotifyMs) {
+    for (int8_t& f : _first) f = -1;
+}
+
+int AlarmRules::add(const AlarmRule& r, uint32_t nowMs) {
+    if (_n >= kMaxRules || r.input >= kMaxInputs) return -1;
+    State& s  = _s[_n];
+    s         = State{};
+    s.rule    = r;
+    s.active  = r.gate == AlarmGate::ALWAYS || _running;
+    s.value   = NAN;
+    s.validMs = nowMs;
+    _next[_n]        = _first[r.input];
+    _first[r.input]  = static_cast<int8_t>(_n);
+    return _n++;
+}
+
+void AlarmRules::setThresholds(int id, float warn, float alarm) {
+    _s[id].rule.warn  = warn;
+    _s[id].rule.alarm = alarm;
+}
+
+void AlarmRules::resetRise(State& s) {
+    s.slotHead  = 0;
+    s.slotCount = 0;
+}
+
+float AlarmRules::riseRate(State& s, float v, uint32_t nowMs) {
+    const uint32_t slotMs = s.rule.windowMs / kRiseSlots;
+    if (s.slotCount == 0) {
+        s.ewma      = v;
+        s.ewmaMs    = nowMs;
+        s.slotV[0]  = v;
+        s.slotMs[0] = nowMs;
+        s.slotHead  = 1;
+        s.slotCount = 1;
+        return NAN;
+    }
+
+    // EWMA with τ = one slot, irregular sample spacing
+    float dt = static_cast<float>(nowMs - s.ewmaMs);
+    s.ewma  += (v - s.ewma) * dt / (static_cast<float>(slotMs) + dt);
+    s.ewmaMs = nowMs;
+
+    int newest = (s.slotHead + kRiseSlots - 1) % kRiseSlots;
+    if (nowMs - s.slotMs[newest] >= slotMs) {
+        s.slotV[s.slotHead]  = s.ewma;
+        s.slotMs[s.slotHead] = nowMs;
+        s.slotHead           = static_cast<uint8_t>((s.slotHead + 1) % kRiseSlots);
+        if (s.slotCount < kRiseSlots) s.slotCount++;
+    }
+
+    int      oldest = (s.slotHead + kRiseSlots - s.slotCount) % kRiseSlots;
+    uint32_t span   = nowMs - s.slotMs[oldest];
+    if (span < s.rule.windowMs / 2) return NAN;
+    return (s.ewma - s.slotV[oldest]) * 60000.0f / static_cast<float>(span);
+}
+
+void AlarmRules::sample(uint8_t input, float value, uint32_t nowMs) {
+    if (input >= kMaxInputs) return;
+    for (int id = _first[input]; id >= 0; id = _next[id]) {
+        State& s = _s[id];
+        if (!s.active) continue;
+        switch (s.rule.kind) {
+            case AlarmKind::STALE:
+                if (!std::isnan(value)) {
+                    s.validMs = nowMs;
+                    evaluate(id, 0.0f, nowMs);
+                }
+                break;
+            case AlarmKind::ABOVE:
+            case AlarmKind::BELOW:
+                if (!std::isnan(value)) evaluate(id, value, nowMs);
+                break;
+            case AlarmKind::RISE: {
+                if (std::isnan(value)) break;
+                float rate = riseRate(s, value, nowMs);
+                if (!std::isnan(s.rule.armAbove) && value < s.rule.armAbove) {
+                    s.value = std::isnan(rate) ? 0.0f : rate;
+                    setLevel(s, AlarmLevel::NORMAL);
+                    notify(id, nowMs);
+                } else if (!std::isnan(rate)) {
+                    evaluate(id, rate, nowMs);
+                }
+                break;
+            }
+        }
+    }
+}
+
+void AlarmRules::setRunning(bool running, uint32_t nowMs) {
+    if (running == _running) return;
+    _running = running;
+    for (int id = 0; id < _n; id++) {
+        State& s = _s[id];
+        if (s.rule.gate != AlarmGate::RUNNING) continue;
+        s.active = running;
+        resetRise(s);
+        if (running) {
+            s.validMs = nowMs;   // the stale clock starts with the engine
+        } else {
+            setLevel(s, AlarmLevel::NORMAL);
+            notify(id, nowMs);
+        }
+    }
+}
+
+void AlarmRules::tick(uint32_t nowMs) {
+    for (int id = 0; id < _n; id++) {
+        State& s = _s[id];
+        if (s.rule.kind == AlarmKind::STALE && s.active) {
+            evaluate(id, (nowMs - s.validMs) / 1000.0f, nowMs);
+        } else {
+            notify(id, nowMs);   // a step down held back by the rate limit
+        }
+    }
+}
+
+void AlarmRules::evaluate(int id, float q, uint32_t nowMs) {
+    State&           s    = _s[id];
+    const AlarmRule& r    = s.rule;
+    const float      sign = r.kind == AlarmKind::BELOW ? -1.0f : 1.0f;
+    const float      hyst = r.kind == AlarmKind::STALE ? 0.0f : r.hysteresis;
+    const float      x    = sign * q;
+    s.value = q;
+
+    // At or past the threshold, or raised to it and not yet back by the hysteresis
+    auto reached = [&](float threshold, AlarmLevel at) {
+        if (std::isnan(threshold)) return false;
+        float t = sign * threshold;
+        return x >= t || (s.level >= at && x > t - hyst);
+    };
+    AlarmLevel l = reached(r.alarm, AlarmLevel::ALARM) ? AlarmLevel::ALARM
+                 : reached(r.warn,  AlarmLevel::WARN)  ? AlarmLevel::WARN
+                                                       : AlarmLevel::NORMAL;
+    setLevel(s, l);
+    notify(id, nowMs);
+}
+
+void AlarmRules::setLevel(State& s, AlarmLevel l) {
+    if (s.level == l) return;
+    s.level = l;
+    s.transitions++;
+}
+
+void AlarmRules::notify(int id, uint32_t nowMs) {
+    State& s = _s[id];
+    if (s.level == s.sent) return;
+    // Step down: rate limited.  Signed — a sample stamped with its
+    // acquisition time may be a little older than the last tick().
+    if (s.level < s.sent &&
+        static_cast<int32_t>(nowMs - s.sentMs) < static_cast<int32_t>(_minNotifyMs)) return;
+    s.sent   = s.level;
+    s.sentMs = nowMs;
+    s.notified++;
+    if (_sink) _sink(_ctx, id, s.level, s.value, nowMs);
+}
@@ -11,7 +11,11 @@ BilgeFan::BilgeFan(uint8_t relayPin, bool activeHigh)
 
 void BilgeFan::begin() {
     pinMode(_pin, OUTPUT);
-    setRelay(false);      // Always start with relay OFF
+    // Always start with relay OFF.  Written directly: setRelay(false)
+    // would skip the write (_relayOn is already false) and leave an
+    // active-low relay energised by the pin's reset level.
+    _relayOn = false;
+    digitalWrite(_pin, _activeHigh ? LOW : HIGH);
     _state    = FanState::IDLE;
     _timerSec = 0.0f;
 }
@@ -0,0 +1,49 @@
+#include "BusTime.h"
+
+#include <cmath>
+
+// ============================================================
+//  BusTime.cpp
+// ============================================================
+
+static constexpr int64_t kMsPerDay = 86400000LL;
+
+BusTime::BusTime(uint32_t validMs, uint32_t stepMs)
+    : _validMs(validMs), _stepMs(stepMs) {}
+
+bool BusTime::update(uint16_t days, double seconds, uint8_t source, uint32_t rxMs) {
+    // 0xFFFF days / negative (N2kDoubleNA) seconds: sender has no fix
+    if (days == 0xFFFF || !(seconds >= 0.0) || seconds >= 86401.0) return false;
+    if (_set && source != _source && synced(rxMs)) {
+        _ignored++;
+        return false;
+    }
+
+    int64_t measured = days * kMsPerDay + static_cast<int64_t>(std::llround(seconds * 1000.0));
+    if (!_set || source != _source) {
+        _refUtcMs = measured;
+    } else {
+        int64_t err = measured - utcMs(rxMs);
+        if (err > static_cast<int64_t>(_stepMs) || -err > static_cast<int64_t>(_stepMs)) {
+            _refUtcMs = measured;
+            _steps++;
+        } else {
+            _refUtcMs = measured - err + err / 8;
+        }
+    }
+    _refLocalMs = rxMs;
+    _lastRxMs   = rxMs;
+    _source     = source;
+    _set        = true;
+    _updates++;
+    return true;
+}
+
+bool BusTime::synced(uint32_t nowMs) const {
+    return _set && (nowMs - _lastRxMs) <= _validMs;
+}
+
+int64_t BusTime::utcMs(uint32_t localMs) const {
+    if (!_set) return -1;
+    return _refUtcMs + static_cast<int32_t>(localMs - _refLocalMs);
+}
@@ -0,0 +1,105 @@
+#include "CompactEncoder.h"
+
+#include <cmath>
+#include <cstring>
+
+// ============================================================
+//  CompactEncoder.cpp
+// ============================================================
+
+CompactEncoder::CompactEncoder(uint8_t* buf, size_t capacity, CompactFormat fmt)
+    : _buf(buf), _cap(capacity), _fmt(fmt) {}
+
+void CompactEncoder::put(uint8_t b) {
+    if (_len >= _cap) {
+        _overflow = true;
+        return;
+    }
+    _buf[_len++] = b;
+}
+
+void CompactEncoder::putBE(uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) put(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+// Major type in the top three bits, argument in the shortest form
+void CompactEncoder::cborHead(uint8_t major, uint64_t v) {
+    uint8_t m = static_cast<uint8_t>(major << 5);
+    if (v < 24)               { put(m | static_cast<uint8_t>(v)); }
+    else if (v <= 0xFF)       { put(m | 24); putBE(v, 1); }
+    else if (v <= 0xFFFF)     { put(m | 25); putBE(v, 2); }
+    else if (v <= 0xFFFFFFFF) { put(m | 26); putBE(v, 4); }
+    else                      { put(m | 27); putBE(v, 8); }
+}
+
+void CompactEncoder::beginMap(uint32_t pairs) {
+    if (_fmt == CompactFormat::CBOR) return cborHead(5, pairs);
+    if (pairs < 16)          put(0x80 | pairs);
+    else if (pairs <= 0xFFFF) { put(0xDE); putBE(pairs, 2); }
+    else                      { put(0xDF); putBE(pairs, 4); }
+}
+
+void CompactEncoder::beginArray(uint32_t items) {
+    if (_fmt == CompactFormat::CBOR) return cborHead(4, items);
+    if (items < 16)          put(0x90 | items);
+    else if (items <= 0xFFFF) { put(0xDC); putBE(items, 2); }
+    else                      { put(0xDD); putBE(items, 4); }
+}
+
+void CompactEncoder::putUint(uint64_t v) {
+    if (_fmt == CompactFormat::CBOR) return cborHead(0, v);
+    if (v < 128)              { put(static_cast<uint8_t>(v)); }
+    else if (v <= 0xFF)       { put(0xCC); putBE(v, 1); }
+    else if (v <= 0xFFFF)     { put(0xCD); putBE(v, 2); }
+    else if (v <= 0xFFFFFFFF) { put(0xCE); putBE(v, 4); }
+    else                      { put(0xCF); putBE(v, 8); }
+}
+
+void CompactEncoder::putInt(int64_t v) {
+    if (v >= 0) return putUint(static_cast<uint64_t>(v));
+    if (_fmt == CompactFormat::CBOR) return cborHead(1, static_cast<uint64_t>(-1 - v));
+    uint64_t u = static_cast<uint64_t>(v);
+    if (v >= -32)             { put(static_cast<uint8_t>(u)); }       // negative fixint
+    else if (v >= INT8_MIN)   { put(0xD0); putBE(u, 1); }
+    else if (v >= INT16_MIN)  { put(0xD1); putBE(u, 2); }
+    else if (v >= INT32_MIN)  { put(0xD2); putBE(u, 4); }
+    else                      { put(0xD3); putBE(u, 8); }
+}
+
+void CompactEncoder::putFloat(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put(_fmt == CompactFormat::CBOR ? 0xFA : 0xCA);
+    putBE(bits, 4);
+}
+
+void CompactEncoder::putBool(bool v) {
+    if (_fmt == CompactFormat::CBOR) put(v ? 0xF5 : 0xF4);
+    else                             put(v ? 0xC3 : 0xC2);
+}
+
+void CompactEncoder::putNull() {
+    put(_fmt == CompactFormat::CBOR ? 0xF6 : 0xC0);
+}
+
+void CompactEncoder::putStr(const char* s) {
+    size_t n = strlen(s);
+    if (_fmt == CompactFormat::CBOR) {
+        cborHead(3, n);
+    } else if (n < 32) {
+        put(static_cast<uint8_t>(0xA0 | n));
+    } else if (n <= 0xFF) {
+        put(0xD9); putBE(n, 1);
+    } else if (n <= 0xFFFF) {
+        put(0xDA); putBE(n, 2);
+    } else {
+        put(0xDB); putBE(n, 4);
+    }
+    for (size_t i = 0; i < n; i++) put(static_cast<uint8_t>(s[i]));
+}
+
+void CompactEncoder::putScaled(float v, float scale) {
+    double x = static_cast<double>(v) * scale;
+    if (!std::isfinite(x) || std::fabs(x) > 9.0e18) return putNull();
+    putInt(static_cast<int64_t>(std::llround(x)));
+}
@@ -0,0 +1,33 @@
+#include "CoolantCurve.h"
+
+#include <cmath>
+
+#include "halmet_config.h"
+
+// ============================================================
+//  CoolantCurve.cpp
+// ============================================================
+
+namespace CoolantCurve {
+
+// ---- Voltage → Temperature curve (VP / VDO NTC sender) ----
+struct CurvePoint { float v; float c; };
+static const CurvePoint kTempCurve[] = { TEMP_CURVE_POINTS };
+static constexpr int kTempCurveLen = sizeof(kTempCurve) / sizeof(CurvePoint);
+
+float voltageToCelsius(float volt) {
+    if (volt < COOLANT_VOLT_MIN_V || volt > COOLANT_VOLT_MAX_V) return NAN;
+
+    if (volt <= kTempCurve[kTempCurveLen - 1].v) return kTempCurve[kTempCurveLen - 1].c;
+    if (volt >= kTempCurve[0].v)                 return kTempCurve[0].c;
+    for (int i = 0; i < kTempCurveLen - 1; i++) {
+        if (volt <= kTempCurve[i].v && volt > kTempCurve[i + 1].v) {
+            float ratio = (volt - kTempCurve[i + 1].v)
+                        / (kTempCurve[i].v - kTempCurve[i + 1].v);
+            return kTempCurve[i + 1].c + ratio * (kTempCurve[i].c - kTempCurve[i + 1].c);
+        }
+    }
+    return NAN;
+}
+
+}  // namespace CoolantCurve
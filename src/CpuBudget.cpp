@@ -0,0 +1,27 @@
+#include "CpuBudget.h"
+
+// ============================================================
+//  CpuBudget.cpp
+// ============================================================
+
+CpuBudget::CpuBudget(uint32_t pct, uint32_t burstUs)
+    : _pct(pct), _burstUs(burstUs), _creditUs(burstUs) {}
+
+void CpuBudget::accrue(uint32_t nowUs) {
+    if (_started) {
+        _creditUs += static_cast<int64_t>(nowUs - _lastUs) * _pct / 100;
+        if (_creditUs > _burstUs) _creditUs = _burstUs;
+    }
+    _started = true;
+    _lastUs  = nowUs;
+}
+
+bool CpuBudget::allow(uint32_t nowUs) {
+    accrue(nowUs);
+    return _creditUs > 0;
+}
+
+void CpuBudget::spend(uint32_t busyUs) {
+    _creditUs -= busyUs;
+    _busyUs   += busyUs;
+}
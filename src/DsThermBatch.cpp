@@ -0,0 +1,308 @@
+#include "DsThermBatch.h"
+
+#include <cmath>
+#include <cstring>
+#include <sensesp.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "supervisor.h"
+#include "arena.h"
+
+// ============================================================
+//  DsThermBatch.cpp
+// ============================================================
+
+using namespace sensesp;
+
+// DS18B20 factory defaults for the (unused) TH/TL alarm registers
+static constexpr uint8_t kDefaultTh = 0x4B;   // 75 °C
+static constexpr uint8_t kDefaultTl = 0x46;   // 70 °C
+
+DsThermBatch::DsThermBatch(uint8_t pin)
+    : _pin(pin),
+      _ow(pin, false),      // HALMET has an external pull-up on the header
+      _drv(_ow) {
+    _drv.filterSupportedSlaves();   // searches return DS18B20-family only
+}
+
+uint32_t DsThermBatch::convTimeMs(uint8_t resolutionBits) {
+    if (resolutionBits < 9)  resolutionBits = 9;
+    if (resolutionBits > 12) resolutionBits = 12;
+    // 750 ms at 12 bit, halved per bit below (rounded up)
+    return (DSTherm::MAX_CONV_TIME + (1u << (12 - resolutionBits)) - 1)
+           >> (12 - resolutionBits);
+}
+
+size_t DsThermBatch::scan(std::vector<OneWireRom>& out) {
+    out.clear();
+    OneWireRom rom;
+    scanBegin();
+    while (scanNext(rom)) out.push_back(rom);
+    return out.size();
+}
+
+void DsThermBatch::scanBegin() {
+    _ow.searchReset();
+    _scanDone = false;
+}
+
+bool DsThermBatch::scanNext(OneWireRom& rom) {
+    if (_scanDone) return false;
+    OneWireNg::Id id;
+    OneWireNg::ErrorCode ec = _ow.search(id);
+    if (ec != OneWireNg::EC_MORE) _scanDone = true;
+    if (ec != OneWireNg::EC_MORE && ec != OneWireNg::EC_DONE) {
+        if (ec != OneWireNg::EC_NO_DEVS) _stats.busErrors++;
+        return false;
+    }
+    for (int j = 0; j < 8; j++) rom[j] = id[j];
+    return true;
+}
+
+int DsThermBatch::findSensor(const OneWireRom& rom) const {
+    for (size_t i = 0; i < _sensors.size(); i++) {
+        if (memcmp(&_sensors[i].id[0], rom.data(), 8) == 0) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+size_t DsThermBatch::groupFor(uint8_t resolutionBits, uint32_t intervalMs) {
+    for (size_t gi = 0; gi < _groups.size(); gi++) {
+        if (_groups[gi].resolutionBits == resolutionBits &&
+            _groups[gi].intervalMs == intervalMs) return gi;
+    }
+    Group g;
+    g.resolutionBits = resolutionBits;
+    g.intervalMs     = intervalMs;
+    _groups.push_back(g);
+    size_t gi = _groups.size() - 1;
+    if (_started) startTimer(gi);
+    return gi;
+}
+
+void DsThermBatch::detach(size_t si) {
+    Sensor& s = _sensors[si];
+    if (s.group < 0) return;
+    auto& m = _groups[s.group].members;
+    for (size_t k = 0; k < m.size(); k++) {
+        if (m[k] == si) { m.erase(m.begin() + k); break; }
+    }
+    s.group = -1;
+    _active--;
+}
+
+ObservableValue<float>* DsThermBatch::addSensor(const OneWireRom& rom,
+                                                uint8_t resolutionBits,
+                                                uint32_t intervalMs) {
+    if (resolutionBits < 9)  resolutionBits = 9;
+    if (resolutionBits > 12) resolutionBits = 12;
+
+    int found = findSensor(rom);
+    size_t si;
+    if (found >= 0) {
+        si = static_cast<size_t>(found);
+        detach(si);
+    } else {
+        Sensor s;
+        for (int j = 0; j < 8; j++) s.id[j] = rom[j];
+        s.out = arena::make<ObservableValue<float>>(NAN);
+        _sensors.push_back(s);
+        si = _sensors.size() - 1;
+    }
+
+    size_t gi = groupFor(resolutionBits, intervalMs);
+    _groups[gi].members.push_back(si);
+    _sensors[si].group       = static_cast<int>(gi);
+    _sensors[si].unconverted = true;
+    _active++;
+
+    // Before begin() the resolution is written in one pass there
+    if (_started) writeResolution(si);
+    return _sensors[si].out;
+}
+
+void DsThermBatch::removeSensor(const OneWireRom& rom) {
+    int si = findSensor(rom);
+    if (si >= 0) detach(static_cast<size_t>(si));
+}
+
+void DsThermBatch::writeResolution(size_t si) {
+    // Resolution lives in the probe's volatile config register; it is
+    // rewritten on every boot, so there is no EEPROM copy to wear out.
+    const Sensor& s = _sensors[si];
+    auto res = static_cast<uint8_t>(DSTherm::RES_9_BIT +
+                                    (_groups[s.group].resolutionBits - 9));
+    if (_drv.writeScratchpad(s.id, kDefaultTh, kDefaultTl, res) != OneWireNg::EC_SUCCESS) {
+        _stats.busErrors++;
+    }
+}
+
+void DsThermBatch::begin(uint32_t phaseMs) {
+    for (const auto& g : _groups) {
+        for (size_t m : g.members) writeResolution(m);
+        ESP_LOGI("1Wire", "Group %u-bit / %lu ms: %u probe(s), conversion %lu ms",
+                 g.resolutionBits, (unsigned long)g.intervalMs,
+                 (unsigned)g.members.size(), (unsigned long)convTimeMs(g.resolutionBits));
+    }
+
+    event_loop()->onDelay(phaseMs, [this]() {
+        _started = true;
+        for (size_t gi = 0; gi < _groups.size(); gi++) startTimer(gi);
+    });
+}
+
+void DsThermBatch::startTimer(size_t gi) {
+    event_loop()->onRepeat(_groups[gi].intervalMs, [this, gi]() { startSweep(gi); });
+}
+
+DsThermGroupStats DsThermBatch::groupStats(size_t gi) const {
+    const Group& g = _groups[gi];
+    return { g.resolutionBits, g.intervalMs, g.members.size(), g.sweeps, g.lastBusUs };
+}
+
+bool DsThermBatch::sensorStats(const OneWireRom& rom, DsThermSensorStats& out) const {
+    int si = findSensor(rom);
+    if (si < 0) return false;
+    out = _sensors[si].q;
+    return true;
+}
+
+// ----------------------------------------------------------
+//  Phase 1 — Convert T for the group, then yield to the event loop
+// ----------------------------------------------------------
+void DsThermBatch::startSweep(size_t gi) {
+    Group& g = _groups[gi];
+    if (g.active || g.members.empty()) return;
+
+    uint32_t t0 = micros();
+    bool     ok = true;
+    g.convertMs = millis();
+    // maxConvTime = 0: DSTherm returns right after the command byte;
+    // the conversion wait is an event-loop delay instead of delay().
+    if (g.members.size() == _active) {
+        ok = _drv.convertTempAll(0, false) == OneWireNg::EC_SUCCESS;
+    } else {
+        for (size_t m : g.members) {
+            if (_sensors[m].q.backoffSweeps > 0) continue;   // read is skipped too
+            if (_drv.convertTemp(_sensors[m].id, 0, false) != OneWireNg::EC_SUCCESS) ok = false;
+        }
+    }
+    g.convertUs      = micros() - t0;
+    _stats.convertUs = g.convertUs;
+    for (size_t m : g.members) _sensors[m].unconverted = false;
+
+    if (!ok) {
+        _stats.busErrors++;
+        _stats.totalBusUs += g.convertUs;
+        return;
+    }
+    g.active = true;
+    event_loop()->onDelay(convTimeMs(g.resolutionBits), [this, gi]() { readGroup(gi); });
+}
+
+// ----------------------------------------------------------
+//  Phase 2 — read the group's scratchpads in one pass
+// ----------------------------------------------------------
+void DsThermBatch::readGroup(size_t gi) {
+    Group&   g  = _groups[gi];
+    uint32_t t0 = micros();
+    _acquiredMs = g.convertMs + convTimeMs(g.resolutionBits) / 2;
+    for (size_t m : g.members) {
+        Sensor& s = _sensors[m];
+        if (s.unconverted) continue;   // re-bound during this conversion
+        if (s.q.backoffSweeps > 0) {
+            s.q.backoffSweeps--;
+            continue;
+        }
+
+        if (readSensor(m)) {
+            s.q.failStreak = 0;
+            continue;
+        }
+        // Exponential backoff once a probe keeps failing: skip 1, 2, 4 …
+        // sweeps (capped) so it stops eating bus time from good probes.
+        if (s.q.failStreak < UINT16_MAX) s.q.failStreak++;
+        if (s.q.failStreak >= ONEWIRE_BACKOFF_AFTER) {
+            // Stop the publishers repeating a stale value from a dead probe
+            if (s.q.failStreak == ONEWIRE_BACKOFF_AFTER) s.out->set(NAN);
+            uint32_t n    = s.q.failStreak - ONEWIRE_BACKOFF_AFTER;
+            uint32_t skip = n >= 16 ? ONEWIRE_BACKOFF_MAX_SWEEPS : (1u << n);
+            if (skip > ONEWIRE_BACKOFF_MAX_SWEEPS) skip = ONEWIRE_BACKOFF_MAX_SWEEPS;
+            s.q.backoffSweeps = static_cast<uint16_t>(skip);
+        }
+    }
+    uint32_t readUs = micros() - t0;
+
+    g.lastBusUs = g.convertUs + readUs;
+    g.sweeps++;
+    g.active = false;
+    supervisor::checkIn(SupervisedTask::ONEWIRE);
+
+    _stats.readUs      = readUs;
+    _stats.sweepBusUs  = g.lastBusUs;
+    _stats.totalBusUs += g.lastBusUs;
+    if (g.lastBusUs > _stats.maxSweepUs) _stats.maxSweepUs = g.lastBusUs;
+    _stats.sweeps++;
+}
+
+// ----------------------------------------------------------
+//  One probe: scratchpad read with bounded CRC retries.
+//  Returns true on a usable reading.
+// ----------------------------------------------------------
+bool DsThermBatch::readSensor(size_t si) {
+    static Placeholder<DSTherm::Scratchpad> scrpd;
+
+    Sensor&  s  = _sensors[si];
+    uint32_t t0 = micros();
+
+    OneWireNg::ErrorCode ec = _drv.readScratchpad(s.id, scrpd);
+    for (int r = 0; ec == OneWireNg::EC_CRC_ERROR && r < ONEWIRE_READ_RETRIES; r++) {
+        s.q.crcErrors++;
+        _stats.crcErrors++;
+        s.q.retries++;
+        ec = _drv.readScratchpad(s.id, scrpd);
+    }
+
+    bool ok = false;
+    if (ec == OneWireNg::EC_SUCCESS) {
+        const DSTherm::Scratchpad& sp = scrpd;
+        long  milliC = sp.getTemp();
+        float prevK  = s.out->get();
+        // 85.000 °C is the power-on-reset value; accept it only when the
+        // probe was already reading close to it (a genuinely hot probe).
+        if (milliC == 85000 &&
+            (std::isnan(prevK) || std::fabs(prevK - 358.15f) > ONEWIRE_POR_PLAUSIBLE_C)) {
+            s.q.porReads++;
+            writeResolution(si);    // POR also reloaded the 12-bit EEPROM default
+        } else {
+            s.out->set(milliC / 1000.0f + 273.15f);   // milli-°C → K
+            s.q.reads++;
+            ok = true;
+        }
+    } else if (ec == OneWireNg::EC_CRC_ERROR) {
+        // Retries exhausted: tell an absent probe (bus floats high,
+        // all 0xFF) from a present one with a corrupted transfer.
+        if (respondsAbsent(s)) {
+            s.q.presenceMisses++;
+        } else {
+            s.q.crcErrors++;
+            _stats.crcErrors++;
+        }
+    } else {
+        s.q.presenceMisses++;   // EC_NO_DEVS: no presence pulse at all
+        _stats.busErrors++;
+    }
+
+    s.q.lastReadUs = micros() - t0;
+    if (s.q.lastReadUs > s.q.maxReadUs) s.q.maxReadUs = s.q.lastReadUs;
+    return ok;
+}
+
+bool DsThermBatch::respondsAbsent(const Sensor& s) {
+    if (_ow.addressSingle(s.id) != OneWireNg::EC_SUCCESS) return true;
+    _ow.writeByte(0xBE);                       // Read Scratchpad
+    for (int i = 0; i < 9; i++) {
+        if (_ow.readByte() != 0xFF) return false;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#include "Fft.h"
+
+#include <cmath>
+
+#if defined(ESP_PLATFORM) && __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define HALMET_FFT_ESP_DSP 1
+#endif
+
+// ============================================================
+//  Fft.cpp
+// ============================================================
+
+static bool validSize(int n) {
+    return n >= 2 && n <= kMaxFft && (n & (n - 1)) == 0;
+}
+
+bool fftReference(float* data, int n) {
+    if (!validSize(n)) return false;
+
+    // Bit-reversal permutation
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float tr = data[2 * i], ti = data[2 * i + 1];
+            data[2 * i]     = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j]     = tr;
+            data[2 * j + 1] = ti;
+        }
+    }
+
+    // Butterflies; twiddles by recurrence in double to keep the
+    // error of a 1024-point transform at float rounding
+    for (int len = 2; len <= n; len <<= 1) {
+        double ang = -2.0 * M_PI / len;
+        double wpr = std::cos(ang), wpi = std::sin(ang);
+        double wr = 1.0, wi = 0.0;
+        for (int k = 0; k < len / 2; k++) {
+            float cr = static_cast<float>(wr), ci = static_cast<float>(wi);
+            for (int i = k; i < n; i += len) {
+                int   j  = i + len / 2;
+                float xr = data[2 * j] * cr - data[2 * j + 1] * ci;
+                float xi = data[2 * j] * ci + data[2 * j + 1] * cr;
+                data[2 * j]     = data[2 * i] - xr;
+                data[2 * j + 1] = data[2 * i + 1] - xi;
+                data[2 * i]     += xr;
+                data[2 * i + 1] += xi;
+            }
+            double t = wr;
+            wr = wr * wpr - wi * wpi;
+            wi = t * wpi + wi * wpr;
+        }
+    }
+    return true;
+}
+
+#ifdef HALMET_FFT_ESP_DSP
+
+bool fft(float* data, int n) {
+    static bool sTables = false;
+    if (!validSize(n)) return false;
+    if (!sTables) {
+        // Twiddle table for the largest size, allocated once by esp-dsp
+        if (dsps_fft2r_init_fc32(nullptr, kMaxFft) != ESP_OK) return fftReference(data, n);
+        sTables = true;
+    }
+    dsps_fft2r_fc32(data, n);
+    dsps_bit_rev_fc32(data, n);
+    return true;
+}
+
+const char* fftBackend() { return "esp-dsp"; }
+
+#else
+
+bool fft(float* data, int n) { return fftReference(data, n); }
+
+const char* fftBackend() { return "reference"; }
+
+#endif
@@ -0,0 +1,128 @@
+#include "FlashJournal.h"
+
+#include <cstring>
+
+// ============================================================
+//  FlashJournal.cpp
+// ============================================================
+
+namespace {
+
+constexpr size_t kHeaderLen = 8;     // magic, payloadLen, seq
+constexpr size_t kCrcLen    = 4;
+constexpr size_t kMaxSlot   = 256;   // stack buffer for one slot
+
+uint32_t crc32(const uint8_t* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+}  // namespace
+
+FlashJournal::FlashJournal(JournalFlash& flash, size_t payloadLen)
+    : _flash(flash), _payloadLen(payloadLen) {
+    // Round up to 16 bytes so slots never straddle a flash page
+    size_t raw = kHeaderLen + payloadLen + kCrcLen;
+    _slotSize       = (raw + 15) & ~static_cast<size_t>(15);
+    _slotsPerSector = (_slotSize <= kMaxSlot) ? _flash.sectorSize() / _slotSize : 0;
+}
+
+size_t FlashJournal::slotAddr(size_t slot) const {
+    return (slot / _slotsPerSector) * _flash.sectorSize() + (slot % _slotsPerSector) * _slotSize;
+}
+
+bool FlashJournal::slotBlank(size_t slot) {
+    uint8_t buf[kMaxSlot];
+    if (!_flash.read(slotAddr(slot), buf, _slotSize)) return false;
+    for (size_t i = 0; i < _slotSize; i++) {
+        if (buf[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+bool FlashJournal::readSlot(size_t slot, void* payload, uint32_t& seq) {
+    uint8_t buf[kMaxSlot];
+    if (!_flash.read(slotAddr(slot), buf, _slotSize)) return false;
+
+    uint16_t magic, len;
+    uint32_t crc;
+    memcpy(&magic, buf,     2);
+    memcpy(&len,   buf + 2, 2);
+    if (magic != kFlashJournalMagic || len != _payloadLen) return false;
+    memcpy(&crc, buf + kHeaderLen + _payloadLen, kCrcLen);
+    if (crc != crc32(buf, kHeaderLen + _payloadLen)) return false;
+
+    memcpy(&seq, buf + 4, 4);
+    memcpy(payload, buf + kHeaderLen, _payloadLen);
+    return true;
+}
+
+bool FlashJournal::recover(void* payload) {
+    _recovered = true;
+    _seq = _appends = _erases = _corrupt = 0;
+    _head = 0;
+    if (_slotsPerSector == 0) return false;
+
+    uint8_t  tmp[kMaxSlot];
+    bool     found = false;
+    size_t   newest = 0;
+    for (size_t slot = 0; slot < capacity(); slot++) {
+        uint32_t seq;
+        if (readSlot(slot, tmp, seq)) {
+            if (!found || seq > _seq) {
+                found  = true;
+                newest = slot;
+                _seq   = seq;
+                memcpy(payload, tmp, _payloadLen);
+            }
+        } else if (!slotBlank(slot)) {
+            _corrupt++;
+        }
+    }
+    if (!found) return false;
+
+    // Head = first blank slot after the newest record in its sector
+    // (a torn write may sit right behind it), else the next sector.
+    size_t sectorEnd = (newest / _slotsPerSector + 1) * _slotsPerSector;
+    _head = sectorEnd % capacity();
+    for (size_t slot = newest + 1; slot < sectorEnd; slot++) {
+        if (slotBlank(slot)) {
+            _head = slot;
+            break;
+        }
+    }
+    return true;
+}
+
+bool FlashJournal::append(const void* payload) {
+    // One sector must always survive the erase of the head sector
+    if (!_recovered || _slotsPerSector == 0 || _flash.sectorCount() < 2) return false;
+
+    if (_head % _slotsPerSector == 0) {
+        if (!_flash.erase(_head / _slotsPerSector)) return false;
+        _erases++;
+    }
+
+    uint8_t  buf[kMaxSlot];
+    uint16_t magic = kFlashJournalMagic;
+    uint16_t len   = static_cast<uint16_t>(_payloadLen);
+    uint32_t seq   = _seq + 1;
+    memcpy(buf,     &magic, 2);
+    memcpy(buf + 2, &len,   2);
+    memcpy(buf + 4, &seq,   4);
+    memcpy(buf + kHeaderLen, payload, _payloadLen);
+    uint32_t crc = crc32(buf, kHeaderLen + _payloadLen);
+    memcpy(buf + kHeaderLen + _payloadLen, &crc, kCrcLen);
+
+    size_t slot = _head;
+    _head = (_head + 1) % capacity();   // a failed write leaves the slot unusable
+    if (!_flash.write(slotAddr(slot), buf, kHeaderLen + _payloadLen + kCrcLen)) return false;
+
+    _seq = seq;
+    _appends++;
+    return true;
+}
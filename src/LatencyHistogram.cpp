@@ -0,0 +1,47 @@
+#include "LatencyHistogram.h"
+
+// ============================================================
+//  LatencyHistogram.cpp
+// ============================================================
+
+int LatencyHistogram::bucketOf(uint32_t ageMs) {
+    int i = 0;
+    while (ageMs && i < kBuckets - 1) {
+        ageMs >>= 1;
+        i++;
+    }
+    return i;
+}
+
+uint32_t LatencyHistogram::bucketLowMs(int i) {
+    return i == 0 ? 0 : 1u << (i - 1);
+}
+
+void LatencyHistogram::record(uint32_t ageMs) {
+    _bucket[bucketOf(ageMs)]++;
+    _count++;
+    _lastMs = ageMs;
+    _sumMs += ageMs;
+    if (ageMs > _maxMs) _maxMs = ageMs;
+}
+
+uint32_t LatencyHistogram::percentileMs(float p) const {
+    if (_count == 0) return 0;
+    if (p < 0.0f) p = 0.0f;
+    if (p > 1.0f) p = 1.0f;
+    float    rank = p * _count;
+    uint32_t below = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        if (_bucket[i] == 0) continue;
+        if (below + _bucket[i] >= rank) {
+            uint32_t lo = bucketLowMs(i);
+            uint32_t hi = i == kBuckets - 1 ? _maxMs : 2 * lo + (i == 0);
+            if (hi > _maxMs) hi = _maxMs;
+            if (hi < lo) return lo;
+            float frac = (rank - below) / _bucket[i];
+            return lo + static_cast<uint32_t>(frac * (hi - lo) + 0.5f);
+        }
+        below += _bucket[i];
+    }
+    return _maxMs;
+}
@@ -0,0 +1,160 @@
+#include "LogRing.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+// ============================================================
+//  LogRing.cpp
+// ============================================================
+
+// Slot i starts with seq i: free for the producer that claims
+// position i.  A published slot holds pos + 1; a consumed one
+// pos + kCapacity, free for the producer one lap later.
+LogRing::LogRing() {
+    for (uint32_t i = 0; i < kCapacity; i++) _slots[i].seq.store(i, std::memory_order_relaxed);
+}
+
+bool IRAM_ATTR LogRing::push(const LogRecord& r) {
+    uint32_t pos = _head.load(std::memory_order_relaxed);
+    Slot*    slot;
+    for (;;) {
+        slot = &_slots[pos & (kCapacity - 1)];
+        uint32_t seq  = slot->seq.load(std::memory_order_acquire);
+        int32_t  diff = static_cast<int32_t>(seq - pos);
+        if (diff == 0) {
+            // Free: claim it (pos is reloaded on failure)
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // Still holds the record from one lap ago: full
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = _head.load(std::memory_order_relaxed);   // another producer took it
+        }
+    }
+    slot->rec = r;
+    slot->seq.store(pos + 1, std::memory_order_release);
+    _pushed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool LogRing::pop(LogRecord& out) {
+    Slot&    slot = _slots[_tail & (kCapacity - 1)];
+    uint32_t seq  = slot.seq.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(seq - (_tail + 1)) < 0) return false;   // empty, or still being written
+
+    uint32_t depth = _head.load(std::memory_order_relaxed) - _tail;
+    if (depth > _maxDepth) _maxDepth = depth;
+
+    out = slot.rec;
+    slot.seq.store(_tail + kCapacity, std::memory_order_release);
+    _tail++;
+    return true;
+}
+
+// ----------------------------------------------------------
+//  Formatting
+// ----------------------------------------------------------
+size_t formatLogRecord(const char* fmt, const LogRecord& r, char* out, size_t len) {
+    if (len == 0) return 0;
+    size_t n   = 0;
+    int    arg = 0;
+    auto put = [&](const char* s, size_t k) {
+        for (size_t i = 0; i < k && n + 1 < len; i++) out[n++] = s[i];
+    };
+
+    for (const char* p = fmt; *p; ) {
+        if (*p != '%') {
+            put(p++, 1);
+            continue;
+        }
+        if (p[1] == '%') {
+            put("%", 1);
+            p += 2;
+            continue;
+        }
+        // One conversion: flags, width, precision, (ignored) length, type
+        const char* start = p++;
+        while (*p && std::strchr("-+ #0", *p)) p++;
+        while (*p >= '0' && *p <= '9') p++;
+        if (*p == '.') {
+            p++;
+            while (*p >= '0' && *p <= '9') p++;
+        }
+        while (*p == 'l' || *p == 'h') p++;
+        char type = *p;
+        if (!type) break;
+        p++;
+
+        if (arg >= r.nargs) {
+            put("?", 1);
+            continue;
+        }
+        uint32_t v = r.args[arg++];
+
+        char spec[16];
+        size_t specLen = 0;
+        for (const char* s = start; s < p - 1 && specLen < sizeof(spec) - 2; s++) {
+            if (*s != 'l' && *s != 'h') spec[specLen++] = *s;
+        }
+        spec[specLen++] = type;
+        spec[specLen]   = '\0';
+
+        char buf[32];
+        int  k;
+        switch (type) {
+        case 'd': case 'i':
+            k = std::snprintf(buf, sizeof(buf), spec, static_cast<int>(static_cast<int32_t>(v)));
+            break;
+        case 'u': case 'x': case 'X': case 'c':
+            k = std::snprintf(buf, sizeof(buf), spec, static_cast<unsigned>(v));
+            break;
+        case 'f': case 'e': case 'g': {
+            float f;
+            std::memcpy(&f, &v, sizeof(f));
+            k = std::snprintf(buf, sizeof(buf), spec, static_cast<double>(f));
+            break;
+        }
+        case 'B':
+            k = std::snprintf(buf, sizeof(buf), "%s", v ? "ON" : "OFF");
+            break;
+        default:
+            k = std::snprintf(buf, sizeof(buf), "?");
+            break;
+        }
+        if (k > 0) put(buf, std::min(static_cast<size_t>(k), sizeof(buf) - 1));
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// ----------------------------------------------------------
+//  Binary frame
+// ----------------------------------------------------------
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), as the telemetry stream
+static uint16_t crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+void encodeLogFrame(const LogRecord& r, uint8_t* out) {
+    out[0] = kLogSync0;
+    out[1] = kLogSync1;
+    out[2] = kLogFrameVersion;
+    std::memcpy(out + 3, &r, sizeof(r));
+    uint16_t crc = crc16(out, 3 + sizeof(r));
+    out[3 + sizeof(r)]     = static_cast<uint8_t>(crc & 0xFF);
+    out[3 + sizeof(r) + 1] = static_cast<uint8_t>(crc >> 8);
+}
@@ -8,27 +8,33 @@
 namespace N2kSenders {
 
 // ----------------------------------------------------------
-void sendEngineRapidUpdate(tNMEA2000& nmea2000,
-                           uint8_t    engineInstance,
-                           double     rpmValue) {
-    tN2kMsg msg;
+void buildEngineRapidUpdate(tN2kMsg& msg,
+                            uint8_t  engineInstance,
+                            double   rpmValue) {
     // boost pressure and trim not applicable on MD7A — pass NA
     SetN2kEngineParamRapid(msg,
                            engineInstance,
                            rpmValue,
                            N2kDoubleNA,   // boost pressure (Pa)
                            N2kInt8NA);    // trim
-    nmea2000.SendMsg(msg);
 }
 
-// ----------------------------------------------------------
-void sendEngineDynamic(tNMEA2000& nmea2000,
-                       uint8_t    engineInstance,
-                       double     coolantTempK,
-                       bool       oilPressureLow,
-                       bool       overTemperature) {
-
+bool sendEngineRapidUpdate(tNMEA2000& nmea2000,
+                           uint8_t    engineInstance,
+                           double     rpmValue) {
     tN2kMsg msg;
+    buildEngineRapidUpdate(msg, engineInstance, rpmValue);
+    return nmea2000.SendMsg(msg);
+}
+
+// ----------------------------------------------------------
+void buildEngineDynamic(tN2kMsg& msg,
+                        uint8_t  engineInstance,
+                        double   coolantTempK,
+                        double   engineHoursS,
+                        double   fuelRateLph,
+                        bool     oilPressureLow,
+                        bool     overTemperature) {
     tN2kEngineDiscreteStatus1 status1 = {};
     tN2kEngineDiscreteStatus2 status2 = {};
 
@@ -42,60 +48,101 @@ void sendEngineDynamic(tNMEA2000& nmea2000,
                              N2kDoubleNA,   // EngineOilTemp   — not measurable on MD7A
                              coolantTempK,  // EngineCoolantTemp (K)
                              N2kDoubleNA,   // AlternatorVoltage — not measurable on MD7A
-                             N2kDoubleNA,   // FuelRate
-                             N2kDoubleNA,   // EngineHours
+                             fuelRateLph,   // FuelRate (L/h)
+                             engineHoursS,  // EngineHours (s)
                              N2kDoubleNA,   // EngineCoolantPressure
                              N2kDoubleNA,   // FuelPressure
                              N2kInt8NA,     // EngineLoad
                              N2kInt8NA,     // EngineTorque
                              status1,
                              status2);
-    nmea2000.SendMsg(msg);
 }
 
-// ----------------------------------------------------------
-void sendBinaryStatus(tNMEA2000& nmea2000,
-                      uint8_t    bankInstance,
-                      bool       relayOn) {
+bool sendEngineDynamic(tNMEA2000& nmea2000,
+                       uint8_t    engineInstance,
+                       double     coolantTempK,
+                       double     engineHoursS,
+                       double     fuelRateLph,
+                       bool       oilPressureLow,
+                       bool       overTemperature) {
     tN2kMsg msg;
+    buildEngineDynamic(msg, engineInstance, coolantTempK, engineHoursS, fuelRateLph,
+                       oilPressureLow, overTemperature);
+    return nmea2000.SendMsg(msg);
+}
+
+// ----------------------------------------------------------
+void buildBinaryStatus(tN2kMsg& msg,
+                       uint8_t  bankInstance,
+                       bool     relayOn) {
     tN2kBinaryStatus bankStatus;
     N2kResetBinaryStatus(bankStatus);
     N2kSetStatusBinaryOnStatus(bankStatus,
                                relayOn ? N2kOnOff_On : N2kOnOff_Off,
                                1);  // switch index 1 (1-based in library)
     SetN2kBinaryStatus(msg, bankInstance, bankStatus);
+}
+
+void sendBinaryStatus(tNMEA2000& nmea2000,
+                      uint8_t    bankInstance,
+                      bool       relayOn) {
+    tN2kMsg msg;
+    buildBinaryStatus(msg, bankInstance, relayOn);
     nmea2000.SendMsg(msg);
 }
 
 // ----------------------------------------------------------
-void sendFluidLevel(tNMEA2000&    nmea2000,
-                    uint8_t       tankInstance,
-                    tN2kFluidType fluidType,
-                    double        levelPct,
-                    double        capacityL) {
-    tN2kMsg msg;
+void buildFluidLevel(tN2kMsg&      msg,
+                     uint8_t       tankInstance,
+                     tN2kFluidType fluidType,
+                     double        levelPct,
+                     double        capacityL) {
     SetN2kFluidLevel(msg,
                      tankInstance,
                      fluidType,
                      levelPct,
                      capacityL);
-    nmea2000.SendMsg(msg);
 }
 
-// ----------------------------------------------------------
-void sendTemperatureExtended(tNMEA2000&     nmea2000,
-                             uint8_t        sensorInstance,
-                             tN2kTempSource source,
-                             double         actualTempK,
-                             double         setTempK) {
+bool sendFluidLevel(tNMEA2000&    nmea2000,
+                    uint8_t       tankInstance,
+                    tN2kFluidType fluidType,
+                    double        levelPct,
+                    double        capacityL) {
     tN2kMsg msg;
+    buildFluidLevel(msg, tankInstance, fluidType, levelPct, capacityL);
+    return nmea2000.SendMsg(msg);
+}
+
+// ----------------------------------------------------------
+void buildTemperatureExtended(tN2kMsg&       msg,
+                              uint8_t        sid,
+                              uint8_t        sensorInstance,
+                              tN2kTempSource source,
+                              double         actualTempK,
+                              double         setTempK) {
     SetN2kTemperatureExt(msg,
-                         0xFF,            // SID — not used
+                         sid,
                          sensorInstance,
                          source,
                          actualTempK,
                          setTempK);
-    nmea2000.SendMsg(msg);
+}
+
+bool sendTemperatureExtended(tNMEA2000&     nmea2000,
+                             uint8_t        sid,
+                             uint8_t        sensorInstance,
+                             tN2kTempSource source,
+                             double         actualTempK,
+                             double         setTempK) {
+    tN2kMsg msg;
+    buildTemperatureExtended(msg, sid, sensorInstance, source, actualTempK, setTempK);
+    return nmea2000.SendMsg(msg);
+}
+
+// ----------------------------------------------------------
+uint8_t sidFor(uint32_t acquiredMs, uint32_t periodMs) {
+    return static_cast<uint8_t>((acquiredMs / periodMs) % 253);
 }
 
 }  // namespace N2kSenders
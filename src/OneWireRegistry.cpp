@@ -0,0 +1,62 @@
+#include "OneWireRegistry.h"
+
+#include "halmet_config.h"
+#include "onewire_setup.h"
+
+// ============================================================
+//  OneWireRegistry.cpp
+// ============================================================
+
+bool OneWireEntry::fresh(uint32_t now) const {
+    if (sampleMs == 0 || dest < 0 || dest >= kNumTempDests) return false;
+    return now - sampleMs <= ONEWIRE_STALE_INTERVALS * kTempDests[dest].intervalMs;   // wrap-safe
+}
+
+uint32_t OneWireRegistry::romHash(const OneWireRom& rom) {
+    // Bytes 1–6 are the factory serial; fold them with the family
+    // code and mix (64-bit Fibonacci hashing, top 32 bits).
+    uint64_t key = 0;
+    for (int i = 0; i < 7; i++) key = (key << 8) | rom[i];
+    return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+int OneWireRegistry::find(const OneWireRom& rom) const {
+    if (_index.empty()) return -1;
+    size_t mask = _index.size() - 1;
+    for (size_t b = romHash(rom) & mask;; b = (b + 1) & mask) {
+        int32_t e = _index[b];
+        if (e < 0) return -1;
+        if (_entries[e].rom == rom) return e;
+    }
+}
+
+size_t OneWireRegistry::add(const OneWireRom& rom, uint8_t bus) {
+    int existing = find(rom);
+    if (existing >= 0) return static_cast<size_t>(existing);
+
+    OneWireEntry e;
+    e.rom = rom;
+    e.bus = bus;
+    _entries.push_back(e);
+
+    // Keep the load factor at or below 1/2
+    if (_entries.size() * 2 > _index.size()) {
+        rebuildIndex(_index.empty() ? 16 : _index.size() * 2);
+    } else {
+        size_t mask = _index.size() - 1;
+        size_t b    = romHash(rom) & mask;
+        while (_index[b] >= 0) b = (b + 1) & mask;
+        _index[b] = static_cast<int32_t>(_entries.size() - 1);
+    }
+    return _entries.size() - 1;
+}
+
+void OneWireRegistry::rebuildIndex(size_t buckets) {
+    _index.assign(buckets, -1);
+    size_t mask = buckets - 1;
+    for (size_t i = 0; i < _entries.size(); i++) {
+        size_t b = romHash(_entries[i].rom) & mask;
+        while (_index[b] >= 0) b = (b + 1) & mask;
+        _index[b] = static_cast<int32_t>(i);
+    }
+}
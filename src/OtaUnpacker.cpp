@@ -0,0 +1,141 @@
+#include "OtaUnpacker.h"
+
+#include <cstring>
+
+// ============================================================
+//  OtaUnpacker.cpp
+// ============================================================
+
+namespace {
+
+uint32_t crc32Update(uint32_t crc, uint8_t b) {
+    crc ^= b;
+    for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    return crc;
+}
+
+}  // namespace
+
+const char* otaStatusName(OtaStatus s) {
+    switch (s) {
+        case OtaStatus::OK:             return "ok";
+        case OtaStatus::BAD_MAGIC:      return "not a compressed image";
+        case OtaStatus::BAD_VERSION:    return "unsupported image version";
+        case OtaStatus::TOO_LARGE:      return "image larger than the partition";
+        case OtaStatus::CORRUPT_STREAM: return "corrupt compressed stream";
+        case OtaStatus::OVERRUN:        return "more data than the header declares";
+        case OtaStatus::TRUNCATED:      return "image truncated";
+        case OtaStatus::CRC_MISMATCH:   return "payload CRC mismatch";
+        case OtaStatus::WRITE_FAILED:   return "flash write failed";
+    }
+    return "?";
+}
+
+OtaUnpacker::OtaUnpacker(OtaSink sink, void* ctx, uint32_t maxImageLen)
+    : _sink(sink), _ctx(ctx), _maxImageLen(maxImageLen) {}
+
+// ----------------------------------------------------------
+OtaStatus OtaUnpacker::checkHeader() {
+    if (_hdr.magic != kOtaImageMagic) return fail(OtaStatus::BAD_MAGIC);
+    if (_hdr.version != kOtaImageVersion) return fail(OtaStatus::BAD_VERSION);
+    switch (static_cast<OtaAlgo>(_hdr.algo)) {
+        case OtaAlgo::STORED:
+            if (_hdr.payloadLen != _hdr.imageLen) return fail(OtaStatus::BAD_VERSION);
+            break;
+        case OtaAlgo::LZSS:
+            if (_hdr.windowBits != 12) return fail(OtaStatus::BAD_VERSION);
+            break;
+        default:
+            return fail(OtaStatus::BAD_VERSION);
+    }
+    if (_hdr.imageLen > _maxImageLen) return fail(OtaStatus::TOO_LARGE);
+    return OtaStatus::OK;
+}
+
+// ----------------------------------------------------------
+bool OtaUnpacker::flush() {
+    size_t n = _out - _flushed;
+    if (n == 0) return true;
+    // _flushed is a multiple of kWindow until the final block
+    if (!_sink(_ctx, _win, n)) return false;
+    _flushed = _out;
+    return true;
+}
+
+bool OtaUnpacker::put(uint8_t b) {
+    if (_out - _flushed == kWindow && !flush()) {
+        _status = OtaStatus::WRITE_FAILED;
+        return false;
+    }
+    _win[_out % kWindow] = b;
+    _out++;
+    return true;
+}
+
+OtaStatus OtaUnpacker::decode(uint8_t b) {
+    if (_flagsLeft == 0) {
+        _flags     = b;
+        _flagsLeft = 8;
+        return OtaStatus::OK;
+    }
+
+    if (_flags & 1) {                                   // literal
+        if (_out >= _hdr.imageLen) return fail(OtaStatus::OVERRUN);
+        if (!put(b)) return _status;
+    } else if (!_haveB0) {                              // first half of a match
+        _b0     = b;
+        _haveB0 = true;
+        return OtaStatus::OK;
+    } else {                                            // back-reference
+        _haveB0       = false;
+        uint32_t dist = (static_cast<uint32_t>(_b0) | ((b & 0x0Fu) << 8)) + 1;
+        uint32_t len  = (b >> 4) + 3;
+        if (dist > _out) return fail(OtaStatus::CORRUPT_STREAM);
+        if (_out + len > _hdr.imageLen) return fail(OtaStatus::OVERRUN);
+        for (uint32_t i = 0; i < len; i++) {
+            if (!put(_win[(_out - dist) % kWindow])) return _status;
+        }
+    }
+    _flags >>= 1;
+    _flagsLeft--;
+    return OtaStatus::OK;
+}
+
+// ----------------------------------------------------------
+OtaStatus OtaUnpacker::feed(const uint8_t* data, size_t len) {
+    if (_status != OtaStatus::OK) return _status;
+
+    size_t i = 0;
+    if (!headerDone()) {
+        size_t n = sizeof(OtaImageHeader) - _hdrGot;
+        if (n > len) n = len;
+        memcpy(reinterpret_cast<uint8_t*>(&_hdr) + _hdrGot, data, n);
+        _hdrGot += n;
+        i        = n;
+        if (headerDone() && checkHeader() != OtaStatus::OK) return _status;
+    }
+
+    if (_payloadIn + (len - i) > _hdr.payloadLen) return fail(OtaStatus::OVERRUN);
+
+    const bool stored = _hdr.algo == static_cast<uint8_t>(OtaAlgo::STORED);
+    for (; i < len; i++) {
+        uint8_t b = data[i];
+        _crc = crc32Update(_crc, b);
+        _payloadIn++;
+        if (stored) {
+            if (!put(b)) return _status;
+        } else if (decode(b) != OtaStatus::OK) {
+            return _status;
+        }
+    }
+    return OtaStatus::OK;
+}
+
+OtaStatus OtaUnpacker::finish() {
+    if (_status != OtaStatus::OK) return _status;
+    if (!headerDone() || _payloadIn != _hdr.payloadLen) return fail(OtaStatus::TRUNCATED);
+    if (~_crc != _hdr.payloadCrc) return fail(OtaStatus::CRC_MISMATCH);
+    if (_out != _hdr.imageLen || _haveB0) return fail(OtaStatus::TRUNCATED);
+    if (!flush()) return fail(OtaStatus::WRITE_FAILED);
+    return OtaStatus::OK;
+}
@@ -0,0 +1,42 @@
+#include "PayloadQueue.h"
+
+#include <cstring>
+
+// ============================================================
+//  PayloadQueue.cpp
+// ============================================================
+
+PayloadQueue::PayloadQueue(uint8_t* buf, size_t slots, size_t slotBytes)
+    : _buf(buf), _slots(slots), _slotBytes(slotBytes) {}
+
+bool PayloadQueue::push(const uint8_t* data, size_t len) {
+    if (len > maxPayload() || len > 0xFFFF || _slots == 0) {
+        _rejected++;
+        return false;
+    }
+    if (_depth == _slots) {
+        pop();
+        _dropped++;
+    }
+    uint8_t* s = slot((_head + _depth) % _slots);
+    s[0] = static_cast<uint8_t>(len);
+    s[1] = static_cast<uint8_t>(len >> 8);
+    memcpy(s + 2, data, len);
+    _depth++;
+    _pushed++;
+    if (_depth > _maxDepth) _maxDepth = _depth;
+    return true;
+}
+
+const uint8_t* PayloadQueue::front(size_t& len) const {
+    if (_depth == 0) return nullptr;
+    const uint8_t* s = slot(_head);
+    len = s[0] | (static_cast<size_t>(s[1]) << 8);
+    return s + 2;
+}
+
+void PayloadQueue::pop() {
+    if (_depth == 0) return;
+    _head = (_head + 1) % _slots;
+    _depth--;
+}
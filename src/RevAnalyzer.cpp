@@ -0,0 +1,154 @@
+#include "RevAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Fft.h"
+
+// ============================================================
+//  RevAnalyzer.cpp
+// ============================================================
+
+static_assert((RevAnalyzer::kBlock & (RevAnalyzer::kBlock - 1)) == 0 &&
+              RevAnalyzer::kBlock <= kMaxFft, "kBlock must be a power of two FFT size");
+
+// An interval this far from the block median is a missing or extra
+// edge, not combustion: cyclic variation at idle is a few percent.
+static constexpr float kGlitchLow  = 0.6f;
+static constexpr float kGlitchHigh = 1.67f;
+
+// Roughness band, in orders: everything combustion-related below
+// the alternator's own pole-spacing pattern
+static constexpr float kBandLowOrder  = 0.25f;
+static constexpr float kBandHighOrder = 4.25f;
+
+// Hann: coherent gain 0.5, equivalent noise bandwidth 1.5 bins.  A
+// sinusoid's energy lands within ±2 bins of its centre.
+static constexpr float kHannEnbw  = 1.5f;
+static constexpr int   kLobeBins  = 2;
+
+RevAnalyzer::RevAnalyzer(float minRpm) : _minRpm(minRpm) {
+    for (int i = 0; i < kBlock; i++) {
+        _window[i] = 0.5f * (1.0f - std::cos(2.0f * static_cast<float>(M_PI) * i / kBlock));
+    }
+}
+
+void RevAnalyzer::feed(const uint32_t* edgesUs, int n) {
+    for (int i = 0; i < n; i++) {
+        uint32_t t = edgesUs[i];
+        if (!_haveEdge) {
+            _haveEdge = true;
+            _lastUs   = t;
+            continue;
+        }
+        uint32_t d = t - _lastUs;
+        _lastUs = t;
+        if (d > kMaxGapUs) {   // stopped, or stalled in between
+            _fill = 0;
+            continue;
+        }
+        _collect[_fill++] = d;
+        if (_fill == kBlock) {
+            if (_pending) _dropped++;
+            std::memcpy(_block, _collect, sizeof(_block));
+            _blockEndUs = t;
+            _pending    = true;
+            _fill       = 0;
+        }
+    }
+}
+
+void RevAnalyzer::restart() {
+    _haveEdge = false;
+    _fill     = 0;
+}
+
+void RevAnalyzer::discard() {
+    if (!_pending) return;
+    _pending = false;
+    _dropped++;
+}
+
+bool RevAnalyzer::analyze(float pulsesPerRev) {
+    if (!_pending) return false;
+    _pending = false;
+    if (!(pulsesPerRev > 0.0f)) {
+        _rejected++;
+        return false;
+    }
+    constexpr int N = kBlock;
+
+    // Median interval (the FFT buffer is free scratch until later)
+    float* tmp = _work;
+    for (int i = 0; i < N; i++) tmp[i] = static_cast<float>(_block[i]);
+    std::nth_element(tmp, tmp + N / 2, tmp + N);
+    float median = tmp[N / 2];
+    for (int i = 0; i < N; i++) {
+        float d = static_cast<float>(_block[i]);
+        if (d < kGlitchLow * median || d > kGlitchHigh * median) {
+            _rejected++;
+            return false;
+        }
+    }
+
+    // Instantaneous speed of each interval, mean and linear trend
+    float  k   = 60.0e6f / pulsesPerRev;
+    double sum = 0.0, sumXS = 0.0, sumXX = 0.0;
+    for (int i = 0; i < N; i++) {
+        float s = k / static_cast<float>(_block[i]);
+        tmp[i] = s;
+        sum += s;
+    }
+    float mean = static_cast<float>(sum / N);
+    if (mean < _minRpm) {
+        _rejected++;
+        return false;
+    }
+    for (int i = 0; i < N; i++) {
+        double x = i - (N - 1) / 2.0;
+        sumXS += x * (tmp[i] - mean);
+        sumXX += x * x;
+    }
+    float slope = static_cast<float>(sumXS / sumXX);
+
+    // Detrended, windowed, zero imaginary part.  Back to front so
+    // the interleaved writes do not overtake the speeds still unread.
+    for (int i = N - 1; i >= 0; i--) {
+        float r = tmp[i] - mean - slope * (i - (N - 1) / 2.0f);
+        _work[2 * i]     = r * _window[i];
+        _work[2 * i + 1] = 0.0f;
+    }
+    fft(_work, N);
+
+    // Peak amplitude² of bin b: (|X| / (N/2 · coherent gain))²
+    auto amp2 = [this](int b) {
+        float re = _work[2 * b], im = _work[2 * b + 1];
+        return (re * re + im * im) * (16.0f / (static_cast<float>(N) * N));
+    };
+    float binsPerOrder = N / pulsesPerRev;
+    int   lastBin      = N / 2 - 1;
+
+    int   lo = std::max(1, static_cast<int>(std::ceil(kBandLowOrder * binsPerOrder)));
+    int   hi = std::min(lastBin, static_cast<int>(std::floor(kBandHighOrder * binsPerOrder)));
+    float band = 0.0f;
+    for (int b = lo; b <= hi; b++) band += amp2(b);
+    // Σ A² / ENBW = Σ of the sinusoids' peak², RMS = peak / √2
+    _result.roughness = std::sqrt(band / kHannEnbw / 2.0f) / mean;
+
+    for (int o = 0; o < kOrders; o++) {
+        int c = static_cast<int>(std::lround(order(o) * binsPerOrder));
+        if (c + kLobeBins > lastBin) {   // above Nyquist at this pulsesPerRev
+            _result.orderRpm[o] = NAN;
+            continue;
+        }
+        float e = 0.0f;
+        for (int b = std::max(1, c - kLobeBins); b <= c + kLobeBins; b++) e += amp2(b);
+        _result.orderRpm[o] = std::sqrt(e / kHannEnbw);
+    }
+
+    _result.rpm   = mean;
+    _result.endUs = _blockEndUs;
+    _analysed++;
+    return true;
+}
@@ -7,13 +7,44 @@
 // Static members shared with the ISR
 volatile uint32_t RpmSensor::_pulseCount    = 0;
 volatile uint32_t RpmSensor::_lastPulseTime = 0;
+volatile uint32_t RpmSensor::_edgeUs[REV_EDGE_RING] = {};
+volatile uint32_t RpmSensor::_edgeHead      = 0;
 
 // ----------------------------------------------------------
 //  ISR  — runs in IRAM, counts every falling edge
 // ----------------------------------------------------------
 void IRAM_ATTR RpmSensor::isrHandler() {
+    uint32_t t = micros();
     _pulseCount = _pulseCount + 1;  // avoid deprecated volatile++ in C++20
-    _lastPulseTime = micros();
+    _lastPulseTime = t;
+    // Slot first, then head: a reader that sees the new head sees the slot
+    uint32_t h = _edgeHead;
+    _edgeUs[h & (REV_EDGE_RING - 1)] = t;
+    _edgeHead = h + 1;
+}
+
+// ----------------------------------------------------------
+//  Edge ring reader (rev_analysis task)
+// ----------------------------------------------------------
+size_t RpmSensor::readEdges(uint32_t& cursor, uint32_t* out, size_t max, uint32_t& lost) {
+    uint32_t head  = _edgeHead;
+    uint32_t avail = head - cursor;
+    if (avail > REV_EDGE_RING) {
+        lost  += avail - REV_EDGE_RING;
+        cursor = head - REV_EDGE_RING;
+        avail  = REV_EDGE_RING;
+    }
+    size_t n = avail < max ? avail : max;
+    for (size_t i = 0; i < n; i++) out[i] = _edgeUs[(cursor + i) & (REV_EDGE_RING - 1)];
+
+    // The ISR may have lapped the copy; then none of it can be trusted
+    if (_edgeHead - cursor > REV_EDGE_RING) {
+        lost  += n;
+        cursor += n;
+        return 0;
+    }
+    cursor += n;
+    return n;
 }
 
 // ----------------------------------------------------------
@@ -37,6 +68,7 @@ float RpmSensor::update() {
     unsigned long now   = millis();
     unsigned long dtMs  = now - _lastUpdateMs;
     if (dtMs == 0) return _smoothedRpm;
+    unsigned long startMs = _lastUpdateMs;
     _lastUpdateMs = now;
 
     // Atomically snapshot and clear the counter
@@ -48,9 +80,11 @@ float RpmSensor::update() {
     // Compute instantaneous RPM from pulse count over the elapsed interval
     float instantHz  = (float)pulses / (dtMs / 1000.0f);
     float instantRpm = (instantHz / _pulsesPerRev) * 60.0f;
+    _instantRpm = instantRpm;
 
     // Moving-average smoothing
     _samples[_sampleIdx] = instantRpm;
+    _startMs[_sampleIdx] = startMs;
     _sampleIdx = (_sampleIdx + 1) % _smoothingSamples;
     if (_sampleCount < _smoothingSamples) _sampleCount++;
 
@@ -58,6 +92,10 @@ float RpmSensor::update() {
     for (int i = 0; i < _sampleCount; i++) sum += _samples[i];
     _smoothedRpm = sum / _sampleCount;
 
+    // The average covers the oldest buffered interval's start to now
+    uint32_t oldestMs = _startMs[_sampleCount < _smoothingSamples ? 0 : _sampleIdx];
+    _acquiredMs = oldestMs + (now - oldestMs) / 2;
+
     // If no pulses in the last 2 seconds, engine is definitely stopped
     noInterrupts();
     uint32_t lastPulse = _lastPulseTime;
@@ -66,7 +104,9 @@ float RpmSensor::update() {
         _smoothedRpm = 0.0f;
         // Reset moving-average buffer so stale values don't linger
         for (int i = 0; i < kMaxSamples; i++) _samples[i] = 0.0f;
+        _sampleIdx   = 0;   // the average reads slots 0.._sampleCount-1
         _sampleCount = 0;
+        _acquiredMs  = now;
     }
 
     return _smoothedRpm;
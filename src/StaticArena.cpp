@@ -0,0 +1,58 @@
+#include "StaticArena.h"
+
+#include <cstring>
+
+// ============================================================
+//  StaticArena.cpp
+// ============================================================
+
+StaticArena::StaticArena(void* buf, size_t capacity)
+    : _buf(static_cast<uint8_t*>(buf)), _capacity(capacity) {}
+
+const char* StaticArena::setModule(const char* name) {
+    const char* prev = _current;
+    _current = name;
+    return prev;
+}
+
+StaticArena::Module* StaticArena::entry(const char* name) {
+    if (!name) name = "unassigned";
+    for (int i = 0; i < _nModules; i++) {
+        if (strcmp(_modules[i].name, name) == 0) return &_modules[i];
+    }
+    // The last slot collects every module the table has no room for
+    if (_nModules == kMaxModules) return &_modules[kMaxModules - 1];
+    Module& m = _modules[_nModules++];
+    m.name = (_nModules == kMaxModules) ? "other" : name;
+    return &m;
+}
+
+void* StaticArena::allocate(size_t size, size_t align) {
+    Module* m = entry(_current);
+    if (align == 0) align = 1;
+
+    uintptr_t base = reinterpret_cast<uintptr_t>(_buf) + _used;
+    size_t    pad  = (align - (base & (align - 1))) & (align - 1);
+    if (pad > _capacity - _used || size > _capacity - _used - pad) {
+        m->failed++;
+        m->failedBytes += size;
+        return nullptr;
+    }
+
+    void* p = _buf + _used + pad;
+    _used      += pad + size;
+    m->bytes   += pad + size;
+    m->objects++;
+    if (_sealed) {
+        _late++;
+        _lateBytes += size;
+    }
+    return p;
+}
+
+const StaticArena::Module* StaticArena::find(const char* name) const {
+    for (int i = 0; i < _nModules; i++) {
+        if (strcmp(_modules[i].name, name) == 0) return &_modules[i];
+    }
+    return nullptr;
+}
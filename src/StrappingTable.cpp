@@ -0,0 +1,92 @@
+#include "StrappingTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ============================================================
+//  StrappingTable.cpp
+// ============================================================
+
+const char* strappingStatusName(StrappingStatus s) {
+    switch (s) {
+        case StrappingStatus::OK:              return "ok";
+        case StrappingStatus::TOO_FEW_POINTS:  return "fewer than 2 points";
+        case StrappingStatus::TOO_MANY_POINTS: return "too many points";
+        case StrappingStatus::BAD_VALUE:       return "non-numeric or negative value";
+        case StrappingStatus::DUPLICATE_OHMS:  return "two points at the same resistance";
+        case StrappingStatus::NOT_MONOTONIC:   return "height/volume not monotonic in resistance";
+    }
+    return "?";
+}
+
+StrappingStatus StrappingTable::compile(Point* pts, int n) {
+    if (n < 2)          return StrappingStatus::TOO_FEW_POINTS;
+    if (n > kMaxPoints) return StrappingStatus::TOO_MANY_POINTS;
+    for (int i = 0; i < n; i++) {
+        const Point& p = pts[i];
+        if (!std::isfinite(p.ohms) || !std::isfinite(p.heightMm) || !std::isfinite(p.litres)
+            || p.ohms < 0.0f) {
+            return StrappingStatus::BAD_VALUE;
+        }
+    }
+    std::sort(pts, pts + n, [](const Point& a, const Point& b) { return a.ohms < b.ohms; });
+
+    // Volume sets the direction; height must not run against it
+    int dir = 0;
+    for (int i = 0; i < n - 1 && dir == 0; i++) {
+        if (pts[i + 1].litres != pts[i].litres) dir = pts[i + 1].litres > pts[i].litres ? 1 : -1;
+    }
+    if (dir == 0) return StrappingStatus::NOT_MONOTONIC;
+    for (int i = 0; i < n - 1; i++) {
+        if (pts[i + 1].ohms == pts[i].ohms)                      return StrappingStatus::DUPLICATE_OHMS;
+        if ((pts[i + 1].litres - pts[i].litres) * dir < 0.0f)     return StrappingStatus::NOT_MONOTONIC;
+        if ((pts[i + 1].heightMm - pts[i].heightMm) * dir < 0.0f) return StrappingStatus::NOT_MONOTONIC;
+    }
+
+    // ---- Forward grid: resistance → height, litres ----
+    _r0    = pts[0].ohms;
+    _rStep = (pts[n - 1].ohms - _r0) / (kGridSize - 1);
+    _rInv  = 1.0f / _rStep;
+    for (int i = 0, j = 0; i < kGridSize; i++) {
+        float x = (i == kGridSize - 1) ? pts[n - 1].ohms : _r0 + i * _rStep;
+        while (j < n - 2 && pts[j + 1].ohms < x) j++;
+        const Point& a = pts[j];
+        const Point& b = pts[j + 1];
+        float t = std::min(1.0f, std::max(0.0f, (x - a.ohms) / (b.ohms - a.ohms)));
+        _fwdHeight[i] = a.heightMm + t * (b.heightMm - a.heightMm);
+        _fwdLitres[i] = a.litres   + t * (b.litres   - a.litres);
+    }
+
+    // ---- Inverse grid: litres → resistance (walk in volume order) ----
+    auto at = [&](int k) -> const Point& { return pts[dir > 0 ? k : n - 1 - k]; };
+    _v0    = at(0).litres;
+    _vStep = (at(n - 1).litres - _v0) / (kGridSize - 1);
+    _vInv  = 1.0f / _vStep;
+    for (int i = 0, j = 0; i < kGridSize; i++) {
+        float y = (i == kGridSize - 1) ? at(n - 1).litres : _v0 + i * _vStep;
+        while (j < n - 2 && at(j + 1).litres < y) j++;
+        const Point& a  = at(j);
+        const Point& b  = at(j + 1);
+        float        dv = b.litres - a.litres;
+        float        t  = dv > 0.0f ? std::min(1.0f, std::max(0.0f, (y - a.litres) / dv)) : 0.0f;
+        _invOhms[i] = a.ohms + t * (b.ohms - a.ohms);
+    }
+
+    _valid    = true;
+    _points   = n;
+    _gridErrL = 0.0f;
+    for (int i = 0; i < n; i++) {
+        _gridErrL = std::max(_gridErrL, std::fabs(litres(pts[i].ohms) - pts[i].litres));
+    }
+    return StrappingStatus::OK;
+}
+
+float StrappingTable::lookup(const float* grid, float x0, float inv, float x) const {
+    if (!_valid || std::isnan(x)) return NAN;
+    float f = (x - x0) * inv;
+    if (f <= 0.0f)                               return grid[0];
+    if (f >= static_cast<float>(kGridSize - 1)) return grid[kGridSize - 1];
+    int   i = static_cast<int>(f);
+    float t = f - static_cast<float>(i);
+    return grid[i] + t * (grid[i + 1] - grid[i]);
+}
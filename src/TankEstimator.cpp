@@ -0,0 +1,103 @@
+#include "TankEstimator.h"
+
+#include <cmath>
+
+// ============================================================
+//  TankEstimator.cpp
+// ============================================================
+
+TankEstimator::TankEstimator(const Tuning& t) : _t(t) {
+    if (_t.medianWindow < 1) _t.medianWindow = 1;
+    if (_t.medianWindow > kMaxWindow) _t.medianWindow = kMaxWindow;
+}
+
+float TankEstimator::median() const {
+    float v[kMaxWindow];
+    for (int i = 0; i < _n; i++) {
+        float x = _ring[i];
+        int   j = i;
+        for (; j > 0 && v[j - 1] > x; j--) v[j] = v[j - 1];
+        v[j] = x;
+    }
+    return (_n & 1) ? v[_n / 2] : 0.5f * (v[_n / 2 - 1] + v[_n / 2]);
+}
+
+void TankEstimator::update(float levelPct, bool engineRunning, float dtS) {
+    _ring[_head] = levelPct;
+    _head        = (_head + 1) % _t.medianWindow;
+    if (_n < _t.medianWindow) _n++;
+    _median = median();
+
+    const float r  = _t.levelSigmaPct * _t.levelSigmaPct;
+    const float q0 = _t.rateInitSigmaPctH * _t.rateInitSigmaPctH;
+    if (!_seeded) {
+        _seeded = true;
+        _level  = _median;
+        _rate   = 0.0f;
+        _p00 = r;
+        _p01 = 0.0f;
+        _p11 = q0;
+    }
+
+    // Engine context: a start begins the rate afresh; stopped = no burn
+    if (engineRunning && !_running) {
+        _runS = 0.0f;
+        _rate = 0.0f;
+        _p01  = 0.0f;
+        _p11  = q0;
+    }
+    _running = engineRunning;
+    if (!_running) {
+        _rate = 0.0f;
+        _p01  = 0.0f;
+    }
+
+    // ---- Predict: L -= q·dt ----
+    float dtH = dtS / 3600.0f;
+    if (dtH < 0.0f) dtH = 0.0f;
+    if (_running) {
+        _runS  += dtS;
+        _level -= _rate * dtH;
+        _p00   += -2.0f * dtH * _p01 + dtH * dtH * _p11;
+        _p01   -= dtH * _p11;
+        _p11   += _t.rateWalkPctH * _t.rateWalkPctH * dtH;
+    }
+    _p00 += _t.levelWalkPct * _t.levelWalkPct * dtH;
+
+    // ---- Update with the median ----
+    float y = _median - _level;
+    float s = _p00 + r;
+    if (y * y > _t.jumpSigma * _t.jumpSigma * s) {
+        if (++_outliers >= _t.jumpSamples) {
+            // Refuelled (or recalibrated): re-seed the level, keep the rate
+            _level    = _median;
+            _p00      = r;
+            _p01      = 0.0f;
+            _outliers = 0;
+            _jumps++;
+        }
+        return;         // a lone outlier is not evidence
+    }
+    _outliers = 0;
+
+    float k0 = _p00 / s;
+    float k1 = _running ? _p01 / s : 0.0f;
+    _level += k0 * y;
+    _rate  += k1 * y;
+    float p00 = _p00, p01 = _p01;
+    _p00 = (1.0f - k0) * p00;
+    _p01 = (1.0f - k0) * p01;
+    _p11 -= k1 * p01;
+    if (_p11 < 0.0f) _p11 = 0.0f;
+}
+
+float TankEstimator::rateSigmaPctH() const {
+    return _running ? std::sqrt(_p11) : 0.0f;
+}
+
+float TankEstimator::enduranceH(float minRatePctH) const {
+    if (!rateValid() || !_running) return -1.0f;
+    float q = ratePctH();
+    if (q < minRatePctH) return -1.0f;
+    return (_level > 0.0f ? _level : 0.0f) / q;
+}
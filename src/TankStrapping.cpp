@@ -0,0 +1,70 @@
+// ============================================================
+//  TankStrapping.cpp — Strapping table config, compiled on save
+// ============================================================
+
+#include "TankStrapping.h"
+
+#include <cmath>
+
+#include "halmet_config.h"
+
+TankStrapping::TankStrapping(float fullLitres, const String& configPath)
+    : sensesp::FileSystemSaveable(configPath) {
+    compileDefault(fullLitres);
+    load();
+}
+
+void TankStrapping::compileDefault(float fullLitres) {
+    if (!(fullLitres > 0.0f)) fullLitres = DEFAULT_TANK_CAPACITY_L;
+    compile({
+        { TANK_RESISTANCE_EMPTY_OHM, 0.0f,                   0.0f       },
+        { TANK_RESISTANCE_FULL_OHM,  DEFAULT_TANK_HEIGHT_MM, fullLitres },
+    });
+}
+
+void TankStrapping::setFullLitres(float fullLitres) {
+    if (_default) compileDefault(fullLitres);
+}
+
+bool TankStrapping::compile(std::vector<StrappingTable::Point> pts) {
+    _status = _table.compile(pts.data(), static_cast<int>(pts.size()));
+    if (_status != StrappingStatus::OK) {
+        ESP_LOGE("Tank", "Strapping table rejected (%d points): %s — keeping the previous table",
+                 (int)pts.size(), strappingStatusName(_status));
+        return false;
+    }
+    _points = std::move(pts);
+    ESP_LOGI("Tank", "Strapping table: %d points, %.0f–%.0f Ω, %.1f–%.1f L, grid error %.2f L",
+             _table.points(), _table.minOhms(), _table.maxOhms(),
+             _table.minLitres(), _table.maxLitres(), _table.gridErrorL());
+    return true;
+}
+
+bool TankStrapping::to_json(JsonObject& root) {
+    JsonArray arr = root["points"].to<JsonArray>();
+    for (const auto& p : _points) {
+        JsonObject o = arr.add<JsonObject>();
+        o["ohms"]   = p.ohms;
+        o["mm"]     = p.heightMm;
+        o["litres"] = p.litres;
+    }
+    return true;
+}
+
+bool TankStrapping::from_json(const JsonObject& root) {
+    JsonArray arr = root["points"].as<JsonArray>();
+    if (arr.isNull()) return false;
+    std::vector<StrappingTable::Point> pts;
+    pts.reserve(arr.size());
+    for (JsonObject o : arr) {
+        pts.push_back({ o["ohms"] | NAN, o["mm"] | NAN, o["litres"] | NAN });
+    }
+    if (!compile(std::move(pts))) return false;
+    _default = false;
+    return true;
+}
+
+const String ConfigSchema(const TankStrapping& obj) {
+    (void)obj;
+    return R"###({"type":"object","properties":{"points":{"title":"Strapping points (any order)","type":"array","format":"table","items":{"type":"object","properties":{"ohms":{"type":"number","title":"Sender resistance (Ω)"},"mm":{"type":"number","title":"Fuel height (mm)"},"litres":{"type":"number","title":"Volume (L)"}}}}}})###";
+}
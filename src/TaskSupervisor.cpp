@@ -0,0 +1,58 @@
+#include "TaskSupervisor.h"
+
+// ============================================================
+//  TaskSupervisor.cpp
+// ============================================================
+
+int TaskSupervisor::add(const char* name, uint32_t deadlineMs, bool critical, uint32_t nowMs) {
+    if (_count >= kMaxTasks) return -1;
+    Task& t      = _tasks[_count];
+    t            = {};
+    t.name       = name;
+    t.deadlineMs = deadlineMs;
+    t.critical   = critical;
+    t.lastMs     = nowMs;
+    return _count++;
+}
+
+void TaskSupervisor::checkIn(int id, uint32_t nowMs) {
+    if (id < 0 || id >= _count) return;
+    Task&    t   = _tasks[id];
+    uint32_t gap = nowMs - t.lastMs;
+    if (t.started && gap > t.maxGapMs) t.maxGapMs = gap;
+    t.lastMs  = nowMs;
+    t.started = true;
+}
+
+bool TaskSupervisor::check(uint32_t nowMs) {
+    bool     healthy   = true;
+    uint32_t worstOver = 0;
+    _worst = -1;
+    for (int i = 0; i < _count; i++) {
+        Task& t = _tasks[i];
+        if (!t.critical && !t.started) {
+            t.overdue = false;
+            continue;
+        }
+        uint32_t age  = nowMs - t.lastMs;
+        bool     late = age > t.deadlineMs;
+        if (late && !t.overdue) t.misses++;
+        t.overdue = late;
+        if (!late || !t.critical) continue;
+
+        healthy = false;
+        if (_worst < 0 || age - t.deadlineMs > worstOver) {
+            worstOver = age - t.deadlineMs;
+            _worst    = i;
+        }
+    }
+    return healthy;
+}
+
+void TaskSupervisor::restart(uint32_t nowMs) {
+    for (int i = 0; i < _count; i++) {
+        _tasks[i].lastMs  = nowMs;
+        _tasks[i].overdue = false;
+    }
+    _worst = -1;
+}
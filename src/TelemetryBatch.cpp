@@ -0,0 +1,46 @@
+#include "TelemetryBatch.h"
+
+#include "CompactEncoder.h"
+
+// ============================================================
+//  TelemetryBatch.cpp
+// ============================================================
+
+TelemetryBatch::TelemetryBatch(const Column* cols, int nCols)
+    : _cols(cols), _nCols(nCols < kMaxColumns ? nCols : kMaxColumns) {}
+
+bool TelemetryBatch::add(uint32_t ms, const float* values) {
+    if (full()) return false;
+    if (_n == 0) _firstMs = ms;
+    _dtMs[_n] = ms - _firstMs;
+    for (int c = 0; c < _nCols; c++) _v[_n][c] = values[c];
+    _n++;
+    return true;
+}
+
+void TelemetryBatch::encode(CompactEncoder& e, int64_t utcMs, uint32_t extraPairs) const {
+    e.beginMap(kBatchKeys + extraPairs);
+
+    e.putStr("v");
+    e.putUint(kVersion);
+    e.putStr("t0");
+    e.putUint(_firstMs);
+    e.putStr("utc");
+    if (utcMs >= 0) e.putUint(static_cast<uint64_t>(utcMs));
+    else            e.putNull();
+
+    e.putStr("f");
+    e.beginArray(_nCols);
+    for (int c = 0; c < _nCols; c++) e.putStr(_cols[c].name);
+    e.putStr("s");
+    e.beginArray(_nCols);
+    for (int c = 0; c < _nCols; c++) e.putFloat(_cols[c].scale);
+
+    e.putStr("r");
+    e.beginArray(_n);
+    for (int i = 0; i < _n; i++) {
+        e.beginArray(_nCols + 1);
+        e.putUint(_dtMs[i]);
+        for (int c = 0; c < _nCols; c++) e.putScaled(_v[i][c], _cols[c].scale);
+    }
+}
@@ -0,0 +1,28 @@
+// ============================================================
+//  ads_channels.cpp — ADS1115 analog channel map
+//
+//  Pure data, like onewire_dests.cpp.  To add a sensor, add a row
+//  (a second ADS1115 is just another address).  Interval × number
+//  of rows on one device must leave room for the conversions:
+//  at 16 SPS each takes ~69 ms, so one chip manages ~14 per second.
+// ============================================================
+
+#include "ads_channels.h"
+
+#include <Adafruit_ADS1X15.h>
+
+const AdsChannelDef kAdsChannels[] = {
+//   name            addr                 in  gain      rate                interval             pipeline               dest                   SK path
+    {"coolant",      ADS1115_I2C_ADDRESS, 0,  GAIN_ONE, RATE_ADS1115_16SPS, INTERVAL_ANALOG_MS,  AdsPipeline::VOLTS,    AdsDest::COOLANT,      nullptr},
+#ifdef TANK_SENSOR_GOBIUS
+    {"gobius3q",     ADS1115_I2C_ADDRESS, 1,  GAIN_ONE, RATE_ADS1115_16SPS, INTERVAL_TANK_MS,    AdsPipeline::VOLTS,    AdsDest::GOBIUS_3Q,    nullptr},
+    {"gobius1q",     ADS1115_I2C_ADDRESS, 2,  GAIN_ONE, RATE_ADS1115_16SPS, INTERVAL_TANK_MS,    AdsPipeline::VOLTS,    AdsDest::GOBIUS_1Q,    nullptr},
+#else
+    {"tankSender",   ADS1115_I2C_ADDRESS, TANK_SENDER_CHANNEL,
+                                              GAIN_ONE, RATE_ADS1115_16SPS, INTERVAL_TANK_MS,    AdsPipeline::CCS_OHMS, AdsDest::TANK_SENDER,  nullptr},
+#endif
+    // A3 (ch3) is free, e.g.:
+    // {"a3",        ADS1115_I2C_ADDRESS, 3,  GAIN_ONE, RATE_ADS1115_16SPS, 1000,                AdsPipeline::VOLTS,    AdsDest::SK_ONLY,      "sensors.halmet.a3.voltage"},
+};
+
+const int kNumAdsChannels = sizeof(kAdsChannels) / sizeof(kAdsChannels[0]);
@@ -0,0 +1,25 @@
+// ============================================================
+//  alarm_rule_defs.cpp — Alarm rule table
+//
+//  Pure data, kept apart from alarm_rules.cpp like kTempDests.
+//  Thresholds in the signal's unit (RISE: per minute, STALE: s).
+// ============================================================
+
+#include <cmath>
+
+#include "alarm_rules.h"
+#include "halmet_config.h"
+
+// Row 0 is kCoolantAlertRule (thresholds from the web UI config).
+// (appending: bump kNumAlarmRules in alarm_rules.h)
+const AlarmRuleDef kAlarmRules[] = {
+//   name              label            unit    input                              kind               gate                 warn                     alarm                     hyst  arm                         window   notification path
+    {"coolantHigh",    "Coolant",       "°C",   {alarmInput(AlarmInput::COOLANT_C), AlarmKind::ABOVE, AlarmGate::ALWAYS,  DEFAULT_COOLANT_WARN_C,  DEFAULT_COOLANT_ALARM_C,  2.0f, NAN,                        0},     "notifications.propulsion.0.coolantTemperature"},
+    {"coolantRise",    "Coolant",       "°C",   {alarmInput(AlarmInput::COOLANT_C), AlarmKind::RISE,  AlarmGate::RUNNING, 2.0f,                    5.0f,                     1.0f, ALARM_COOLANT_RISE_ARM_C,   60000}, "notifications.propulsion.0.coolantTemperatureRise"},
+    {"coolantSensor",  "Coolant",       "°C",   {alarmInput(AlarmInput::COOLANT_C), AlarmKind::STALE, AlarmGate::RUNNING, 10.0f,                   NAN,                      0.0f, NAN,                        0},     "notifications.propulsion.0.coolantSensor"},
+    {"fuelLow",        "Fuel",          "%",    {alarmInput(AlarmInput::TANK_PCT),  AlarmKind::BELOW, AlarmGate::ALWAYS,  20.0f,                   10.0f,                    3.0f, NAN,                        0},     "notifications.tanks.fuel.0.currentLevel"},
+    {"exhaustHigh",    "Exhaust",       "°C",   {oneWireAlarmInput(2),              AlarmKind::ABOVE, AlarmGate::RUNNING, 70.0f,                   90.0f,                    5.0f, NAN,                        0},     "notifications.propulsion.0.exhaustTemperature"},
+    {"exhaustRise",    "Exhaust",       "°C",   {oneWireAlarmInput(2),              AlarmKind::RISE,  AlarmGate::RUNNING, 10.0f,                   20.0f,                    3.0f, 50.0f,                      30000}, "notifications.propulsion.0.exhaustTemperatureRise"},
+    {"engineRoomHigh", "Engine room",   "°C",   {oneWireAlarmInput(1),              AlarmKind::ABOVE, AlarmGate::ALWAYS,  60.0f,                   70.0f,                    3.0f, NAN,                        0},     "notifications.environment.inside.engineRoom.temperature"},
+    {"oilSumpHigh",    "Oil sump",      "°C",   {oneWireAlarmInput(9),              AlarmKind::ABOVE, AlarmGate::RUNNING, 110.0f,                  120.0f,                   3.0f, NAN,                        0},     "notifications.propulsion.0.oilTemperature"},
+};
@@ -0,0 +1,140 @@
+// ============================================================
+//  alarm_rules.cpp — Alarm rule table → Signal K notifications
+// ============================================================
+
+#include "alarm_rules.h"
+
+#include <Arduino.h>
+#include <cmath>
+#include <vector>
+#include <N2kMsg.h>
+#include <sensesp.h>
+#include <sensesp/system/observablevalue.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "OneWireRegistry.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+namespace alarm_rules {
+
+static_assert(kNumAlarmRules <= AlarmRules::kMaxRules, "kAlarmRules does not fit AlarmRules");
+static_assert(static_cast<uint8_t>(AlarmLevel::WARN)  == static_cast<uint8_t>(CoolantAlertState::WARN) &&
+              static_cast<uint8_t>(AlarmLevel::ALARM) == static_cast<uint8_t>(CoolantAlertState::ALARM),
+              "AlarmLevel must map onto CoolantAlertState");
+
+static EngineState*          sState    = nullptr;
+static OneWireRegistry*      sRegistry = nullptr;
+static AlarmRules*           sRules    = nullptr;
+static SKOutputRawJson*      sSk[kNumAlarmRules];
+static uint32_t              sSeenMs[static_cast<uint8_t>(EngineField::COUNT)] = {};   // last sample fed, per field
+static std::vector<uint32_t> sOwSeenMs;                                                   // the same, per registry entry
+
+// Rule level change that passed the rate limit → its notification path
+static void onNotify(void* ctx, int rule, AlarmLevel level, float value, uint32_t now) {
+    (void)ctx;
+    (void)now;
+    const AlarmRuleDef& def = kAlarmRules[rule];
+    if (level == AlarmLevel::NORMAL) {
+        sSk[rule]->set("null");
+        return;
+    }
+    const char* state = alarmLevelName(level);
+    char msg[96];
+    switch (def.rule.kind) {
+        case AlarmKind::RISE:
+            snprintf(msg, sizeof(msg), "%s rising %.1f%s/min (%s threshold)", def.label, value, def.unit, state);
+            break;
+        case AlarmKind::STALE:
+            snprintf(msg, sizeof(msg), "%s sensor: no reading for %.0f s", def.label, value);
+            break;
+        default:
+            snprintf(msg, sizeof(msg), "%s %.0f%s (%s threshold)", def.label, value, def.unit, state);
+            break;
+    }
+    char buf[192];
+    snprintf(buf, sizeof(buf),
+        "{\"state\":\"%s\",\"method\":[\"visual\",\"sound\"],\"message\":\"%s\"}", state, msg);
+    sSk[rule]->set(String(buf));
+}
+
+// One EngineState field → its alarm input, once per sample
+template <typename T>
+static void feed(const Sampled<T>& f, AlarmInput in, float value) {
+    uint32_t& seen = sSeenMs[static_cast<uint8_t>(f.field)];
+    if (f.sampleMs == 0 || f.sampleMs == seen) return;
+    seen = f.sampleMs;
+    sRules->sample(alarmInput(in), value, f.sampleMs);
+}
+
+static float naToNan(double v) { return N2kIsNA(v) ? NAN : static_cast<float>(v); }
+
+static void tick(PersistingObservableValue<float>* warnC, PersistingObservableValue<float>* alarmC) {
+    EngineState* st  = sState;
+    uint32_t     now = millis();
+    if (warnC && alarmC) sRules->setThresholds(kCoolantAlertRule, warnC->get(), alarmC->get());
+    sRules->setRunning(st->engineRunning.value, now);
+
+    double coolantK = st->coolantK.value;
+    feed(st->coolantK,     AlarmInput::COOLANT_C,     N2kIsNA(coolantK) ? NAN : static_cast<float>(coolantK - 273.15));
+    feed(st->tankLevelPct, AlarmInput::TANK_PCT,      st->tankLevelPct.value);
+    feed(st->fuelRateLph,  AlarmInput::FUEL_RATE_LPH, naToNan(st->fuelRateLph.value));
+    feed(st->rpm,          AlarmInput::RPM,           st->rpm.value);
+
+    if (sRegistry) {
+        if (sOwSeenMs.size() < sRegistry->size()) sOwSeenMs.resize(sRegistry->size(), 0);
+        for (size_t i = 0; i < sRegistry->size(); i++) {
+            const OneWireEntry& e = (*sRegistry)[i];
+            if (!e.bound() || e.sampleMs == 0 || e.sampleMs == sOwSeenMs[i]) continue;
+            sOwSeenMs[i] = e.sampleMs;
+            sRules->sample(oneWireAlarmInput(e.dest), e.value->get() - 273.15f, e.sampleMs);
+        }
+    }
+
+    sRules->tick(now);
+    st->set(st->coolantAlertState,
+            static_cast<CoolantAlertState>(sRules->level(kCoolantAlertRule)), now);
+}
+
+static void publish(SKOutputRawJson* sk) {
+    JsonDocument doc;
+    JsonArray    rules = doc["rules"].to<JsonArray>();
+    for (int i = 0; i < kNumAlarmRules; i++) {
+        const AlarmRules::State& s = sRules->state(i);
+        JsonObject o = rules.add<JsonObject>();
+        o["name"]        = kAlarmRules[i].name;
+        o["level"]       = alarmLevelName(s.level);
+        o["active"]      = s.active;
+        if (!std::isnan(s.value)) o["value"] = s.value;
+        o["transitions"] = s.transitions;
+        o["notified"]    = s.notified;
+    }
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
+
+void init(const InitParams& p) {
+    arena::Scope scope("alarmRules");
+    sState    = p.state;
+    sRegistry = p.owRegistry;
+
+    uint32_t now = millis();
+    sRules = arena::make<AlarmRules>(onNotify, nullptr, ALARM_NOTIFY_MIN_MS);
+    for (int i = 0; i < kNumAlarmRules; i++) {
+        sRules->add(kAlarmRules[i].rule, now);
+        sSk[i] = arena::make<SKOutputRawJson>(kAlarmRules[i].skPath, "");
+    }
+
+    auto* warnC  = p.coolantWarnC;
+    auto* alarmC = p.coolantAlarmC;
+    event_loop()->onRepeat(INTERVAL_ALARM_RULES_MS, [warnC, alarmC]() { tick(warnC, alarmC); });
+
+    auto* skDiag = arena::make<SKOutputRawJson>("design.halmet.diagnostics.alarms", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [skDiag]() { publish(skDiag); });
+}
+
+}  // namespace alarm_rules
@@ -10,147 +10,304 @@
 #include <Adafruit_ADS1X15.h>
 #include <N2kMsg.h>
 #include <sensesp.h>
-#include <sensesp/sensors/sensor.h>
 #include <sensesp/system/observablevalue.h>
 #include <sensesp/signalk/signalk_output.h>
-#include <sensesp/transforms/curveinterpolator.h>
 #include <sensesp/ui/config_item.h>
 
 #include "halmet_config.h"
 #include "engine_state.h"
+#include "ads_channels.h"
+#include "AdsScheduler.h"
+#include "CoolantCurve.h"
+#include "dlog.h"
+#include "TankEstimator.h"
+#include "TankStrapping.h"
+#include "supervisor.h"
+#include "arena.h"
 
 using namespace sensesp;
 
 namespace analog_inputs {
 
-// ---- Voltage → Temperature curve (VP / VDO NTC sender) ----
-struct CurvePoint { float v; float c; };
-static const CurvePoint kTempCurve[] = { TEMP_CURVE_POINTS };
-static constexpr int kTempCurveLen = sizeof(kTempCurve) / sizeof(CurvePoint);
-
-static float voltageToCelsius(float volt) {
-    if (volt < COOLANT_VOLT_MIN_V || volt > COOLANT_VOLT_MAX_V) return NAN;
-
-    if (volt <= kTempCurve[kTempCurveLen - 1].v) return kTempCurve[kTempCurveLen - 1].c;
-    if (volt >= kTempCurve[0].v)                 return kTempCurve[0].c;
-    for (int i = 0; i < kTempCurveLen - 1; i++) {
-        if (volt <= kTempCurve[i].v && volt > kTempCurve[i + 1].v) {
-            float ratio = (volt - kTempCurve[i + 1].v)
-                        / (kTempCurve[i].v - kTempCurve[i + 1].v);
-            return kTempCurve[i + 1].c + ratio * (kTempCurve[i].c - kTempCurve[i + 1].c);
+// ============================================================
+//  ADS1115 bus — Adafruit driver, single-shot, never blocking
+// ============================================================
+class AdafruitAdsBus : public AdsBus {
+public:
+    int deviceFor(uint8_t addr) {
+        for (int i = 0; i < _n; i++) {
+            if (_addr[i] == addr) return i;
         }
+        if (_n >= AdsScheduler::kMaxDevices) return -1;
+        _addr[_n] = addr;
+        return _n++;
     }
-    return NAN;
-}
+    uint8_t address(int device) const { return _addr[device]; }
 
-void init(const InitParams& p) {
-    EngineState*                       st      = p.state;
-    Adafruit_ADS1115*                  ads     = p.ads;
-    SKOutputRawJson*                   skNotif = p.skCoolantNotification;
-    PersistingObservableValue<float>*  povWarn  = p.coolantWarnC;
-    PersistingObservableValue<float>*  povAlarm = p.coolantAlarmC;
-
-    // Coolant temp read (200 ms)
-    event_loop()->onRepeat(INTERVAL_ANALOG_MS, [st, ads, skNotif, povWarn, povAlarm]() {
-        if (!st->adsOk) return;
-        float volts0 = ads->computeVolts(ads->readADC_SingleEnded(0));
-        float celsius = voltageToCelsius(volts0);
-        if (std::isnan(celsius)) {
-            st->coolantK = N2kDoubleNA;
+    bool begin(uint8_t device) override {
+        Wire.begin(HALMET_PIN_SDA, HALMET_PIN_SCL);
+        Wire.setClock(400000);
+        bool ok = _ads[device].begin(_addr[device], &Wire);
+        if (ok) {
+            dlog::log(LogFmt::ADS_FOUND, _addr[device]);
         } else {
-            st->coolantK = celsius + 273.15f;
-            st->coolantLastUpdateMs = millis();
-
-            float warnC  = povWarn  ? povWarn->get()  : DEFAULT_COOLANT_WARN_C;
-            float alarmC = povAlarm ? povAlarm->get() : DEFAULT_COOLANT_ALARM_C;
-            auto newState = CoolantAlertState::NORMAL;
-            if (celsius >= alarmC)      newState = CoolantAlertState::ALARM;
-            else if (celsius >= warnC)  newState = CoolantAlertState::WARN;
-
-            if (newState != st->coolantAlertState) {
-                st->coolantAlertState = newState;
-                if (skNotif) {
-                    if (newState == CoolantAlertState::NORMAL) {
-                        skNotif->set("null");
-                    } else {
-                        const char* state = (newState == CoolantAlertState::ALARM) ? "alarm" : "warn";
-                        char buf[192];
-                        snprintf(buf, sizeof(buf),
-                            "{\"state\":\"%s\",\"method\":[\"visual\",\"sound\"],"
-                            "\"message\":\"Coolant %.0f°C (%s threshold)\"}",
-                            state, celsius, state);
-                        skNotif->set(String(buf));
-                    }
-                }
-            }
+            dlog::log(LogFmt::ADS_NOT_ANSWERING, _addr[device]);
         }
-    });
+        return ok;
+    }
+    void start(uint8_t device, const AdsChannel& ch) override {
+        static const uint16_t kMux[4] = {
+            ADS1X15_REG_CONFIG_MUX_SINGLE_0, ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+            ADS1X15_REG_CONFIG_MUX_SINGLE_2, ADS1X15_REG_CONFIG_MUX_SINGLE_3,
+        };
+        _ads[device].setGain(static_cast<adsGain_t>(ch.gain));
+        _ads[device].setDataRate(ch.rate);
+        _ads[device].startADCReading(kMux[ch.mux], /*continuous=*/false);
+    }
+    bool    ready(uint8_t device) override  { return _ads[device].conversionComplete(); }
+    int16_t result(uint8_t device) override { return _ads[device].getLastConversionResults(); }
+
+private:
+    Adafruit_ADS1115 _ads[AdsScheduler::kMaxDevices];
+    uint8_t          _addr[AdsScheduler::kMaxDevices] = {};
+    int              _n = 0;
+};
+
+static AdafruitAdsBus sBus;
+static AdsScheduler*  sSched = nullptr;
+static int8_t         sRowOf[AdsScheduler::kMaxChannels];   // scheduler channel → kAdsChannels row
+static SKOutputFloat* sRowSk[AdsScheduler::kMaxChannels];   // per-row skPath output
+
+static EngineState* sState = nullptr;
 
 #ifdef TANK_SENSOR_GOBIUS
-    // Gobius Pro binary threshold sensors on ADS ch1 + ch2 (500 ms)
-    event_loop()->onRepeat(INTERVAL_TANK_MS, [st, ads]() {
-        if (!st->adsOk) return;
-        bool below3q = ads->computeVolts(ads->readADC_SingleEnded(1))
-                       < GOBIUS_THRESHOLD_VOLTAGE;
-        bool below1q = ads->computeVolts(ads->readADC_SingleEnded(2))
-                       < GOBIUS_THRESHOLD_VOLTAGE;
-
-        if (below1q)      st->tankLevelPct = TANK_LEVEL_LOW_PCT;
-        else if (below3q) st->tankLevelPct = TANK_LEVEL_MID_PCT;
-        else              st->tankLevelPct = TANK_LEVEL_HIGH_PCT;
-    });
+static bool sBelow3q = false;
+static bool sBelow1q = false;
 #else
-    // Resistive sender on ADS ch1 via 10 mA constant-current source (500 ms)
-    // R = V_adc / I  (no voltage divider on this input)
-    auto* resistance = new RepeatSensor<float>(
-        INTERVAL_TANK_MS, [st, ads]() -> float {
-            if (!st->adsOk) return NAN;
-            float v = ads->computeVolts(ads->readADC_SingleEnded(TANK_SENDER_CHANNEL));
-            float r = v / TANK_MEASUREMENT_CURRENT;
-            return (r < 0.0f || r > TANK_RESISTANCE_MAX_OHM) ? NAN : r;
-        });
-
-    auto* curve = new CurveInterpolator(nullptr, "/tank/resistance_curve");
-    curve->set_input_title("Sender Resistance (ohms)")
-         ->set_output_title("Tank Level (ratio 0-1)");
-
-    if (curve->get_samples().empty()) {
-        // Default: European VDO fuel sender (10 Ω = empty, 180 Ω = full)
-        curve->clear_samples();
-        curve->add_sample(CurveInterpolator::Sample(TANK_RESISTANCE_EMPTY_OHM, 0.0));
-        curve->add_sample(CurveInterpolator::Sample(TANK_RESISTANCE_FULL_OHM,  1.0));
+static TankEstimator sTank({
+    TANK_MEDIAN_WINDOW,
+    TANK_LEVEL_SIGMA_PCT,
+    TANK_LEVEL_WALK_PCT,
+    TANK_RATE_WALK_PCT_H,
+    TANK_RATE_INIT_SIGMA_PCT_H,
+    TANK_RATE_SETTLE_S,
+    TANK_JUMP_SIGMA,
+    TANK_JUMP_SAMPLES,
+});
+static uint32_t                          sTankLastMs = 0;     // previous valid sender reading
+static float                             sTankOhms   = NAN;   // latest sender reading
+static TankStrapping*                    sStrapping  = nullptr;
+static PersistingObservableValue<float>* sPovTankCap = nullptr;
+static SKOutputFloat*                    sSkLevel    = nullptr;
+static SKOutputFloat*                    sSkVolume   = nullptr;
+#endif
+
+static uint32_t clockUs() { return micros(); }
+
+// ============================================================
+//  Destinations
+// ============================================================
+// Sender voltage → °C (N/A while open/shorted); the warn/alarm
+// levels are kAlarmRules' (alarm_rules)
+static void onCoolant(float volts, uint32_t now) {
+    float celsius = CoolantCurve::voltageToCelsius(volts);
+    sState->set(sState->coolantK, std::isnan(celsius) ? N2kDoubleNA : celsius + 273.15, now);
+}
+
+#ifdef TANK_SENSOR_GOBIUS
+// Gobius Pro binary threshold sensors: both outputs → 3-band level
+static void onGobius(bool below, bool oneQuarter, uint32_t now) {
+    (oneQuarter ? sBelow1q : sBelow3q) = below;
+    float level = sBelow1q ? TANK_LEVEL_LOW_PCT
+                : sBelow3q ? TANK_LEVEL_MID_PCT
+                           : TANK_LEVEL_HIGH_PCT;
+    sState->set(sState->tankLevelPct, level, now);
+}
+#else
+// Sender reading → volume → TankEstimator → shared state
+// (PGN 127505 / 127489).  No sample while the sender is
+// open/shorted or the ADS is down: the level and rate go stale.
+static void onTankSender(float ohms, uint32_t now) {
+    EngineState* st = sState;
+    sTankOhms       = ohms;
+    float litres    = sStrapping->table().litres(ohms);
+    float cap       = sPovTankCap->get();
+    if (std::isnan(litres) || !(cap > 0.0f)) return;
+    float dtS   = sTankLastMs ? (now - sTankLastMs) / 1000.0f : INTERVAL_TANK_MS / 1000.0f;
+    sTankLastMs = now;
+
+    sTank.update(litres / cap * 100.0f, st->engineRunning.value, dtS);
+    st->set(st->tankLevelPct, sTank.levelPct(), now);
+    st->set(st->fuelRateLph,
+            sTank.rateValid() ? sTank.ratePctH() * cap / 100.0 : N2kDoubleNA, now);
+    sSkLevel->set(sTank.levelPct() / 100.0f);
+    sSkVolume->set(sTank.levelPct() * cap / 1e5f);   // % of capacity → m³
+}
+#endif
+
+// Scheduler sink: every completed conversion, through its row's
+// pipeline to its destination.  `now` is the conversion's
+// acquisition time, so the destination's sampleMs is too.
+static void onSample(void* ctx, int channel, int16_t raw, uint32_t now) {
+    (void)ctx;
+    const AdsChannelDef& row   = kAdsChannels[sRowOf[channel]];
+    float                volts = raw * adsVoltsPerCount(row.gain);
+    if (row.addr == ADS1115_I2C_ADDRESS) {
+        sState->adsRaw[row.mux]   = raw;
+        sState->adsVolts[row.mux] = volts;
     }
 
-    ConfigItem(curve)
-        ->set_title("Tank level curve")
-        ->set_description("Calibration table: sender resistance (ohms) to level (0=empty, 1=full)");
+    float value = volts;
+    if (row.pipeline == AdsPipeline::CCS_OHMS) {
+        value = volts / TANK_MEASUREMENT_CURRENT;
+        if (value < 0.0f || value > TANK_RESISTANCE_MAX_OHM) value = NAN;
+    }
+    if (sRowSk[channel]) sRowSk[channel]->set(value);
+
+    switch (row.dest) {
+        case AdsDest::COOLANT: onCoolant(value, now); break;
+#ifdef TANK_SENSOR_GOBIUS
+        case AdsDest::GOBIUS_3Q: onGobius(value < GOBIUS_THRESHOLD_VOLTAGE, false, now); break;
+        case AdsDest::GOBIUS_1Q: onGobius(value < GOBIUS_THRESHOLD_VOLTAGE, true,  now); break;
+#else
+        case AdsDest::TANK_SENDER:
+            if (!std::isnan(value)) onTankSender(value, now);
+            else                    sTankOhms = NAN;
+            break;
+#endif
+        default: break;
+    }
+}
+
+// ============================================================
+//  Diagnostics — per device bus cost, per channel sample state
+// ============================================================
+static void publishAds(SKOutputRawJson* sk) {
+    uint32_t     now = millis();
+    JsonDocument doc;
+    JsonArray    devs = doc["devices"].to<JsonArray>();
+    for (int i = 0; i < AdsScheduler::kMaxDevices; i++) {
+        const AdsScheduler::Device& d = sSched->device(i);
+        if (!d.used) continue;
+        JsonObject o = devs.add<JsonObject>();
+        char addr[8];
+        snprintf(addr, sizeof(addr), "0x%02X", sBus.address(i));
+        o["addr"]         = addr;
+        o["up"]           = d.state != AdsScheduler::State::DOWN;
+        o["samples"]      = d.samples;
+        o["timeouts"]     = d.timeouts;
+        o["failedBegins"] = d.failedBegins;
+        o["transactions"] = d.transactions;
+        o["usPerSample"]  = sSched->usPerSample(i);
+        o["maxTxUs"]      = d.maxTxUs;
+    }
+    JsonArray chans = doc["channels"].to<JsonArray>();
+    for (int c = 0; c < sSched->channels(); c++) {
+        const AdsScheduler::Channel& ch  = sSched->channel(c);
+        const AdsChannelDef&         row = kAdsChannels[sRowOf[c]];
+        JsonObject o = chans.add<JsonObject>();
+        o["name"]    = row.name;
+        o["in"]      = row.mux;
+        o["raw"]     = ch.raw;
+        o["samples"] = ch.samples;
+        o["late"]    = ch.late;
+        if (ch.lastMs) o["ageMs"] = now - ch.lastMs;
+    }
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
 
-    resistance->connect_to(curve);
-    curve->connect_to(new SKOutputFloat("tanks.fuel.0.currentLevel"));
+void init(const InitParams& p) {
+    arena::Scope scope("analogInputs");
+    EngineState* st = p.state;
+    sState = st;
+
+#ifndef TANK_SENSOR_GOBIUS
+    // Strapping table: Ω → litres (compiled on save, O(1) per reading).
+    // Without a saved table: VDO 10–180 Ω, linear to the tank capacity.
+    PersistingObservableValue<float>* povTankCap = p.tankCapacityL;
+    sPovTankCap = povTankCap;
+    sStrapping  = arena::make<TankStrapping>(povTankCap->get(), "/tank/strapping");
+    ConfigItem(sStrapping)
+        ->set_title("Tank strapping table")
+        ->set_description("Sender resistance (ohms), fuel height (mm) and volume (litres), "
+                          "up to 1024 rows in any order");
+    // The default table is linear to the capacity: follow it when
+    // the capacity is saved, so the level stays right without a reboot
+    povTankCap->attach([povTankCap]() { sStrapping->setFullLitres(povTankCap->get()); });
+    sSkLevel  = arena::make<SKOutputFloat>("tanks.fuel.0.currentLevel");
+    sSkVolume = arena::make<SKOutputFloat>("tanks.fuel.0.currentVolume");
+#endif
 
-    // Update shared state for N2K PGN 127505
-    curve->attach([curve, st]() {
-        float ratio = curve->get();
-        if (!std::isnan(ratio)) {
-            st->tankLevelPct = ratio * 100.0f;
+    // ---- Channel map → scheduler ----
+    uint32_t now = millis();
+    sSched = arena::make<AdsScheduler>(sBus, clockUs, onSample, nullptr, INTERVAL_ADS_RETRY_MS);
+    for (int r = 0; r < kNumAdsChannels; r++) {
+        const AdsChannelDef& row = kAdsChannels[r];
+        int dev = sBus.deviceFor(row.addr);
+        int id  = dev < 0 ? -1
+                : sSched->add({ static_cast<uint8_t>(dev), row.mux, row.gain, row.rate, row.intervalMs }, now);
+        if (id < 0) {
+            ESP_LOGE("HALMET", "ADS channel '%s' (0x%02X in %u) dropped: channel map full",
+                     row.name, row.addr, row.mux);
+            continue;
         }
+        sRowOf[id] = static_cast<int8_t>(r);
+        sRowSk[id] = row.skPath ? arena::make<SKOutputFloat>(row.skPath) : nullptr;
+    }
+
+    // Every ADS_POLL_MS: finish, start and retry conversions on every
+    // device.  The device state is mirrored into EngineState.
+    event_loop()->onRepeat(ADS_POLL_MS, [st]() {
+        supervisor::checkIn(SupervisedTask::ADS);
+        sSched->poll(millis());
+        st->adsOk        = sSched->allUp();
+        st->adsFailCount = sSched->failedBegins();
     });
-#endif
 
-    // ADS1115 I2C recovery (retry when not present)
-    event_loop()->onRepeat(INTERVAL_ADS_RETRY_MS, [st, ads]() {
-        if (st->adsOk) return;
-        Wire.begin(HALMET_PIN_SDA, HALMET_PIN_SCL);
-        Wire.setClock(400000);
-        st->adsOk = ads->begin(ADS1115_I2C_ADDRESS, &Wire);
-        if (st->adsOk) {
-            ads->setGain(GAIN_ONE);
-            ads->setDataRate(RATE_ADS1115_8SPS);
-            ESP_LOGI("HALMET", "ADS1115 recovered on I2C retry");
-        } else {
-            st->adsFailCount++;
+    auto* skAds = arena::make<SKOutputRawJson>("design.halmet.diagnostics.ads", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [skAds]() { publishAds(skAds); });
+
+#ifndef TANK_SENSOR_GOBIUS
+    // Burn and endurance to Signal K (null while the rate settles),
+    // and the sender against the table: the resistance the filtered
+    // volume implies next to the one measured.
+    auto* skFuelRate  = arena::make<SKOutputFloat>("propulsion.0.fuel.rate", "");
+    auto* skEndurance = arena::make<SKOutputFloat>("design.halmet.engine.fuelEndurance", "");
+    auto* skTankDiag  = arena::make<SKOutputRawJson>("design.halmet.diagnostics.tank", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [st, skFuelRate, skEndurance, skTankDiag, povTankCap]() {
+        uint32_t now = millis();
+        double   lph = st->freshOr(st->fuelRateLph, N2kDoubleNA, now);
+        skFuelRate->set(N2kIsNA(lph) ? NAN : static_cast<float>(lph / 3.6e6));   // L/h → m³/s
+        float cap = povTankCap->get();
+        float h   = (cap > 0.0f && st->fresh(st->fuelRateLph, now))
+                        ? sTank.enduranceH(TANK_ENDURANCE_MIN_LPH * 100.0f / cap) : -1.0f;
+        skEndurance->set(h < 0.0f ? NAN : h * 3600.0f);
+
+        const StrappingTable& tbl  = sStrapping->table();
+        float                 ohms = sTankOhms;
+        JsonDocument doc;
+        doc["points"]     = tbl.points();
+        doc["fullL"]      = tbl.maxLitres();
+        doc["gridErrorL"] = tbl.gridErrorL();
+        doc["table"]      = strappingStatusName(sStrapping->status());
+        doc["jumps"]      = sTank.jumps();
+        if (st->adsOk && !std::isnan(ohms)) {
+            doc["ohms"]     = ohms;
+            doc["heightMm"] = tbl.heightMm(ohms);
+            doc["litres"]   = tbl.litres(ohms);
+        }
+        if (st->fresh(st->tankLevelPct, now)) {
+            float filtL         = st->tankLevelPct.value * cap / 100.0f;
+            doc["filteredL"]    = filtL;
+            doc["expectedOhms"] = tbl.ohmsFor(filtL);
         }
+        String output;
+        serializeJson(doc, output);
+        skTankDiag->set(output);
     });
+#endif
 }
 
 }  // namespace analog_inputs
@@ -0,0 +1,101 @@
+// ============================================================
+//  arena.cpp — Static arena for setup-time objects + RAM report
+// ============================================================
+
+#include "arena.h"
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "StaticArena.h"
+
+using namespace sensesp;
+
+// ============================================================
+//  File-scope state
+// ============================================================
+alignas(alignof(std::max_align_t)) static uint8_t sBuf[ARENA_BYTES];
+static StaticArena sArena(sBuf, sizeof(sBuf));
+
+static size_t sHeapAtSeal = 0;
+
+namespace arena {
+
+void* allocate(size_t size, size_t align) {
+    void* p = sArena.allocate(size, align);
+    if (p) return p;
+    ESP_LOGW("Arena", "%u B does not fit (%u of %u B used) — heap instead",
+             (unsigned)size, (unsigned)sArena.used(), (unsigned)sArena.capacity());
+    return ::operator new(size);
+}
+
+Scope::Scope(const char* module) : _prev(sArena.setModule(module)) {}
+
+Scope::~Scope() { sArena.setModule(_prev); }
+
+const StaticArena& get() { return sArena; }
+
+void seal() {
+    if (sArena.sealed()) return;
+    sArena.seal();
+    sHeapAtSeal = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    for (int i = 0; i < sArena.modules(); i++) {
+        const StaticArena::Module& m = sArena.module(i);
+        ESP_LOGI("Arena", "%-14s %6lu B %3u objects%s", m.name,
+                 (unsigned long)m.bytes, m.objects, m.failed ? " (some on heap)" : "");
+    }
+    ESP_LOGI("Arena", "%u of %u B used, heap free %u B",
+             (unsigned)sArena.used(), (unsigned)sArena.capacity(), (unsigned)sHeapAtSeal);
+}
+
+static void publish(SKOutputRawJson* sk) {
+    JsonDocument doc;
+
+    JsonObject a = doc["arena"].to<JsonObject>();
+    a["capacity"] = sArena.capacity();
+    a["used"]     = sArena.used();
+    a["free"]     = sArena.available();
+    a["sealed"]   = sArena.sealed();
+    a["late"]     = sArena.lateAllocs();
+
+    JsonArray modules = doc["modules"].to<JsonArray>();
+    for (int i = 0; i < sArena.modules(); i++) {
+        const StaticArena::Module& m = sArena.module(i);
+        JsonObject o = modules.add<JsonObject>();
+        o["name"]    = m.name;
+        o["bytes"]   = m.bytes;
+        o["objects"] = m.objects;
+        if (m.failed) {
+            o["heapObjects"] = m.failed;
+            o["heapBytes"]   = m.failedBytes;
+        }
+    }
+
+    // Free heap against the baseline taken at seal(): a steady
+    // negative sinceSeal is a leak, not buffering
+    size_t free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    JsonObject h = doc["heap"].to<JsonObject>();
+    h["free"]         = free;
+    h["minFree"]      = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    h["largestBlock"] = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    if (sArena.sealed()) {
+        h["atSeal"]    = sHeapAtSeal;
+        h["sinceSeal"] = static_cast<int32_t>(free) - static_cast<int32_t>(sHeapAtSeal);
+    }
+
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
+
+void init() {
+    Scope scope("arena");
+    auto* sk = make<SKOutputRawJson>("design.halmet.diagnostics.ram", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [sk]() { publish(sk); });
+}
+
+}  // namespace arena
@@ -0,0 +1,374 @@
+// ============================================================
+//  blackbox.cpp — Alarm-triggered pre/post-trigger event recorder
+//
+//  Ownership of the sample ring is handed back and forth via
+//  sPhase: the event loop samples into it while ARMED/POST, the
+//  writer task reads it while WRITING.  Sampling pauses for the
+//  (sub-second) duration of the LittleFS write; the loop itself
+//  never touches the filesystem.
+// ============================================================
+
+#include "blackbox.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sensesp.h>
+#include <sensesp_app.h>
+#include <sensesp/net/http_server.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "OneWireRegistry.h"
+#include "dlog.h"
+
+using namespace sensesp;
+
+namespace blackbox {
+
+static constexpr int kPeriodMs       = INTERVAL_RPM_MS;
+static constexpr int kPreSamples     = BLACKBOX_PRE_TRIGGER_S * 1000 / kPeriodMs;
+static constexpr int kMaxPostSamples = BLACKBOX_MAX_POST_TRIGGER_S * 1000 / kPeriodMs;
+static constexpr int kRingLen        = kPreSamples + kMaxPostSamples;
+static constexpr const char* kDir    = "/blackbox";
+
+enum class Phase : uint8_t {
+    ARMED   = 0,   ///< Sampling; ring trimmed to the pre-trigger window
+    POST    = 1,   ///< Triggered; collecting post-trigger samples
+    WRITING = 2,   ///< Ring frozen; writer task persisting the event
+};
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static BlackboxSample     sRing[kRingLen];
+static int                sHead     = 0;   // next write index
+static int                sCount    = 0;   // valid samples ending at sHead
+static int                sPostLeft = 0;
+static std::atomic<Phase> sPhase{Phase::ARMED};
+
+// Frozen event handed to the writer task
+static BlackboxFileHeader   sHdr;
+static BlackboxOneWireEntry sOw[BLACKBOX_MAX_ONEWIRE];
+static int                  sFirst   = 0;  // ring index of the oldest event sample
+static uint32_t             sNextSeq = 0;
+
+static TaskHandle_t sWriterTask = nullptr;
+
+// ============================================================
+//  Helpers
+// ============================================================
+static int16_t toCx100(double kelvin) {
+    if (std::isnan(kelvin) || kelvin <= 0.0) return INT16_MIN;
+    double c = (kelvin - 273.15) * 100.0;
+    if (c <= INT16_MIN || c > INT16_MAX) return INT16_MIN;
+    return static_cast<int16_t>(lround(c));
+}
+
+static void eventPath(char* buf, size_t len, uint32_t seq) {
+    snprintf(buf, len, "%s/ev%05lu.bin", kDir, (unsigned long)(seq % 100000));
+}
+
+// Accepts exactly "evNNNNN.bin"; returns the sequence number or -1.
+static long parseEventName(const char* name) {
+    unsigned long seq;
+    int consumed = 0;
+    if (strlen(name) != 11) return -1;
+    if (sscanf(name, "ev%5lu.bin%n", &seq, &consumed) != 1 || consumed != 11) return -1;
+    return static_cast<long>(seq);
+}
+
+static const char* reasonName(uint8_t r) {
+    switch (static_cast<BlackboxReason>(r)) {
+        case BlackboxReason::OIL_ALARM:     return "oilAlarm";
+        case BlackboxReason::TEMP_ALARM:    return "tempAlarm";
+        case BlackboxReason::COOLANT_WARN:  return "coolantWarn";
+        case BlackboxReason::COOLANT_ALARM: return "coolantAlarm";
+    }
+    return "unknown";
+}
+
+// One log format per reason: a record carries no strings, so the
+// name has to be in the format text
+static void logTrigger(uint8_t r, int32_t post) {
+    LogFmt f;
+    switch (static_cast<BlackboxReason>(r)) {
+        case BlackboxReason::OIL_ALARM:     f = LogFmt::BLACKBOX_TRIGGER_OIL;           break;
+        case BlackboxReason::TEMP_ALARM:    f = LogFmt::BLACKBOX_TRIGGER_TEMP;          break;
+        case BlackboxReason::COOLANT_WARN:  f = LogFmt::BLACKBOX_TRIGGER_COOLANT_WARN;  break;
+        case BlackboxReason::COOLANT_ALARM: f = LogFmt::BLACKBOX_TRIGGER_COOLANT_ALARM; break;
+        default:
+            dlog::log(LogFmt::BLACKBOX_TRIGGER, r, post);
+            return;
+    }
+    dlog::log(f, post);
+}
+
+static void takeSample(const EngineState* st, BlackboxSample& s) {
+    s.ms = millis();
+    float rpmX4 = st->rpm.value * 4.0f;
+    s.rpmX4 = rpmX4 <= 0.0f ? 0 : rpmX4 >= 65535.0f ? 65535
+            : static_cast<uint16_t>(lroundf(rpmX4));
+    for (int c = 0; c < 4; c++) s.adsRaw[c] = st->adsRaw[c];
+    s.coolantCx100 = toCx100(st->coolantK.value);
+    s.oilHistory   = st->oilAlarmHistory;
+    s.tempHistory  = st->tempAlarmHistory;
+    s.flags = (st->oilAlarm.value      ? kBlackboxFlagOilAlarm      : 0)
+            | (st->tempAlarm.value     ? kBlackboxFlagTempAlarm     : 0)
+            | (static_cast<uint8_t>(st->coolantAlertState.value) << kBlackboxFlagCoolantShift)
+            | (st->engineRunning.value ? kBlackboxFlagEngineRunning : 0)
+            | (st->adsOk               ? kBlackboxFlagAdsOk         : 0);
+    s.reserved = 0;
+}
+
+// Edge-detect the trigger sources; returns 0 when nothing tripped.
+static uint8_t detectTrigger(const EngineState* st) {
+    static bool              prevOil     = false;
+    static bool              prevTemp    = false;
+    static CoolantAlertState prevCoolant = CoolantAlertState::NORMAL;
+
+    BlackboxReason reason{};
+    if (st->oilAlarm.value && !prevOil) {
+        reason = BlackboxReason::OIL_ALARM;
+    } else if (st->tempAlarm.value && !prevTemp) {
+        reason = BlackboxReason::TEMP_ALARM;
+    } else if (st->coolantAlertState.value > prevCoolant) {
+        reason = (st->coolantAlertState.value == CoolantAlertState::ALARM)
+                     ? BlackboxReason::COOLANT_ALARM
+                     : BlackboxReason::COOLANT_WARN;
+    }
+    prevOil     = st->oilAlarm.value;
+    prevTemp    = st->tempAlarm.value;
+    prevCoolant = st->coolantAlertState.value;
+    return static_cast<uint8_t>(reason);
+}
+
+static void snapshotOneWire(const OneWireRegistry* reg) {
+    int n = 0;
+    if (reg) {
+        for (const auto& e : *reg) {
+            if (n >= BLACKBOX_MAX_ONEWIRE) break;
+            if (!e.bound()) continue;
+            sOw[n].dest      = static_cast<uint8_t>(e.dest);
+            sOw[n].slot      = static_cast<uint8_t>(e.instance);
+            sOw[n].tempCx100 = toCx100(e.value->get());
+            n++;
+        }
+    }
+    sHdr.numOneWire = static_cast<uint8_t>(n);
+}
+
+static void freeze() {
+    sHdr.sampleCount = static_cast<uint16_t>(sCount);
+    sHdr.seq         = sNextSeq++;
+    sFirst           = (sHead - sCount + kRingLen) % kRingLen;
+    sPhase           = Phase::WRITING;
+    xTaskNotifyGive(sWriterTask);
+}
+
+// ============================================================
+//  Writer task — the only code that writes to /blackbox
+// ============================================================
+static void writeEvent() {
+    char path[24];
+    eventPath(path, sizeof(path), sHdr.seq);
+
+    uint32_t t0 = millis();
+    File f = LittleFS.open(path, FILE_WRITE);
+    if (!f) {
+        ESP_LOGE("BlackBox", "Cannot create %s", path);
+        return;
+    }
+    f.write(reinterpret_cast<const uint8_t*>(&sHdr), sizeof(sHdr));
+    f.write(reinterpret_cast<const uint8_t*>(sOw),
+            sizeof(BlackboxOneWireEntry) * sHdr.numOneWire);
+
+    // Ring may wrap: write [first, end) then [0, rest)
+    int n    = sHdr.sampleCount;
+    int tail = (n < kRingLen - sFirst) ? n : kRingLen - sFirst;
+    f.write(reinterpret_cast<const uint8_t*>(&sRing[sFirst]),
+            sizeof(BlackboxSample) * tail);
+    if (n > tail) {
+        f.write(reinterpret_cast<const uint8_t*>(&sRing[0]),
+                sizeof(BlackboxSample) * (n - tail));
+    }
+    f.close();
+
+    if (sHdr.seq >= BLACKBOX_MAX_EVENTS) {
+        char old[24];
+        eventPath(old, sizeof(old), sHdr.seq - BLACKBOX_MAX_EVENTS);
+        if (LittleFS.exists(old)) LittleFS.remove(old);
+    }
+    ESP_LOGI("BlackBox", "Event %lu (%s, %d samples) saved in %lu ms",
+             (unsigned long)sHdr.seq, reasonName(sHdr.reason), n,
+             (unsigned long)(millis() - t0));
+}
+
+static void writerTask(void*) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        writeEvent();
+        // Re-arm with an empty ring so the next event's pre-trigger
+        // history does not overlap the one just saved.
+        sHead  = 0;
+        sCount = 0;
+        sPhase = Phase::ARMED;
+    }
+}
+
+// ============================================================
+//  Boot-time directory scan: resume numbering, drop old events
+// ============================================================
+static void scanExistingEvents() {
+    if (!LittleFS.exists(kDir)) LittleFS.mkdir(kDir);
+
+    long maxSeq = -1;
+    File dir = LittleFS.open(kDir);
+    for (File e = dir.openNextFile(); e; e = dir.openNextFile()) {
+        long seq = parseEventName(e.name());
+        if (seq > maxSeq) maxSeq = seq;
+    }
+    dir.close();
+    sNextSeq = static_cast<uint32_t>(maxSeq + 1);
+
+    for (long seq = maxSeq - BLACKBOX_MAX_EVENTS; seq >= 0; seq--) {
+        char path[24];
+        eventPath(path, sizeof(path), seq);
+        if (!LittleFS.exists(path)) break;
+        LittleFS.remove(path);
+    }
+    ESP_LOGI("BlackBox", "Ring %d samples (%d pre), next event #%lu",
+             kRingLen, kPreSamples, (unsigned long)sNextSeq);
+}
+
+// ============================================================
+//  HTTP handlers (run in the httpd task, not the event loop)
+// ============================================================
+static esp_err_t handleList(httpd_req_t* req) {
+    JsonDocument doc;
+    JsonArray events = doc["events"].to<JsonArray>();
+
+    File dir = LittleFS.open(kDir);
+    for (File e = dir.openNextFile(); e; e = dir.openNextFile()) {
+        if (parseEventName(e.name()) < 0) continue;
+        JsonObject obj = events.add<JsonObject>();
+        obj["name"] = e.name();
+        obj["size"] = e.size();
+
+        BlackboxFileHeader h;
+        if (e.read(reinterpret_cast<uint8_t*>(&h), sizeof(h)) == sizeof(h) &&
+            h.magic == kBlackboxMagic) {
+            obj["seq"]          = h.seq;
+            obj["reason"]       = reasonName(h.reason);
+            obj["triggerMs"]    = h.triggerMs;
+            obj["samples"]      = h.sampleCount;
+            obj["triggerIndex"] = h.triggerIndex;
+            obj["periodMs"]     = h.periodMs;
+        }
+    }
+    dir.close();
+
+    String out;
+    serializeJson(doc, out);
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, out.c_str(), out.length());
+}
+
+static esp_err_t handleDownload(httpd_req_t* req) {
+    char query[48];
+    char name[16];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "name", name, sizeof(name)) != ESP_OK ||
+        parseEventName(name) < 0) {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected ?name=evNNNNN.bin");
+    }
+
+    String path = String(kDir) + "/" + name;
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such event");
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    uint8_t buf[512];
+    size_t  n;
+    while ((n = f.read(buf, sizeof(buf))) > 0) {
+        if (httpd_resp_send_chunk(req, reinterpret_cast<const char*>(buf), n) != ESP_OK) {
+            f.close();
+            return ESP_FAIL;
+        }
+    }
+    f.close();
+    return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+// ============================================================
+void init(const InitParams& p) {
+    const EngineState*                st        = p.state;
+    const OneWireRegistry*            owReg     = p.owRegistry;
+    PersistingObservableValue<float>* povPost   = p.postTriggerS;
+
+    scanExistingEvents();
+    xTaskCreatePinnedToCore(writerTask, "blackbox", 4096, nullptr,
+                            tskIDLE_PRIORITY + 1, &sWriterTask, 0);
+
+    auto server = SensESPApp::get()->get_http_server();
+    auto listHandler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, "/api/blackbox/events", handleList);
+    auto fileHandler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, "/api/blackbox/event", handleDownload);
+    server->add_handler(listHandler);
+    server->add_handler(fileHandler);
+
+    // Sampler + trigger (100 ms, same tick as the RPM counter)
+    event_loop()->onRepeat(kPeriodMs, [st, owReg, povPost]() {
+        uint8_t reason = detectTrigger(st);
+        Phase   phase  = sPhase.load();
+        if (phase == Phase::WRITING) return;   // writer task owns the ring
+
+        takeSample(st, sRing[sHead]);
+        sHead = (sHead + 1) % kRingLen;
+        if (sCount < kRingLen) sCount++;
+
+        if (phase == Phase::POST) {
+            if (--sPostLeft <= 0) freeze();
+            return;
+        }
+
+        // ARMED: keep only the pre-trigger window
+        if (sCount > kPreSamples) sCount = kPreSamples;
+        if (reason == 0) return;
+
+        float postS = povPost ? povPost->get() : DEFAULT_BLACKBOX_POST_S;
+        long  post  = lroundf(postS * 1000.0f / kPeriodMs);
+        if (post < 0)               post = 0;
+        if (post > kMaxPostSamples) post = kMaxPostSamples;
+
+        sHdr = {};
+        sHdr.magic        = kBlackboxMagic;
+        sHdr.version      = kBlackboxVersion;
+        sHdr.sampleBytes  = sizeof(BlackboxSample);
+        sHdr.triggerMs    = millis();
+        sHdr.triggerIndex = static_cast<uint16_t>(sCount - 1);
+        sHdr.periodMs     = kPeriodMs;
+        sHdr.reason       = reason;
+        snapshotOneWire(owReg);
+
+        logTrigger(reason, static_cast<int32_t>(post));
+        sPostLeft = static_cast<int>(post);
+        if (sPostLeft == 0) {
+            freeze();
+        } else {
+            sPhase = Phase::POST;
+        }
+    });
+}
+
+}  // namespace blackbox
@@ -0,0 +1,62 @@
+// ============================================================
+//  boot_profile.cpp — Boot phase timestamps
+// ============================================================
+
+#include "boot_profile.h"
+
+#include <Arduino.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static constexpr size_t kNumPhases = static_cast<size_t>(BootPhase::COUNT);
+
+// millis() + 1 so that a phase reached at t = 0 still reads as set
+static uint32_t sMarkMs[kNumPhases] = {};
+
+static const char* const kPhaseNames[kNumPhases] = {
+    "setupEntry", "canOpen", "appBuilt", "engineArmed",
+    "first127488", "oneWireBound", "subsystemsUp", "oneWireValidated",
+};
+
+namespace boot_profile {
+
+void mark(BootPhase phase) {
+    size_t i = static_cast<size_t>(phase);
+    if (i >= kNumPhases || sMarkMs[i] != 0) return;
+    sMarkMs[i] = millis() + 1;
+    ESP_LOGI("Boot", "%-16s %6lu ms", kPhaseNames[i], (unsigned long)(sMarkMs[i] - 1));
+}
+
+uint32_t at(BootPhase phase) {
+    size_t i = static_cast<size_t>(phase);
+    return (i < kNumPhases && sMarkMs[i] != 0) ? sMarkMs[i] - 1 : 0;
+}
+
+void init() {
+    arena::Scope scope("bootProfile");
+    auto* skBoot = arena::make<SKOutputRawJson>("design.halmet.diagnostics.bootPhases", "");
+
+    // Re-sent on the diagnostics heartbeat: the SK connection usually
+    // comes up well after the phases it reports.
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [skBoot]() {
+        JsonDocument doc;
+        doc["firmware"] = FW_VERSION_STR;
+        JsonObject phases = doc["phasesMs"].to<JsonObject>();
+        for (size_t i = 0; i < kNumPhases; i++) {
+            if (sMarkMs[i] != 0) phases[kPhaseNames[i]] = sMarkMs[i] - 1;
+        }
+        String output;
+        serializeJson(doc, output);
+        skBoot->set(output);
+    });
+}
+
+}  // namespace boot_profile
@@ -11,16 +11,18 @@
 
 #include "halmet_config.h"
 #include "engine_state.h"
+#include "arena.h"
 
 using namespace sensesp;
 
 namespace diagnostics {
 
 void init(const EngineState* st) {
-    static auto* skDiagUptime    = new SKOutputFloat("design.halmet.diagnostics.uptimeSeconds", "");
-    static auto* skDiagVersion   = new SKOutputString("design.halmet.diagnostics.firmwareVersion", "");
-    static auto* skDiagAdsFails  = new SKOutputInt("design.halmet.diagnostics.adsFailCount", "");
-    static auto* skDiagResetCode = new SKOutputInt("design.halmet.diagnostics.lastResetReason", "");
+    arena::Scope scope("diagnostics");
+    static auto* skDiagUptime    = arena::make<SKOutputFloat>("design.halmet.diagnostics.uptimeSeconds", "");
+    static auto* skDiagVersion   = arena::make<SKOutputString>("design.halmet.diagnostics.firmwareVersion", "");
+    static auto* skDiagAdsFails  = arena::make<SKOutputInt>("design.halmet.diagnostics.adsFailCount", "");
+    static auto* skDiagResetCode = arena::make<SKOutputInt>("design.halmet.diagnostics.lastResetReason", "");
 
     skDiagVersion->set(FW_VERSION_STR);
 
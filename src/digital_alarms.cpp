@@ -1,33 +1,133 @@
 // ============================================================
-//  digital_alarms.cpp — Oil/temp alarm input debounce
+//  digital_alarms.cpp — Oil/temp alarm inputs
+//
+//  D2/D3 raise a CHANGE interrupt; the ISR timestamps the edge
+//  into a small ring.  Every ALARM_INTEGRATOR_TICK_MS the event
+//  loop replays the edges, in order, into one AlarmIntegrator per
+//  input, so the debounce works on real edge times rather than on
+//  whatever the input happened to be at a sample instant.  An
+//  alarm change drives the warning lamp and calls onChange (PGN
+//  127489 goes out immediately) in the same tick.
 // ============================================================
 
 #include "digital_alarms.h"
 
 #include <Arduino.h>
+#include <algorithm>
 #include <sensesp.h>
+#include <sensesp/system/observablevalue.h>
 
 #include "halmet_config.h"
 #include "engine_state.h"
+#include "AlarmIntegrator.h"
+#include "dlog.h"
 
 using namespace sensesp;
 
 namespace digital_alarms {
 
-void init(EngineState* st) {
-    // Alarm digital inputs with debounce (500 ms)
-    // Shift-register majority vote: alarm asserts only when
-    // ALARM_DEBOUNCE_THRESHOLD of the last ALARM_DEBOUNCE_SAMPLES agree.
-    event_loop()->onRepeat(INTERVAL_DIGITAL_ALARM_MS, [st]() {
-        constexpr uint8_t mask = (1 << ALARM_DEBOUNCE_SAMPLES) - 1;
+// ============================================================
+//  File-scope state
+// ============================================================
+enum : uint8_t { kOil = 0, kTemp = 1, kNumInputs = 2 };
+
+struct Edge {
+    uint32_t us;
+    uint8_t  input;
+    uint8_t  active;
+};
 
-        st->oilAlarmHistory  = ((st->oilAlarmHistory  << 1) | (digitalRead(HALMET_PIN_D2) == LOW)) & mask;
-        st->tempAlarmHistory = ((st->tempAlarmHistory << 1) | (digitalRead(HALMET_PIN_D3) == LOW)) & mask;
+// Single-producer (ISRs, same core) / single-consumer (event loop) ring
+static constexpr uint32_t kRingLen = 32;                  // power of two
+static Edge               sRing[kRingLen];
+static volatile uint32_t  sHead     = 0;                  // written by ISR
+static volatile uint32_t  sTail     = 0;                  // written by loop
+static volatile bool      sOverflow = false;
 
-        st->oilAlarm  = (__builtin_popcount(st->oilAlarmHistory)  >= ALARM_DEBOUNCE_THRESHOLD);
-        st->tempAlarm = (__builtin_popcount(st->tempAlarmHistory) >= ALARM_DEBOUNCE_THRESHOLD);
+static const uint8_t kPins[kNumInputs] = { HALMET_PIN_D2, HALMET_PIN_D3 };
 
-        digitalWrite(HALMET_PIN_WARN_LAMP, (st->oilAlarm || st->tempAlarm) ? HIGH : LOW);
+static AlarmIntegrator sInt[kNumInputs] = {
+    AlarmIntegrator(DEFAULT_ALARM_ASSERT_MS * 1000UL, DEFAULT_ALARM_RELEASE_MS * 1000UL,
+                    ALARM_DRAIN_RATIO),
+    AlarmIntegrator(DEFAULT_ALARM_ASSERT_MS * 1000UL, DEFAULT_ALARM_RELEASE_MS * 1000UL,
+                    ALARM_DRAIN_RATIO),
+};
+
+// ----------------------------------------------------------
+//  ISRs — inputs are active-low (switch to GND)
+// ----------------------------------------------------------
+static inline void IRAM_ATTR pushEdge(uint8_t input) {
+    uint32_t head = sHead;
+    if (head - sTail >= kRingLen) {
+        if (!sOverflow) dlog::log(LogFmt::ALARM_EDGE_OVERFLOW, input);
+        sOverflow = true;       // loop resyncs from the pin levels
+        return;
+    }
+    Edge& e  = sRing[head & (kRingLen - 1)];
+    e.us     = micros();
+    e.input  = input;
+    e.active = (digitalRead(kPins[input]) == LOW);
+    sHead    = head + 1;
+}
+
+static void IRAM_ATTR isrOil()  { pushEdge(kOil); }
+static void IRAM_ATTR isrTemp() { pushEdge(kTemp); }
+
+static inline bool pinActive(uint8_t input) {
+    return digitalRead(kPins[input]) == LOW;
+}
+
+void init(const InitParams& p) {
+    EngineState*                       st         = p.state;
+    PersistingObservableValue<float>*  povAssert  = p.assertMs;
+    PersistingObservableValue<float>*  povRelease = p.releaseMs;
+    void                             (*onChange)() = p.onChange;
+
+    // Start released and let a closed switch integrate up, so an alarm
+    // present at power-on (key on, engine stopped) still needs assertMs.
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < kNumInputs; i++) {
+        sInt[i].reset(false, now);
+        sInt[i].edge(pinActive(i), now);
+    }
+    attachInterrupt(digitalPinToInterrupt(HALMET_PIN_D2), isrOil,  CHANGE);
+    attachInterrupt(digitalPinToInterrupt(HALMET_PIN_D3), isrTemp, CHANGE);
+
+    event_loop()->onRepeat(ALARM_INTEGRATOR_TICK_MS, [st, povAssert, povRelease, onChange]() {
+        uint32_t assertUs  = static_cast<uint32_t>(std::max(povAssert->get(),  1.0f) * 1000.0f);
+        uint32_t releaseUs = static_cast<uint32_t>(std::max(povRelease->get(), 1.0f) * 1000.0f);
+        for (auto& in : sInt) in.setTimes(assertUs, releaseUs);
+
+        bool changed = false;
+        while (sTail != sHead) {
+            const Edge& e = sRing[sTail & (kRingLen - 1)];
+            changed |= sInt[e.input].edge(e.active, e.us);
+            sTail = sTail + 1;
+        }
+        uint32_t now = micros();
+        if (sOverflow) {
+            // Edges were lost in a burst: continue from the actual levels
+            sOverflow = false;
+            for (uint8_t i = 0; i < kNumInputs; i++) changed |= sInt[i].edge(pinActive(i), now);
+        }
+        for (auto& in : sInt) changed |= in.update(now);
+
+        // Sampled every tick, so the alarm fields never go stale
+        uint32_t nowMs = millis();
+        st->set(st->oilAlarm,  sInt[kOil].asserted(),  nowMs);
+        st->set(st->tempAlarm, sInt[kTemp].asserted(), nowMs);
+        if (!changed) return;
+        digitalWrite(HALMET_PIN_WARN_LAMP, (st->oilAlarm.value || st->tempAlarm.value) ? HIGH : LOW);
+        dlog::log(LogFmt::ALARM_INPUTS, st->oilAlarm.value, st->tempAlarm.value);
+        if (onChange) onChange();
+    });
+
+    // Raw input history for the black box / telemetry (not used for the
+    // decision): one bit per INTERVAL_DIGITAL_ALARM_MS, newest in bit 0.
+    event_loop()->onRepeat(INTERVAL_DIGITAL_ALARM_MS, [st]() {
+        constexpr uint8_t mask = (1 << ALARM_DEBOUNCE_SAMPLES) - 1;
+        st->oilAlarmHistory  = ((st->oilAlarmHistory  << 1) | pinActive(kOil))  & mask;
+        st->tempAlarmHistory = ((st->tempAlarmHistory << 1) | pinActive(kTemp)) & mask;
     });
 }
 
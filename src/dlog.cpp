@@ -0,0 +1,99 @@
+// ============================================================
+//  dlog.cpp — Deferred log ring and its drain task
+// ============================================================
+
+#include "dlog.h"
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+namespace dlog {
+
+static LogRing      sRing;
+static uint32_t     sReportedDrops = 0;   // drain task only
+static TaskHandle_t sTask          = nullptr;
+
+bool IRAM_ATTR write(LogFmt f, const uint32_t* args, int nargs) {
+    LogRecord r;
+    r.ms       = millis();
+    r.fmt      = static_cast<uint16_t>(f);
+    r.nargs    = static_cast<uint8_t>(nargs);
+    r.reserved = 0;
+    for (int i = 0; i < kLogMaxArgs; i++) r.args[i] = i < nargs ? args[i] : 0;
+    return sRing.push(r);
+}
+
+const LogRing& ring() { return sRing; }
+
+static void emit(const LogRecord& r) {
+#ifdef DLOG_BINARY_UART
+    uint8_t frame[kLogFrameSize];
+    encodeLogFrame(r, frame);
+    Serial.write(frame, sizeof(frame));
+#else
+    if (r.fmt >= static_cast<uint16_t>(LogFmt::COUNT)) {
+        ESP_LOGW("dlog", "[%lu] unknown format %u", (unsigned long)r.ms, (unsigned)r.fmt);
+        return;
+    }
+    const LogFormat& f = kLogFormats[r.fmt];
+    char text[160];
+    formatLogRecord(f.fmt, r, text, sizeof(text));
+    switch (f.level) {
+    case 'E': ESP_LOGE(f.tag, "[%lu] %s", (unsigned long)r.ms, text); break;
+    case 'W': ESP_LOGW(f.tag, "[%lu] %s", (unsigned long)r.ms, text); break;
+    default:  ESP_LOGI(f.tag, "[%lu] %s", (unsigned long)r.ms, text); break;
+    }
+#endif
+}
+
+size_t drain(size_t max) {
+    size_t    n = 0;
+    LogRecord r;
+    while (n < max && sRing.pop(r)) {
+        emit(r);
+        n++;
+    }
+    uint32_t drops = sRing.dropped();
+    if (drops != sReportedDrops) {
+        ESP_LOGW("dlog", "%lu log records dropped (ring full)",
+                 (unsigned long)(drops - sReportedDrops));
+        sReportedDrops = drops;
+    }
+    return n;
+}
+
+static void drainTask(void*) {
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_MS));
+        drain(LogRing::kCapacity);
+    }
+}
+
+void init() {
+    arena::Scope scope("dlog");
+    xTaskCreatePinnedToCore(drainTask, "dlog", 3072, nullptr,
+                            tskIDLE_PRIORITY + 1, &sTask, 0);
+
+    auto* sk = arena::make<SKOutputRawJson>("design.halmet.diagnostics.log", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [sk]() {
+        JsonDocument doc;
+        doc["capacity"] = LogRing::kCapacity;
+        doc["pushed"]   = sRing.pushed();
+        doc["dropped"]  = sRing.dropped();
+        doc["drained"]  = sRing.popped();
+        doc["maxDepth"] = sRing.maxDepth();
+        String output;
+        serializeJson(doc, output);
+        sk->set(output);
+    });
+}
+
+}  // namespace dlog
@@ -0,0 +1,180 @@
+// ============================================================
+//  engine_hours.cpp — Engine hours & RPM load profile
+// ============================================================
+
+#include "engine_hours.h"
+
+#include <Arduino.h>
+#include <cstring>
+#include <esp_partition.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "engine_state.h"
+#include "FlashJournal.h"
+#include "dlog.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+namespace engine_hours {
+
+// ============================================================
+//  ESP32 data partition as journal flash
+// ============================================================
+class PartitionFlash : public JournalFlash {
+public:
+    explicit PartitionFlash(const esp_partition_t* part) : _part(part) {}
+
+    size_t sectorSize()  const override { return _part->erase_size; }
+    size_t sectorCount() const override { return _part->size / _part->erase_size; }
+
+    bool read(size_t addr, void* dst, size_t len) override {
+        return esp_partition_read(_part, addr, dst, len) == ESP_OK;
+    }
+    bool write(size_t addr, const void* src, size_t len) override {
+        return esp_partition_write(_part, addr, src, len) == ESP_OK;
+    }
+    bool erase(size_t sector) override {
+        return esp_partition_erase_range(_part, sector * _part->erase_size,
+                                         _part->erase_size) == ESP_OK;
+    }
+
+private:
+    const esp_partition_t* _part;
+};
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static EngineHoursRecord sRec         = {};
+static uint32_t          sRunCarryMs  = 0;     // sub-second remainders
+static uint32_t          sBandCarryMs[ENGINE_RPM_BANDS] = {};
+static FlashJournal*     sJournal     = nullptr;
+static bool              sDirty       = false;
+static bool              sWasRunning  = false;
+static uint32_t          sLastTickMs  = 0;
+static uint32_t          sLastSaveMs  = 0;
+
+static void save() {
+    sLastSaveMs = millis();
+    if (!sJournal) return;
+    if (sJournal->append(&sRec)) {
+        sDirty = false;
+    } else {
+        dlog::log(LogFmt::JOURNAL_APPEND_FAILED, sJournal->seq());
+    }
+}
+
+static void addMs(uint32_t& seconds, uint32_t& carryMs, uint32_t dtMs) {
+    carryMs += dtMs;
+    seconds += carryMs / 1000;
+    carryMs %= 1000;
+}
+
+static void tick(EngineState* st) {
+    uint32_t now = millis();
+    uint32_t dt  = now - sLastTickMs;
+    sLastTickMs  = now;
+
+    if (st->engineRunning.value) {
+        if (!sWasRunning) sRec.starts++;
+        float    rpm  = st->rpm.value > 0.0f ? st->rpm.value : 0.0f;
+        uint32_t band = static_cast<uint32_t>(rpm) / ENGINE_RPM_BAND_WIDTH;
+        if (band >= ENGINE_RPM_BANDS) band = ENGINE_RPM_BANDS - 1;
+        addMs(sRec.runS,        sRunCarryMs,        dt);
+        addMs(sRec.bandS[band], sBandCarryMs[band], dt);
+        sDirty = true;
+        if ((now - sLastSaveMs) >= ENGINE_HOURS_SAVE_S * 1000UL) save();
+    } else if (sDirty) {
+        save();     // engine stopped (or preset changed) — journal at once
+    }
+    sWasRunning = st->engineRunning.value;
+    if (sJournal) st->set(st->engineSeconds, sRec.runS, now);
+}
+
+void init(const InitParams& p) {
+    arena::Scope scope("engineHours");
+    EngineState*                       st        = p.state;
+    PersistingObservableValue<float>*  povPreset = p.hoursPreset;
+
+    sRec.version      = kEngineHoursVersion;
+    sRec.numBands     = ENGINE_RPM_BANDS;
+    sRec.bandWidthRpm = ENGINE_RPM_BAND_WIDTH;
+
+    const esp_partition_t* part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA,
+        static_cast<esp_partition_subtype_t>(ENGINE_HOURS_PARTITION_SUBTYPE),
+        ENGINE_HOURS_PARTITION_LABEL);
+    if (part) {
+        sJournal = arena::make<FlashJournal>(*arena::make<PartitionFlash>(part), sizeof(EngineHoursRecord));
+        EngineHoursRecord rec;
+        if (sJournal->recover(&rec) && rec.version == kEngineHoursVersion) {
+            sRec.runS   = rec.runS;
+            sRec.starts = rec.starts;
+            // A changed band layout restarts the histogram, not the hours
+            if (rec.numBands == ENGINE_RPM_BANDS && rec.bandWidthRpm == ENGINE_RPM_BAND_WIDTH) {
+                memcpy(sRec.bandS, rec.bandS, sizeof(sRec.bandS));
+            }
+        }
+        st->set(st->engineSeconds, sRec.runS, millis());
+        ESP_LOGI("EngineHours", "%.1f h, %u starts (journal seq %u, %u corrupt slots)",
+                 sRec.runS / 3600.0f, (unsigned)sRec.starts,
+                 (unsigned)sJournal->seq(), (unsigned)sJournal->corruptSlots());
+    } else {
+        ESP_LOGE("EngineHours", "No '%s' partition — engine hours are not persisted "
+                 "(upload the partition table over USB)", ENGINE_HOURS_PARTITION_LABEL);
+    }
+
+    // Hour-meter preset from the web UI: replaces the running total
+    // once, then the card goes back to "no preset" so saving it again
+    // (or the value persisted from an old preset) cannot roll the
+    // hours back.
+    povPreset->attach([povPreset]() {
+        float h = povPreset->get();
+        if (h < 0.0f) return;
+        sRec.runS   = static_cast<uint32_t>(h * 3600.0f);
+        sRunCarryMs = 0;
+        sDirty      = true;
+        save();
+        ESP_LOGI("EngineHours", "Preset to %.1f h", h);
+        povPreset->set(DEFAULT_ENGINE_HOURS_PRESET_H);
+    });
+
+    sLastTickMs = sLastSaveMs = millis();
+    event_loop()->onRepeat(INTERVAL_ENGINE_HOURS_MS, [st]() { tick(st); });
+
+    auto* skRunTime = arena::make<SKOutputFloat>("propulsion.0.runTime", "");
+    auto* skProfile = arena::make<SKOutputRawJson>("design.halmet.engine.loadProfile", "");
+
+    // Change-only: the hours (and so the profile) only move while the
+    // engine runs.  Without a journal engineSeconds is never set and
+    // the RAM-only profile goes out every time.
+    uint32_t cursor = 0;
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [st, skRunTime, skProfile, cursor]() mutable {
+        bool changed = st->takeChanges(cursor) & fieldBit(EngineField::ENGINE_HOURS);
+        if (sJournal && !changed) return;
+        if (sJournal) skRunTime->set(static_cast<float>(sRec.runS));
+
+        JsonDocument doc;
+        doc["runHours"]     = sRec.runS / 3600.0f;
+        doc["starts"]       = sRec.starts;
+        doc["bandWidthRpm"] = ENGINE_RPM_BAND_WIDTH;
+        JsonArray bands = doc["bandHours"].to<JsonArray>();
+        for (uint32_t s : sRec.bandS) bands.add(s / 3600.0f);
+        if (sJournal) {
+            JsonObject j = doc["journal"].to<JsonObject>();
+            j["seq"]          = sJournal->seq();
+            j["slots"]        = sJournal->capacity();
+            j["appends"]      = sJournal->appends();
+            j["erases"]       = sJournal->erases();
+            j["corruptSlots"] = sJournal->corruptSlots();
+        }
+        String output;
+        serializeJson(doc, output);
+        skProfile->set(output);
+    });
+}
+
+}  // namespace engine_hours
@@ -13,19 +13,22 @@
 #include "engine_state.h"
 #include "RpmSensor.h"
 #include "N2kSenders.h"
+#include "boot_profile.h"
+#include "latency.h"
+#include "supervisor.h"
 
 using namespace sensesp;
 
 namespace engine_state_machine {
 
-static void updateEngineState(EngineState* st, bool rawRunning) {
+static void updateEngineState(EngineState* st, bool rawRunning, uint32_t now) {
     if (rawRunning != st->engineRunningRaw) {
         st->engineRunningRaw = rawRunning;
-        st->engineStateMs    = millis();
-    }
-    if ((millis() - st->engineStateMs) >= ENGINE_STATE_DEBOUNCE_MS) {
-        st->engineRunning = st->engineRunningRaw;
+        st->engineStateMs    = now;
     }
+    bool running = st->engineRunning.value;
+    if ((now - st->engineStateMs) >= ENGINE_STATE_DEBOUNCE_MS) running = st->engineRunningRaw;
+    st->set(st->engineRunning, running, now);
 }
 
 void init(const InitParams& p) {
@@ -37,10 +40,16 @@ void init(const InitParams& p) {
 
     // RPM counter + N2K PGN 127488 (100 ms / 10 Hz)
     event_loop()->onRepeat(INTERVAL_RPM_MS, [st, nmea, rpm, povPulses, povThresh]() {
+        supervisor::checkIn(SupervisedTask::RPM_TICK);
         rpm->setPulsesPerRev(povPulses->get());
-        float rpmVal = rpm->update();
-        updateEngineState(st, rpmVal > povThresh->get());
-        N2kSenders::sendEngineRapidUpdate(*nmea, N2K_ENGINE_INSTANCE, rpmVal);
+        float    rpmVal = rpm->update();
+        uint32_t now    = millis();
+        st->set(st->rpm, rpmVal, rpm->acquiredMs());   // middle of the averaging window
+        updateEngineState(st, rpmVal > povThresh->get(), now);
+        if (N2kSenders::sendEngineRapidUpdate(*nmea, N2K_ENGINE_INSTANCE, rpmVal)) {
+            boot_profile::mark(BootPhase::FIRST_127488);
+            latency::record(LatencySignal::RPM, st->rpm.sampleMs, now);
+        }
     });
 }
 
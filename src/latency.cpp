@@ -0,0 +1,106 @@
+// ============================================================
+//  latency.cpp — Sample age at transmit + bus time (PGN 126992)
+// ============================================================
+
+#include "latency.h"
+
+#include <Arduino.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "BusTime.h"
+#include "LatencyHistogram.h"
+#include "dlog.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+namespace latency {
+
+static constexpr size_t kNumSignals = static_cast<size_t>(LatencySignal::COUNT);
+
+struct SignalSpec {
+    const char*   name;
+    unsigned long pgn;
+};
+
+static const SignalSpec kSignalSpecs[kNumSignals] = {
+    { "rpm",       127488UL },
+    { "coolant",   127489UL },
+    { "fuelRate",  127489UL },
+    { "tankLevel", 127505UL },
+    { "oneWire",   130316UL },
+};
+
+static LatencyHistogram sHist[kNumSignals];
+static uint32_t         sLastAcqMs[kNumSignals] = {};
+static BusTime          sBusTime(BUS_TIME_VALID_MS, BUS_TIME_STEP_MS);
+
+void record(LatencySignal s, uint32_t acquiredMs, uint32_t nowMs) {
+    if (acquiredMs == 0) return;   // never sampled
+    size_t i = static_cast<size_t>(s);
+    sHist[i].record(nowMs - acquiredMs);
+    sLastAcqMs[i] = acquiredMs;
+}
+
+void onSystemTime(uint16_t days, double seconds, uint8_t source, uint32_t rxMs) {
+    bool wasSynced = sBusTime.synced(rxMs);
+    if (sBusTime.update(days, seconds, source, rxMs) && !wasSynced) {
+        dlog::log(LogFmt::BUS_TIME_SOURCE, source);
+    }
+}
+
+int64_t utcMs(uint32_t localMs) {
+    return sBusTime.utcMs(localMs);
+}
+
+const LatencyHistogram& histogram(LatencySignal s) {
+    return sHist[static_cast<size_t>(s)];
+}
+
+static void publish(SKOutputRawJson* sk) {
+    uint32_t     now = millis();
+    JsonDocument doc;
+
+    JsonObject bt = doc["busTime"].to<JsonObject>();
+    bt["synced"]  = sBusTime.synced(now);
+    bt["updates"] = sBusTime.updates();
+    if (sBusTime.updates()) {
+        bt["source"]  = sBusTime.source();
+        bt["steps"]   = sBusTime.steps();
+        bt["ignored"] = sBusTime.ignored();
+        bt["utcMs"]   = sBusTime.utcMs(now);
+    }
+
+    JsonArray signals = doc["signals"].to<JsonArray>();
+    for (size_t i = 0; i < kNumSignals; i++) {
+        const LatencyHistogram& h = sHist[i];
+        JsonObject o = signals.add<JsonObject>();
+        o["name"] = kSignalSpecs[i].name;
+        o["pgn"]  = kSignalSpecs[i].pgn;
+        o["n"]    = h.count();
+        if (h.count() == 0) continue;
+        o["lastMs"] = h.lastMs();
+        o["meanMs"] = h.meanMs();
+        o["p50Ms"]  = h.percentileMs(0.50f);
+        o["p95Ms"]  = h.percentileMs(0.95f);
+        o["p99Ms"]  = h.percentileMs(0.99f);
+        o["maxMs"]  = h.maxMs();
+        if (sBusTime.updates()) o["acquiredUtcMs"] = sBusTime.utcMs(sLastAcqMs[i]);
+        JsonArray b = o["buckets"].to<JsonArray>();   // [0,1) [1,2) [2,4) … ms
+        for (int k = 0; k < LatencyHistogram::kBuckets; k++) b.add(h.bucket(k));
+    }
+
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
+
+void init() {
+    arena::Scope scope("latency");
+    auto* sk = arena::make<SKOutputRawJson>("design.halmet.diagnostics.latency", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [sk]() { publish(sk); });
+}
+
+}  // namespace latency
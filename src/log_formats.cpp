@@ -0,0 +1,27 @@
+// ============================================================
+//  log_formats.cpp — kLogFormats table (see log_formats.h)
+//
+//  Parsed by tools/log_decode.py: one entry per line.
+// ============================================================
+
+#include "log_formats.h"
+
+const LogFormat kLogFormats[static_cast<int>(LogFmt::COUNT)] = {
+    { LogFmt::RELAY_CHANGE,                   'I', "BilgeFan",    "Relay -> %B" },
+    { LogFmt::FAN_SK_PUT,                     'I', "BilgeFan",    "SK PUT -> %B" },
+    { LogFmt::SWITCH_BANK_CONTROL,            'I', "N2K",         "PGN 127502: bank=%u sw0=%d" },
+    { LogFmt::N2K_ADDRESS_CLAIMED,            'I', "HALMET",      "N2K address claimed: %d (saved)" },
+    { LogFmt::ADS_FOUND,                      'I', "HALMET",      "ADS1115 found at 0x%02X" },
+    { LogFmt::ADS_NOT_ANSWERING,              'W', "HALMET",      "ADS1115 not answering at 0x%02X — will retry" },
+    { LogFmt::ALARM_INPUTS,                   'I', "HALMET",      "Alarm inputs: oil=%d temp=%d" },
+    { LogFmt::ALARM_EDGE_OVERFLOW,            'W', "HALMET",      "Alarm edge ring full at input %u — resyncing from pin levels" },
+    { LogFmt::JOURNAL_APPEND_FAILED,          'W', "EngineHours", "Journal append failed (seq %u)" },
+    { LogFmt::BLACKBOX_TRIGGER,               'W', "BlackBox",    "Trigger: reason %u — capturing %d post-trigger samples" },
+    { LogFmt::BUS_TIME_SOURCE,                'I', "Latency",     "Bus time from N2K address %u" },
+    { LogFmt::MQTT_CONNECTED,                 'I', "MQTT",        "Broker connected (%u batches queued)" },
+    { LogFmt::MQTT_DISCONNECTED,              'W', "MQTT",        "Broker disconnected — batches queue until it is back" },
+    { LogFmt::BLACKBOX_TRIGGER_OIL,           'W', "BlackBox",    "Trigger: oilAlarm — capturing %d post-trigger samples" },
+    { LogFmt::BLACKBOX_TRIGGER_TEMP,          'W', "BlackBox",    "Trigger: tempAlarm — capturing %d post-trigger samples" },
+    { LogFmt::BLACKBOX_TRIGGER_COOLANT_WARN,  'W', "BlackBox",    "Trigger: coolantWarn — capturing %d post-trigger samples" },
+    { LogFmt::BLACKBOX_TRIGGER_COOLANT_ALARM, 'W', "BlackBox",    "Trigger: coolantAlarm — capturing %d post-trigger samples" },
+};
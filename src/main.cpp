@@ -37,22 +37,33 @@
 #include <ArduinoOTA.h>
 #include <NMEA2000_esp32.h>
 #include <Preferences.h>
-
-// --- Adafruit ADS1115 ---
-#include <Adafruit_ADS1X15.h>
+#include <Wire.h>
 
 // --- Project modules ---
 #include "secrets.h"
 #include "halmet_config.h"
+#include "arena.h"
 #include "engine_state.h"
 #include "BilgeFan.h"
 #include "RpmSensor.h"
 #include "analog_inputs.h"
+#include "alarm_rules.h"
 #include "digital_alarms.h"
 #include "engine_state_machine.h"
 #include "onewire_setup.h"
+#include "OneWireRegistry.h"
 #include "n2k_publisher.h"
 #include "diagnostics.h"
+#include "dlog.h"
+#include "latency.h"
+#include "blackbox.h"
+#include "telemetry_stream.h"
+#include "mqtt_export.h"
+#include "boot_profile.h"
+#include "engine_hours.h"
+#include "ota_stream.h"
+#include "rev_analysis.h"
+#include "supervisor.h"
 
 using namespace sensesp;
 
@@ -60,14 +71,14 @@ using namespace sensesp;
 //  Global hardware objects
 // ============================================================
 static tNMEA2000_esp32  gNmea2000;
-static Adafruit_ADS1115 gAds;
 static RpmSensor        gRpm(HALMET_PIN_D1);
 static BilgeFan         gBilgeFan(HALMET_PIN_RELAY, /*activeHigh=*/true);
 
 // ============================================================
 //  Shared engine/sensor state
 // ============================================================
-static EngineState gState;
+static EngineState     gState;
+static OneWireRegistry gOneWire;   // every probe on every 1-Wire bus, keyed by ROM
 
 // ============================================================
 //  NMEA 2000 setup
@@ -114,6 +125,11 @@ static void setupNmea2000() {
 // ============================================================
 void setup() {
     SetupLogging();
+    boot_profile::mark(BootPhase::SETUP_ENTRY);
+
+    // ========================================================
+    //  Stage 1 — engine-critical I/O and CAN, before anything slow
+    // ========================================================
 
     // --- Digital inputs ---
     pinMode(HALMET_PIN_D2, INPUT_PULLUP);
@@ -130,32 +146,28 @@ void setup() {
     // --- Bilge fan relay ---
     gBilgeFan.begin();
 
-    // --- I2C bus ---
-    Wire.setTimeOut(100);
-    Wire.begin(HALMET_PIN_SDA, HALMET_PIN_SCL);
-    Wire.setClock(400000);
-
-    // --- ADS1115 ADC (ADDR tied to VCC → 0x4B) ---
-    gState.adsOk = gAds.begin(ADS1115_I2C_ADDRESS, &Wire);
-    if (gState.adsOk) {
-        gAds.setGain(GAIN_ONE);
-        gAds.setDataRate(RATE_ADS1115_8SPS);
-        ESP_LOGI("HALMET", "ADS1115 found at 0x%02X", ADS1115_I2C_ADDRESS);
-    } else {
-        gState.adsFailCount++;
-        ESP_LOGE("HALMET", "ADS1115 not found at 0x4B — will retry");
-    }
-
-    // --- NMEA 2000 ---
+    // --- NMEA 2000 (address claim runs from the message pump) ---
     setupNmea2000();
+    boot_profile::mark(BootPhase::CAN_OPEN);
 
     // --- SensESP v3 app builder ---
+    // Mounts the filesystem the persisted config below is read from;
+    // WiFi and the SK connection come up in the background.
     SensESPAppBuilder builder;
     builder.set_hostname("halmet-engine")
            ->set_wifi_client(WIFI_SSID, WIFI_PASSWORD)
            ->set_sk_server(SK_SERVER_IP, SK_SERVER_PORT)
-           ->enable_ota("SomeOTAPassword")
+           ->enable_ota(OTA_PASSWORD)
            ->get_app();
+    boot_profile::mark(BootPhase::APP_BUILT);
+
+    // --- I2C bus ---
+    Wire.setTimeOut(100);
+    Wire.begin(HALMET_PIN_SDA, HALMET_PIN_SCL);
+    Wire.setClock(400000);
+
+    // ADS1115s (kAdsChannels) are probed by analog_inputs' scheduler
+    // on its first tick and retried every INTERVAL_ADS_RETRY_MS.
 
     // --- Persist N2K source address after address claiming ---
     event_loop()->onRepeat(10000, []() {
@@ -165,41 +177,84 @@ void setup() {
             prefs.begin("n2k", /*readOnly=*/false);
             prefs.putUChar("addr", addr);
             prefs.end();
-            ESP_LOGI("HALMET", "N2K address claimed: %d (saved)", addr);
+            dlog::log(LogFmt::N2K_ADDRESS_CLAIMED, addr);
         }
     });
 
     // --- Configurable parameters (web UI + persisted to flash) ---
-    auto* gPurgeDurationSec = new PersistingObservableValue<float>(
+    //  Objects built from here on live until reset: static arena.
+    arena::Scope scope("main");
+
+    auto* gPurgeDurationSec = arena::make<PersistingObservableValue<float>>(
         DEFAULT_PURGE_DURATION_S, "/bilge/purge_duration_s");
     ConfigItem(gPurgeDurationSec)
         ->set_title("Bilge fan purge duration (s)");
 
-    auto* gPulsesPerRev = new PersistingObservableValue<float>(
+    auto* gPulsesPerRev = arena::make<PersistingObservableValue<float>>(
         DEFAULT_PULSES_PER_REVOLUTION, "/rpm/pulses_per_rev");
     ConfigItem(gPulsesPerRev)
         ->set_title("Alternator pulses per engine revolution");
 
-    auto* gEngineRunningRpm = new PersistingObservableValue<float>(
+    auto* gEngineRunningRpm = arena::make<PersistingObservableValue<float>>(
         DEFAULT_ENGINE_RUNNING_RPM, "/rpm/running_threshold");
     ConfigItem(gEngineRunningRpm)
         ->set_title("RPM threshold: engine considered running");
 
-    auto* gTankCapacityL = new PersistingObservableValue<float>(
+    auto* gTankCapacityL = arena::make<PersistingObservableValue<float>>(
         DEFAULT_TANK_CAPACITY_L, "/tank/capacity_l");
     ConfigItem(gTankCapacityL)
         ->set_title("Tank capacity (litres)");
 
-    auto* gCoolantWarnC = new PersistingObservableValue<float>(
+    auto* gCoolantWarnC = arena::make<PersistingObservableValue<float>>(
         DEFAULT_COOLANT_WARN_C, "/coolant/warn_threshold_c");
     ConfigItem(gCoolantWarnC)
         ->set_title("Coolant warning threshold (°C)");
 
-    auto* gCoolantAlarmC = new PersistingObservableValue<float>(
+    auto* gCoolantAlarmC = arena::make<PersistingObservableValue<float>>(
         DEFAULT_COOLANT_ALARM_C, "/coolant/alarm_threshold_c");
     ConfigItem(gCoolantAlarmC)
         ->set_title("Coolant alarm threshold (°C)");
 
+    auto* gAlarmAssertMs = arena::make<PersistingObservableValue<float>>(
+        DEFAULT_ALARM_ASSERT_MS, "/alarms/assert_ms");
+    ConfigItem(gAlarmAssertMs)
+        ->set_title("Oil/temp alarm assert time (ms)");
+
+    auto* gAlarmReleaseMs = arena::make<PersistingObservableValue<float>>(
+        DEFAULT_ALARM_RELEASE_MS, "/alarms/release_ms");
+    ConfigItem(gAlarmReleaseMs)
+        ->set_title("Oil/temp alarm release time (ms)");
+
+    auto* gEngineHoursPreset = arena::make<PersistingObservableValue<float>>(
+        DEFAULT_ENGINE_HOURS_PRESET_H, "/engine/hours_preset");
+    ConfigItem(gEngineHoursPreset)
+        ->set_title("Engine hour meter preset (h, applied once when saved; -1 = none)");
+
+    auto* gBlackboxPostS = arena::make<PersistingObservableValue<float>>(
+        DEFAULT_BLACKBOX_POST_S, "/blackbox/post_trigger_s");
+    ConfigItem(gBlackboxPostS)
+        ->set_title("Black-box post-trigger capture (s, max 30)");
+
+    auto* gTelemetryEnabled = arena::make<PersistingObservableValue<bool>>(
+        false, "/telemetry/stream_enabled");
+    ConfigItem(gTelemetryEnabled)
+        ->set_title("Commissioning telemetry stream (TCP port 8765)");
+
+    auto* gMqttBrokerUri = arena::make<PersistingObservableValue<String>>(
+        DEFAULT_MQTT_BROKER_URI, "/mqtt/broker_uri");
+    ConfigItem(gMqttBrokerUri)
+        ->set_title("MQTT export broker URI (mqtt://host:1883, empty = off)");
+
+    auto* gMqttQos = arena::make<PersistingObservableValue<int>>(
+        DEFAULT_MQTT_QOS, "/mqtt/qos");
+    ConfigItem(gMqttQos)
+        ->set_title("MQTT export QoS (0-2)");
+
+    auto* gMqttMsgpack = arena::make<PersistingObservableValue<bool>>(
+        false, "/mqtt/msgpack");
+    ConfigItem(gMqttMsgpack)
+        ->set_title("MQTT export as MessagePack (off = CBOR)");
+
     // --- Signal K outputs for data with no NMEA 2000 PGN ---
 
     // Metadata subclass: no units (boolean path), adds supportsPut:true for KIP.
@@ -218,44 +273,42 @@ void setup() {
       String display_name_;
     };
 
-    auto* skFanState = new SKOutputBool("electrical.switches.bilgeFan.state", "",
-                                        new SwitchMetadata("Bilge fan"));
-    auto* skIgnState = new SKOutputBool("electrical.switches.ignition.state", "",
-                                        new SKMetadata("", "Ignition turned on"));
+    auto* skFanState = arena::make<SKOutputBool>("electrical.switches.bilgeFan.state", "",
+                                                 arena::make<SwitchMetadata>("Bilge fan"));
+    auto* skIgnState = arena::make<SKOutputBool>("electrical.switches.ignition.state", "",
+                                                 arena::make<SKMetadata>("", "Ignition turned on"));
     skFanState->set(false);
     skIgnState->set(false);
 
-    auto* skCoolantNotification = new SKOutputRawJson(
-        "notifications.propulsion.0.coolantTemperature", "");
-
     // --- OTA safety: force relay OFF before firmware write begins ---
+    //  ArduinoOTA blocks loop() for the transfer: take the loop task
+    //  off the watchdog first, and back on if the upload fails.
     event_loop()->onDelay(0, []() {
         ArduinoOTA.onStart([]() {
+            supervisor::suspend();
             gBilgeFan.forceOff();
             ESP_LOGW("HALMET", "OTA starting — relay forced OFF");
         });
+        ArduinoOTA.onError([](ota_error_t) { supervisor::resume(); });
     });
 
     // Relay state change callback → Signal K
     gBilgeFan.onRelayChange([skFanState](bool on) {
         if (skFanState) skFanState->set(on);
-        ESP_LOGI("BilgeFan", "Relay -> %s", on ? "ON" : "OFF");
+        dlog::log(LogFmt::RELAY_CHANGE, on);
     });
 
     // SK PUT listener — allows KIP (and other SK clients) to control the fan
-    auto* fanPutListener = new SKPutRequestListener<bool>(
+    auto* fanPutListener = arena::make<SKPutRequestListener<bool>>(
         "electrical.switches.bilgeFan.state");
-    fanPutListener->connect_to(new LambdaConsumer<bool>([](bool v) {
+    fanPutListener->connect_to(arena::make<LambdaConsumer<bool>>([](bool v) {
         if (v) gBilgeFan.manualOn();
         else   gBilgeFan.forceOff();
-        ESP_LOGI("BilgeFan", "SK PUT -> %s", v ? "ON" : "OFF");
+        dlog::log(LogFmt::FAN_SK_PUT, v);
     }));
 
-    // --- 1-Wire setup ---
-    static onewire_setup::Outputs owOut = {};
-    onewire_setup::init(owOut);
-
     // --- Module init (callback registration order preserved) ---
+    supervisor::init();
     engine_state_machine::init({
         .state            = &gState,
         .nmea2000         = &gNmea2000,
@@ -265,27 +318,36 @@ void setup() {
     });
 
     analog_inputs::init({
-        .state                 = &gState,
-        .ads                   = &gAds,
-        .skCoolantNotification = skCoolantNotification,
-        .coolantWarnC          = gCoolantWarnC,
-        .coolantAlarmC         = gCoolantAlarmC,
+        .state         = &gState,
+        .tankCapacityL = gTankCapacityL,
     });
 
-    digital_alarms::init(&gState);
+    digital_alarms::init({
+        .state     = &gState,
+        .assertMs  = gAlarmAssertMs,
+        .releaseMs = gAlarmReleaseMs,
+        .onChange  = n2k_publisher::publishEngineDynamic,
+    });
 
     n2k_publisher::init({
         .state         = &gState,
         .nmea2000      = &gNmea2000,
         .tankCapacityL = gTankCapacityL,
-        .owDest        = owOut.owDest,
-        .owSensors     = owOut.owSensors,
+        .owRegistry    = &gOneWire,
         .bilgeFan      = &gBilgeFan,
     });
 
+    alarm_rules::init({
+        .state         = &gState,
+        .owRegistry    = &gOneWire,
+        .coolantWarnC  = gCoolantWarnC,
+        .coolantAlarmC = gCoolantAlarmC,
+    });
+    boot_profile::mark(BootPhase::ENGINE_ARMED);
+
     // Bilge fan state machine tick (1 s)
     event_loop()->onRepeat(INTERVAL_FAN_MS, [gPurgeDurationSec]() {
-        gBilgeFan.update(gState.engineRunning, gPurgeDurationSec->get());
+        gBilgeFan.update(gState.engineRunning.value, gPurgeDurationSec->get());
     });
 
     // Signal K supplemental data (5 s)
@@ -294,9 +356,57 @@ void setup() {
         if (skIgnState) skIgnState->set(digitalRead(HALMET_PIN_D4) == HIGH);
     });
 
-    diagnostics::init(&gState);
+    // ========================================================
+    //  Stage 2 — slow subsystems, from the first event-loop tick so
+    //  RPM / coolant / alarms are already being published.  Engine
+    //  hours go out as N2kDoubleNA until the journal is scanned.  The
+    //  1-Wire probes bind from the NVS ROM cache; the bus search
+    //  that validates it runs later, one ROM per step.
+    // ========================================================
+    event_loop()->onDelay(0, [gBlackboxPostS, gTelemetryEnabled, gEngineHoursPreset,
+                              gMqttBrokerUri, gMqttQos, gMqttMsgpack]() {
+        onewire_setup::init(gOneWire);
+
+        engine_hours::init({
+            .state       = &gState,
+            .hoursPreset = gEngineHoursPreset,
+        });
+
+        diagnostics::init(&gState);
+        dlog::init();
+        latency::init();
+        boot_profile::init();
+
+        blackbox::init({
+            .state        = &gState,
+            .owRegistry   = &gOneWire,
+            .postTriggerS = gBlackboxPostS,
+        });
+
+        telemetry_stream::init({
+            .state   = &gState,
+            .rpm     = &gRpm,
+            .enabled = gTelemetryEnabled,
+        });
+
+        mqtt_export::init({
+            .state      = &gState,
+            .owRegistry = &gOneWire,
+            .brokerUri  = gMqttBrokerUri,
+            .qos        = gMqttQos,
+            .msgpack    = gMqttMsgpack,
+        });
+
+        ota_stream::init({ .bilgeFan = &gBilgeFan });
+
+        rev_analysis::init({ .rpm = &gRpm });
+
+        arena::init();
+        arena::seal();
+        boot_profile::mark(BootPhase::SUBSYSTEMS_UP);
+    });
 
-    ESP_LOGI("HALMET", "Setup complete.");
+    ESP_LOGI("HALMET", "Setup complete (stage 2 deferred to event loop).");
 }
 
 // ============================================================
@@ -0,0 +1,290 @@
+// ============================================================
+//  mqtt_export.cpp — Compact telemetry batches to an MQTT broker
+// ============================================================
+
+#include "mqtt_export.h"
+
+#include <Arduino.h>
+#include <atomic>
+#include <cmath>
+#include <N2kMsg.h>
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#include <mqtt_client.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "blackbox.h"
+#include "CompactEncoder.h"
+#include "OneWireRegistry.h"
+#include "PayloadQueue.h"
+#include "TelemetryBatch.h"
+#include "arena.h"
+#include "dlog.h"
+#include "latency.h"
+#include "onewire_setup.h"
+
+using namespace sensesp;
+
+namespace mqtt_export {
+
+// ============================================================
+//  Columns of a batch row, in EngineState order
+// ============================================================
+static const TelemetryBatch::Column kColumns[] = {
+    { "rpm",     1.0f },     // RPM
+    { "coolC",   10.0f },    // °C
+    { "tankPct", 10.0f },    // % of capacity, filtered
+    { "fuelLph", 100.0f },   // L/h
+    { "engH",    100.0f },   // engine hours
+    { "flags",   1.0f },     // kBlackboxFlag* bits
+};
+static constexpr int kNumColumns = sizeof(kColumns) / sizeof(kColumns[0]);
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static TelemetryBatch sBatch(kColumns, kNumColumns);
+alignas(4) static uint8_t sQueueBuf[MQTT_QUEUE_SLOTS * (MQTT_PAYLOAD_MAX + 2)];
+static PayloadQueue       sQueue(sQueueBuf, MQTT_QUEUE_SLOTS, MQTT_PAYLOAD_MAX + 2);
+static uint8_t            sScratch[MQTT_PAYLOAD_MAX];
+
+static const OneWireRegistry*             sRegistry = nullptr;
+static PersistingObservableValue<String>* sUri      = nullptr;
+static PersistingObservableValue<int>*    sQos      = nullptr;
+static PersistingObservableValue<bool>*   sMsgpack  = nullptr;
+
+static esp_mqtt_client_handle_t sClient       = nullptr;
+static bool                     sRestart      = false;   // broker URI saved
+static bool                     sBadUri       = false;   // rejected; not retried until saved again
+static bool                     sWasConnected = false;
+
+// Written by the esp-mqtt task
+static std::atomic<bool>     sConnected{false};
+static std::atomic<uint32_t> sAcked{0};
+
+static uint32_t sBatches      = 0;
+static uint32_t sOverflows    = 0;   // batch did not fit MQTT_PAYLOAD_MAX
+static uint32_t sSent         = 0;
+static uint32_t sSentBytes    = 0;
+static uint32_t sLastBytes    = 0;
+static uint32_t sLastRows     = 0;
+static uint32_t sEncodeUsMax  = 0;
+
+static bool enabled() { return sUri->get().length() > 0; }
+
+static int qos() {
+    int q = sQos->get();
+    return q < 0 ? 0 : (q > 2 ? 2 : q);
+}
+
+// ============================================================
+//  esp-mqtt client (network I/O on its own task)
+// ============================================================
+static void onMqttEvent(void*, esp_event_base_t, int32_t id, void*) {
+    switch (static_cast<esp_mqtt_event_id_t>(id)) {
+        case MQTT_EVENT_CONNECTED:    sConnected = true;  break;
+        case MQTT_EVENT_DISCONNECTED: sConnected = false; break;
+        case MQTT_EVENT_PUBLISHED:    sAcked++;           break;
+        default:                                          break;
+    }
+}
+
+static void startClient() {
+    esp_mqtt_client_config_t cfg = {};
+    cfg.broker.address.uri    = sUri->get().c_str();   // copied by the client
+    cfg.credentials.client_id = MQTT_CLIENT_ID;
+    cfg.session.keepalive     = 30;
+    sClient = esp_mqtt_client_init(&cfg);
+    if (!sClient) {
+        ESP_LOGW("MQTT", "Bad broker URI '%s'", sUri->get().c_str());
+        sBadUri = true;
+        return;
+    }
+    esp_mqtt_client_register_event(sClient, MQTT_EVENT_ANY, onMqttEvent, nullptr);
+    esp_mqtt_client_start(sClient);
+    ESP_LOGI("MQTT", "Exporting to %s (%s, QoS %d)", sUri->get().c_str(),
+             sMsgpack->get() ? "MessagePack" : "CBOR", qos());
+}
+
+static void stopClient() {
+    if (!sClient) return;
+    esp_mqtt_client_stop(sClient);
+    esp_mqtt_client_destroy(sClient);
+    sClient       = nullptr;
+    sConnected    = false;
+    sWasConnected = false;
+}
+
+// ============================================================
+//  Sampling and encoding (event loop)
+// ============================================================
+static void sample(const EngineState* st) {
+    uint32_t now = millis();
+    double   fuel = st->freshOr(st->fuelRateLph, N2kDoubleNA, now);
+    double   engS = st->engineSeconds.value;
+    float    v[kNumColumns] = {
+        st->freshOr(st->rpm, NAN, now),
+        (st->fresh(st->coolantK, now) && !N2kIsNA(st->coolantK.value))
+            ? static_cast<float>(st->coolantK.value - 273.15) : NAN,
+        st->freshOr(st->tankLevelPct, NAN, now),
+        N2kIsNA(fuel) ? NAN : static_cast<float>(fuel),
+        N2kIsNA(engS) ? NAN : static_cast<float>(engS / 3600.0),
+        static_cast<float>((st->oilAlarm.value      ? kBlackboxFlagOilAlarm      : 0)
+                         | (st->tempAlarm.value     ? kBlackboxFlagTempAlarm     : 0)
+                         | (static_cast<uint8_t>(st->coolantAlertState.value) << kBlackboxFlagCoolantShift)
+                         | (st->engineRunning.value ? kBlackboxFlagEngineRunning : 0)
+                         | (st->adsOk               ? kBlackboxFlagAdsOk         : 0)),
+    };
+    sBatch.add(now, v);
+}
+
+// "ow": [[instance, °C × 10], …] for every bound probe
+static void encodeOneWire(CompactEncoder& e, uint32_t now) {
+    uint32_t n = 0;
+    for (const auto& p : *sRegistry) {
+        if (p.bound() && p.instance >= 0 && p.dest < kNumTempDests) n++;
+    }
+    e.putStr("ow");
+    e.beginArray(n);
+    for (const auto& p : *sRegistry) {
+        if (!p.bound() || p.instance < 0 || p.dest >= kNumTempDests) continue;
+        e.beginArray(2);
+        e.putUint(static_cast<uint32_t>(p.instance));
+        e.putScaled(p.fresh(now) ? p.value->get() - 273.15f : NAN, 10.0f);   // stale as for PGN 130316
+    }
+}
+
+// "d": {up, ads, rst, drop, heap}
+static void encodeDiagnostics(CompactEncoder& e, const EngineState* st) {
+    e.putStr("d");
+    e.beginMap(5);
+    e.putStr("up");
+    e.putUint(millis() / 1000);
+    e.putStr("ads");
+    e.putUint(st->adsFailCount);
+    e.putStr("rst");
+    e.putUint(static_cast<uint32_t>(esp_reset_reason()));
+    e.putStr("drop");
+    e.putUint(sQueue.dropped());
+    e.putStr("heap");
+    e.putUint(heap_caps_get_free_size(MALLOC_CAP_8BIT));
+}
+
+static void closeBatch(const EngineState* st) {
+    if (sBatch.count() == 0) return;
+    uint32_t t0  = micros();
+    uint32_t now = millis();
+
+    CompactEncoder e(sScratch, sizeof(sScratch),
+                     sMsgpack->get() ? CompactFormat::MSGPACK : CompactFormat::CBOR);
+    sBatch.encode(e, latency::utcMs(sBatch.firstMs()), 2);
+    encodeOneWire(e, now);
+    encodeDiagnostics(e, st);
+
+    uint32_t us = micros() - t0;
+    if (us > sEncodeUsMax) sEncodeUsMax = us;
+    sLastRows = sBatch.count();
+    sBatch.clear();
+    if (e.overflowed()) {
+        sOverflows++;
+        return;
+    }
+    sLastBytes = e.size();
+    sBatches++;
+    sQueue.push(e.data(), e.size());
+}
+
+// ============================================================
+//  Queue → client: never more than MQTT_OUTBOX_MAX_BYTES waiting
+//  in the client for the network or an ack
+// ============================================================
+static void pump() {
+    if (sRestart) {
+        stopClient();
+        sRestart = false;
+        sBadUri  = false;
+    }
+    if (!enabled()) return;
+    if (!sClient) {
+        if (!sBadUri) startClient();
+        return;
+    }
+
+    bool up = sConnected;
+    if (up != sWasConnected) {
+        if (up) dlog::log(LogFmt::MQTT_CONNECTED, static_cast<uint32_t>(sQueue.depth()));
+        else    dlog::log(LogFmt::MQTT_DISCONNECTED);
+        sWasConnected = up;
+    }
+    if (!up) return;
+
+    size_t len;
+    while (const uint8_t* p = sQueue.front(len)) {
+        if (esp_mqtt_client_get_outbox_size(sClient) > MQTT_OUTBOX_MAX_BYTES) break;
+        int id = esp_mqtt_client_enqueue(sClient, MQTT_TOPIC, reinterpret_cast<const char*>(p),
+                                         static_cast<int>(len), qos(), 0, true);
+        if (id < 0) break;
+        sSent++;
+        sSentBytes += len;
+        sQueue.pop();
+    }
+}
+
+static void publishDiag(SKOutputRawJson* sk) {
+    JsonDocument doc;
+    doc["enabled"]   = enabled();
+    doc["connected"] = static_cast<bool>(sConnected);
+    doc["format"]    = sMsgpack->get() ? "msgpack" : "cbor";
+    doc["qos"]       = qos();
+    doc["batches"]   = sBatches;
+    doc["queued"]    = sQueue.depth();
+    doc["maxQueued"] = sQueue.maxDepth();
+    doc["dropped"]   = sQueue.dropped();
+    doc["overflows"] = sOverflows;
+    doc["sent"]      = sSent;
+    doc["sentBytes"] = sSentBytes;
+    doc["acked"]     = static_cast<uint32_t>(sAcked);
+    doc["lastBytes"] = sLastBytes;
+    doc["lastRows"]  = sLastRows;
+    doc["encodeUsMax"] = sEncodeUsMax;
+    if (sClient) doc["outboxBytes"] = esp_mqtt_client_get_outbox_size(sClient);
+
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
+
+void init(const InitParams& p) {
+    arena::Scope scope("mqttExport");
+    const EngineState* st = p.state;
+    sRegistry = p.owRegistry;
+    sUri      = p.brokerUri;
+    sQos      = p.qos;
+    sMsgpack  = p.msgpack;
+
+    sUri->attach([]() { sRestart = true; });
+
+    event_loop()->onRepeat(MQTT_SAMPLE_MS, [st]() {
+        if (!enabled()) {
+            sBatch.clear();
+            return;
+        }
+        sample(st);
+        if (sBatch.full()) closeBatch(st);
+    });
+    event_loop()->onRepeat(MQTT_PUBLISH_MS, [st]() { closeBatch(st); });
+    event_loop()->onRepeat(MQTT_PUMP_MS, pump);
+
+    auto* sk = arena::make<SKOutputRawJson>("design.halmet.diagnostics.mqtt", "");
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [sk]() { publishDiag(sk); });
+}
+
+const PayloadQueue& queue() { return sQueue; }
+
+bool connected() { return sConnected; }
+
+}  // namespace mqtt_export
@@ -10,16 +10,18 @@
 #include <N2kMessages.h>
 #include <sensesp.h>
 #include <sensesp/system/observablevalue.h>
-#include <sensesp_onewire/onewire_temperature.h>
 
 #include "halmet_config.h"
 #include "engine_state.h"
 #include "onewire_setup.h"
+#include "OneWireRegistry.h"
 #include "N2kSenders.h"
 #include "BilgeFan.h"
+#include "dlog.h"
+#include "latency.h"
+#include "supervisor.h"
 
 using namespace sensesp;
-using namespace sensesp::onewire;
 
 namespace n2k_publisher {
 
@@ -27,8 +29,32 @@ namespace n2k_publisher {
 // File-scope pointer set during init(); used by the static handler below.
 static BilgeFan* sBilgeFan = nullptr;
 
+// Set during init(); used by sendEngineDynamicNow() / publishEngineDynamic()
+static EngineState* sState = nullptr;
+static tNMEA2000*   sNmea  = nullptr;
+
+// ---- PGN 127489 from the current state (coolant, hours and fuel
+//      rate NA when stale or never sampled; the status bits keep their
+//      last value, an alarm is never cleared by a stalled input) ----
+static void sendEngineDynamicNow() {
+    EngineState* st  = sState;
+    uint32_t     now = millis();
+    bool coolant  = st->fresh(st->coolantK, now);
+    bool fuelRate = st->fresh(st->fuelRateLph, now);
+    if (!N2kSenders::sendEngineDynamic(*sNmea, N2K_ENGINE_INSTANCE,
+                                       coolant ? st->coolantK.value : N2kDoubleNA,
+                                       st->freshOr(st->engineSeconds, N2kDoubleNA, now),
+                                       fuelRate ? st->fuelRateLph.value : N2kDoubleNA,
+                                       st->oilAlarm.value, st->tempAlarm.value)) {
+        return;
+    }
+    if (coolant)  latency::record(LatencySignal::COOLANT, st->coolantK.sampleMs, now);
+    if (fuelRate && !N2kIsNA(st->fuelRateLph.value)) {
+        latency::record(LatencySignal::FUEL_RATE, st->fuelRateLph.sampleMs, now);
+    }
+}
+
 static void handleSwitchBankControl(const tN2kMsg& N2kMsg) {
-    if (N2kMsg.PGN != 127502UL) return;
     unsigned char targetBank;
     tN2kBinaryStatus bankStatus;
     if (!ParseN2kSwitchbankControl(N2kMsg, targetBank, bankStatus)) return;
@@ -36,60 +62,92 @@ static void handleSwitchBankControl(const tN2kMsg& N2kMsg) {
     tN2kOnOff sw0 = N2kGetStatusOnBinaryStatus(bankStatus, 1);
     if      (sw0 == N2kOnOff_On)  sBilgeFan->manualOn();
     else if (sw0 == N2kOnOff_Off) sBilgeFan->forceOff();
-    ESP_LOGI("N2K", "PGN 127502: bank=%u sw0=%d", (unsigned)targetBank, (int)sw0);
+    dlog::log(LogFmt::SWITCH_BANK_CONTROL, targetBank, static_cast<int>(sw0));
+}
+
+// ---- PGN 126992 → bus time (UTC for the sample timestamps) ----
+static void handleSystemTime(const tN2kMsg& N2kMsg) {
+    unsigned char  sid;
+    uint16_t       days;
+    double         seconds;
+    tN2kTimeSource source;
+    if (!ParseN2kSystemTime(N2kMsg, sid, days, seconds, source)) return;
+    latency::onSystemTime(days, seconds, N2kMsg.Source, millis());
+}
+
+static void handleMessage(const tN2kMsg& N2kMsg) {
+    switch (N2kMsg.PGN) {
+        case 127502UL: handleSwitchBankControl(N2kMsg); break;
+        case 126992UL: handleSystemTime(N2kMsg);        break;
+        default: break;
+    }
 }
 
 void init(const InitParams& p) {
     EngineState*                       st         = p.state;
     tNMEA2000*                         nmea       = p.nmea2000;
     PersistingObservableValue<float>*  povTankCap  = p.tankCapacityL;
-    int*                               owDest      = p.owDest;
-    OneWireTemperature**               owSensors   = p.owSensors;
+    OneWireRegistry*                   owRegistry  = p.owRegistry;
     BilgeFan*                          bilgeFan    = p.bilgeFan;
 
-    // Register PGN 127501 (tx) and 127502 (rx) with the N2K stack
+    // Register PGN 127501 (tx) and 127502 + 126992 (rx) with the N2K stack
     sBilgeFan = bilgeFan;
+    sState    = st;
+    sNmea     = nmea;
     static const unsigned long kExtraTxPGNs[] PROGMEM = { 127501UL, 0 };
-    static const unsigned long kExtraRxPGNs[] PROGMEM = { 127502UL, 0 };
+    static const unsigned long kExtraRxPGNs[] PROGMEM = { 127502UL, 126992UL, 0 };
     nmea->ExtendTransmitMessages(kExtraTxPGNs);
     nmea->ExtendReceiveMessages(kExtraRxPGNs);
-    nmea->SetMsgHandler(handleSwitchBankControl);
+    nmea->SetMsgHandler(handleMessage);
 
     // N2K slow PGNs: PGN 127489 + PGN 127505 + PGN 127501 (1 s)
     event_loop()->onRepeat(1000, [st, nmea, povTankCap, bilgeFan]() {
-        double coolantToSend = st->coolantK;
-        if (st->coolantLastUpdateMs == 0 ||
-            (millis() - st->coolantLastUpdateMs) > STALE_DATA_TIMEOUT_MS) {
-            coolantToSend = N2kDoubleNA;
+        supervisor::checkIn(SupervisedTask::SLOW_PGNS);
+        sendEngineDynamicNow();
+        uint32_t now   = millis();
+        bool     fresh = st->fresh(st->tankLevelPct, now);
+        if (N2kSenders::sendFluidLevel(*nmea, 0, N2kft_Fuel, fresh ? st->tankLevelPct.value : N2kDoubleNA,
+                                       povTankCap->get()) && fresh) {
+            latency::record(LatencySignal::TANK_LEVEL, st->tankLevelPct.sampleMs, now);
         }
-        N2kSenders::sendEngineDynamic(*nmea, N2K_ENGINE_INSTANCE,
-                                      coolantToSend,
-                                      st->oilAlarm, st->tempAlarm);
-        N2kSenders::sendFluidLevel(*nmea, 0, N2kft_Fuel,
-                                   st->tankLevelPct, povTankCap->get());
         N2kSenders::sendBinaryStatus(*nmea, 0, bilgeFan->relayOn());
     });
 
-    // 1-Wire → N2K PGN 130316 (10 s, matching 1-Wire read interval)
-    event_loop()->onRepeat(INTERVAL_ONEWIRE_N2K_MS, [nmea, owDest, owSensors]() {
-        for (int i = 0; i < NUM_ONEWIRE_SLOTS; i++) {
-            int dest = owDest[i];
-            if (dest <= 0 || dest >= kNumTempDests || !owSensors[i]) continue;
-            int n2kSrc = kTempDests[dest].n2kSource;
+    // 1-Wire → N2K PGN 130316 (1 s tick; each registry entry at its
+    // destination's read interval, so fast profiles such as exhaust go
+    // out every second).  Instance = the entry's assigned instance;
+    // probes read in the same DS18B20 sweep share a SID.
+    event_loop()->onRepeat(INTERVAL_ONEWIRE_N2K_MS, [nmea, owRegistry]() {
+        uint32_t now = millis();
+        for (auto& e : *owRegistry) {
+            if (!e.bound() || e.dest >= kNumTempDests) continue;
+            int n2kSrc = kTempDests[e.dest].n2kSource;
             if (n2kSrc < 0) continue;
-            float tempK = owSensors[i]->get();
+            uint32_t interval = kTempDests[e.dest].intervalMs;
+            if (e.lastSentMs != 0 && (now - e.lastSentMs) < interval) continue;
+            if (!e.fresh(now)) continue;
+            float tempK = e.value->get();
             if (std::isnan(tempK) || tempK <= 0) continue;
-            N2kSenders::sendTemperatureExtended(
-                *nmea, i,
-                static_cast<tN2kTempSource>(n2kSrc),
-                tempK);
+            if (N2kSenders::sendTemperatureExtended(
+                    *nmea, N2kSenders::sidFor(e.sampleMs, N2K_SID_PERIOD_MS),
+                    static_cast<uint8_t>(e.instance),
+                    static_cast<tN2kTempSource>(n2kSrc),
+                    tempK)) {
+                latency::record(LatencySignal::ONEWIRE, e.sampleMs, now);
+            }
+            e.lastSentMs = now;
         }
     });
 
     // NMEA 2000 message pump (every 1 ms — must be fast)
     event_loop()->onRepeat(1, [nmea]() {
+        supervisor::checkIn(SupervisedTask::N2K_PUMP);
         nmea->ParseMessages();
     });
 }
 
+void publishEngineDynamic() {
+    if (sNmea && sState) sendEngineDynamicNow();
+}
+
 }  // namespace n2k_publisher
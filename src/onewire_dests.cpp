@@ -0,0 +1,28 @@
+// ============================================================
+//  onewire_dests.cpp — 1-Wire temperature destination table
+//
+//  Pure data, kept apart from onewire_setup.cpp so the publishers
+//  link without the 1-Wire driver stack (native test build).
+// ============================================================
+
+#include "onewire_setup.h"
+
+// ---- APPEND ONLY — do not reorder or insert ----
+// (appending: bump kNumTempDests in onewire_setup.h)
+// Sampling profile: fast/coarse where a failure shows up quickly
+// (exhaust → raw-water loss), slow/fine where nothing moves fast.
+const TempDestination kTempDests[] = {
+//  config  label                     n2k   SK path                                         bits  interval
+    /*0*/  {"Not used",                -1,  nullptr,                                         12, INTERVAL_1WIRE_MS},
+    /*1*/  {"Engine room",              3,  "environment.inside.engineRoom.temperature",     12, INTERVAL_1WIRE_MS},
+    /*2*/  {"Exhaust gas",             14,  "propulsion.0.exhaustTemperature",               10,  1000},
+    /*3*/  {"Sea water",                0,  "environment.water.temperature",                 12, INTERVAL_1WIRE_MS},
+    /*4*/  {"Outside air",              1,  "environment.outside.temperature",               12, 30000},
+    /*5*/  {"Inside / cabin",           2,  "environment.inside.temperature",                12, 30000},
+    /*6*/  {"Refrigeration",            7,  "environment.inside.refrigerator.temperature",   12, 30000},
+    /*7*/  {"Freezer",                 13,  "environment.inside.freezer.temperature",        12, 30000},
+    /*8*/  {"Alternator (SK only)",    -1,  "electrical.alternators.0.temperature",          11,  5000},
+    /*9*/  {"Oil sump (SK only)",      -1,  "propulsion.0.oilTemperature",                   11,  5000},
+    /*10*/ {"Intake manifold (SK only)", -1,  "propulsion.0.intakeManifoldTemperature",      11,  5000},
+    /*11*/ {"Engine block (SK only)",   -1,  "propulsion.0.engineBlockTemperature",          11,  5000},
+};
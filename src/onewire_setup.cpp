@@ -4,97 +4,132 @@
 //  Sprint 6 UX redesign: each detected sensor gets a config card
 //  with ROM address title, live temp description, and a dropdown
 //  to pick its destination (engine room, exhaust, sea water, etc.)
+//
+//  Saving a dropdown re-binds that one sensor in place (bindEntry):
+//  its sampling profile, N2K instance and SK path change on the
+//  next event-loop tick, everything else keeps running.
 // ============================================================
 
 #include "onewire_setup.h"
 
 #include <Arduino.h>
+#include <Preferences.h>
 #include <vector>
 #include <sensesp.h>
 #include <sensesp/system/observablevalue.h>
 #include <sensesp/system/saveable.h>
 #include <sensesp/ui/config_item.h>
 #include <sensesp/signalk/signalk_output.h>
-#include <sensesp_onewire/onewire_temperature.h>
-#include <OneWireNg_CurrentPlatform.h>
-#include <drivers/DSTherm.h>
+#include <sensesp/system/lambda_consumer.h>
 
 #include "halmet_config.h"
+#include "DsThermBatch.h"
+#include "OneWireRegistry.h"
+#include "boot_profile.h"
+#include "arena.h"
 
 using namespace sensesp;
-using namespace sensesp::onewire;
-
-// ---- APPEND ONLY — do not reorder or insert ----
-const TempDestination kTempDests[] = {
-//  config  label                     n2k   SK path
-    /*0*/  {"Not used",                -1,  nullptr},
-    /*1*/  {"Engine room",              3,  "environment.inside.engineRoom.temperature"},
-    /*2*/  {"Exhaust gas",             14,  "propulsion.0.exhaustTemperature"},
-    /*3*/  {"Sea water",                0,  "environment.water.temperature"},
-    /*4*/  {"Outside air",              1,  "environment.outside.temperature"},
-    /*5*/  {"Inside / cabin",           2,  "environment.inside.temperature"},
-    /*6*/  {"Refrigeration",            7,  "environment.inside.refrigerator.temperature"},
-    /*7*/  {"Freezer",                 13,  "environment.inside.freezer.temperature"},
-    /*8*/  {"Alternator (SK only)",    -1,  "electrical.alternators.0.temperature"},
-    /*9*/  {"Oil sump (SK only)",      -1,  "propulsion.0.oilTemperature"},
-    /*10*/ {"Intake manifold (SK only)", -1,  "propulsion.0.intakeManifoldTemperature"},
-    /*11*/ {"Engine block (SK only)",   -1,  "propulsion.0.engineBlockTemperature"},
-};
-const int kNumTempDests = sizeof(kTempDests) / sizeof(TempDestination);
 
 // ============================================================
 //  File-scope state
 // ============================================================
-static std::vector<OWDevAddr> sDetectedAddrs;
+static const uint8_t              kBusPins[] = ONEWIRE_BUS_PINS;
+static constexpr size_t           kNumBuses  = sizeof(kBusPins) / sizeof(kBusPins[0]);
+static DsThermBatch*              sBuses[kNumBuses] = {};  // created in init(), own the GPIOs
+static OneWireRegistry*           sRegistry = nullptr;
+
+// One SK output per destination, created on first use.  SensESP has no
+// way to unregister an SKOutput, so they are pooled rather than deleted;
+// a retired sensor simply stops feeding its destination's output.
+static SKOutputFloat*             sSkOut[kNumTempDests] = {};
 
-// Per-detected-sensor binding
+// Per-detected-sensor binding (config UI side of a registry entry)
 struct SensorBinding {
-    OWDevAddr                       addr;
+    size_t                          reg;          // registry index
     PersistingObservableValue<String>* pov;       // persisted dest label
     ConfigItemT<PersistingObservableValue<String>>* configItem;
-    int                             slot;         // assigned slot, or -1
 };
 static std::vector<SensorBinding> sBindings;
 
 // ============================================================
-//  Helper: format OWDevAddr as "28:aa:bb:cc:dd:ee:ff:00"
+//  Helper: format OneWireRom as "28:aa:bb:cc:dd:ee:ff:00"
 // ============================================================
-static void formatAddr(char* buf, const OWDevAddr& addr) {
+static void formatAddr(char* buf, const OneWireRom& addr) {
     sprintf(buf, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
             addr[0], addr[1], addr[2], addr[3],
             addr[4], addr[5], addr[6], addr[7]);
 }
 
 // Helper: ROM address as compact hex (no colons) for config path
-static void formatAddrCompact(char* buf, const OWDevAddr& addr) {
+static void formatAddrCompact(char* buf, const OneWireRom& addr) {
     sprintf(buf, "%02x%02x%02x%02x%02x%02x%02x%02x",
             addr[0], addr[1], addr[2], addr[3],
             addr[4], addr[5], addr[6], addr[7]);
 }
 
 // ============================================================
-//  Independent bus scan (before DallasTemperatureSensors)
+//  Bus scan — every bus, into the registry (first boot / no cache)
 // ============================================================
-static void scanBus() {
-    sDetectedAddrs.clear();
-    {
-        OneWireNg_CurrentPlatform ow(HALMET_PIN_1WIRE, false);
-        DSTherm drv{ow};
-        drv.filterSupportedSlaves();
-
-        for (const auto& id : ow) {
-            OWDevAddr owda;
-            for (int j = 0; j < 8; j++) owda[j] = id[j];
-            sDetectedAddrs.push_back(owda);
-        }
-    }  // ow destroyed here — pin released
+static void addFound(const OneWireRom& rom, size_t bi) {
+    char buf[24];
+    formatAddr(buf, rom);
+    size_t idx = sRegistry->add(rom, static_cast<uint8_t>(bi));
+    if ((*sRegistry)[idx].bus != bi) {
+        ESP_LOGW("1Wire", "  %s also seen on bus %d — check wiring",
+                 buf, (*sRegistry)[idx].bus);
+        return;
+    }
+    ESP_LOGI("1Wire", "  [%d] %s", idx, buf);
+}
 
-    ESP_LOGI("1Wire", "Bus scan found %d sensor(s):", sDetectedAddrs.size());
-    for (size_t i = 0; i < sDetectedAddrs.size(); i++) {
-        char buf[24];
-        formatAddr(buf, sDetectedAddrs[i]);
-        ESP_LOGI("1Wire", "  [%d] %s", i, buf);
+static void scanBuses() {
+    std::vector<OneWireRom> found;
+    for (size_t bi = 0; bi < kNumBuses; bi++) {
+        sBuses[bi]->scan(found);
+        ESP_LOGI("1Wire", "Bus %d (GPIO %d) scan found %d sensor(s):",
+                 bi, kBusPins[bi], found.size());
+        for (const auto& rom : found) addFound(rom, bi);
+    }
+}
+
+// ============================================================
+//  ROM cache (NVS): lets boot bind probes without a bus search.
+//  Record = 8-byte ROM + bus index.  Validated by rescanStep().
+// ============================================================
+struct __attribute__((packed)) CachedRom {
+    OneWireRom rom;
+    uint8_t    bus;
+};
+
+static size_t loadRomCache() {
+    Preferences prefs;
+    prefs.begin(ONEWIRE_CACHE_NVS_NS, /*readOnly=*/true);
+    size_t len = prefs.getBytesLength("roms");
+    std::vector<CachedRom> recs(len / sizeof(CachedRom));
+    if (!recs.empty()) prefs.getBytes("roms", recs.data(), recs.size() * sizeof(CachedRom));
+    prefs.end();
+
+    for (const auto& r : recs) {
+        if (r.bus >= kNumBuses) continue;   // pin list shrank since the cache was written
+        if (OneWireNg::crc8(r.rom.data(), 7) != r.rom[7]) continue;
+        sRegistry->add(r.rom, r.bus);
     }
+    ESP_LOGI("1Wire", "ROM cache: %d probe(s)", sRegistry->size());
+    return sRegistry->size();
+}
+
+static void saveRomCache(const std::vector<CachedRom>& recs) {
+    Preferences prefs;
+    prefs.begin(ONEWIRE_CACHE_NVS_NS, /*readOnly=*/false);
+    prefs.putBytes("roms", recs.data(), recs.size() * sizeof(CachedRom));
+    prefs.end();
+    ESP_LOGI("1Wire", "ROM cache saved: %d probe(s)", recs.size());
+}
+
+static void saveRegistryToCache() {
+    std::vector<CachedRom> recs;
+    for (const auto& e : *sRegistry) recs.push_back({e.rom, e.bus});
+    saveRomCache(recs);
 }
 
 // ============================================================
@@ -123,193 +158,339 @@ static int destIndexByLabel(const String& label) {
 }
 
 // ============================================================
-//  OwAddressPrewriter — writes ROM address to OWT config path
-//  so that OneWireTemperature::load() reads the pre-written
-//  address instead of auto-assigning.
+//  SK output for a destination (pooled, see sSkOut)
 // ============================================================
-class OwAddressPrewriter : public FileSystemSaveable,
-                           public virtual Serializable {
-public:
-    OwAddressPrewriter(const String& config_path, const String& addr)
-        : FileSystemSaveable(config_path), addr_(addr) {}
-
-    bool to_json(JsonObject& doc) override {
-        doc["address"] = addr_;
-        doc["found"] = true;
-        return true;
+static SKOutputFloat* skOutputFor(int dest) {
+    if (!sSkOut[dest]) {
+        String skPath;
+        if (kTempDests[dest].skPath) {
+            skPath = kTempDests[dest].skPath;
+        } else {
+            skPath = "environment.inside.temperature." + String(dest);
+        }
+        sSkOut[dest] = arena::make<SKOutputFloat>(skPath);
     }
-    bool from_json(const JsonObject&) override { return true; }
+    return sSkOut[dest];
+}
 
-private:
-    String addr_;
-};
+// ============================================================
+//  Lowest PGN 130316 instance not held by a bound sensor, or -1
+// ============================================================
+static int allocInstance() {
+    std::vector<bool> used(ONEWIRE_MAX_INSTANCES, false);
+    for (const auto& e : *sRegistry) {
+        if (e.instance >= 0 && e.instance < ONEWIRE_MAX_INSTANCES) used[e.instance] = true;
+    }
+    for (int i = 0; i < ONEWIRE_MAX_INSTANCES; i++) {
+        if (!used[i]) return i;
+    }
+    return -1;
+}
 
-namespace onewire_setup {
+// ============================================================
+//  (Re)bind one registry entry to a destination.  Used for the
+//  initial assignment and whenever a dropdown is saved; touches
+//  only this entry, its bus's group membership and its SK feed.
+// ============================================================
+static void bindEntry(size_t idx, int destIdx) {
+    arena::Scope scope("oneWire");   // also runs when a dropdown is saved
+    OneWireEntry& e = (*sRegistry)[idx];
+    char romColon[24];
+    formatAddr(romColon, e.rom);
+
+    if (destIdx == e.dest && e.bound()) return;
+
+    if (destIdx == 0) {
+        if (e.dest == 0) return;
+        sBuses[e.bus]->removeSensor(e.rom);
+        ESP_LOGI("1Wire", "Instance %d released ← %s (was %s)",
+                 e.instance, romColon, kTempDests[e.dest].label);
+        e.dest     = 0;
+        e.instance = -1;
+        return;
+    }
 
-void init(Outputs& out) {
-    // Zero-init outputs
-    for (int i = 0; i < NUM_ONEWIRE_SLOTS; i++) {
-        out.owDest[i] = 0;
-        out.owSensors[i] = nullptr;
+    if (e.instance < 0) {
+        int inst = allocInstance();
+        if (inst < 0) {
+            ESP_LOGW("1Wire", "Sensor %s: all %d N2K instances in use, skipping",
+                     romColon, ONEWIRE_MAX_INSTANCES);
+            e.dest = 0;
+            return;
+        }
+        e.instance = inst;
     }
 
-    // ---- Step 1: scan bus ----
-    scanBus();
+    bool firstBind = (e.value == nullptr);
+    e.dest       = destIdx;
+    e.lastSentMs = 0;
+    e.value      = sBuses[e.bus]->addSensor(e.rom,
+                                            kTempDests[destIdx].resolutionBits,
+                                            kTempDests[destIdx].intervalMs);
+
+    if (firstBind) {
+        // The driver keeps one output per ROM for good, so this forwarder
+        // is connected once and follows the entry's current destination.
+        // Stamped with the sweep's conversion time: probes read in one
+        // sweep share it (and their PGN 130316 SID).
+        e.value->connect_to(arena::make<LambdaConsumer<float>>([idx](float tempK) {
+            OneWireEntry& cur = (*sRegistry)[idx];
+            if (!isnan(tempK)) cur.sampleMs = sBuses[cur.bus]->acquiredMs();
+            if (cur.bound()) skOutputFor(cur.dest)->set(tempK);
+        }));
+    }
 
-    // ---- Step 2: build dropdown schema ----
-    String dropdownSchema = buildDropdownSchema();
+    ESP_LOGI("1Wire", "Instance %d ← %s (bus %d) → %s (idx %d, %u-bit / %lu ms)",
+             e.instance, romColon, e.bus, kTempDests[destIdx].label, destIdx,
+             kTempDests[destIdx].resolutionBits,
+             (unsigned long)kTempDests[destIdx].intervalMs);
+}
 
-    // ---- Step 3: create config card per detected sensor ----
-    sBindings.clear();
-    sBindings.reserve(sDetectedAddrs.size());
-
-    for (size_t i = 0; i < sDetectedAddrs.size(); i++) {
-        char romColon[24];
-        formatAddr(romColon, sDetectedAddrs[i]);
-        char romCompact[20];
-        formatAddrCompact(romCompact, sDetectedAddrs[i]);
-
-        // Config path: /onewire/<rom_hex>/dest — stable across discovery order
-        String cfgPath = String("/onewire/") + romCompact + "/dest";
-
-        auto* pov = new PersistingObservableValue<String>(
-            String(kTempDests[0].label), cfgPath);
-
-        auto ci = ConfigItem(pov);
-        ci->set_title(romColon)
-          ->set_description("Not yet read")
-          ->set_config_schema(dropdownSchema)
-          ->set_requires_restart(true)
-          ->set_sort_order(2000 + (int)i);
-
-        SensorBinding binding;
-        binding.addr = sDetectedAddrs[i];
-        binding.pov = pov;
-        binding.configItem = ci.get();
-        binding.slot = -1;
-        sBindings.push_back(binding);
-
-        String destLabel = pov->get();
-        ESP_LOGI("1Wire", "Sensor %s → dest \"%s\"", romColon, destLabel.c_str());
+// ============================================================
+//  Config card for one registry entry, bound to its persisted
+//  destination; saving the card re-binds it (bindEntry).
+// ============================================================
+static String sDropdownSchema;
+
+static void addSensorCard(size_t idx) {
+    const OneWireEntry& e = (*sRegistry)[idx];
+    char romColon[24];
+    formatAddr(romColon, e.rom);
+    char romCompact[20];
+    formatAddrCompact(romCompact, e.rom);
+
+    // Config path: /onewire/<rom_hex>/dest — stable across discovery order
+    String cfgPath = String("/onewire/") + romCompact + "/dest";
+
+    auto* pov = arena::make<PersistingObservableValue<String>>(
+        String(kTempDests[0].label), cfgPath);
+
+    auto ci = ConfigItem(pov);
+    ci->set_title(romColon)
+      ->set_description("Not yet read")
+      ->set_config_schema(sDropdownSchema)
+      ->set_sort_order(2000 + (int)idx);
+
+    SensorBinding binding;
+    binding.reg = idx;
+    binding.pov = pov;
+    binding.configItem = ci.get();
+    sBindings.push_back(binding);
+
+    String destLabel = pov->get();
+    ESP_LOGI("1Wire", "Sensor %s → dest \"%s\"", romColon, destLabel.c_str());
+
+    int destIdx = destIndexByLabel(destLabel);
+    if (destIdx == 0 && destLabel != String(kTempDests[0].label)) {
+        ESP_LOGW("1Wire", "Sensor %s: dest \"%s\" not found, treating as Not used",
+                 romColon, destLabel.c_str());
     }
+    bindEntry(idx, destIdx);
 
-    // ---- Step 4: slot assignment ----
-    int nextSlot = 0;
-    for (auto& b : sBindings) {
-        String destLabel = b.pov->get();
-        int destIdx = destIndexByLabel(destLabel);
+    pov->attach([idx, pov]() {
+        bindEntry(idx, destIndexByLabel(pov->get()));
+    });
+}
 
-        if (destIdx == 0) continue;  // "Not used"
+// ============================================================
+//  Background validation of the ROM cache: one ROM search per
+//  step so the event loop (and 127488) never stalls on the bus.
+// ============================================================
+static std::vector<CachedRom> sRescanFound;
+static size_t                 sRescanBus = 0;
+
+static void rescanStep() {
+    OneWireRom rom;
+    if (sBuses[sRescanBus]->scanNext(rom)) {
+        sRescanFound.push_back({rom, static_cast<uint8_t>(sRescanBus)});
+        event_loop()->onDelay(ONEWIRE_RESCAN_STEP_MS, rescanStep);
+        return;
+    }
+    if (++sRescanBus < kNumBuses) {
+        sBuses[sRescanBus]->scanBegin();
+        event_loop()->onDelay(ONEWIRE_RESCAN_STEP_MS, rescanStep);
+        return;
+    }
 
-        if (destIdx > 0 && destLabel != String(kTempDests[destIdx].label)) {
-            // Label mismatch (shouldn't happen after destIndexByLabel, but guard)
-            char romBuf[24];
-            formatAddr(romBuf, b.addr);
-            ESP_LOGW("1Wire", "Sensor %s: dest \"%s\" not found, treating as Not used",
-                     romBuf, destLabel.c_str());
+    // All buses searched — reconcile with what the cache claimed
+    arena::Scope scope("oneWire");
+    bool changed = false;
+    for (const auto& r : sRescanFound) {
+        char buf[24];
+        formatAddr(buf, r.rom);
+        int known = sRegistry->find(r.rom);
+        if (known >= 0) {
+            if ((*sRegistry)[known].bus != r.bus) {
+                // Sampled on the cached bus until the next boot re-reads the cache
+                ESP_LOGW("1Wire", "Rescan: probe %s moved to bus %d (reboot to follow)",
+                         buf, r.bus);
+                changed = true;
+            }
             continue;
         }
-
-        if (nextSlot >= NUM_ONEWIRE_SLOTS) {
-            char romBuf[24];
-            formatAddr(romBuf, b.addr);
-            ESP_LOGW("1Wire", "Sensor %s: all %d slots in use, skipping",
-                     romBuf, NUM_ONEWIRE_SLOTS);
-            continue;
+        ESP_LOGI("1Wire", "Rescan: new probe %s on bus %d", buf, r.bus);
+        addSensorCard(sRegistry->add(r.rom, r.bus));
+        changed = true;
+    }
+    for (const auto& e : *sRegistry) {
+        bool seen = false;
+        for (const auto& r : sRescanFound) {
+            if (r.rom == e.rom) { seen = true; break; }
         }
+        if (seen) continue;
+        char buf[24];
+        formatAddr(buf, e.rom);
+        ESP_LOGW("1Wire", "Rescan: cached probe %s not found on bus %d", buf, e.bus);
+        changed = true;
+    }
+    if (changed) saveRomCache(sRescanFound);
+    sRescanFound.clear();
+    sRescanFound.shrink_to_fit();
+    boot_profile::mark(BootPhase::ONEWIRE_VALIDATED);
+}
 
-        // Pre-write ROM address to the OWT config path for this slot
-        char romColon[24];
-        formatAddr(romColon, b.addr);
-        String owCfg = "/onewire/sensor" + String(nextSlot) + "/address";
-        OwAddressPrewriter(owCfg, String(romColon)).save();
+namespace onewire_setup {
 
-        b.slot = nextSlot;
-        out.owDest[nextSlot] = destIdx;
+void init(OneWireRegistry& reg) {
+    arena::Scope scope("oneWire");
+    sRegistry = &reg;
 
-        ESP_LOGI("1Wire", "Slot %d ← %s → %s (idx %d)",
-                 nextSlot, romColon, kTempDests[destIdx].label, destIdx);
-        nextSlot++;
+    for (size_t bi = 0; bi < kNumBuses; bi++) {
+        sBuses[bi] = arena::make<DsThermBatch>(kBusPins[bi]);
     }
 
-    ESP_LOGI("1Wire", "Assigned %d of %d detected sensors to slots",
-             nextSlot, sDetectedAddrs.size());
-
-    // ---- Step 5: create DallasTemperatureSensors ----
-    auto* dts = new DallasTemperatureSensors(HALMET_PIN_1WIRE);
+    // ---- Step 1: probes from the ROM cache, else a full bus scan ----
+    bool fromCache = loadRomCache() > 0;
+    if (!fromCache) {
+        scanBuses();
+        saveRegistryToCache();
+    }
 
-    // ---- Step 6: create OWT + SK outputs per assigned slot ----
-    for (int i = 0; i < NUM_ONEWIRE_SLOTS; i++) {
-        if (out.owDest[i] <= 0) {
-            out.owSensors[i] = nullptr;
-            continue;
-        }
+    // ---- Step 2: build dropdown schema ----
+    sDropdownSchema = buildDropdownSchema();
 
-        String owCfg = "/onewire/sensor" + String(i) + "/address";
-        out.owSensors[i] = new OneWireTemperature(dts, INTERVAL_1WIRE_MS, owCfg.c_str());
+    // ---- Step 3: config card + destination binding per sensor ----
+    sBindings.clear();
+    sBindings.reserve(reg.size());
+    for (size_t i = 0; i < reg.size(); i++) addSensorCard(i);
 
-        int dest = out.owDest[i];
-        String skPath;
-        if (dest > 0 && dest < kNumTempDests && kTempDests[dest].skPath) {
-            skPath = kTempDests[dest].skPath;
-        } else {
-            skPath = "environment.inside.temperature." + String(i);
-        }
-        auto* skOutput = new SKOutputFloat(skPath);
-        out.owSensors[i]->connect_to(skOutput);
+    int assigned = 0;
+    for (const auto& e : reg) {
+        if (e.bound()) assigned++;
+    }
+    ESP_LOGI("1Wire", "Assigned %d of %d %s sensors on %d bus(es)",
+             assigned, reg.size(), fromCache ? "cached" : "detected", kNumBuses);
+
+    // ---- Step 4: start batch sweeps (one conversion per profile group
+    //      per bus), buses staggered across the fastest read interval
+    //      so their bus transactions interleave ----
+    uint32_t fastestMs = INTERVAL_1WIRE_MS;
+    for (int d = 1; d < kNumTempDests; d++) {
+        if (kTempDests[d].intervalMs < fastestMs) fastestMs = kTempDests[d].intervalMs;
+    }
+    for (size_t bi = 0; bi < kNumBuses; bi++) {
+        sBuses[bi]->begin(static_cast<uint32_t>(bi * fastestMs / kNumBuses));
+    }
+    boot_profile::mark(BootPhase::ONEWIRE_BOUND);
+
+    // ---- Step 5: validate the cache in the background ----
+    if (fromCache) {
+        event_loop()->onDelay(ONEWIRE_RESCAN_DELAY_MS, []() {
+            sRescanBus = 0;
+            sBuses[0]->scanBegin();
+            rescanStep();
+        });
+    } else {
+        boot_profile::mark(BootPhase::ONEWIRE_VALIDATED);
     }
 
-    // ---- Step 7: periodic description updater + SK diagnostics ----
-    auto* skDiag = new SKOutputRawJson(
+    // ---- Step 6: periodic description updater + SK diagnostics ----
+    auto* skDiag = arena::make<SKOutputRawJson>(
         "design.halmet.diagnostics.onewireSensors", "");
 
-    auto* sensorArr = out.owSensors;
-    auto* destArr = out.owDest;
-
-    event_loop()->onRepeat(INTERVAL_ONEWIRE_DIAG_MS, [skDiag, sensorArr, destArr]() {
+    event_loop()->onRepeat(INTERVAL_ONEWIRE_DIAG_MS, [skDiag]() {
         JsonDocument doc;
         JsonArray sensors = doc["sensors"].to<JsonArray>();
 
         for (auto& b : sBindings) {
+            const OneWireEntry& e = (*sRegistry)[b.reg];
             JsonObject obj = sensors.add<JsonObject>();
             char romBuf[24];
-            formatAddr(romBuf, b.addr);
+            formatAddr(romBuf, e.rom);
             obj["address"] = String(romBuf);
+            obj["bus"]     = e.bus;
 
             String destLabel = b.pov->get();
             obj["dest"] = destLabel;
-            obj["slot"] = b.slot;
+            obj["slot"] = e.instance;
+
+            DsThermSensorStats q;
+            bool haveQ = sBuses[e.bus]->sensorStats(e.rom, q);
+            if (haveQ) {
+                JsonObject qo = obj["quality"].to<JsonObject>();
+                qo["reads"]          = q.reads;
+                qo["crcErrors"]      = q.crcErrors;
+                qo["presenceMisses"] = q.presenceMisses;
+                qo["porReads"]       = q.porReads;
+                qo["retries"]        = q.retries;
+                qo["lastReadUs"]     = q.lastReadUs;
+                qo["maxReadUs"]      = q.maxReadUs;
+                qo["failStreak"]     = q.failStreak;
+                qo["backoffSweeps"]  = q.backoffSweeps;
+            }
 
             // Update config card description with live temp
             String desc;
-            if (b.slot >= 0 && b.slot < NUM_ONEWIRE_SLOTS && sensorArr[b.slot]) {
-                float tempK = sensorArr[b.slot]->get();
-                if (!isnan(tempK) && tempK > 0) {
+            if (e.bound()) {
+                float tempK = e.value->get();
+                if (haveQ && q.failStreak >= ONEWIRE_BACKOFF_AFTER) {
+                    desc = "Not responding (" + String((unsigned)q.failStreak) +
+                           " failed reads, backing off)";
+                } else if (!isnan(tempK) && tempK > 0) {
                     float tempC = tempK - 273.15f;
                     obj["tempK"] = serialized(String(tempK, 1));
                     desc = "Currently: " + String(tempC, 1) + " °C";
-                    if (destLabel != kTempDests[0].label) {
-                        desc += String(" — ") + destLabel;
-                    }
                 } else {
                     desc = "Waiting for reading";
-                    if (destLabel != kTempDests[0].label) {
-                        desc += String(" — ") + destLabel;
-                    }
-                }
-            } else if (b.slot < 0) {
-                int destIdx = destIndexByLabel(destLabel);
-                if (destIdx == 0) {
-                    desc = "Not assigned";
-                } else {
-                    desc = "Not assigned (all slots in use)";
                 }
+                desc += String(" — ") + destLabel;
+            } else if (destIndexByLabel(destLabel) == 0) {
+                desc = "Not assigned";
+            } else {
+                desc = "Not assigned (no free N2K instance)";
             }
             if (b.configItem) {
                 b.configItem->set_description(desc);
             }
         }
 
+        JsonArray buses = doc["buses"].to<JsonArray>();
+        for (size_t bi = 0; bi < kNumBuses; bi++) {
+            const DsThermBatch*    bus = sBuses[bi];
+            const DsThermBusStats& bs  = bus->stats();
+            JsonObject bo = buses.add<JsonObject>();
+            bo["pin"]        = bus->pin();
+            bo["sensors"]    = bus->sensorCount();
+            bo["sweeps"]     = bs.sweeps;
+            bo["convertUs"]  = bs.convertUs;
+            bo["readUs"]     = bs.readUs;
+            bo["sweepBusUs"] = bs.sweepBusUs;
+            bo["maxSweepUs"] = bs.maxSweepUs;
+            bo["totalBusMs"] = static_cast<uint32_t>(bs.totalBusUs / 1000);
+            bo["crcErrors"]  = bs.crcErrors;
+            bo["busErrors"]  = bs.busErrors;
+            JsonArray groups = bo["groups"].to<JsonArray>();
+            for (size_t g = 0; g < bus->groupCount(); g++) {
+                DsThermGroupStats gs = bus->groupStats(g);
+                JsonObject go = groups.add<JsonObject>();
+                go["bits"]       = gs.resolutionBits;
+                go["intervalMs"] = gs.intervalMs;
+                go["sensors"]    = gs.sensors;
+                go["sweeps"]     = gs.sweeps;
+                go["lastBusUs"]  = gs.lastBusUs;
+            }
+        }
+
         String output;
         serializeJson(doc, output);
         skDiag->set(output);
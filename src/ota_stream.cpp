@@ -0,0 +1,211 @@
+// ============================================================
+//  ota_stream.cpp — Compressed OTA upload without an N2K outage
+//
+//  The POST handler owns the whole transfer in the httpd task:
+//  receive → OtaUnpacker → SHA-256 + esp_ota_write.  The
+//  partition is opened with OTA_WITH_SEQUENTIAL_WRITES so each
+//  sector is erased as the write reaches it instead of the whole
+//  3 MB slot up front (several seconds of stalled flash cache).
+//  The event loop only sees sSwapPending, set once the image has
+//  been verified and made bootable.
+// ============================================================
+
+#include "ota_stream.h"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <esp_http_server.h>
+#include <esp_ota_ops.h>
+#include <esp_system.h>
+#include <mbedtls/sha256.h>
+#include <sensesp.h>
+#include <sensesp_app.h>
+#include <sensesp/net/http_server.h>
+
+#include "halmet_config.h"
+#include "BilgeFan.h"
+#include "OtaUnpacker.h"
+
+using namespace sensesp;
+
+namespace ota_stream {
+
+struct Transfer {
+    esp_ota_handle_t       handle  = 0;
+    mbedtls_sha256_context sha;
+    uint32_t               written = 0;
+    esp_err_t              otaErr  = ESP_OK;
+};
+
+// Written by the httpd task, read by GET /api/ota and the event loop
+static std::atomic<bool>     sBusy{false};
+static std::atomic<bool>     sSwapPending{false};
+static std::atomic<uint32_t> sReceived{0};
+static std::atomic<uint32_t> sImageOut{0};
+static std::atomic<uint32_t> sImageLen{0};
+static std::atomic<uint32_t> sElapsedMs{0};
+static const char*           sLastResult = "none";
+
+static bool writeBlock(void* ctx, const uint8_t* data, size_t len) {
+    auto* t = static_cast<Transfer*>(ctx);
+    mbedtls_sha256_update(&t->sha, data, len);
+    t->otaErr = esp_ota_write(t->handle, data, len);
+    if (t->otaErr != ESP_OK) return false;
+    t->written += len;
+    sImageOut.store(t->written);
+    return true;
+}
+
+static esp_err_t sendResult(httpd_req_t* req, const char* status, const char* result) {
+    JsonDocument doc;
+    doc["result"]     = result;
+    doc["received"]   = sReceived.load();
+    doc["imageBytes"] = sImageOut.load();
+    doc["ms"]         = sElapsedMs.load();
+    String out;
+    serializeJson(doc, out);
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, out.c_str(), out.length());
+}
+
+// ============================================================
+//  HTTP handlers (run in the httpd task, not the event loop)
+// ============================================================
+static esp_err_t handleUpload(httpd_req_t* req) {
+    char pw[64];
+    if (httpd_req_get_hdr_value_str(req, "X-OTA-Password", pw, sizeof(pw)) != ESP_OK ||
+        strcmp(pw, OTA_PASSWORD) != 0) {
+        return httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "Bad X-OTA-Password");
+    }
+    bool idle = false;
+    if (!sBusy.compare_exchange_strong(idle, true)) {
+        return sendResult(req, "409 Conflict", "transfer already in progress");
+    }
+
+    const esp_partition_t* part = esp_ota_get_next_update_partition(nullptr);
+    static Transfer t;
+    t = Transfer{};
+    sReceived.store(0);
+    sImageOut.store(0);
+    sImageLen.store(0);
+    uint32_t t0 = millis();
+
+    if (!part || esp_ota_begin(part, OTA_WITH_SEQUENTIAL_WRITES, &t.handle) != ESP_OK) {
+        sLastResult = "no OTA partition";
+        sBusy.store(false);
+        return sendResult(req, "500 Internal Server Error", sLastResult);
+    }
+    mbedtls_sha256_init(&t.sha);
+    mbedtls_sha256_starts(&t.sha, /*is224=*/0);
+    ESP_LOGI("OTA", "Streaming %d bytes into %s", req->content_len, part->label);
+
+    // 4 KB window: heap, not the httpd stack
+    auto unpacker = std::make_unique<OtaUnpacker>(writeBlock, &t, part->size);
+    uint8_t   buf[1024];
+    size_t    remaining = req->content_len;
+    OtaStatus st        = OtaStatus::OK;
+    uint32_t  nextLog   = 0;
+    int       timeouts  = 0;
+    bool      stalled   = false;
+    while (remaining > 0 && st == OtaStatus::OK) {
+        int n = httpd_req_recv(req, reinterpret_cast<char*>(buf),
+                               remaining < sizeof(buf) ? remaining : sizeof(buf));
+        // A client that vanished without closing the socket would
+        // otherwise hold the httpd task (and sBusy) until a reboot
+        if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= OTA_RECV_TIMEOUTS_MAX) continue;
+        if (n <= 0) {
+            stalled = n == HTTPD_SOCK_ERR_TIMEOUT;
+            st      = OtaStatus::TRUNCATED;
+            break;
+        }
+        timeouts = 0;
+        remaining -= n;
+        sReceived.fetch_add(n);
+        st = unpacker->feed(buf, n);
+        if (unpacker->headerDone()) sImageLen.store(unpacker->header().imageLen);
+        if (sImageOut.load() >= nextLog && sImageLen.load()) {
+            ESP_LOGI("OTA", "%u / %u bytes", (unsigned)sImageOut.load(), (unsigned)sImageLen.load());
+            nextLog = sImageOut.load() + sImageLen.load() / 10;
+        }
+    }
+    if (st == OtaStatus::OK) st = unpacker->finish();
+
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&t.sha, digest);
+    mbedtls_sha256_free(&t.sha);
+    sElapsedMs.store(millis() - t0);
+
+    const char* result = stalled ? "upload stalled" : otaStatusName(st);
+    if (st == OtaStatus::OK && memcmp(digest, unpacker->header().imageSha256, sizeof(digest)) != 0) {
+        result = "image SHA-256 mismatch";
+        st     = OtaStatus::WRITE_FAILED;
+    }
+    if (st != OtaStatus::OK) {
+        esp_ota_abort(t.handle);
+        ESP_LOGE("OTA", "Rejected after %u bytes: %s (esp_ota_write %s)",
+                 (unsigned)sReceived.load(), result, esp_err_to_name(t.otaErr));
+        sLastResult = result;
+        sBusy.store(false);
+        return sendResult(req, "400 Bad Request", result);
+    }
+
+    // esp_ota_end() checks the ESP image itself (segments, appended hash)
+    esp_err_t err = esp_ota_end(t.handle);
+    if (err == ESP_OK) err = esp_ota_set_boot_partition(part);
+    if (err != ESP_OK) {
+        sLastResult = esp_err_to_name(err);
+        sBusy.store(false);
+        return sendResult(req, "400 Bad Request", sLastResult);
+    }
+
+    ESP_LOGI("OTA", "%u bytes (%u on the wire) verified in %u ms — restarting into %s",
+             (unsigned)t.written, (unsigned)sReceived.load(), (unsigned)sElapsedMs.load(),
+             part->label);
+    sLastResult = "ok";
+    sendResult(req, "200 OK", sLastResult);
+    sSwapPending.store(true);   // sBusy stays set: no second upload before the restart
+    return ESP_OK;
+}
+
+static esp_err_t handleStatus(httpd_req_t* req) {
+    JsonDocument doc;
+    doc["busy"]       = sBusy.load();
+    doc["received"]   = sReceived.load();
+    doc["imageBytes"] = sImageOut.load();
+    doc["imageLen"]   = sImageLen.load();
+    doc["ms"]         = sElapsedMs.load();
+    doc["last"]       = sLastResult;
+    String out;
+    serializeJson(doc, out);
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, out.c_str(), out.length());
+}
+
+// ============================================================
+void init(const InitParams& p) {
+    BilgeFan* fan = p.bilgeFan;
+
+    auto server = SensESPApp::get()->get_http_server();
+    auto uploadHandler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_POST, "/api/ota", handleUpload);
+    auto statusHandler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, "/api/ota", handleStatus);
+    server->add_handler(uploadHandler);
+    server->add_handler(statusHandler);
+
+    // Final swap: the only part of the update the engine data misses
+    event_loop()->onRepeat(INTERVAL_RPM_MS, [fan]() {
+        bool pending = true;
+        if (!sSwapPending.compare_exchange_strong(pending, false)) return;
+        fan->forceOff();
+        ESP_LOGW("OTA", "New image verified — relay forced OFF, restarting in %d ms",
+                 OTA_SWAP_DELAY_MS);
+        event_loop()->onDelay(OTA_SWAP_DELAY_MS, []() { esp_restart(); });
+    });
+}
+
+}  // namespace ota_stream
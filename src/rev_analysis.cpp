@@ -0,0 +1,149 @@
+// ============================================================
+//  rev_analysis.cpp — Per-revolution speed variation task
+//
+//  The task owns the RevAnalyzer and the CpuBudget; the event loop
+//  only ever sees a Snapshot copied out under sLock.
+// ============================================================
+
+#include "rev_analysis.h"
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "CpuBudget.h"
+#include "Fft.h"
+#include "RevAnalyzer.h"
+#include "RpmSensor.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+namespace rev_analysis {
+
+struct Snapshot {
+    RevAnalyzer::Result result;
+    uint32_t analysed  = 0;
+    uint32_t rejected  = 0;
+    uint32_t dropped   = 0;
+    uint32_t lostEdges = 0;
+    uint64_t busyUs    = 0;
+};
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static RpmSensor*   sRpm = nullptr;
+static RevAnalyzer  sAnalyzer(REV_MIN_RPM);
+static CpuBudget    sBudget(REV_CPU_BUDGET_PCT, REV_CPU_BURST_MS * 1000UL);
+static uint32_t     sEdges[REV_EDGE_RING];
+static TaskHandle_t sTask = nullptr;
+
+static portMUX_TYPE sLock = portMUX_INITIALIZER_UNLOCKED;
+static Snapshot     sShared;   // guarded by sLock
+
+static void analysisTask(void*) {
+    uint32_t cursor    = 0;
+    uint32_t lostEdges = 0;
+    // Edges from before the task started are history, not loss
+    uint32_t ignored = 0;
+    RpmSensor::readEdges(cursor, sEdges, REV_EDGE_RING, ignored);
+
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(REV_POLL_MS));
+        uint32_t t0 = micros();
+
+        uint32_t lost = 0;
+        size_t   n    = RpmSensor::readEdges(cursor, sEdges, REV_EDGE_RING, lost);
+        if (lost) {
+            sAnalyzer.restart();
+            lostEdges += lost;
+        }
+        sAnalyzer.feed(sEdges, static_cast<int>(n));
+
+        bool fresh = false;
+        if (sAnalyzer.pending()) {
+            if (sBudget.allow(t0)) fresh = sAnalyzer.analyze(sRpm->getPulsesPerRev());
+            else                   sAnalyzer.discard();
+        }
+        sBudget.spend(micros() - t0);
+
+        portENTER_CRITICAL(&sLock);
+        if (fresh) sShared.result = sAnalyzer.result();
+        sShared.analysed  = sAnalyzer.analysed();
+        sShared.rejected  = sAnalyzer.rejected();
+        sShared.dropped   = sAnalyzer.dropped();
+        sShared.lostEdges = lostEdges;
+        sShared.busyUs    = sBudget.busyUs();
+        portEXIT_CRITICAL(&sLock);
+    }
+}
+
+// ============================================================
+//  Signal K (event loop)
+// ============================================================
+static void publish(SKOutputFloat* skRough, SKOutputRawJson* skJson) {
+    static uint32_t sLastAnalysed = 0;
+    static uint64_t sLastBusyUs   = 0;
+    static uint32_t sLastMs       = millis();
+
+    Snapshot s;
+    portENTER_CRITICAL(&sLock);
+    s = sShared;
+    portEXIT_CRITICAL(&sLock);
+
+    uint32_t now    = millis();
+    uint32_t spanMs = now - sLastMs;
+    float    cpuPct = spanMs ? (s.busyUs - sLastBusyUs) / (spanMs * 10.0f) : 0.0f;
+    bool     fresh  = s.analysed != sLastAnalysed;
+    sLastAnalysed = s.analysed;
+    sLastBusyUs   = s.busyUs;
+    sLastMs       = now;
+
+    JsonDocument doc;
+    doc["fft"]        = fftBackend();
+    doc["blockEdges"] = RevAnalyzer::kBlock;
+    doc["analysed"]   = s.analysed;
+    doc["rejected"]   = s.rejected;
+    doc["dropped"]    = s.dropped;
+    doc["lostEdges"]  = s.lostEdges;
+    doc["cpuPct"]     = cpuPct;
+    if (s.analysed) {
+        const RevAnalyzer::Result& r = s.result;
+        doc["ageMs"]     = (micros() - r.endUs) / 1000;
+        doc["rpm"]       = r.rpm;
+        doc["roughness"] = r.roughness;
+        JsonArray orders = doc["orders"].to<JsonArray>();
+        for (int i = 0; i < RevAnalyzer::kOrders; i++) {
+            JsonObject o = orders.add<JsonObject>();
+            o["order"] = RevAnalyzer::order(i);
+            o["rpm"]   = r.orderRpm[i];   // null above Nyquist
+        }
+    }
+    String output;
+    serializeJson(doc, output);
+    skJson->set(output);
+
+    // The index itself only while it is being measured
+    if (fresh) skRough->set(s.result.roughness);
+}
+
+// ============================================================
+void init(const InitParams& p) {
+    arena::Scope scope("revAnalysis");
+    sRpm = p.rpm;
+
+    auto* skRough = arena::make<SKOutputFloat>("design.halmet.engine.roughness", "");
+    auto* skJson  = arena::make<SKOutputRawJson>("design.halmet.engine.revolutionAnalysis", "");
+    event_loop()->onRepeat(INTERVAL_REV_SK_MS, [skRough, skJson]() { publish(skRough, skJson); });
+
+    xTaskCreatePinnedToCore(analysisTask, "rev_analysis", 4096, nullptr,
+                            tskIDLE_PRIORITY + 1, &sTask, 0);
+    ESP_LOGI("RevAnalysis", "%d-edge blocks, FFT %s, CPU budget %d%%",
+             RevAnalyzer::kBlock, fftBackend(), REV_CPU_BUDGET_PCT);
+}
+
+}  // namespace rev_analysis
@@ -0,0 +1,168 @@
+// ============================================================
+//  supervisor.cpp — Per-task deadlines feeding the task watchdog
+// ============================================================
+
+#include "supervisor.h"
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+
+#include "halmet_config.h"
+#include "TaskSupervisor.h"
+#include "arena.h"
+
+using namespace sensesp;
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static constexpr size_t kNumTasks = static_cast<size_t>(SupervisedTask::COUNT);
+
+struct TaskSpec {
+    const char* name;
+    uint32_t    deadlineMs;
+    bool        critical;
+};
+
+static const TaskSpec kTaskSpecs[kNumTasks] = {
+    { "rpm",      DEADLINE_RPM_TICK_MS,  true  },
+    { "ads",      DEADLINE_ADS_MS,       true  },
+    { "n2kPump",  DEADLINE_N2K_PUMP_MS,  true  },
+    { "slowPgns", DEADLINE_SLOW_PGNS_MS, true  },
+    { "oneWire",  DEADLINE_ONEWIRE_MS,   false },
+};
+
+// Survives the watchdog reset (not the power-on reset): which task
+// stopped the feeding.  kNoTask = the event loop itself hung.
+struct WatchdogCrumb {
+    uint32_t magic;
+    uint32_t task;
+    uint32_t overdueMs;
+    uint32_t uptimeS;
+};
+static constexpr uint32_t kCrumbMagic = 0x57444F47;   // "WDOG"
+static constexpr uint32_t kNoTask     = 0xFF;
+
+RTC_NOINIT_ATTR static WatchdogCrumb sCrumb;
+
+static TaskSupervisor sSup;
+static TaskHandle_t   sLoopTask  = nullptr;
+static bool           sSuspended = false;
+static bool           sStarving  = false;   // feeding withheld
+static WatchdogCrumb  sLastReset = {};      // from the previous boot (magic = 0: none)
+
+static void subscribe() {
+    esp_task_wdt_config_t cfg = {
+        .timeout_ms     = SUPERVISOR_WDT_TIMEOUT_S * 1000,
+        .idle_core_mask = 1 << 0,   // Arduino default: idle task on core 0 only
+        .trigger_panic  = true,
+    };
+    // The IDF normally starts the TWDT at boot; initialise it if not
+    if (esp_task_wdt_reconfigure(&cfg) == ESP_ERR_INVALID_STATE) esp_task_wdt_init(&cfg);
+    esp_task_wdt_add(sLoopTask);
+}
+
+static void tick() {
+    if (sSuspended) return;
+    uint32_t now = millis();
+
+    if (sSup.check(now)) {
+        if (sStarving) {
+            ESP_LOGW("Supervisor", "All tasks back within deadline — feeding resumed");
+            sCrumb.magic = 0;
+            sStarving    = false;
+        }
+        esp_task_wdt_reset();
+        return;
+    }
+
+    int w = sSup.worstOverdue();
+    if (!sStarving) {
+        ESP_LOGE("Supervisor", "Task '%s' missed its %lu ms deadline (%lu ms since check-in) "
+                 "— watchdog reset in %d s unless it recovers",
+                 sSup.task(w).name, (unsigned long)sSup.task(w).deadlineMs,
+                 (unsigned long)sSup.ageMs(w, now), SUPERVISOR_WDT_TIMEOUT_S);
+        sStarving = true;
+    }
+    sCrumb = { kCrumbMagic, static_cast<uint32_t>(w),
+               sSup.ageMs(w, now) - sSup.task(w).deadlineMs, now / 1000 };
+}
+
+static void publish(SKOutputRawJson* sk) {
+    uint32_t     now = millis();
+    JsonDocument doc;
+    JsonArray    tasks = doc["tasks"].to<JsonArray>();
+    for (int i = 0; i < sSup.count(); i++) {
+        const TaskSupervisor::Task& t = sSup.task(i);
+        JsonObject o = tasks.add<JsonObject>();
+        o["name"]       = t.name;
+        o["critical"]   = t.critical;
+        o["deadlineMs"] = t.deadlineMs;
+        o["maxGapMs"]   = t.maxGapMs;
+        o["misses"]     = t.misses;
+        if (t.started) o["ageMs"] = sSup.ageMs(i, now);
+    }
+    doc["suspended"] = sSuspended;
+    if (sLastReset.magic == kCrumbMagic) {
+        JsonObject r = doc["lastWatchdogReset"].to<JsonObject>();
+        r["task"]      = sLastReset.task < kNumTasks ? kTaskSpecs[sLastReset.task].name : "eventLoop";
+        r["overdueMs"] = sLastReset.overdueMs;
+        r["uptimeS"]   = sLastReset.uptimeS;
+    }
+    String output;
+    serializeJson(doc, output);
+    sk->set(output);
+}
+
+namespace supervisor {
+
+void init() {
+    arena::Scope scope("supervisor");
+    // What stopped the last boot, if the watchdog did
+    if (esp_reset_reason() == ESP_RST_TASK_WDT) {
+        sLastReset = (sCrumb.magic == kCrumbMagic)
+                         ? sCrumb
+                         : WatchdogCrumb{ kCrumbMagic, kNoTask, 0, 0 };
+        ESP_LOGE("Supervisor", "Last reset by task watchdog: %s",
+                 sLastReset.task < kNumTasks ? kTaskSpecs[sLastReset.task].name : "event loop hung");
+    }
+    sCrumb.magic = 0;
+
+    uint32_t now = millis();
+    for (const auto& s : kTaskSpecs) sSup.add(s.name, s.deadlineMs, s.critical, now);
+
+    sLoopTask = xTaskGetCurrentTaskHandle();
+    subscribe();
+
+    auto* skTasks = arena::make<SKOutputRawJson>("design.halmet.diagnostics.tasks", "");
+    event_loop()->onRepeat(SUPERVISOR_TICK_MS, tick);
+    event_loop()->onRepeat(INTERVAL_DIAG_MS, [skTasks]() { publish(skTasks); });
+}
+
+void checkIn(SupervisedTask t) {
+    sSup.checkIn(static_cast<int>(t), millis());
+}
+
+void suspend() {
+    if (sSuspended || !sLoopTask) return;
+    sSuspended = true;
+    esp_task_wdt_delete(sLoopTask);
+    ESP_LOGW("Supervisor", "Watchdog suspended (OTA)");
+}
+
+void resume() {
+    if (!sSuspended) return;
+    sSup.restart(millis());
+    sSuspended = false;
+    sStarving  = false;
+    esp_task_wdt_add(sLoopTask);
+    ESP_LOGW("Supervisor", "Watchdog resumed");
+}
+
+}  // namespace supervisor
@@ -0,0 +1,150 @@
+// ============================================================
+//  telemetry_stream.cpp — Live binary telemetry for commissioning
+//
+//  Frames are sent with a non-blocking send(); if the socket
+//  buffer is full the frame is dropped (visible to the host as a
+//  seq gap) rather than stalling the event loop.
+// ============================================================
+
+#include "telemetry_stream.h"
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <cmath>
+#include <cerrno>
+#include <lwip/sockets.h>
+#include <sensesp.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "blackbox.h"
+#include "RpmSensor.h"
+
+using namespace sensesp;
+
+namespace telemetry_stream {
+
+// ============================================================
+//  File-scope state
+// ============================================================
+static WiFiServer*            sServer     = nullptr;
+static WiFiClient             sClient;
+static reactesp::RepeatEvent* sFrameEvent = nullptr;
+static uint16_t               sSeq        = 0;
+static uint32_t               sDropped    = 0;
+static bool                   sBroken     = false;  // set by the frame pump, handled by the poller
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+static uint16_t crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void buildFrame(TelemetryFrame& f, const EngineState* st, RpmSensor* rpm) {
+    f.sync[0] = kTelemetrySync0;
+    f.sync[1] = kTelemetrySync1;
+    f.version = kTelemetryVersion;
+    f.flags   = (st->oilAlarm.value      ? kBlackboxFlagOilAlarm      : 0)
+              | (st->tempAlarm.value     ? kBlackboxFlagTempAlarm     : 0)
+              | (static_cast<uint8_t>(st->coolantAlertState.value) << kBlackboxFlagCoolantShift)
+              | (st->engineRunning.value ? kBlackboxFlagEngineRunning : 0)
+              | (st->adsOk               ? kBlackboxFlagAdsOk         : 0);
+    f.seq     = sSeq++;
+    f.ms      = millis();
+
+    f.rpmInstant   = rpm->getInstantRpm();
+    f.rpmSmoothed  = rpm->getRpm();
+    f.pulsesPerRev = rpm->getPulsesPerRev();
+
+    for (int c = 0; c < 4; c++) {
+        f.adsRaw[c]   = st->adsRaw[c];
+        f.adsVolts[c] = st->adsVolts[c];
+    }
+    f.coolantC = (st->coolantK.value > 0.0) ? static_cast<float>(st->coolantK.value - 273.15) : NAN;
+
+    float ohm = f.adsVolts[TANK_SENDER_CHANNEL] / TANK_MEASUREMENT_CURRENT;
+    f.tankOhm = (ohm < 0.0f || ohm > TANK_RESISTANCE_MAX_OHM) ? NAN : ohm;
+
+    f.oilHistory  = st->oilAlarmHistory;
+    f.tempHistory = st->tempAlarmHistory;
+    f.crc = crc16(reinterpret_cast<const uint8_t*>(&f), sizeof(f) - sizeof(f.crc));
+}
+
+static void dropClient() {
+    if (sFrameEvent) {
+        event_loop()->remove(sFrameEvent);
+        sFrameEvent = nullptr;
+    }
+    sClient.stop();
+    sBroken = false;
+    ESP_LOGI("Telemetry", "Client disconnected (%lu frames dropped)",
+             (unsigned long)sDropped);
+}
+
+static void stopServer() {
+    if (sClient) dropClient();
+    if (sServer) {
+        sServer->end();
+        delete sServer;
+        sServer = nullptr;
+        ESP_LOGI("Telemetry", "Stream disabled");
+    }
+}
+
+void init(const InitParams& p) {
+    const EngineState*               st      = p.state;
+    RpmSensor*                       rpm     = p.rpm;
+    PersistingObservableValue<bool>* povOn   = p.enabled;
+
+    // Listener management (500 ms).  Opening the socket is deferred
+    // until WiFi is up; disabling closes everything.
+    event_loop()->onRepeat(TELEMETRY_ACCEPT_POLL_MS, [st, rpm, povOn]() {
+        if (!povOn->get()) {
+            stopServer();
+            return;
+        }
+        if (!sServer) {
+            if (!WiFi.isConnected()) return;
+            sServer = new WiFiServer(TELEMETRY_STREAM_PORT);
+            sServer->begin();
+            ESP_LOGI("Telemetry", "Listening on port %d", TELEMETRY_STREAM_PORT);
+        }
+
+        if (sClient && (sBroken || !sClient.connected())) dropClient();
+        if (sClient) return;   // one client at a time
+
+        WiFiClient c = sServer->accept();
+        if (!c) return;
+        sClient = c;
+        sClient.setNoDelay(true);
+        sDropped = 0;
+        ESP_LOGI("Telemetry", "Client %s connected",
+                 sClient.remoteIP().toString().c_str());
+
+        // Frame pump only exists while a client is attached
+        sFrameEvent = event_loop()->onRepeat(INTERVAL_RPM_MS, [st, rpm]() {
+            if (sBroken) return;
+            TelemetryFrame f;
+            buildFrame(f, st, rpm);
+            int n = send(sClient.fd(), &f, sizeof(f), MSG_DONTWAIT);
+            if (n == static_cast<int>(sizeof(f))) return;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                sDropped++;
+                return;
+            }
+            // Short write or hard error — the byte stream is no longer
+            // frame-aligned.  The poller closes it (an event must not
+            // remove itself from inside its own callback).
+            sBroken = true;
+        });
+    });
+}
+
+}  // namespace telemetry_stream
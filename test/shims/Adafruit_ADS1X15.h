@@ -0,0 +1,99 @@
+#pragma once
+
+// ============================================================
+//  Adafruit_ADS1X15.h  —  Native stand-in for the ADS1115
+//
+//  A test sets the voltage on each input in shim::adsVolts and
+//  whether the chip answers on I²C in shim::adsPresent (only at
+//  shim::adsAddress).  A single-shot conversion completes one
+//  data-rate period after startADCReading() on the virtual clock;
+//  the code is what the real chip would return at the configured
+//  gain.  readADC_SingleEnded() (blocking) is counted separately.
+// ============================================================
+
+#include <Arduino.h>
+#include <Wire.h>
+
+typedef enum {
+    GAIN_TWOTHIRDS = 0x0000,
+    GAIN_ONE       = 0x0200,
+    GAIN_TWO       = 0x0400,
+    GAIN_FOUR      = 0x0600,
+    GAIN_EIGHT     = 0x0800,
+    GAIN_SIXTEEN   = 0x0A00,
+} adsGain_t;
+
+#define RATE_ADS1115_8SPS   (0x0000)
+#define RATE_ADS1115_16SPS  (0x0020)
+#define RATE_ADS1115_32SPS  (0x0040)
+#define RATE_ADS1115_64SPS  (0x0060)
+#define RATE_ADS1115_128SPS (0x0080)
+#define RATE_ADS1115_250SPS (0x00A0)
+#define RATE_ADS1115_475SPS (0x00C0)
+#define RATE_ADS1115_860SPS (0x00E0)
+
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+
+namespace shim {
+inline bool     adsPresent       = true;
+inline uint8_t  adsAddress       = 0x4B;
+inline float    adsVolts[4]      = {};
+inline uint32_t adsBegins        = 0;
+inline uint32_t adsReads         = 0;   // conversions read back
+inline uint32_t adsBlockingReads = 0;   // of which readADC_SingleEnded()
+}  // namespace shim
+
+class Adafruit_ADS1115 {
+public:
+    bool begin(uint8_t addr = 0x48, TwoWire* wire = &Wire) {
+        (void)wire;
+        shim::adsBegins++;
+        _addr = addr;
+        return answering();
+    }
+    void setGain(adsGain_t gain)     { _gain = gain; }
+    void setDataRate(uint16_t rate)  { _rate = rate; }
+
+    void startADCReading(uint16_t mux, bool continuous) {
+        (void)continuous;
+        _mux     = (mux >> 12) & 0x03;
+        _startUs = shim::nowUs;
+    }
+    bool conversionComplete() {
+        static const uint16_t kSps[8] = { 8, 16, 32, 64, 128, 250, 475, 860 };
+        return answering() && shim::nowUs - _startUs >= 1000000u / kSps[(_rate >> 5) & 0x07];
+    }
+    int16_t getLastConversionResults() {
+        shim::adsReads++;
+        if (!answering()) return 0;
+        float counts = shim::adsVolts[_mux] / voltsPerCount();
+        if (counts > 32767.0f)  counts = 32767.0f;
+        if (counts < -32768.0f) counts = -32768.0f;
+        return static_cast<int16_t>(lroundf(counts));
+    }
+
+    int16_t readADC_SingleEnded(uint8_t channel) {
+        shim::adsBlockingReads++;
+        if (channel > 3) return 0;
+        startADCReading(ADS1X15_REG_CONFIG_MUX_SINGLE_0 + (channel << 12), false);
+        return getLastConversionResults();
+    }
+
+    float computeVolts(int16_t counts) { return counts * voltsPerCount(); }
+
+private:
+    bool  answering() const { return shim::adsPresent && _addr == shim::adsAddress; }
+    float voltsPerCount() const {
+        static const float kFsr[6] = { 6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f };
+        return kFsr[(_gain >> 9) & 0x07] / 32768.0f;
+    }
+
+    uint8_t   _addr    = 0;
+    adsGain_t _gain    = GAIN_TWOTHIRDS;
+    uint16_t  _rate    = RATE_ADS1115_128SPS;
+    uint8_t   _mux     = 0;
+    uint64_t  _startUs = 0;
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+// ============================================================
+//  Arduino.h  —  Native (host) stand-in for the Arduino core
+//
+//  Just enough for the pure-logic modules built by [env:native]:
+//  a virtual clock behind millis()/micros(), recorded pin modes
+//  and levels, and attachInterrupt() handlers that a test fires
+//  with shim::fireInterrupt().  Time only moves when a test
+//  advances it, so every run is deterministic.
+//
+//  String is std::string plus the Print-style write() that
+//  ArduinoJson's generic writer serialises into.
+//
+//  millis()/delay() have C linkage to match the declarations the
+//  NMEA2000 library makes for non-Arduino builds; their bodies
+//  live in shim_main.h, included once per test program.
+// ============================================================
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#define IRAM_ATTR
+#define PROGMEM
+
+#define LOW           0x0
+#define HIGH          0x1
+#define INPUT         0x01
+#define OUTPUT        0x03
+#define INPUT_PULLUP  0x05
+#define RISING        0x01
+#define FALLING       0x02
+#define CHANGE        0x03
+
+#define ESP_LOGE(tag, ...) ((void)0)
+#define ESP_LOGW(tag, ...) ((void)0)
+#define ESP_LOGI(tag, ...) ((void)0)
+#define ESP_LOGD(tag, ...) ((void)0)
+#define ESP_LOGV(tag, ...) ((void)0)
+
+class String : public std::string {
+public:
+    using std::string::string;
+    String() = default;
+    String(const std::string& s) : std::string(s) {}
+
+    size_t write(uint8_t c) {
+        push_back(static_cast<char>(c));
+        return 1;
+    }
+    size_t write(const uint8_t* s, size_t n) {
+        append(reinterpret_cast<const char*>(s), n);
+        return n;
+    }
+};
+
+namespace shim {
+
+constexpr uint8_t kNumPins = 40;
+
+inline uint64_t nowUs                 = 0;     // virtual clock
+inline uint8_t  pinModes[kNumPins]    = {};
+inline uint8_t  pinLevels[kNumPins]   = {};    // last written, or set by the test
+inline void   (*isrs[kNumPins])()     = {};
+inline int      isrModes[kNumPins]    = {};
+inline uint32_t digitalWrites         = 0;
+
+inline void advanceUs(uint64_t us) { nowUs += us; }
+inline void advanceMs(uint64_t ms) { nowUs += ms * 1000; }
+
+/// Call the handler attached to `pin`, as the GPIO interrupt would.
+inline void fireInterrupt(uint8_t pin) {
+    if (pin < kNumPins && isrs[pin]) isrs[pin]();
+}
+
+/// Clock back to `startUs`, all pins LOW, no handlers.
+inline void reset(uint64_t startUs = 0) {
+    nowUs = startUs;
+    memset(pinModes,  0, sizeof(pinModes));
+    memset(pinLevels, 0, sizeof(pinLevels));
+    memset(isrModes,  0, sizeof(isrModes));
+    for (auto& isr : isrs) isr = nullptr;
+    digitalWrites = 0;
+}
+
+}  // namespace shim
+
+extern "C" uint32_t millis();
+extern "C" void     delay(uint32_t ms);
+
+inline uint32_t micros() { return static_cast<uint32_t>(shim::nowUs); }
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < shim::kNumPins) shim::pinModes[pin] = mode;
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < shim::kNumPins) shim::pinLevels[pin] = level ? HIGH : LOW;
+    shim::digitalWrites++;
+}
+
+inline int digitalRead(uint8_t pin) {
+    return pin < shim::kNumPins ? shim::pinLevels[pin] : LOW;
+}
+
+inline int digitalPinToInterrupt(uint8_t pin) { return pin; }
+
+inline void attachInterrupt(int irq, void (*isr)(), int mode) {
+    if (irq < 0 || irq >= shim::kNumPins) return;
+    shim::isrs[irq]     = isr;
+    shim::isrModes[irq] = mode;
+}
+
+inline void detachInterrupt(int irq) {
+    if (irq >= 0 && irq < shim::kNumPins) shim::isrs[irq] = nullptr;
+}
+
+inline void noInterrupts() {}
+inline void interrupts()   {}
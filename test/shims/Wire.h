@@ -0,0 +1,19 @@
+#pragma once
+
+// ============================================================
+//  Wire.h  —  Native stand-in for the Arduino I²C bus (no-op)
+// ============================================================
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+        (void)sda; (void)scl; (void)frequency;
+        return true;
+    }
+    void setClock(uint32_t) {}
+    void setTimeOut(uint16_t) {}
+};
+
+inline TwoWire Wire;
@@ -0,0 +1,10 @@
+#pragma once
+
+// ============================================================
+//  esp_attr.h  —  Native stand-in: placement attributes are no-ops
+//  (RTC_NOINIT_ATTR data is simply zero-initialised on the host)
+// ============================================================
+
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define DRAM_ATTR
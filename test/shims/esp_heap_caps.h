@@ -0,0 +1,21 @@
+#pragma once
+
+// ============================================================
+//  esp_heap_caps.h  —  Native stand-in: heap figures set by the
+//  test (shim::heapFree etc.); every capability reads the same.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+namespace shim {
+inline size_t heapFree         = 200 * 1024;
+inline size_t heapMinFree      = 180 * 1024;
+inline size_t heapLargestBlock = 110 * 1024;
+}  // namespace shim
+
+inline size_t heap_caps_get_free_size(uint32_t)          { return shim::heapFree; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t)  { return shim::heapMinFree; }
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return shim::heapLargestBlock; }
@@ -0,0 +1,73 @@
+#pragma once
+
+// ============================================================
+//  esp_partition.h  —  Native stand-in for the ESP-IDF partition
+//  API: one 64 KB "journal" data partition held in RAM with NOR
+//  semantics (erase → 0xFF, write only clears bits).  It keeps
+//  its contents across a simulated reboot; set
+//  shim::journalPresent = false for a board without it.
+// ============================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <esp_err.h>
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    uint32_t                erase_size;
+    char                    label[17];
+} esp_partition_t;
+
+namespace shim {
+inline bool                 journalPresent = true;
+inline esp_partition_t      journalPartition = {
+    ESP_PARTITION_TYPE_DATA, static_cast<esp_partition_subtype_t>(0x40),
+    0x7E0000, 0x10000, 0x1000, "journal" };
+inline std::vector<uint8_t> journalMem(0x10000, 0xFF);
+inline uint32_t             journalErases = 0;
+}  // namespace shim
+
+inline const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+                                                       esp_partition_subtype_t subtype,
+                                                       const char* label) {
+    (void)subtype;
+    if (!shim::journalPresent || type != ESP_PARTITION_TYPE_DATA) return nullptr;
+    if (label && strcmp(label, shim::journalPartition.label) != 0) return nullptr;
+    return &shim::journalPartition;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t* p, size_t offset, void* dst, size_t len) {
+    if (offset + len > p->size) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, &shim::journalMem[offset], len);
+    return ESP_OK;
+}
+
+inline esp_err_t esp_partition_write(const esp_partition_t* p, size_t offset, const void* src, size_t len) {
+    if (offset + len > p->size) return ESP_ERR_INVALID_SIZE;
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < len; i++) shim::journalMem[offset + i] &= s[i];
+    return ESP_OK;
+}
+
+inline esp_err_t esp_partition_erase_range(const esp_partition_t* p, size_t offset, size_t len) {
+    if (offset % p->erase_size || len % p->erase_size) return ESP_ERR_INVALID_ARG;
+    if (offset + len > p->size) return ESP_ERR_INVALID_SIZE;
+    memset(&shim::journalMem[offset], 0xFF, len);
+    shim::journalErases += len / p->erase_size;
+    return ESP_OK;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// ============================================================
+//  esp_system.h  —  Native stand-in: reset reason set by the
+//  test (shim::resetReason); esp_restart() only counts.
+// ============================================================
+
+#include <cstdint>
+
+typedef enum {
+    ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC,
+    ESP_RST_INT_WDT, ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT, ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+namespace shim {
+inline esp_reset_reason_t resetReason = ESP_RST_POWERON;
+inline uint32_t           restarts    = 0;
+}  // namespace shim
+
+inline esp_reset_reason_t esp_reset_reason() { return shim::resetReason; }
+inline void               esp_restart()      { shim::restarts++; }
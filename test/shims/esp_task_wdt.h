@@ -0,0 +1,65 @@
+#pragma once
+
+// ============================================================
+//  esp_task_wdt.h  —  Native stand-in for the task watchdog
+//
+//  Records subscriptions and feeds; shim::wdtStarvedMs() says how
+//  long the subscribed task has gone unfed on the virtual clock,
+//  which is what would have reset a real board.
+// ============================================================
+
+#include <cstdint>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+
+#include "Arduino.h"
+
+typedef struct {
+    uint32_t timeout_ms;
+    uint32_t idle_core_mask;
+    bool     trigger_panic;
+} esp_task_wdt_config_t;
+
+namespace shim {
+inline bool     wdtInitialised = true;     // the IDF starts it at boot
+inline uint32_t wdtTimeoutMs   = 5000;
+inline bool     wdtSubscribed  = false;
+inline uint32_t wdtFeeds       = 0;
+inline uint32_t wdtLastFeedMs  = 0;
+inline uint32_t wdtMaxStarveMs = 0;        // worst gap between feeds while subscribed
+}  // namespace shim
+
+inline esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t* c) {
+    if (shim::wdtInitialised) return ESP_ERR_INVALID_STATE;
+    shim::wdtInitialised = true;
+    shim::wdtTimeoutMs   = c->timeout_ms;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t* c) {
+    if (!shim::wdtInitialised) return ESP_ERR_INVALID_STATE;
+    shim::wdtTimeoutMs = c->timeout_ms;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_task_wdt_add(TaskHandle_t) {
+    if (shim::wdtSubscribed) return ESP_ERR_INVALID_ARG;
+    shim::wdtSubscribed = true;
+    shim::wdtLastFeedMs = millis();
+    return ESP_OK;
+}
+
+inline esp_err_t esp_task_wdt_delete(TaskHandle_t) {
+    if (!shim::wdtSubscribed) return ESP_ERR_INVALID_ARG;
+    shim::wdtSubscribed = false;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_task_wdt_reset() {
+    if (!shim::wdtSubscribed) return ESP_ERR_INVALID_STATE;
+    uint32_t now = millis();
+    if (now - shim::wdtLastFeedMs > shim::wdtMaxStarveMs) shim::wdtMaxStarveMs = now - shim::wdtLastFeedMs;
+    shim::wdtLastFeedMs = now;
+    shim::wdtFeeds++;
+    return ESP_OK;
+}
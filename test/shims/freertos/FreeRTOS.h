@@ -0,0 +1,15 @@
+#pragma once
+
+// ============================================================
+//  freertos/FreeRTOS.h  —  Native stand-in: types only
+// ============================================================
+
+#include <cstdint>
+
+typedef void*    TaskHandle_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define tskIDLE_PRIORITY  0
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
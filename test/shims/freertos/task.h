@@ -0,0 +1,23 @@
+#pragma once
+
+// ============================================================
+//  freertos/task.h  —  Native stand-in: the test program is the
+//  one "loop task"; background tasks are never started (tests call
+//  their bodies' step functions, e.g. dlog::drain(), directly)
+// ============================================================
+
+#include "FreeRTOS.h"
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    static int loopTask;
+    return &loopTask;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*,
+                                          UBaseType_t, TaskHandle_t* handle, int) {
+    static int task;
+    if (handle) *handle = &task;
+    return 1;
+}
+
+inline void vTaskDelay(TickType_t) {}
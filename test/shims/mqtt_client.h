@@ -0,0 +1,149 @@
+#pragma once
+
+// ============================================================
+//  mqtt_client.h  —  Native stand-in for esp-mqtt with an
+//  in-memory broker (shim::mqtt), the mosquitto of the tests
+//
+//  esp_mqtt_client_enqueue() puts messages in the client's
+//  outbox; nothing reaches the broker until the test calls
+//  shim::mqtt.flush(), which delivers the outbox in order and
+//  raises MQTT_EVENT_PUBLISHED for QoS 1/2 as an ack would.
+//  connect() / disconnect() raise the connection events.  Events
+//  run on the caller's thread, not on a client task.  A URI
+//  without a scheme is rejected by init, as esp-mqtt's parser does.
+// ============================================================
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "esp_err.h"
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t base, int32_t id, void* data);
+
+typedef enum {
+    MQTT_EVENT_ANY = -1,
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+    MQTT_EVENT_DELETED,
+} esp_mqtt_event_id_t;
+
+struct esp_mqtt_client_config_t {
+    struct { struct { const char* uri; } address; } broker;
+    struct { const char* client_id; }              credentials;
+    struct { int keepalive; }                       session;
+};
+
+struct esp_mqtt_event_t {
+    esp_mqtt_event_id_t event_id;
+    int                 msg_id;
+};
+typedef esp_mqtt_event_t* esp_mqtt_event_handle_t;
+
+struct esp_mqtt_client {};
+typedef esp_mqtt_client* esp_mqtt_client_handle_t;
+
+namespace shim {
+
+struct MqttMessage {
+    std::string          topic;
+    std::vector<uint8_t> payload;
+    int                  qos;
+};
+
+struct MqttBroker {
+    esp_mqtt_client          client;
+    std::string              uri;
+    std::string              clientId;
+    bool                     exists   = false;
+    bool                     started  = false;
+    esp_event_handler_t      handler  = nullptr;
+    void*                    arg      = nullptr;
+    int                      nextId   = 1;
+    int                      inits    = 0;        // esp_mqtt_client_init() calls
+    std::vector<MqttMessage> outbox;               // enqueued, not yet delivered
+    std::vector<int>         outboxIds;
+    std::vector<MqttMessage> delivered;
+
+    void event(esp_mqtt_event_id_t id, int msgId = 0) {
+        esp_mqtt_event_t e = { id, msgId };
+        if (handler) handler(arg, "MQTT_EVENTS", id, &e);
+    }
+    void connect()    { event(MQTT_EVENT_CONNECTED); }
+    void disconnect() { event(MQTT_EVENT_DISCONNECTED); }
+
+    void flush() {
+        for (size_t i = 0; i < outbox.size(); i++) {
+            delivered.push_back(outbox[i]);
+            if (outbox[i].qos > 0) event(MQTT_EVENT_PUBLISHED, outboxIds[i]);
+        }
+        outbox.clear();
+        outboxIds.clear();
+    }
+
+    int outboxBytes() const {
+        int n = 0;
+        for (const auto& m : outbox) n += static_cast<int>(m.payload.size());
+        return n;
+    }
+};
+
+inline MqttBroker mqtt;
+
+}  // namespace shim
+
+inline esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t* cfg) {
+    shim::mqtt.inits++;
+    if (!cfg->broker.address.uri || !strstr(cfg->broker.address.uri, "://")) return nullptr;
+    shim::mqtt.exists   = true;
+    shim::mqtt.uri      = cfg->broker.address.uri ? cfg->broker.address.uri : "";
+    shim::mqtt.clientId = cfg->credentials.client_id ? cfg->credentials.client_id : "";
+    return &shim::mqtt.client;
+}
+
+inline esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t, esp_mqtt_event_id_t,
+                                                esp_event_handler_t handler, void* arg) {
+    shim::mqtt.handler = handler;
+    shim::mqtt.arg     = arg;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t) {
+    shim::mqtt.started = true;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t) {
+    shim::mqtt.started = false;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t) {
+    shim::mqtt.exists  = false;
+    shim::mqtt.started = false;
+    shim::mqtt.handler = nullptr;
+    shim::mqtt.outbox.clear();
+    shim::mqtt.outboxIds.clear();
+    return ESP_OK;
+}
+
+inline int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t, const char* topic, const char* data,
+                                   int len, int qos, int /*retain*/, bool /*store*/) {
+    if (!shim::mqtt.started) return -1;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    shim::mqtt.outbox.push_back({ topic, std::vector<uint8_t>(p, p + len), qos });
+    shim::mqtt.outboxIds.push_back(shim::mqtt.nextId);
+    return shim::mqtt.nextId++;
+}
+
+inline int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t) {
+    return shim::mqtt.outboxBytes();
+}
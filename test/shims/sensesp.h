@@ -0,0 +1,85 @@
+#pragma once
+
+// ============================================================
+//  sensesp.h  —  Native stand-in for the SensESP event loop
+//
+//  event_loop() schedules onRepeat()/onDelay() callbacks on the
+//  shim's virtual clock.  Nothing runs until a test calls
+//  runUntil(), which moves the clock to each due event in time
+//  order (ties in registration order) and runs it, so hours of
+//  firmware time cost only as much as the callbacks themselves.
+//
+//  Repeats are scheduled from their previous due time, not from
+//  when they ran, so a 1 ms repeat fires exactly 1000 times a
+//  second.
+// ============================================================
+
+#include <Arduino.h>
+
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace sensesp {
+
+class EventLoop {
+public:
+    void onRepeat(uint32_t ms, std::function<void()> fn) {
+        add(ms ? ms * 1000ULL : 1000ULL, std::move(fn), true);
+    }
+    void onDelay(uint32_t ms, std::function<void()> fn) {
+        add(ms * 1000ULL, std::move(fn), false);
+    }
+
+    /// Run everything due up to untilUs, then leave the clock there.
+    void runUntil(uint64_t untilUs) {
+        while (!_queue.empty() && _queue.top().dueUs <= untilUs) {
+            Due d = _queue.top();
+            _queue.pop();
+            if (d.dueUs > shim::nowUs) shim::nowUs = d.dueUs;
+            Event& e = _events[d.index];      // deque: stable across add()
+            e.fn();
+            _dispatched++;
+            if (e.repeat) _queue.push({ d.dueUs + e.intervalUs, d.order, d.index });
+        }
+        if (untilUs > shim::nowUs) shim::nowUs = untilUs;
+    }
+
+    void runFor(uint64_t us) { runUntil(shim::nowUs + us); }
+    void tick()              { runUntil(shim::nowUs); }
+
+    uint64_t dispatched() const { return _dispatched; }
+
+private:
+    struct Event {
+        std::function<void()> fn;
+        uint64_t               intervalUs;
+        bool                   repeat;
+    };
+    struct Due {
+        uint64_t dueUs;
+        uint64_t order;
+        size_t   index;
+        bool operator>(const Due& o) const {
+            return dueUs != o.dueUs ? dueUs > o.dueUs : order > o.order;
+        }
+    };
+
+    void add(uint64_t us, std::function<void()> fn, bool repeat) {
+        _events.push_back({ std::move(fn), us, repeat });
+        _queue.push({ shim::nowUs + us, _order++, _events.size() - 1 });
+    }
+
+    std::deque<Event>                                     _events;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> _queue;
+    uint64_t                                              _order      = 0;
+    uint64_t                                              _dispatched = 0;
+};
+
+inline EventLoop* event_loop() {
+    static EventLoop loop;
+    return &loop;
+}
+
+}  // namespace sensesp
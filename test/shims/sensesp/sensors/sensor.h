@@ -0,0 +1,22 @@
+#pragma once
+
+// ============================================================
+//  sensor.h  —  Native stand-in for SensESP RepeatSensor
+// ============================================================
+
+#include <functional>
+
+#include <sensesp.h>
+#include "sensesp/system/observablevalue.h"
+
+namespace sensesp {
+
+template <typename T>
+class RepeatSensor : public ValueProducer<T> {
+public:
+    RepeatSensor(unsigned int intervalMs, std::function<T()> callback) {
+        event_loop()->onRepeat(intervalMs, [this, callback]() { this->emit(callback()); });
+    }
+};
+
+}  // namespace sensesp
@@ -0,0 +1,61 @@
+#pragma once
+
+// ============================================================
+//  signalk_output.h  —  Native stand-in for SensESP SK outputs
+//
+//  Each output keeps its last value and how often it was set,
+//  and registers under its SK path so a test can look it up with
+//  SKOutput<T>::find().
+// ============================================================
+
+#include <Arduino.h>
+#include <ArduinoJson.h>   // SensESP pulls it in for every module
+
+#include <map>
+#include <string>
+
+#include "sensesp/system/observablevalue.h"
+
+namespace sensesp {
+
+template <typename T>
+class SKOutput : public ObservableValue<T> {
+public:
+    explicit SKOutput(const String& skPath, const String& configPath = "")
+        : _skPath(skPath), _configPath(configPath) {
+        registry()[skPath] = this;
+    }
+
+    void set(const T& value) override {
+        _sets++;
+        ObservableValue<T>::set(value);
+    }
+
+    const String& get_sk_path() const { return _skPath; }
+    uint32_t      sets()        const { return _sets; }
+
+    static SKOutput* find(const std::string& skPath) {
+        auto it = registry().find(skPath);
+        return it == registry().end() ? nullptr : it->second;
+    }
+
+private:
+    static std::map<std::string, SKOutput*>& registry() {
+        static std::map<std::string, SKOutput*> r;
+        return r;
+    }
+
+    String   _skPath;
+    String   _configPath;
+    uint32_t _sets = 0;
+};
+
+// Distinct classes (not aliases) so the firmware's forward
+// declarations (`class SKOutputRawJson;`) match.
+class SKOutputFloat : public SKOutput<float> { using SKOutput<float>::SKOutput; };
+class SKOutputInt : public SKOutput<int> { using SKOutput<int>::SKOutput; };
+class SKOutputBool : public SKOutput<bool> { using SKOutput<bool>::SKOutput; };
+class SKOutputString : public SKOutput<String> { using SKOutput<String>::SKOutput; };
+class SKOutputRawJson : public SKOutput<String> { using SKOutput<String>::SKOutput; };
+
+}  // namespace sensesp
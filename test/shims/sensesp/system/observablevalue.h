@@ -0,0 +1,82 @@
+#pragma once
+
+// ============================================================
+//  observablevalue.h  —  Native stand-in for SensESP values
+//
+//  Observable (attach/notify), producer → consumer connections
+//  and (Persisting)ObservableValue, with the same call shapes as
+//  SensESP v3.  Nothing is persisted: the config path is kept
+//  only so a test can tell values apart.
+// ============================================================
+
+#include <Arduino.h>
+
+#include <functional>
+#include <vector>
+
+namespace sensesp {
+
+class Observable {
+public:
+    void attach(std::function<void()> observer) { _observers.push_back(std::move(observer)); }
+    void notify() {
+        for (auto& o : _observers) o();
+    }
+
+private:
+    std::vector<std::function<void()>> _observers;
+};
+
+template <typename T>
+class ValueConsumer {
+public:
+    virtual ~ValueConsumer() = default;
+    virtual void set(const T& value) = 0;
+};
+
+template <typename T>
+class ValueProducer : public Observable {
+public:
+    virtual ~ValueProducer() = default;
+
+    const T& get() const { return _output; }
+
+    void emit(const T& value) {
+        _output = value;
+        notify();
+        for (auto* c : _consumers) c->set(value);
+    }
+
+    template <typename C>
+    C* connect_to(C* consumer) {
+        _consumers.push_back(consumer);
+        return consumer;
+    }
+
+protected:
+    T _output{};
+
+private:
+    std::vector<ValueConsumer<T>*> _consumers;
+};
+
+template <typename T>
+class ObservableValue : public ValueProducer<T>, public ValueConsumer<T> {
+public:
+    explicit ObservableValue(const T& value = T()) { this->_output = value; }
+    void set(const T& value) override { this->emit(value); }
+};
+
+template <typename T>
+class PersistingObservableValue : public ObservableValue<T> {
+public:
+    PersistingObservableValue(const T& value, const String& configPath = "")
+        : ObservableValue<T>(value), _configPath(configPath) {}
+
+    const String& get_config_path() const { return _configPath; }
+
+private:
+    String _configPath;
+};
+
+}  // namespace sensesp
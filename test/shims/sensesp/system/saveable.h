@@ -0,0 +1,29 @@
+#pragma once
+
+// ============================================================
+//  saveable.h  —  Native stand-in for SensESP FileSystemSaveable
+//
+//  There is no filesystem: load() finds no saved config, so an
+//  object keeps its defaults unless a test calls from_json().
+// ============================================================
+
+#include <Arduino.h>
+
+namespace sensesp {
+
+class FileSystemSaveable {
+public:
+    explicit FileSystemSaveable(const String& configPath) : _configPath(configPath) {}
+    virtual ~FileSystemSaveable() = default;
+
+    virtual bool load()  { return false; }
+    virtual bool save()  { return true; }
+    virtual bool clear() { return true; }
+
+    const String& get_config_path() const { return _configPath; }
+
+private:
+    String _configPath;
+};
+
+}  // namespace sensesp
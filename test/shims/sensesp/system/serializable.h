@@ -0,0 +1,19 @@
+#pragma once
+
+// ============================================================
+//  serializable.h  —  Native stand-in for SensESP Serializable
+//  (config objects read from / written to JSON)
+// ============================================================
+
+#include <ArduinoJson.h>
+
+namespace sensesp {
+
+class Serializable {
+public:
+    virtual ~Serializable() = default;
+    virtual bool to_json(JsonObject& root)         { (void)root; return false; }
+    virtual bool from_json(const JsonObject& root) { (void)root; return false; }
+};
+
+}  // namespace sensesp
@@ -0,0 +1,59 @@
+#pragma once
+
+// ============================================================
+//  curveinterpolator.h  —  Native stand-in for SensESP
+//  CurveInterpolator: piecewise-linear over the sample table,
+//  clamped at both ends, NaN in → NaN out.
+// ============================================================
+
+#include <Arduino.h>
+
+#include <cmath>
+#include <iterator>
+#include <set>
+
+#include "sensesp/system/observablevalue.h"
+
+namespace sensesp {
+
+class CurveInterpolator : public ValueProducer<float>, public ValueConsumer<float> {
+public:
+    class Sample {
+    public:
+        Sample(float input, float output) : input_(input), output_(output) {}
+        bool operator<(const Sample& o) const { return input_ < o.input_; }
+        float input_;
+        float output_;
+    };
+
+    explicit CurveInterpolator(std::set<Sample>* defaults = nullptr,
+                               const String& configPath = "") {
+        (void)configPath;
+        if (defaults) _samples = *defaults;
+    }
+
+    void set(const float& input) override {
+        if (std::isnan(input) || _samples.empty()) {
+            emit(NAN);
+            return;
+        }
+        auto hi = _samples.lower_bound(Sample(input, 0));
+        if (hi == _samples.begin()) { emit(hi->output_); return; }
+        if (hi == _samples.end())   { emit(std::prev(hi)->output_); return; }
+        auto  lo = std::prev(hi);
+        float r  = (input - lo->input_) / (hi->input_ - lo->input_);
+        emit(lo->output_ + r * (hi->output_ - lo->output_));
+    }
+
+    const std::set<Sample>& get_samples() const { return _samples; }
+    void clear_samples()                  { _samples.clear(); }
+    void add_sample(const Sample& sample) { _samples.insert(sample); }
+
+    CurveInterpolator* set_input_title(const String&)  { return this; }
+    CurveInterpolator* set_output_title(const String&) { return this; }
+
+private:
+    std::set<Sample> _samples;
+};
+
+}  // namespace sensesp
@@ -0,0 +1,27 @@
+#pragma once
+
+// ============================================================
+//  config_item.h  —  Native stand-in for SensESP ConfigItem
+//  (web UI cards): accepts the builder calls and does nothing.
+// ============================================================
+
+#include <Arduino.h>
+
+#include <memory>
+
+namespace sensesp {
+
+template <typename T>
+class ConfigItemT {
+public:
+    ConfigItemT* set_title(const String&)       { return this; }
+    ConfigItemT* set_description(const String&) { return this; }
+    ConfigItemT* set_sort_order(int)            { return this; }
+};
+
+template <typename T>
+std::shared_ptr<ConfigItemT<T>> ConfigItem(T*) {
+    return std::make_shared<ConfigItemT<T>>();
+}
+
+}  // namespace sensesp
@@ -0,0 +1,14 @@
+#pragma once
+
+// ============================================================
+//  shim_main.h  —  Out-of-line parts of the native shims
+//
+//  Include from exactly one file per test program (the one with
+//  main()): these definitions must exist once for the NMEA2000
+//  library objects to link against.
+// ============================================================
+
+#include <Arduino.h>
+
+extern "C" uint32_t millis() { return static_cast<uint32_t>(shim::nowUs / 1000); }
+extern "C" void     delay(uint32_t ms) { shim::advanceMs(ms); }
@@ -0,0 +1,216 @@
+// ============================================================
+//  test_ads_scheduler — Non-blocking multi-ADS1115 scheduling
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "AdsScheduler.h"
+
+void setUp() { shim::reset(); }
+void tearDown() {}
+
+static constexpr uint16_t kGainOne = 0x0200;
+static constexpr uint16_t k16Sps   = 0x0020;   // 62.5 ms (68.75 ms with tolerance)
+static constexpr uint16_t k128Sps  = 0x0080;   // 7.8 ms  (8.6 ms)
+
+// Scripted bus: each chip converts for a fixed time, each I²C
+// transaction costs txUs on the virtual clock.
+class FakeBus : public AdsBus {
+public:
+    bool     present[AdsScheduler::kMaxDevices] = { true, true, true, true };
+    bool     stuck[AdsScheduler::kMaxDevices]   = {};   // OS bit never set
+    uint32_t convUs[AdsScheduler::kMaxDevices]  = { 62500, 62500, 62500, 62500 };
+    uint32_t txUs   = 100;
+    int      begins = 0;
+    int      starts[AdsScheduler::kMaxDevices]  = {};
+    int      busy   = 0;                                 // devices converting right now
+    int      maxBusy = 0;
+
+    bool begin(uint8_t d) override {
+        tx();
+        begins++;
+        return present[d];
+    }
+    void start(uint8_t d, const AdsChannel& ch) override {
+        tx();
+        starts[d]++;
+        _mux[d]     = ch.mux;
+        _startUs[d] = micros();
+        if (!_conv[d]) busy++;
+        _conv[d] = true;
+        if (busy > maxBusy) maxBusy = busy;
+    }
+    bool ready(uint8_t d) override {
+        tx();
+        bool done = present[d] && !stuck[d] && micros() - _startUs[d] >= convUs[d];
+        if (done && _conv[d]) {
+            _conv[d] = false;
+            busy--;
+        }
+        return done;
+    }
+    int16_t result(uint8_t d) override {
+        tx();
+        return static_cast<int16_t>(1000 * (d + 1) + _mux[d]);
+    }
+
+private:
+    void tx() { shim::advanceUs(txUs); }
+
+    uint8_t  _mux[AdsScheduler::kMaxDevices]     = {};
+    uint32_t _startUs[AdsScheduler::kMaxDevices] = {};
+    bool     _conv[AdsScheduler::kMaxDevices]    = {};
+};
+
+struct Got {
+    int      n = 0;
+    int      channel[64];
+    int16_t  raw[64];
+    uint32_t ageMs[64];    // delivery time − acquisition stamp
+};
+
+static void sink(void* ctx, int channel, int16_t raw, uint32_t acquiredMs) {
+    Got* g = static_cast<Got*>(ctx);
+    if (g->n < 64) {
+        g->channel[g->n] = channel;
+        g->raw[g->n]     = raw;
+        g->ageMs[g->n]   = millis() - acquiredMs;
+    }
+    g->n++;
+}
+
+static uint32_t clockUs() { return micros(); }
+
+// Poll every 5 ms of virtual time for `ms`
+static void run(AdsScheduler& s, uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 5) {
+        shim::advanceMs(5);
+        s.poll(millis());
+    }
+}
+
+// ----------------------------------------------------------
+static void test_devices_convert_in_parallel() {
+    FakeBus      bus;
+    Got          got;
+    AdsScheduler s(bus, clockUs, sink, &got, 5000);
+    // One channel on each of two chips, both every 100 ms
+    TEST_ASSERT_EQUAL(0, s.add({ 0, 0, kGainOne, k16Sps, 100 }, millis()));
+    TEST_ASSERT_EQUAL(1, s.add({ 1, 3, kGainOne, k16Sps, 100 }, millis()));
+
+    run(s, 1000);
+    TEST_ASSERT_TRUE(s.allUp());
+    TEST_ASSERT_EQUAL(2, bus.begins);
+    TEST_ASSERT_EQUAL(2, bus.maxBusy);              // both chips busy at once
+    TEST_ASSERT_UINT32_WITHIN(1, 10, s.channel(0).samples);
+    TEST_ASSERT_UINT32_WITHIN(1, 10, s.channel(1).samples);
+    TEST_ASSERT_EQUAL(0, s.channel(0).late + s.channel(1).late);
+    TEST_ASSERT_EQUAL(1000, s.channel(0).raw);
+    TEST_ASSERT_EQUAL(2003, s.channel(1).raw);
+
+    // Stamped mid-conversion: half of 68.75 ms, plus up to one poll
+    for (int i = 0; i < got.n && i < 64; i++) {
+        TEST_ASSERT_TRUE(got.ageMs[i] >= 34 && got.ageMs[i] <= 34 + 5 + 5);
+    }
+
+    // Each completed sample cost one start, one (or two) ready checks
+    // and one result read — never the conversion time itself
+    uint32_t us = s.usPerSample(0);
+    TEST_ASSERT_TRUE(us >= 300 && us <= 500);
+    TEST_ASSERT_EQUAL(100u, s.device(0).maxTxUs);
+}
+
+static void test_channels_share_a_device_by_interval() {
+    FakeBus      bus;
+    Got          got;
+    AdsScheduler s(bus, clockUs, sink, &got, 5000);
+    bus.convUs[0] = 7800;
+    s.add({ 0, 0, kGainOne, k128Sps, 50 },  millis());   // fast channel
+    s.add({ 0, 1, kGainOne, k128Sps, 500 }, millis());   // slow channel
+
+    run(s, 2000);
+    TEST_ASSERT_UINT32_WITHIN(2, 40, s.channel(0).samples);
+    TEST_ASSERT_UINT32_WITHIN(1, 4,  s.channel(1).samples);
+    TEST_ASSERT_EQUAL(0, s.channel(0).late + s.channel(1).late);
+    TEST_ASSERT_EQUAL(got.n, static_cast<int>(s.device(0).samples));
+}
+
+static void test_overloaded_device_counts_late() {
+    FakeBus      bus;
+    Got          got;
+    AdsScheduler s(bus, clockUs, sink, &got, 5000);
+    // Three 16 SPS channels every 100 ms need ~210 ms of conversion
+    // per 100 ms — the device can only fall behind
+    for (uint8_t m = 0; m < 3; m++) s.add({ 0, m, kGainOne, k16Sps, 100 }, millis());
+
+    run(s, 3000);
+    uint32_t late = 0, samples = 0;
+    for (int c = 0; c < 3; c++) {
+        late    += s.channel(c).late;
+        samples += s.channel(c).samples;
+        TEST_ASSERT_TRUE(s.channel(c).samples > 5);   // nobody starves
+    }
+    TEST_ASSERT_TRUE(late > 0);
+    TEST_ASSERT_UINT32_WITHIN(3, 3000 / 70, samples);   // back to back
+}
+
+static void test_timeouts_take_device_down_and_probe_recovers() {
+    FakeBus      bus;
+    Got          got;
+    AdsScheduler s(bus, clockUs, sink, &got, 5000);
+    s.add({ 0, 0, kGainOne, k16Sps, 100 }, millis());
+    s.add({ 1, 0, kGainOne, k16Sps, 100 }, millis());
+
+    run(s, 500);
+    TEST_ASSERT_TRUE(s.allUp());
+
+    // Chip 1 stops completing conversions
+    bus.stuck[1] = true;
+    run(s, 1000);
+    TEST_ASSERT_FALSE(s.allUp());
+    TEST_ASSERT_EQUAL(static_cast<int>(AdsScheduler::State::DOWN), static_cast<int>(s.device(1).state));
+    TEST_ASSERT_EQUAL(AdsScheduler::kMaxTimeouts, static_cast<int>(s.device(1).timeouts));
+    TEST_ASSERT_EQUAL(1u, s.device(1).downs);
+    uint32_t frozen = s.channel(1).samples;
+    uint32_t before = s.channel(0).samples;
+
+    // …and drops off the bus: probes fail every 5 s; chip 0 carries on
+    bus.present[1] = false;
+    bus.stuck[1]   = false;
+    run(s, 11000);
+    TEST_ASSERT_EQUAL(frozen, s.channel(1).samples);
+    TEST_ASSERT_UINT32_WITHIN(2, 2, s.failedBegins());
+    TEST_ASSERT_TRUE(s.channel(0).samples - before >= 110);
+
+    // Back on the bus: the next probe brings it up without a burst of late samples
+    bus.present[1] = true;
+    run(s, 6000);
+    TEST_ASSERT_TRUE(s.allUp());
+    TEST_ASSERT_TRUE(s.channel(1).samples > frozen + 5);
+    TEST_ASSERT_EQUAL(0u, s.channel(1).late);
+}
+
+static void test_rejects_bad_rows() {
+    FakeBus      bus;
+    AdsScheduler s(bus, clockUs, nullptr, nullptr, 5000);
+    TEST_ASSERT_EQUAL(-1, s.add({ AdsScheduler::kMaxDevices, 0, kGainOne, k16Sps, 100 }, 0));
+    TEST_ASSERT_EQUAL(-1, s.add({ 0, 4, kGainOne, k16Sps, 100 }, 0));
+    for (int i = 0; i < AdsScheduler::kMaxChannels; i++) {
+        TEST_ASSERT_EQUAL(i, s.add({ 0, static_cast<uint8_t>(i & 3), kGainOne, k16Sps, 100 }, 0));
+    }
+    TEST_ASSERT_EQUAL(-1, s.add({ 0, 0, kGainOne, k16Sps, 100 }, 0));
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 4.096f / 32768.0f, adsVoltsPerCount(kGainOne));
+    TEST_ASSERT_EQUAL(68750u, adsConversionUs(k16Sps));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_devices_convert_in_parallel);
+    RUN_TEST(test_channels_share_a_device_by_interval);
+    RUN_TEST(test_overloaded_device_counts_late);
+    RUN_TEST(test_timeouts_take_device_down_and_probe_recovers);
+    RUN_TEST(test_rejects_bad_rows);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// ============================================================
+//  test_alarm_integrator — time-based alarm debounce
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "AlarmIntegrator.h"
+
+static constexpr uint32_t kAssertUs  = 60'000;
+static constexpr uint32_t kReleaseUs = 500'000;
+
+void setUp()    {}
+void tearDown() {}
+
+static void test_glitch_shorter_than_assert_rejected() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(false, 0);
+    TEST_ASSERT_FALSE(in.edge(true,  1'000));
+    TEST_ASSERT_FALSE(in.edge(false, 1'000 + kAssertUs - 1));
+    TEST_ASSERT_FALSE(in.update(1'000'000));
+    TEST_ASSERT_FALSE(in.asserted());
+    TEST_ASSERT_EQUAL_UINT32(1, in.rejected());
+}
+
+static void test_asserts_at_exact_crossing() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(false, 0);
+    in.edge(true, 10'000);
+    // Polled late: the change is still timestamped at the crossing
+    TEST_ASSERT_TRUE(in.update(200'000));
+    TEST_ASSERT_TRUE(in.asserted());
+    TEST_ASSERT_EQUAL_UINT32(10'000 + kAssertUs, in.lastChangeUs());
+}
+
+static void test_releases_after_release_time() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(true, 0);
+    in.edge(false, 100'000);
+    TEST_ASSERT_FALSE(in.update(100'000 + kReleaseUs - 1));
+    TEST_ASSERT_TRUE(in.update(100'000 + kReleaseUs));
+    TEST_ASSERT_FALSE(in.asserted());
+}
+
+static void test_dense_spikes_drained() {
+    // 40 ms on / 20 ms off: 40 in, 80 drained per cycle → never 60
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(false, 0);
+    uint32_t t = 0;
+    for (int i = 0; i < 100; i++) {
+        in.edge(true,  t);
+        in.edge(false, t + 40'000);
+        t += 60'000;
+    }
+    in.update(t);
+    TEST_ASSERT_FALSE(in.asserted());
+}
+
+static void test_dropout_does_not_release() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(true, 0);
+    uint32_t t = 0;
+    for (int i = 0; i < 50; i++) {               // 150 ms dropout every second
+        in.edge(false, t + 850'000);
+        in.edge(true,  t + 1'000'000);
+        t += 1'000'000;
+    }
+    in.update(t);
+    TEST_ASSERT_TRUE(in.asserted());
+}
+
+static void test_wraps_with_micros() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    uint32_t t0 = 0xFFFFFFFFu - 20'000;
+    in.reset(false, t0);
+    in.edge(true, t0);
+    TEST_ASSERT_FALSE(in.update(t0 + kAssertUs - 1));   // wrapped
+    TEST_ASSERT_TRUE(in.update(t0 + kAssertUs));
+}
+
+static void test_set_times_applies_to_next_integration() {
+    AlarmIntegrator in(kAssertUs, kReleaseUs, 4);
+    in.reset(false, 0);
+    in.setTimes(10'000, kReleaseUs);
+    in.edge(true, 0);
+    TEST_ASSERT_TRUE(in.update(10'000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_glitch_shorter_than_assert_rejected);
+    RUN_TEST(test_asserts_at_exact_crossing);
+    RUN_TEST(test_releases_after_release_time);
+    RUN_TEST(test_dense_spikes_drained);
+    RUN_TEST(test_dropout_does_not_release);
+    RUN_TEST(test_wraps_with_micros);
+    RUN_TEST(test_set_times_applies_to_next_integration);
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+// ============================================================
+//  test_alarm_rules — Hysteresis, rate of rise, stale sensors
+//                     and notification rate limiting
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cmath>
+#include <vector>
+
+#include "AlarmRules.h"
+
+void setUp() {}
+void tearDown() {}
+
+struct Note {
+    int        rule;
+    AlarmLevel level;
+    float      value;
+    uint32_t   ms;
+};
+
+static std::vector<Note> sNotes;
+
+static void sink(void*, int rule, AlarmLevel level, float value, uint32_t nowMs) {
+    sNotes.push_back({ rule, level, value, nowMs });
+}
+
+static constexpr uint32_t kNotifyMs = 30000;
+static const AlarmRule kCoolantHigh = { 0, AlarmKind::ABOVE, AlarmGate::ALWAYS, 95.0f, 105.0f, 2.0f, NAN, 0 };
+
+// ----------------------------------------------------------
+static void test_hysteresis_stops_flapping() {
+    sNotes.clear();
+    AlarmRules r(sink, nullptr, kNotifyMs);
+    TEST_ASSERT_EQUAL(0, r.add(kCoolantHigh, 0));
+
+    // A reading hovering at the warn threshold, every 200 ms for 10 min
+    uint32_t t = 0;
+    for (int i = 0; i < 3000; i++, t += 200) {
+        r.sample(0, (i & 1) ? 95.3f : 94.6f, t);
+        r.tick(t);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(0)));
+    TEST_ASSERT_EQUAL(1u, r.state(0).transitions);
+    TEST_ASSERT_EQUAL(1u, sNotes.size());
+
+    // Clears only below 93 °C; alarm steps down to warn below 103 °C
+    r.sample(0, 93.5f, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(0)));
+    r.sample(0, 92.9f, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(r.level(0)));
+    r.sample(0, 106.0f, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::ALARM), static_cast<int>(r.level(0)));
+    r.sample(0, 103.5f, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::ALARM), static_cast<int>(r.level(0)));
+    r.sample(0, 102.9f, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(0)));
+
+    // A failed sensor (NaN) leaves the level where it is
+    r.sample(0, NAN, t += 200);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(0)));
+}
+
+static void test_notifications_rate_limited() {
+    sNotes.clear();
+    AlarmRule noHyst = kCoolantHigh;
+    noHyst.hysteresis = 0.0f;
+    AlarmRules r(sink, nullptr, kNotifyMs);
+    r.add(noHyst, 0);
+
+    // Without hysteresis the level flips every sample for 10 min …
+    uint32_t t = 0;
+    for (int i = 0; i < 3000; i++, t += 200) {
+        r.sample(0, (i & 1) ? 95.3f : 94.6f, t);
+        r.tick(t);
+    }
+    TEST_ASSERT_TRUE(r.state(0).transitions > 2900);
+    // … but at most two notifications go out per 30 s
+    TEST_ASSERT_TRUE(sNotes.size() <= 2 * (600000 / kNotifyMs) + 1);
+    for (size_t i = 2; i < sNotes.size(); i++) {
+        TEST_ASSERT_TRUE(sNotes[i].ms - sNotes[i - 2].ms >= kNotifyMs);
+    }
+
+    // An escalation is never held back
+    sNotes.clear();
+    r.sample(0, 110.0f, t += 200);
+    TEST_ASSERT_EQUAL(1u, sNotes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::ALARM), static_cast<int>(sNotes[0].level));
+
+    // A clear is sent once the interval has passed, from tick() alone
+    r.sample(0, 80.0f, t += 200);
+    size_t before = sNotes.size();
+    for (uint32_t end = t + kNotifyMs + 1000; t < end; t += 100) r.tick(t);
+    TEST_ASSERT_EQUAL(before + 1, sNotes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(sNotes.back().level));
+}
+
+static void test_rise_warns_before_threshold() {
+    sNotes.clear();
+    AlarmRules r(sink, nullptr, kNotifyMs);
+    int high = r.add(kCoolantHigh, 0);
+    int rise = r.add({ 0, AlarmKind::RISE, AlarmGate::RUNNING, 2.0f, 5.0f, 1.0f, 88.0f, 60000 }, 0);
+    r.setRunning(true, 0);
+
+    // Warm-up: 20 → 82 °C at up to 12 °C/min, below the arming level
+    uint32_t t = 0;
+    float    c = 20.0f;
+    for (; t < 20 * 60000u; t += 200) {
+        c += (82.0f - c) * 0.2f / 300.0f;
+        r.sample(0, c + ((t / 200) % 3) * 0.1f, t);
+    }
+    TEST_ASSERT_EQUAL(0u, sNotes.size());
+
+    // Impeller failure: +3 °C/min from the thermostat
+    uint32_t riseWarn = 0, highWarn = 0;
+    for (; c < 100.0f; t += 200) {
+        c += 3.0f * 0.2f / 60.0f;
+        r.sample(0, c, t);
+        r.tick(t);
+        if (!riseWarn && r.level(rise) != AlarmLevel::NORMAL) riseWarn = t;
+        if (!highWarn && r.level(high) != AlarmLevel::NORMAL) highWarn = t;
+    }
+    TEST_ASSERT_TRUE(riseWarn > 0 && highWarn > 0);
+    printf("rate-of-rise warning %.0f s before the 95 °C threshold\n", (highWarn - riseWarn) / 1000.0);
+    TEST_ASSERT_TRUE(highWarn - riseWarn > 120000);             // armed at 88 °C, 95 °C is 140 s later
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(rise)));
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 3.0f, r.state(rise).value);
+
+    // Engine stopped: RUNNING rules drop to normal
+    r.setRunning(false, t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(r.level(rise)));
+    TEST_ASSERT_FALSE(r.state(rise).active);
+}
+
+static void test_stale_sensor_while_running() {
+    sNotes.clear();
+    AlarmRules r(sink, nullptr, kNotifyMs);
+    int stale = r.add({ 0, AlarmKind::STALE, AlarmGate::RUNNING, 10.0f, 60.0f, 0.0f, NAN, 0 }, 0);
+    int tank  = r.add({ 1, AlarmKind::BELOW, AlarmGate::ALWAYS, 20.0f, 10.0f, 3.0f, NAN, 0 }, 0);
+
+    // Engine off: no readings at all, no alarm
+    uint32_t t = 0;
+    for (; t < 120000; t += 100) r.tick(t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(r.level(stale)));
+
+    // Running: the clock starts at the start, NaN readings do not reset it
+    r.setRunning(true, t);
+    for (uint32_t end = t + 9000; t < end; t += 100) {
+        r.sample(0, NAN, t);
+        r.tick(t);
+    }
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(r.level(stale)));
+    for (uint32_t end = t + 2000; t < end; t += 100) r.tick(t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(stale)));
+    for (uint32_t end = t + 50000; t < end; t += 100) r.tick(t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::ALARM), static_cast<int>(r.level(stale)));
+    TEST_ASSERT_TRUE(r.state(stale).value >= 60.0f);
+
+    // A valid reading clears it (sent once the rate limit allows)
+    r.sample(0, 80.0f, t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::NORMAL), static_cast<int>(r.level(stale)));
+
+    // Inputs are independent: the tank rule only sees input 1
+    r.sample(1, 15.0f, t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(tank)));
+    r.sample(1, 22.0f, t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(tank)));   // < 23 %
+    r.sample(1, 9.0f, t);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::ALARM), static_cast<int>(r.level(tank)));
+}
+
+static void test_thresholds_and_limits() {
+    AlarmRules r(nullptr, nullptr, kNotifyMs);
+    int id = r.add(kCoolantHigh, 0);
+    r.setThresholds(id, 85.0f, 90.0f);
+    r.sample(0, 87.0f, 0);
+    TEST_ASSERT_EQUAL(static_cast<int>(AlarmLevel::WARN), static_cast<int>(r.level(id)));
+
+    AlarmRule bad = kCoolantHigh;
+    bad.input = AlarmRules::kMaxInputs;
+    TEST_ASSERT_EQUAL(-1, r.add(bad, 0));
+    for (int i = 1; i < AlarmRules::kMaxRules; i++) TEST_ASSERT_EQUAL(i, r.add(kCoolantHigh, 0));
+    TEST_ASSERT_EQUAL(-1, r.add(kCoolantHigh, 0));
+    TEST_ASSERT_EQUAL_STRING("alarm", alarmLevelName(AlarmLevel::ALARM));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hysteresis_stops_flapping);
+    RUN_TEST(test_notifications_rate_limited);
+    RUN_TEST(test_rise_warns_before_threshold);
+    RUN_TEST(test_stale_sensor_while_running);
+    RUN_TEST(test_thresholds_and_limits);
+    return UNITY_END();
+}
@@ -0,0 +1,370 @@
+// ============================================================
+//  test_bench — Microbenchmarks of the hot pure-logic paths
+//
+//  Each benchmark runs its body in growing batches until it has
+//  taken at least HALMET_BENCH_MIN_MS (default 50 ms) of wall
+//  time, then reports nanoseconds and heap allocations per call.
+//  Allocations are counted by replacing the global operator
+//  new/delete for this program.
+//
+//  Results go to stdout and to bench_results.json (override with
+//  the HALMET_BENCH_OUT environment variable) as:
+//    { "schema": 1, "compiler": "...",
+//      "results": [ { "name", "ns_per_op", "allocs_per_op",
+//                     "iterations" }, ... ] }
+//  Compare two runs with tools/bench_compare.py.
+//
+//  The test itself only fails if a path that runs every tick on
+//  the target allocates; timings are host numbers, useful for
+//  relative comparison only.
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "AlarmIntegrator.h"
+#include "AlarmRules.h"
+#include "BilgeFan.h"
+#include "CompactEncoder.h"
+#include "CoolantCurve.h"
+#include "FlashJournal.h"
+#include "N2kSenders.h"
+#include "OneWireRegistry.h"
+#include "RevAnalyzer.h"
+#include "RpmSensor.h"
+#include "StrappingTable.h"
+#include "TelemetryBatch.h"
+
+// ----------------------------------------------------------
+//  Allocation counting
+// ----------------------------------------------------------
+static uint64_t sAllocs = 0;
+
+void* operator new(size_t n) {
+    sAllocs++;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void  operator delete(void* p) noexcept { std::free(p); }
+void  operator delete[](void* p) noexcept { std::free(p); }
+void  operator delete(void* p, size_t) noexcept { std::free(p); }
+void  operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// ----------------------------------------------------------
+//  Harness
+// ----------------------------------------------------------
+struct BenchResult {
+    std::string name;
+    double      nsPerOp;
+    double      allocsPerOp;
+    uint64_t    iterations;
+};
+
+static std::vector<BenchResult> sResults;
+static volatile double          sSink;    // keeps results observable
+
+template <typename F>
+static const BenchResult& bench(const char* name, F&& body) {
+    using Clock = std::chrono::steady_clock;
+    const char* env   = std::getenv("HALMET_BENCH_MIN_MS");
+    const double minNs = (env ? std::atof(env) : 50.0) * 1e6;
+
+    for (int i = 0; i < 1000; i++) body();   // warm caches and lazy state
+
+    uint64_t batch = 1000, iters = 0, allocs = 0;
+    double   ns = 0;
+    while (ns < minNs) {
+        uint64_t a0 = sAllocs;
+        auto     t0 = Clock::now();
+        for (uint64_t i = 0; i < batch; i++) body();
+        auto     t1 = Clock::now();
+        allocs += sAllocs - a0;
+        ns     += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        iters  += batch;
+        batch  *= 2;
+    }
+
+    sResults.push_back({ name, ns / iters, static_cast<double>(allocs) / iters, iters });
+    const BenchResult& r = sResults.back();
+    printf("%-36s %10.1f ns/op %8.3f allocs/op  (%llu iterations)\n",
+           r.name.c_str(), r.nsPerOp, r.allocsPerOp, (unsigned long long)r.iterations);
+    return r;
+}
+
+static void writeJson() {
+    const char* path = std::getenv("HALMET_BENCH_OUT");
+    if (!path) path = "bench_results.json";
+
+    std::string out = "{\n  \"schema\": 1,\n  \"compiler\": \"" __VERSION__ "\",\n  \"results\": [\n";
+    char line[256];
+    for (size_t i = 0; i < sResults.size(); i++) {
+        const BenchResult& r = sResults[i];
+        snprintf(line, sizeof(line),
+                 "    { \"name\": \"%s\", \"ns_per_op\": %.2f, \"allocs_per_op\": %.4f, "
+                 "\"iterations\": %llu }%s\n",
+                 r.name.c_str(), r.nsPerOp, r.allocsPerOp,
+                 (unsigned long long)r.iterations, i + 1 < sResults.size() ? "," : "");
+        out += line;
+    }
+    out += "  ]\n}\n";
+
+    fputs(out.c_str(), stdout);
+    if (FILE* f = fopen(path, "w")) {
+        fputs(out.c_str(), f);
+        fclose(f);
+    }
+}
+
+// ----------------------------------------------------------
+//  Benchmarks
+// ----------------------------------------------------------
+static constexpr uint8_t kPin = 23;
+
+void setUp()    { shim::reset(10'000'000); }
+void tearDown() {}
+
+static void bench_rpm_sensor() {
+    RpmSensor s(kPin, 10.0f, RPM_SMOOTHING_SAMPLES);
+    s.begin();
+
+    auto& isr = bench("RpmSensor::isrHandler", [] {
+        shim::advanceUs(4000);
+        RpmSensor::isrHandler();
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, isr.allocsPerOp);
+
+    auto& upd = bench("RpmSensor::update (25 edges)", [&] {
+        for (int i = 0; i < 25; i++) RpmSensor::isrHandler();
+        shim::advanceMs(INTERVAL_RPM_MS);
+        sSink = s.update();
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, upd.allocsPerOp);
+}
+
+static void bench_coolant_curve() {
+    float v = 0.0f;
+    auto& r = bench("CoolantCurve::voltageToCelsius", [&] {
+        v += 0.0137f;
+        if (v > 3.3f) v = 0.0f;
+        sSink = CoolantCurve::voltageToCelsius(v);
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+static void bench_strapping_table() {
+    // 1024-point table: the lookup must not depend on its length
+    static StrappingTable t;
+    std::vector<StrappingTable::Point> pts;
+    for (int i = 0; i < StrappingTable::kMaxPoints; i++) {
+        float x = i / float(StrappingTable::kMaxPoints - 1);
+        pts.push_back({ 10.0f + 170.0f * x, 600.0f * x, 90.0f * x * (2.0f - x) });
+    }
+    TEST_ASSERT_TRUE(t.compile(pts.data(), static_cast<int>(pts.size())) == StrappingStatus::OK);
+    float r = 10.0f;
+    auto& b = bench("StrappingTable::litres (1024 pts)", [&] {
+        r += 0.731f;
+        if (r > 180.0f) r = 10.0f;
+        sSink = t.litres(r);
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, b.allocsPerOp);
+}
+
+static void bench_bilge_fan() {
+    BilgeFan fan(HALMET_PIN_RELAY);
+    fan.begin();
+    int  relayChanges = 0;
+    fan.onRelayChange([&](bool) { relayChanges++; });
+    uint32_t n = 0;
+    auto& r = bench("BilgeFan::update", [&] {
+        // Alternate run / stop so purge and relay callbacks are exercised
+        fan.update((++n / 64) % 2 == 0, 30.0f);
+    });
+    sSink = relayChanges;
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+static void bench_alarm_integrator() {
+    AlarmIntegrator a(60'000, 500'000, 4);
+    uint32_t t     = 0;
+    bool     level = false;
+    a.reset(false, t);
+    auto& r = bench("AlarmIntegrator::edge+update", [&] {
+        t += 7'000;
+        level = !level;
+        a.edge(level, t);
+        sSink = a.update(t + 5'000);
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+static void bench_alarm_rules() {
+    // The coolant rows of kAlarmRules: threshold, rate of rise, stale
+    static AlarmRules rules(nullptr, nullptr, 30000);
+    rules.add({ 0, AlarmKind::ABOVE, AlarmGate::ALWAYS,  95.0f, 105.0f, 2.0f, NAN,   0 },     0);
+    rules.add({ 0, AlarmKind::RISE,  AlarmGate::RUNNING, 2.0f,  5.0f,   1.0f, 88.0f, 60000 }, 0);
+    rules.add({ 0, AlarmKind::STALE, AlarmGate::RUNNING, 10.0f, NAN,    0.0f, NAN,   0 },     0);
+    rules.setRunning(true, 0);
+    uint32_t t = 0;
+    auto& r = bench("AlarmRules::sample (3 rules)", [&] {
+        t += 200;
+        rules.sample(0, 85.0f + (t / 200 % 200) * 0.1f, t);   // saw tooth 85–105 °C
+    });
+    sSink = rules.state(0).transitions;
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+static void bench_n2k_senders() {
+    tN2kMsg msg;
+    double  rpm = 800.0;
+    auto& rapid = bench("N2kSenders::buildEngineRapidUpdate", [&] {
+        rpm = rpm > 3000.0 ? 800.0 : rpm + 1.0;
+        N2kSenders::buildEngineRapidUpdate(msg, 0, rpm);
+        sSink = msg.DataLen;
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rapid.allocsPerOp);
+
+    auto& dyn = bench("N2kSenders::buildEngineDynamic", [&] {
+        N2kSenders::buildEngineDynamic(msg, 0, 353.15, 4'000'000.0, 2.4, false, false);
+        sSink = msg.DataLen;
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, dyn.allocsPerOp);
+
+    auto& temp = bench("N2kSenders::buildTemperatureExtended", [&] {
+        N2kSenders::buildTemperatureExtended(msg, 0, 3, N2kts_EngineRoomTemperature, 310.0);
+        sSink = msg.DataLen;
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, temp.allocsPerOp);
+}
+
+static void bench_onewire_registry() {
+    OneWireRegistry reg;
+    std::vector<OneWireRom> roms;
+    for (uint8_t i = 0; i < 32; i++) {
+        OneWireRom rom = { 0x28, i, static_cast<uint8_t>(i * 37), 0x11, 0x22, 0x33, 0x44, 0x00 };
+        roms.push_back(rom);
+        reg.add(rom, 0);
+    }
+    size_t k = 0;
+    auto& r = bench("OneWireRegistry::find (32 probes)", [&] {
+        sSink = reg.find(roms[k++ & 31]);
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+// One block of edges at 1500 RPM with firing pulses, then the FFT
+static void bench_rev_analyzer() {
+    static RevAnalyzer a(400.0f);
+    static uint32_t    edges[RevAnalyzer::kBlock];
+    uint32_t t = 0;
+    auto& r = bench("RevAnalyzer::feed+analyze (256)", [&] {
+        for (int i = 0; i < RevAnalyzer::kBlock; i++) {
+            t += 4000 + ((i % 10) < 5 ? 80 : -80);
+            edges[i] = t;
+        }
+        a.feed(edges, RevAnalyzer::kBlock);
+        sSink = a.analyze(10.0f) ? a.result().roughness : 0.0f;
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocsPerOp);
+}
+
+// Not a tick path: reported for trend only, no allocation assertion
+static void bench_flash_journal() {
+    class RamFlash : public JournalFlash {
+    public:
+        size_t sectorSize()  const override { return 4096; }
+        size_t sectorCount() const override { return 16; }
+        bool read(size_t addr, void* dst, size_t len) override {
+            memcpy(dst, mem + addr, len);
+            return true;
+        }
+        bool write(size_t addr, const void* src, size_t len) override {
+            memcpy(mem + addr, src, len);
+            return true;
+        }
+        bool erase(size_t sector) override {
+            memset(mem + sector * 4096, 0xFF, 4096);
+            return true;
+        }
+        uint8_t mem[16 * 4096];
+    };
+
+    static RamFlash flash;
+    memset(flash.mem, 0xFF, sizeof(flash.mem));
+    uint8_t      payload[44] = {};
+    FlashJournal j(flash, sizeof(payload));
+    j.recover(payload);
+    bench("FlashJournal::append (RAM flash)", [&] {
+        payload[0]++;
+        sSink = j.append(payload);
+    });
+}
+
+// One MQTT publish interval (10 samples) as a CBOR batch against the
+// Signal K deltas for the same samples.  The deltas are printed with
+// snprintf, cheaper than building them in a JsonDocument, so the
+// ratio is a lower bound.
+static void bench_telemetry_batch() {
+    static const TelemetryBatch::Column cols[] = {
+        { "rpm", 1 }, { "coolC", 10 }, { "tankPct", 10 },
+        { "fuelLph", 100 }, { "engH", 100 }, { "flags", 1 },
+    };
+    static TelemetryBatch b(cols, 6);
+    for (int i = 0; i < 10; i++) {
+        float v[6] = { 1500.0f + i, 82.0f + i * 0.1f, 62.0f, 7.6f, 1250.0f, 0x19 };
+        b.add(i * 1000, v);
+    }
+    static uint8_t buf[1024];
+    auto& cbor = bench("TelemetryBatch::encode (10 rows)", [&] {
+        CompactEncoder e(buf, sizeof(buf), CompactFormat::CBOR);
+        b.encode(e, 1728043200000LL, 0);
+        sSink = e.size();
+    });
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, cbor.allocsPerOp);
+
+    static char json[1024];
+    auto& sk = bench("Signal K deltas (10 samples)", [&] {
+        size_t total = 0;
+        for (int i = 0; i < 10; i++) {
+            size_t n = snprintf(json, sizeof(json),
+                                "{\"updates\":[{\"source\":{\"label\":\"halmet\"},"
+                                "\"timestamp\":\"2024-10-04T12:00:%02d.000Z\",\"values\":[", i);
+            n += snprintf(json + n, sizeof(json) - n,
+                          "{\"path\":\"propulsion.main.revolutions\",\"value\":%.10g},"
+                          "{\"path\":\"propulsion.main.temperature\",\"value\":%.10g},"
+                          "{\"path\":\"tanks.fuel.0.currentLevel\",\"value\":%.10g},"
+                          "{\"path\":\"propulsion.main.fuel.rate\",\"value\":%.10g},"
+                          "{\"path\":\"propulsion.main.runTime\",\"value\":%.10g},"
+                          "{\"path\":\"propulsion.main.state\",\"value\":\"started\"}]}]}",
+                          (1500 + i) / 60.0, 355.15 + i * 0.1, 0.62, 2.1e-6, 4500000.0 + i);
+            total += n;
+        }
+        sSink = total;
+    });
+    printf("  batch %.0f ns vs deltas %.0f ns (%.1fx)\n", cbor.nsPerOp, sk.nsPerOp,
+           sk.nsPerOp / cbor.nsPerOp);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(bench_rpm_sensor);
+    RUN_TEST(bench_coolant_curve);
+    RUN_TEST(bench_strapping_table);
+    RUN_TEST(bench_bilge_fan);
+    RUN_TEST(bench_alarm_integrator);
+    RUN_TEST(bench_alarm_rules);
+    RUN_TEST(bench_n2k_senders);
+    RUN_TEST(bench_onewire_registry);
+    RUN_TEST(bench_rev_analyzer);
+    RUN_TEST(bench_flash_journal);
+    RUN_TEST(bench_telemetry_batch);
+    writeJson();
+    return UNITY_END();
+}
@@ -0,0 +1,115 @@
+// ============================================================
+//  test_bilge_fan — purge state machine and relay guarantees
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "BilgeFan.h"
+
+static constexpr uint8_t kRelay = 32;
+static constexpr float   kPurgeS = 5.0f;    // 5 ticks of INTERVAL_FAN_MS (1 s)
+
+void setUp()    { shim::reset(); }
+void tearDown() {}
+
+static void test_begin_forces_relay_off() {
+    shim::pinLevels[kRelay] = HIGH;
+    BilgeFan fan(kRelay, true);
+    fan.begin();
+    TEST_ASSERT_EQUAL_INT(OUTPUT, shim::pinModes[kRelay]);
+    TEST_ASSERT_FALSE(fan.relayOn());
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[kRelay]);
+    TEST_ASSERT_TRUE(fan.state() == FanState::IDLE);
+}
+
+static void test_begin_drives_active_low_relay_off() {
+    // GPIO reset level is LOW = energised for an active-low module
+    BilgeFan fan(kRelay, false);
+    fan.begin();
+    TEST_ASSERT_EQUAL_INT(HIGH, shim::pinLevels[kRelay]);
+}
+
+static void test_relay_off_while_running() {
+    BilgeFan fan(kRelay, true);
+    fan.begin();
+    for (int i = 0; i < 10; i++) fan.update(true, kPurgeS);
+    TEST_ASSERT_TRUE(fan.state() == FanState::RUNNING);
+    TEST_ASSERT_FALSE(fan.relayOn());
+}
+
+static void test_purge_after_stop_then_idle() {
+    BilgeFan fan(kRelay, true);
+    fan.begin();
+    fan.update(true,  kPurgeS);              // → RUNNING
+    fan.update(false, kPurgeS);              // → PURGE (timer loaded)
+    TEST_ASSERT_TRUE(fan.state() == FanState::PURGE);
+    for (int i = 0; i < 4; i++) {
+        fan.update(false, kPurgeS);
+        TEST_ASSERT_TRUE(fan.relayOn());
+        TEST_ASSERT_EQUAL_INT(HIGH, shim::pinLevels[kRelay]);
+    }
+    fan.update(false, kPurgeS);              // timer expires
+    TEST_ASSERT_FALSE(fan.relayOn());
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[kRelay]);
+    TEST_ASSERT_TRUE(fan.state() == FanState::IDLE);
+}
+
+static void test_restart_during_purge_cuts_relay() {
+    BilgeFan fan(kRelay, true);
+    fan.begin();
+    fan.update(true,  kPurgeS);
+    fan.update(false, kPurgeS);
+    fan.update(false, kPurgeS);
+    TEST_ASSERT_TRUE(fan.relayOn());
+    fan.update(true,  kPurgeS);
+    TEST_ASSERT_FALSE(fan.relayOn());
+    TEST_ASSERT_TRUE(fan.state() == FanState::RUNNING);
+}
+
+static void test_manual_on_latches_until_force_off() {
+    BilgeFan fan(kRelay, true);
+    fan.begin();
+    fan.manualOn();
+    for (int i = 0; i < 3; i++) fan.update(true, kPurgeS);
+    TEST_ASSERT_TRUE(fan.relayOn());
+    fan.forceOff();
+    TEST_ASSERT_FALSE(fan.relayOn());
+    TEST_ASSERT_TRUE(fan.state() == FanState::IDLE);
+}
+
+static void test_active_low_inverts_pin() {
+    BilgeFan fan(kRelay, false);
+    fan.begin();
+    fan.manualOn();
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[kRelay]);
+    fan.forceOff();
+    TEST_ASSERT_EQUAL_INT(HIGH, shim::pinLevels[kRelay]);
+}
+
+static void test_callback_only_on_change() {
+    BilgeFan fan(kRelay, true);
+    int calls = 0;
+    fan.onRelayChange([&calls](bool) { calls++; });
+    fan.begin();
+    uint32_t writes = shim::digitalWrites;
+    for (int i = 0; i < 5; i++) fan.update(true, kPurgeS);
+    TEST_ASSERT_EQUAL_INT(0, calls);
+    TEST_ASSERT_EQUAL_UINT32(writes, shim::digitalWrites);
+    fan.manualOn();
+    fan.manualOn();
+    TEST_ASSERT_EQUAL_INT(1, calls);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_forces_relay_off);
+    RUN_TEST(test_begin_drives_active_low_relay_off);
+    RUN_TEST(test_relay_off_while_running);
+    RUN_TEST(test_purge_after_stop_then_idle);
+    RUN_TEST(test_restart_during_purge_cuts_relay);
+    RUN_TEST(test_manual_on_latches_until_force_off);
+    RUN_TEST(test_active_low_inverts_pin);
+    RUN_TEST(test_callback_only_on_change);
+    return UNITY_END();
+}
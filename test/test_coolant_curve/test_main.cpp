@@ -0,0 +1,62 @@
+// ============================================================
+//  test_coolant_curve — A1 voltage → °C interpolation and faults
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "CoolantCurve.h"
+#include "halmet_config.h"
+
+using CoolantCurve::voltageToCelsius;
+
+void setUp()    {}
+void tearDown() {}
+
+struct Knot { float v; float c; };
+static const Knot kKnots[] = { TEMP_CURVE_POINTS };
+
+static void test_knots_exact() {
+    for (const auto& k : kKnots) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, k.c, voltageToCelsius(k.v));
+    }
+}
+
+static void test_interpolates_between_knots() {
+    // Midpoint of the first segment
+    float v = (kKnots[0].v + kKnots[1].v) / 2.0f;
+    float c = (kKnots[0].c + kKnots[1].c) / 2.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, c, voltageToCelsius(v));
+}
+
+static void test_clamps_inside_valid_range() {
+    constexpr int n = sizeof(kKnots) / sizeof(Knot);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, kKnots[0].c,     voltageToCelsius(COOLANT_VOLT_MAX_V));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, kKnots[n - 1].c, voltageToCelsius(COOLANT_VOLT_MIN_V));
+}
+
+static void test_open_or_shorted_sender_is_nan() {
+    TEST_ASSERT_TRUE(std::isnan(voltageToCelsius(COOLANT_VOLT_MIN_V - 0.01f)));
+    TEST_ASSERT_TRUE(std::isnan(voltageToCelsius(COOLANT_VOLT_MAX_V + 0.01f)));
+    TEST_ASSERT_TRUE(std::isnan(voltageToCelsius(0.0f)));
+}
+
+static void test_monotonic_decreasing() {
+    float prev = voltageToCelsius(COOLANT_VOLT_MIN_V);
+    for (float v = COOLANT_VOLT_MIN_V + 0.01f; v <= COOLANT_VOLT_MAX_V; v += 0.01f) {
+        float c = voltageToCelsius(v);
+        TEST_ASSERT_FALSE(std::isnan(c));
+        TEST_ASSERT_TRUE(c <= prev + 1e-4f);
+        prev = c;
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_knots_exact);
+    RUN_TEST(test_interpolates_between_knots);
+    RUN_TEST(test_clamps_inside_valid_range);
+    RUN_TEST(test_open_or_shorted_sender_is_nan);
+    RUN_TEST(test_monotonic_decreasing);
+    return UNITY_END();
+}
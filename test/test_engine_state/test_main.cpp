@@ -0,0 +1,114 @@
+// ============================================================
+//  test_engine_state — Sampled fields, staleness, change cursors
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "engine_state.h"
+
+void setUp() {}
+void tearDown() {}
+
+static constexpr double kNA = -1e9;   // N2kDoubleNA
+
+// ----------------------------------------------------------
+static void test_set_stamps_sample_and_counts_changes() {
+    EngineState st;
+    TEST_ASSERT_TRUE(st.set(st.rpm, 800.0f, 100));
+    TEST_ASSERT_EQUAL_UINT32(1, st.seq);
+    TEST_ASSERT_EQUAL_UINT32(100, st.rpm.sampleMs);
+
+    // Same value: a new sample, not a change
+    TEST_ASSERT_FALSE(st.set(st.rpm, 800.0f, 200));
+    TEST_ASSERT_EQUAL_UINT32(1, st.seq);
+    TEST_ASSERT_EQUAL_UINT32(200, st.rpm.sampleMs);
+
+    TEST_ASSERT_TRUE(st.set(st.coolantAlertState, CoolantAlertState::WARN, 200));
+    TEST_ASSERT_EQUAL_UINT32(2, st.seq);
+    TEST_ASSERT_EQUAL_UINT32(2, st.changeSeq[static_cast<uint8_t>(EngineField::COOLANT_ALERT)]);
+}
+
+static void test_set_converts_value_type() {
+    EngineState st;
+    st.set(st.coolantK, 80.5f + 273.15f, 10);            // float into a double field
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, 353.65, st.coolantK.value);
+    st.set(st.engineSeconds, uint32_t(3600), 10);        // journal seconds
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, 3600.0, st.engineSeconds.value);
+}
+
+static void test_never_sampled_is_stale() {
+    EngineState st;
+    TEST_ASSERT_FALSE(st.fresh(st.tankLevelPct, 0));
+    TEST_ASSERT_FALSE(st.fresh(st.tankLevelPct, 1000));
+    TEST_ASSERT_DOUBLE_WITHIN(0.001, kNA, st.freshOr(st.coolantK, kNA, 1000));
+}
+
+static void test_every_field_goes_stale() {
+    EngineState st;
+    st.set(st.coolantK, 350.0, 1000);
+    st.set(st.tankLevelPct, 42.0f, 1000);
+    st.set(st.engineSeconds, 7200.0, 1000);
+    uint32_t edge = 1000 + STALE_DATA_TIMEOUT_MS;
+    TEST_ASSERT_DOUBLE_WITHIN(0.001, 350.0, st.freshOr(st.coolantK, kNA, edge));
+    TEST_ASSERT_EQUAL_FLOAT(42.0f, st.freshOr(st.tankLevelPct, -1.0f, edge));
+    TEST_ASSERT_DOUBLE_WITHIN(0.001, kNA, st.freshOr(st.coolantK, kNA, edge + 1));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, st.freshOr(st.tankLevelPct, -1.0f, edge + 1));
+    TEST_ASSERT_DOUBLE_WITHIN(0.001, kNA, st.freshOr(st.engineSeconds, kNA, edge + 1));
+
+    // An unchanged re-sample keeps it fresh
+    st.set(st.tankLevelPct, 42.0f, edge);
+    TEST_ASSERT_TRUE(st.fresh(st.tankLevelPct, edge + STALE_DATA_TIMEOUT_MS));
+}
+
+static void test_freshness_across_millis_wrap() {
+    EngineState st;
+    uint32_t t0 = 0xFFFFFF00u;
+    st.set(st.rpm, 1500.0f, t0);
+    TEST_ASSERT_TRUE(st.fresh(st.rpm, t0 + STALE_DATA_TIMEOUT_MS));
+    TEST_ASSERT_FALSE(st.fresh(st.rpm, t0 + STALE_DATA_TIMEOUT_MS + 1));
+}
+
+static void test_cursors_are_independent() {
+    EngineState st;
+    uint32_t a = 0, b = 0;
+    st.set(st.oilAlarm, true, 10);
+    st.set(st.rpm, 900.0f, 10);
+    TEST_ASSERT_EQUAL_UINT32(fieldBit(EngineField::OIL_ALARM) | fieldBit(EngineField::RPM),
+                             st.takeChanges(a));
+    TEST_ASSERT_EQUAL_UINT32(0, st.takeChanges(a));
+
+    st.set(st.rpm, 950.0f, 20);
+    st.set(st.oilAlarm, true, 20);                      // unchanged
+    TEST_ASSERT_EQUAL_UINT32(fieldBit(EngineField::RPM), st.takeChanges(a));
+    // b never looked: sees both, once
+    TEST_ASSERT_EQUAL_UINT32(fieldBit(EngineField::OIL_ALARM) | fieldBit(EngineField::RPM),
+                             st.takeChanges(b));
+    TEST_ASSERT_EQUAL_UINT32(0, st.takeChanges(b));
+}
+
+static void test_changed_since_wraps() {
+    EngineState st;
+    st.seq = 0xFFFFFFFEu;
+    uint32_t cursor = st.seq;
+    st.set(st.tempAlarm, true, 1);      // seq FFFFFFFF
+    st.set(st.engineRunning, true, 1);  // seq 0
+    st.set(st.coolantK, 300.0, 1);      // seq 1
+    uint32_t expect = fieldBit(EngineField::TEMP_ALARM) | fieldBit(EngineField::RUNNING) |
+                      fieldBit(EngineField::COOLANT);
+    // Crossing zero may also report the never-changed fields, once
+    TEST_ASSERT_EQUAL_UINT32(expect, st.changedSince(cursor) & expect);
+    TEST_ASSERT_EQUAL_UINT32(fieldBit(EngineField::COOLANT), st.changedSince(0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_set_stamps_sample_and_counts_changes);
+    RUN_TEST(test_set_converts_value_type);
+    RUN_TEST(test_never_sampled_is_stale);
+    RUN_TEST(test_every_field_goes_stale);
+    RUN_TEST(test_freshness_across_millis_wrap);
+    RUN_TEST(test_cursors_are_independent);
+    RUN_TEST(test_changed_since_wraps);
+    return UNITY_END();
+}
@@ -0,0 +1,131 @@
+// ============================================================
+//  test_flash_journal — append / recover / wear levelling
+//  (years of use and power cuts: tools/journal_wear_sim.cpp)
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cstring>
+#include <vector>
+
+#include "FlashJournal.h"
+
+class RamFlash : public JournalFlash {
+public:
+    RamFlash(size_t sectors, size_t sectorSize)
+        : _sectorSize(sectorSize), mem(sectors * sectorSize, 0xFF), erases(sectors, 0) {}
+
+    size_t sectorSize()  const override { return _sectorSize; }
+    size_t sectorCount() const override { return erases.size(); }
+    bool read(size_t addr, void* dst, size_t len) override {
+        memcpy(dst, &mem[addr], len);
+        return true;
+    }
+    bool write(size_t addr, const void* src, size_t len) override {
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < len; i++) mem[addr + i] &= s[i];
+        return true;
+    }
+    bool erase(size_t sector) override {
+        memset(&mem[sector * _sectorSize], 0xFF, _sectorSize);
+        erases[sector]++;
+        return true;
+    }
+
+    size_t                _sectorSize;
+    std::vector<uint8_t>  mem;
+    std::vector<uint32_t> erases;
+};
+
+struct Payload {
+    uint32_t a;
+    uint32_t b;
+};
+
+void setUp()    {}
+void tearDown() {}
+
+static void test_empty_area_recovers_nothing() {
+    RamFlash     flash(4, 256);
+    FlashJournal j(flash, sizeof(Payload));
+    Payload p;
+    TEST_ASSERT_FALSE(j.recover(&p));
+    TEST_ASSERT_EQUAL_UINT32(0, j.corruptSlots());
+}
+
+static void test_round_trip_newest_wins() {
+    RamFlash flash(4, 256);
+    {
+        FlashJournal j(flash, sizeof(Payload));
+        Payload p;
+        j.recover(&p);
+        for (uint32_t i = 1; i <= 10; i++) {
+            p = { i, i * 2 };
+            TEST_ASSERT_TRUE(j.append(&p));
+        }
+    }
+    FlashJournal j(flash, sizeof(Payload));
+    Payload p = {};
+    TEST_ASSERT_TRUE(j.recover(&p));
+    TEST_ASSERT_EQUAL_UINT32(10, p.a);
+    TEST_ASSERT_EQUAL_UINT32(20, p.b);
+    TEST_ASSERT_EQUAL_UINT32(10, j.seq());
+}
+
+static void test_ring_wears_sectors_evenly() {
+    RamFlash     flash(4, 256);
+    FlashJournal j(flash, sizeof(Payload));
+    Payload p = {};
+    j.recover(&p);
+    size_t perSector = 256 / j.slotSize();
+    for (size_t i = 0; i < perSector * 4 * 25; i++) {
+        p.a = static_cast<uint32_t>(i);
+        TEST_ASSERT_TRUE(j.append(&p));
+    }
+    for (uint32_t e : flash.erases) TEST_ASSERT_EQUAL_UINT32(25, e);
+}
+
+static void test_torn_write_falls_back_to_previous() {
+    RamFlash flash(4, 256);
+    size_t   slot;
+    {
+        FlashJournal j(flash, sizeof(Payload));
+        Payload p = { 1, 1 };
+        j.recover(&p);
+        j.append(&p);
+        p = { 2, 2 };
+        j.append(&p);
+        slot = j.slotSize();
+    }
+    // Corrupt the second record's payload as an interrupted write would
+    flash.mem[slot + 8] = 0x00;
+    FlashJournal j(flash, sizeof(Payload));
+    Payload p = {};
+    TEST_ASSERT_TRUE(j.recover(&p));
+    TEST_ASSERT_EQUAL_UINT32(1, p.a);
+    TEST_ASSERT_EQUAL_UINT32(1, j.corruptSlots());
+    // Next append skips the torn slot and becomes the newest
+    p = { 3, 3 };
+    TEST_ASSERT_TRUE(j.append(&p));
+    FlashJournal k(flash, sizeof(Payload));
+    TEST_ASSERT_TRUE(k.recover(&p));
+    TEST_ASSERT_EQUAL_UINT32(3, p.a);
+}
+
+static void test_append_requires_recover() {
+    RamFlash     flash(4, 256);
+    FlashJournal j(flash, sizeof(Payload));
+    Payload p = {};
+    TEST_ASSERT_FALSE(j.append(&p));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_area_recovers_nothing);
+    RUN_TEST(test_round_trip_newest_wins);
+    RUN_TEST(test_ring_wears_sectors_evenly);
+    RUN_TEST(test_torn_write_falls_back_to_previous);
+    RUN_TEST(test_append_requires_recover);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+// ============================================================
+//  test_latency — Data-age histogram, bus time from PGN 126992
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cmath>
+
+#include "BusTime.h"
+#include "LatencyHistogram.h"
+
+void setUp() {}
+void tearDown() {}
+
+static constexpr uint16_t kDay      = 20000;                 // 2024-10-04
+static constexpr int64_t  kDayUtcMs = 20000LL * 86400000LL;
+
+// ----------------------------------------------------------
+static void test_histogram_buckets() {
+    TEST_ASSERT_EQUAL(0, LatencyHistogram::bucketOf(0));
+    TEST_ASSERT_EQUAL(1, LatencyHistogram::bucketOf(1));
+    TEST_ASSERT_EQUAL(2, LatencyHistogram::bucketOf(2));
+    TEST_ASSERT_EQUAL(2, LatencyHistogram::bucketOf(3));
+    TEST_ASSERT_EQUAL(8, LatencyHistogram::bucketOf(250));            // [128, 256)
+    TEST_ASSERT_EQUAL(LatencyHistogram::kBuckets - 1, LatencyHistogram::bucketOf(UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT32(128, LatencyHistogram::bucketLowMs(8));
+
+    LatencyHistogram h;
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileMs(0.5f));
+    h.record(250);
+    h.record(300);
+    h.record(1200);
+    TEST_ASSERT_EQUAL_UINT32(3, h.count());
+    TEST_ASSERT_EQUAL_UINT32(1, h.bucket(8));
+    TEST_ASSERT_EQUAL_UINT32(1, h.bucket(9));
+    TEST_ASSERT_EQUAL_UINT32(1, h.bucket(11));
+    TEST_ASSERT_EQUAL_UINT32(583, h.meanMs());
+    TEST_ASSERT_EQUAL_UINT32(1200, h.maxMs());
+    TEST_ASSERT_EQUAL_UINT32(1200, h.lastMs());
+}
+
+static void test_histogram_percentiles() {
+    // A 1 s publisher reading a 200 ms sampler: ages spread 0–1200 ms
+    LatencyHistogram h;
+    for (uint32_t i = 0; i < 1000; i++) h.record(100 + (i * 7919) % 1100);
+    uint32_t p50 = h.percentileMs(0.50f);
+    uint32_t p95 = h.percentileMs(0.95f);
+    uint32_t p99 = h.percentileMs(0.99f);
+    printf("p50 %u  p95 %u  p99 %u  max %u ms\n", p50, p95, p99, h.maxMs());
+    // Within the factor-of-two bucket of the true value, and ordered
+    TEST_ASSERT_TRUE(p50 >= 512 && p50 < 1024);          // true 650
+    TEST_ASSERT_TRUE(p95 >= 1024 && p95 <= h.maxMs());   // true 1145
+    TEST_ASSERT_TRUE(p50 <= p95 && p95 <= p99);
+    TEST_ASSERT_TRUE(p99 <= h.maxMs());
+
+    // A single constant age reads back exactly
+    LatencyHistogram c;
+    for (int i = 0; i < 100; i++) c.record(250);
+    TEST_ASSERT_UINT32_WITHIN(130, 250, c.percentileMs(0.5f));
+    TEST_ASSERT_EQUAL_UINT32(250, c.percentileMs(1.0f));
+}
+
+static void test_bus_time_sets_and_converts() {
+    BusTime bt(10000, 2000);
+    TEST_ASSERT_FALSE(bt.synced(0));
+    TEST_ASSERT_EQUAL_INT64(-1, bt.utcMs(1234));
+
+    // 12:00:00.000 UTC received at uptime 60 s
+    TEST_ASSERT_TRUE(bt.update(kDay, 43200.0, 12, 60000));
+    TEST_ASSERT_TRUE(bt.synced(60000));
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43200000LL, bt.utcMs(60000));
+    // A sample acquired 250 ms before, and one 5 s later
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43199750LL, bt.utcMs(59750));
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43205000LL, bt.utcMs(65000));
+
+    // No System Time for validMs: not synced, still extrapolates
+    TEST_ASSERT_FALSE(bt.synced(70001));
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43210001LL, bt.utcMs(70001));
+
+    // Fields not available (no fix) are ignored
+    TEST_ASSERT_FALSE(bt.update(0xFFFF, 43300.0, 12, 160000));
+    TEST_ASSERT_FALSE(bt.update(kDay, -1e9, 12, 160000));
+    TEST_ASSERT_EQUAL_UINT32(1, bt.updates());
+}
+
+static void test_bus_time_slews_jitter_and_steps_jumps() {
+    BusTime bt(10000, 2000);
+    bt.update(kDay, 43200.0, 12, 60000);
+
+    // 1 Hz readings arriving 0–40 ms late: the clock stays within a
+    // few ms of true instead of following each reading
+    uint32_t rx = 60000;
+    for (int i = 1; i <= 60; i++) {
+        rx = 60000 + i * 1000 + (i * 37) % 41;
+        bt.update(kDay, 43200.0 + i, 12, rx);
+    }
+    int64_t truth = kDayUtcMs + 43200000LL + (rx - 60000);
+    int64_t err   = bt.utcMs(rx) - truth;
+    TEST_ASSERT_TRUE(err > -45 && err < 5);
+    TEST_ASSERT_EQUAL_UINT32(0, bt.steps());
+
+    // The chartplotter gets a fix 1 h later than it thought: step
+    bt.update(kDay, 43200.0 + 61 + 3600, 12, rx + 1000);
+    TEST_ASSERT_EQUAL_UINT32(1, bt.steps());
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + (43200LL + 61 + 3600) * 1000, bt.utcMs(rx + 1000));
+}
+
+static void test_bus_time_follows_one_sender() {
+    BusTime bt(10000, 2000);
+    bt.update(kDay, 43200.0, 12, 60000);
+    // A second source 3 s off is ignored while the first is current
+    TEST_ASSERT_FALSE(bt.update(kDay, 43204.0, 40, 61000));
+    TEST_ASSERT_EQUAL_UINT32(1, bt.ignored());
+    TEST_ASSERT_EQUAL(12, bt.source());
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43201000LL, bt.utcMs(61000));
+
+    // … and taken over once the first has gone quiet
+    TEST_ASSERT_TRUE(bt.update(kDay, 43275.0, 40, 135000));
+    TEST_ASSERT_EQUAL(40, bt.source());
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43275000LL, bt.utcMs(135000));
+    TEST_ASSERT_EQUAL_UINT32(0, bt.steps());
+}
+
+static void test_bus_time_across_millis_wrap() {
+    BusTime  bt(10000, 2000);
+    uint32_t rx = UINT32_MAX - 500;
+    bt.update(kDay, 43200.0, 12, rx);
+    // 1 s later millis() has wrapped; the conversion has not
+    TEST_ASSERT_EQUAL_INT64(kDayUtcMs + 43201000LL, bt.utcMs(rx + 1000));
+    TEST_ASSERT_TRUE(bt.update(kDay, 43201.0, 12, rx + 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, bt.steps());
+    TEST_ASSERT_TRUE(bt.synced(rx + 1500));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_histogram_percentiles);
+    RUN_TEST(test_bus_time_sets_and_converts);
+    RUN_TEST(test_bus_time_slews_jitter_and_steps_jumps);
+    RUN_TEST(test_bus_time_follows_one_sender);
+    RUN_TEST(test_bus_time_across_millis_wrap);
+    return UNITY_END();
+}
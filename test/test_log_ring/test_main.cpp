@@ -0,0 +1,185 @@
+// ============================================================
+//  test_log_ring — Deferred log ring, formatting, wire frames
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "LogRing.h"
+#include "dlog.h"
+#include "log_formats.h"
+
+void setUp() {}
+void tearDown() {}
+
+static LogRecord rec(uint16_t fmt, std::initializer_list<uint32_t> args, uint32_t ms = 0) {
+    LogRecord r = {};
+    r.ms  = ms;
+    r.fmt = fmt;
+    for (uint32_t a : args) r.args[r.nargs++] = a;
+    return r;
+}
+
+// CRC-16/CCITT-FALSE, written out again as tools/log_decode.py does
+static uint16_t crc16(const uint8_t* d, size_t n) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= static_cast<uint16_t>(d[i]) << 8;
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+// ----------------------------------------------------------
+static void test_fifo_and_counters() {
+    static LogRing ring;
+    LogRecord out;
+    TEST_ASSERT_FALSE(ring.pop(out));
+    for (uint32_t i = 0; i < 10; i++) TEST_ASSERT_TRUE(ring.push(rec(1, {i}, 100 + i)));
+    for (uint32_t i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(ring.pop(out));
+        TEST_ASSERT_EQUAL_UINT32(100 + i, out.ms);
+        TEST_ASSERT_EQUAL_UINT32(i, out.args[0]);
+    }
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_EQUAL_UINT32(10, ring.pushed());
+    TEST_ASSERT_EQUAL_UINT32(10, ring.popped());
+    TEST_ASSERT_EQUAL_UINT32(10, ring.maxDepth());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+}
+
+static void test_full_ring_drops_newest() {
+    static LogRing ring;
+    LogRecord out;
+    // Many laps, so slot sequence numbers wrap past the capacity
+    for (int lap = 0; lap < 20; lap++) {
+        for (uint32_t i = 0; i < LogRing::kCapacity + 5; i++) ring.push(rec(2, {i}));
+        for (uint32_t i = 0; i < LogRing::kCapacity; i++) {
+            TEST_ASSERT_TRUE(ring.pop(out));
+            TEST_ASSERT_EQUAL_UINT32(i, out.args[0]);   // oldest kept, newest dropped
+        }
+        TEST_ASSERT_FALSE(ring.pop(out));
+    }
+    TEST_ASSERT_EQUAL_UINT32(20 * 5, ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(20 * LogRing::kCapacity, ring.pushed());
+}
+
+static void test_concurrent_producers() {
+    // Four producers (tasks on both cores, an ISR) against one drain
+    static LogRing    ring;
+    constexpr int     kProducers = 4;
+    constexpr uint32_t kEach     = 50000;
+    std::atomic<bool> done{false};
+    std::vector<uint32_t> next(kProducers, 0);
+    uint32_t received = 0;
+    bool     ordered  = true;
+
+    std::thread consumer([&] {
+        LogRecord r;
+        for (;;) {
+            bool finished = done.load();
+            while (ring.pop(r)) {
+                // Per producer, records arrive in order, each at most once
+                if (r.args[1] < next[r.args[0]]) ordered = false;
+                next[r.args[0]] = r.args[1] + 1;
+                received++;
+            }
+            if (finished) break;
+        }
+    });
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; p++) {
+        producers.emplace_back([p] {
+            for (uint32_t i = 0; i < kEach; i++) {
+                ring.push(rec(3, {p, i}));
+                if (i % 64 == 63) std::this_thread::yield();   // let the drain run
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    done = true;
+    consumer.join();
+
+    printf("%u received, %u dropped, max depth %u\n", received, ring.dropped(), ring.maxDepth());
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(kProducers * kEach, received + ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(received, ring.pushed());
+    TEST_ASSERT_TRUE(received > LogRing::kCapacity);
+}
+
+static void test_format_conversions() {
+    char out[96];
+    formatLogRecord("bank=%u sw0=%d", rec(0, {0, static_cast<uint32_t>(-1)}), out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("bank=0 sw0=-1", out);
+    formatLogRecord("at 0x%02X, %B/%B, 100%%", rec(0, {0x48, 1, 0}), out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("at 0x48, ON/OFF, 100%", out);
+    formatLogRecord("%.1f h, %lu starts", rec(0, {toLogArg(123.46f), 7}), out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("123.5 h, 7 starts", out);
+    formatLogRecord("%5d|%-3u|", rec(0, {42, 7}), out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("   42|7  |", out);
+    // Missing arguments and a short buffer
+    formatLogRecord("a=%d b=%d", rec(0, {1}), out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("a=1 b=?", out);
+    TEST_ASSERT_EQUAL(4, formatLogRecord("abcdefgh", rec(0, {}), out, 5));
+    TEST_ASSERT_EQUAL_STRING("abcd", out);
+}
+
+static void test_format_table() {
+    for (int i = 0; i < static_cast<int>(LogFmt::COUNT); i++) {
+        const LogFormat& f = kLogFormats[i];
+        TEST_ASSERT_EQUAL(i, static_cast<int>(f.id));   // table in enum order
+        TEST_ASSERT_TRUE(f.level == 'E' || f.level == 'W' || f.level == 'I');
+        TEST_ASSERT_NOT_NULL(f.tag);
+        int convs = 0;
+        for (const char* p = f.fmt; *p; p++) {
+            if (*p != '%') continue;
+            if (p[1] == '%') { p++; continue; }
+            TEST_ASSERT_TRUE(p[1] != 's');   // strings cannot be deferred
+            convs++;
+        }
+        TEST_ASSERT_TRUE(convs <= kLogMaxArgs);
+    }
+}
+
+static void test_frame_encoding() {
+    LogRecord r = rec(static_cast<uint16_t>(LogFmt::SWITCH_BANK_CONTROL), {0, 1}, 123456);
+    uint8_t   f[kLogFrameSize];
+    encodeLogFrame(r, f);
+    TEST_ASSERT_EQUAL(29, kLogFrameSize);
+    TEST_ASSERT_EQUAL_HEX8(kLogSync0, f[0]);
+    TEST_ASSERT_EQUAL_HEX8(kLogSync1, f[1]);
+    TEST_ASSERT_EQUAL(kLogFrameVersion, f[2]);
+    LogRecord back;
+    std::memcpy(&back, f + 3, sizeof(back));
+    TEST_ASSERT_EQUAL_UINT32(123456, back.ms);
+    TEST_ASSERT_EQUAL(2, back.nargs);
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16(reinterpret_cast<const uint8_t*>("123456789"), 9));
+    TEST_ASSERT_EQUAL_HEX16(crc16(f, kLogFrameSize - 2), f[27] | (f[28] << 8));
+}
+
+static void test_dlog_queues_until_drained() {
+    shim::reset(5'000'000);
+    uint32_t before = dlog::ring().pushed();
+    TEST_ASSERT_TRUE(dlog::log(LogFmt::RELAY_CHANGE, true));
+    TEST_ASSERT_TRUE(dlog::log(LogFmt::SWITCH_BANK_CONTROL, 0u, -1));
+    TEST_ASSERT_EQUAL_UINT32(before + 2, dlog::ring().pushed());
+    TEST_ASSERT_EQUAL(2, dlog::drain(16));
+    TEST_ASSERT_EQUAL(0, dlog::drain(16));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_and_counters);
+    RUN_TEST(test_full_ring_drops_newest);
+    RUN_TEST(test_concurrent_producers);
+    RUN_TEST(test_format_conversions);
+    RUN_TEST(test_format_table);
+    RUN_TEST(test_frame_encoding);
+    RUN_TEST(test_dlog_queues_until_drained);
+    return UNITY_END();
+}
@@ -0,0 +1,469 @@
+// ============================================================
+//  test_mqtt_export — CBOR/MessagePack batches, bounded queue,
+//  the exporter against the shim broker
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mqtt_client.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "CompactEncoder.h"
+#include "OneWireRegistry.h"
+#include "PayloadQueue.h"
+#include "TelemetryBatch.h"
+#include "mqtt_export.h"
+#include "onewire_setup.h"
+
+using namespace sensesp;
+
+void setUp() {}
+void tearDown() {}
+
+static bool bytesEqual(const uint8_t* expected, size_t n, const CompactEncoder& e) {
+    if (e.size() != n) {
+        printf("size %u, expected %u\n", (unsigned)e.size(), (unsigned)n);
+        return false;
+    }
+    return memcmp(expected, e.data(), n) == 0;
+}
+
+// ----------------------------------------------------------
+static void test_cbor_encoding() {
+    // RFC 8949 Appendix A examples
+    uint8_t buf[64];
+    CompactEncoder e(buf, sizeof(buf), CompactFormat::CBOR);
+    e.putUint(0);
+    e.putUint(23);
+    e.putUint(24);
+    e.putUint(1000);
+    e.putUint(1000000);
+    e.putUint(1000000000000ULL);
+    e.putInt(-1);
+    e.putInt(-1000);
+    e.putFloat(100000.0f);
+    e.putBool(false);
+    e.putNull();
+    e.putStr("IETF");
+    const uint8_t expected[] = {
+        0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xE8, 0x1A, 0x00, 0x0F, 0x42, 0x40,
+        0x1B, 0x00, 0x00, 0x00, 0xE8, 0xD4, 0xA5, 0x10, 0x00,
+        0x20, 0x39, 0x03, 0xE7, 0xFA, 0x47, 0xC3, 0x50, 0x00,
+        0xF4, 0xF6, 0x64, 'I', 'E', 'T', 'F',
+    };
+    TEST_ASSERT_TRUE(bytesEqual(expected, sizeof(expected), e));
+
+    // {"a": 1, "b": [2, 3]}
+    CompactEncoder m(buf, sizeof(buf), CompactFormat::CBOR);
+    m.beginMap(2);
+    m.putStr("a");
+    m.putUint(1);
+    m.putStr("b");
+    m.beginArray(2);
+    m.putUint(2);
+    m.putUint(3);
+    const uint8_t map[] = { 0xA2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03 };
+    TEST_ASSERT_TRUE(bytesEqual(map, sizeof(map), m));
+}
+
+static void test_msgpack_encoding() {
+    uint8_t buf[64];
+    CompactEncoder e(buf, sizeof(buf), CompactFormat::MSGPACK);
+    e.putUint(127);
+    e.putUint(128);
+    e.putUint(1000);
+    e.putUint(100000);
+    e.putInt(-1);
+    e.putInt(-33);
+    e.putInt(-1000);
+    e.putFloat(1.5f);
+    e.putBool(true);
+    e.putNull();
+    e.putStr("abc");
+    const uint8_t expected[] = {
+        0x7F, 0xCC, 0x80, 0xCD, 0x03, 0xE8, 0xCE, 0x00, 0x01, 0x86, 0xA0,
+        0xFF, 0xD0, 0xDF, 0xD1, 0xFC, 0x18, 0xCA, 0x3F, 0xC0, 0x00, 0x00,
+        0xC3, 0xC0, 0xA3, 'a', 'b', 'c',
+    };
+    TEST_ASSERT_TRUE(bytesEqual(expected, sizeof(expected), e));
+
+    // Same document as the CBOR map above
+    CompactEncoder m(buf, sizeof(buf), CompactFormat::MSGPACK);
+    m.beginMap(2);
+    m.putStr("a");
+    m.putUint(1);
+    m.putStr("b");
+    m.beginArray(2);
+    m.putUint(2);
+    m.putUint(3);
+    const uint8_t map[] = { 0x82, 0xA1, 0x61, 0x01, 0xA1, 0x62, 0x92, 0x02, 0x03 };
+    TEST_ASSERT_TRUE(bytesEqual(map, sizeof(map), m));
+}
+
+static void test_encoder_scaled_and_overflow() {
+    uint8_t buf[8];
+    CompactEncoder e(buf, sizeof(buf), CompactFormat::CBOR);
+    e.putScaled(82.46f, 10.0f);     // 825
+    e.putScaled(-0.04f, 10.0f);     // 0
+    e.putScaled(NAN, 10.0f);        // null
+    e.putScaled(INFINITY, 1.0f);    // null
+    const uint8_t expected[] = { 0x19, 0x03, 0x39, 0x00, 0xF6, 0xF6 };
+    TEST_ASSERT_TRUE(bytesEqual(expected, sizeof(expected), e));
+    TEST_ASSERT_FALSE(e.overflowed());
+
+    e.putStr("toolong");
+    TEST_ASSERT_TRUE(e.overflowed());
+    TEST_ASSERT_TRUE(e.size() <= sizeof(buf));
+}
+
+static void test_payload_queue() {
+    alignas(4) static uint8_t buf[3 * 10];
+    PayloadQueue q(buf, 3, 10);
+    TEST_ASSERT_EQUAL_UINT32(8, q.maxPayload());
+    size_t len = 0;
+    TEST_ASSERT_TRUE(q.front(len) == nullptr);
+
+    const uint8_t a[] = { 1 }, b[] = { 2, 2 }, c[] = { 3, 3, 3 }, d[] = { 4, 4, 4, 4 };
+    uint8_t big[9] = {};
+    TEST_ASSERT_TRUE(q.push(a, sizeof(a)));
+    TEST_ASSERT_TRUE(q.push(b, sizeof(b)));
+    TEST_ASSERT_TRUE(q.push(c, sizeof(c)));
+    TEST_ASSERT_FALSE(q.push(big, sizeof(big)));      // never fits
+    TEST_ASSERT_EQUAL_UINT32(1, q.rejected());
+    TEST_ASSERT_TRUE(q.push(d, sizeof(d)));           // evicts a
+    TEST_ASSERT_EQUAL_UINT32(1, q.dropped());
+    TEST_ASSERT_EQUAL_UINT32(3, q.depth());
+    TEST_ASSERT_EQUAL_UINT32(3, q.maxDepth());
+
+    const uint8_t* p = q.front(len);
+    TEST_ASSERT_EQUAL_UINT32(2, len);
+    TEST_ASSERT_EQUAL_UINT8(2, p[0]);
+    q.pop();
+    p = q.front(len);
+    TEST_ASSERT_EQUAL_UINT32(3, len);
+    q.pop();
+    p = q.front(len);
+    TEST_ASSERT_EQUAL_UINT32(4, len);
+    TEST_ASSERT_EQUAL_UINT8(4, p[3]);
+    q.pop();
+    q.pop();                                           // empty: no-op
+    TEST_ASSERT_EQUAL_UINT32(0, q.depth());
+    TEST_ASSERT_EQUAL_UINT32(4, q.pushed());
+}
+
+static void test_batch_layout() {
+    static const TelemetryBatch::Column cols[] = { { "a", 10.0f } };
+    TelemetryBatch b(cols, 1);
+    float v1 = 1.5f, v2 = NAN;
+    TEST_ASSERT_TRUE(b.add(1000, &v1));
+    TEST_ASSERT_TRUE(b.add(1500, &v2));
+    TEST_ASSERT_EQUAL(2, b.count());
+
+    uint8_t        buf[64];
+    CompactEncoder e(buf, sizeof(buf), CompactFormat::CBOR);
+    b.encode(e, -1, 0);
+    // {"v":1, "t0":1000, "utc":null, "f":["a"], "s":[10.0], "r":[[0,15],[500,null]]}
+    const uint8_t expected[] = {
+        0xA6,
+        0x61, 'v', 0x01,
+        0x62, 't', '0', 0x19, 0x03, 0xE8,
+        0x63, 'u', 't', 'c', 0xF6,
+        0x61, 'f', 0x81, 0x61, 'a',
+        0x61, 's', 0x81, 0xFA, 0x41, 0x20, 0x00, 0x00,
+        0x61, 'r', 0x82, 0x82, 0x00, 0x0F, 0x82, 0x19, 0x01, 0xF4, 0xF6,
+    };
+    TEST_ASSERT_TRUE(bytesEqual(expected, sizeof(expected), e));
+
+    for (int i = 2; i < TelemetryBatch::kMaxRecords; i++) TEST_ASSERT_TRUE(b.add(1000 + i, &v1));
+    TEST_ASSERT_TRUE(b.full());
+    TEST_ASSERT_FALSE(b.add(5000, &v1));
+    b.clear();
+    TEST_ASSERT_EQUAL(0, b.count());
+}
+
+// ----------------------------------------------------------
+//  Size against the Signal K deltas carrying the same samples
+// ----------------------------------------------------------
+// One delta per sample, as a Signal K server forwards them
+static size_t skDeltaBytes(int i) {
+    struct { const char* path; double value; } values[] = {
+        { "propulsion.main.revolutions", (1500 + i) / 60.0 },
+        { "propulsion.main.temperature", 355.15 + i * 0.1 },
+        { "tanks.fuel.0.currentLevel", 0.62 },
+        { "propulsion.main.fuel.rate", 2.1e-6 + i * 1e-9 },
+        { "propulsion.main.runTime", 4500000.0 + i },
+        { "propulsion.main.state", 1 },
+        { "environment.inside.engineRoom.temperature", 308.15 },
+        { "propulsion.main.exhaustTemperature", 330.15 },
+    };
+    char   buf[1024];
+    size_t n = snprintf(buf, sizeof(buf),
+                        "{\"context\":\"vessels.urn:mrn:signalk:uuid:c0d79334-4e25-4245-8892-54e8ccc8021d\","
+                        "\"updates\":[{\"source\":{\"label\":\"halmet\"},"
+                        "\"timestamp\":\"2024-10-04T12:00:%02d.000Z\",\"values\":[", i % 60);
+    for (size_t k = 0; k < sizeof(values) / sizeof(values[0]); k++) {
+        n += snprintf(buf + n, sizeof(buf) - n, "%s{\"path\":\"%s\",\"value\":%.10g}",
+                      k ? "," : "", values[k].path, values[k].value);
+    }
+    n += snprintf(buf + n, sizeof(buf) - n, "]}]}");
+    return n;
+}
+
+static void test_size_against_signalk() {
+    static const TelemetryBatch::Column cols[] = {
+        { "rpm", 1 }, { "coolC", 10 }, { "tankPct", 10 },
+        { "fuelLph", 100 }, { "engH", 100 }, { "flags", 1 },
+    };
+    TelemetryBatch b(cols, 6);
+    const int kRows = MQTT_PUBLISH_MS / MQTT_SAMPLE_MS;
+    size_t    skBytes = 0;
+    for (int i = 0; i < kRows; i++) {
+        float v[6] = { 1500.0f + i, 82.0f + i * 0.1f, 62.0f, 7.6f, 1250.0f, 0x19 };
+        b.add(1000 + i * MQTT_SAMPLE_MS, v);
+        skBytes += skDeltaBytes(i);
+    }
+
+    for (CompactFormat fmt : { CompactFormat::CBOR, CompactFormat::MSGPACK }) {
+        static uint8_t buf[MQTT_PAYLOAD_MAX];
+        CompactEncoder e(buf, sizeof(buf), fmt);
+        b.encode(e, 1728043200000LL, 1);
+        e.putStr("ow");
+        e.beginArray(2);
+        e.beginArray(2);
+        e.putUint(0);
+        e.putScaled(35.0f, 10);
+        e.beginArray(2);
+        e.putUint(1);
+        e.putScaled(57.0f, 10);
+        TEST_ASSERT_FALSE(e.overflowed());
+        printf("%d samples: %s %u bytes, Signal K deltas %u bytes (%.1fx)\n", kRows,
+               fmt == CompactFormat::CBOR ? "CBOR" : "MessagePack", (unsigned)e.size(),
+               (unsigned)skBytes, static_cast<double>(skBytes) / e.size());
+        TEST_ASSERT_TRUE(e.size() * 10 < skBytes);
+    }
+}
+
+// ----------------------------------------------------------
+//  The exporter against the in-memory broker
+// ----------------------------------------------------------
+static EngineState     sState;
+static OneWireRegistry sOneWire;
+static PersistingObservableValue<String> sUri("", "/mqtt/broker_uri");
+static PersistingObservableValue<int>    sQos(DEFAULT_MQTT_QOS, "/mqtt/qos");
+static PersistingObservableValue<bool>   sMsgpack(false, "/mqtt/msgpack");
+static ObservableValue<float>            sProbe(308.15f);
+static ObservableValue<float>            sOutside(291.15f);
+static ObservableValue<float>            sLostProbe(300.15f);
+
+static void runSeconds(uint32_t s) { event_loop()->runFor(s * 1000000ULL); }
+
+// A sweep every intervalMs, stamped mid-conversion as DsThermBatch does
+static void sweepEvery(uint32_t intervalMs, size_t entry) {
+    event_loop()->onRepeat(intervalMs, [entry]() {
+        sOneWire[entry].sampleMs = millis() - 375;
+    });
+}
+
+// Value of probe `instance` in a CBOR batch's "ow" array: false when
+// absent, otherwise isNull / tenthsC set
+static bool owEntry(const shim::MqttMessage& m, uint8_t instance, bool& isNull, int& tenthsC) {
+    static const uint8_t key[] = { 0x62, 'o', 'w' };
+    const uint8_t* p   = m.payload.data();
+    const uint8_t* end = p + m.payload.size();
+    const uint8_t* k   = std::search(p, end, key, key + sizeof(key));
+    if (k == end) return false;
+    p = k + sizeof(key);
+    int n = *p++ & 0x1F;                             // array(n), n < 24
+    for (int i = 0; i < n; i++) {
+        uint8_t inst = p[1];                         // array(2), small uint
+        uint8_t b    = p[2];
+        int     len  = (b & 0x1F) < 24 ? 0 : 1 << ((b & 0x1F) - 24);
+        if (inst == instance) {
+            isNull  = b == 0xF6;
+            tenthsC = 0;
+            for (int j = 0; j < len; j++) tenthsC = (tenthsC << 8) | p[3 + j];
+            if (len == 0) tenthsC = b & 0x1F;
+            return true;
+        }
+        p += 3 + (b == 0xF6 ? 0 : len);
+    }
+    return false;
+}
+
+static void test_exporter_queue_and_broker() {
+    sOneWire.add({ 0x28, 1, 2, 3, 4, 5, 6, 0 }, 0);
+    sOneWire[0].dest     = 1;
+    sOneWire[0].instance = 3;
+    sOneWire[0].value    = &sProbe;
+
+    // Sensors keep the state fresh
+    event_loop()->onRepeat(500, []() {
+        uint32_t now = millis();
+        sState.set(sState.rpm, 1500.0f, now);
+        sState.set(sState.coolantK, 355.15, now);
+        sState.set(sState.engineSeconds, 4500000.0, now);
+    });
+    sweepEvery(kTempDests[1].intervalMs, 0);
+
+    mqtt_export::init({
+        .state      = &sState,
+        .owRegistry = &sOneWire,
+        .brokerUri  = &sUri,
+        .qos        = &sQos,
+        .msgpack    = &sMsgpack,
+    });
+    const PayloadQueue& q = mqtt_export::queue();
+
+    // Off until a broker is configured
+    runSeconds(30);
+    TEST_ASSERT_FALSE(shim::mqtt.exists);
+    TEST_ASSERT_EQUAL_UINT32(0, q.pushed());
+
+    sUri.set("mqtt://127.0.0.1:1883");
+    runSeconds(1);
+    TEST_ASSERT_TRUE(shim::mqtt.started);
+    TEST_ASSERT_EQUAL_STRING("mqtt://127.0.0.1:1883", shim::mqtt.uri.c_str());
+    TEST_ASSERT_EQUAL_STRING(MQTT_CLIENT_ID, shim::mqtt.clientId.c_str());
+
+    // Broker unreachable: batches queue, the oldest are dropped
+    runSeconds(90);
+    TEST_ASSERT_FALSE(mqtt_export::connected());
+    TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SLOTS, q.depth());
+    TEST_ASSERT_TRUE(q.dropped() >= 2);
+    TEST_ASSERT_EQUAL_UINT32(0, shim::mqtt.outbox.size());
+
+    // Connected but never acknowledging: the client's outbox stays bounded
+    shim::mqtt.connect();
+    runSeconds(300);
+    TEST_ASSERT_TRUE(mqtt_export::connected());
+    printf("outbox %d bytes in %u messages, %u queued\n", esp_mqtt_client_get_outbox_size(nullptr),
+           (unsigned)shim::mqtt.outbox.size(), (unsigned)q.depth());
+    TEST_ASSERT_TRUE(esp_mqtt_client_get_outbox_size(nullptr) <= MQTT_OUTBOX_MAX_BYTES + MQTT_PAYLOAD_MAX);
+    TEST_ASSERT_TRUE(q.depth() > 0);
+
+    // Acks arrive: everything drains to the broker in order
+    uint32_t dropped = q.dropped();
+    for (int i = 0; i < 5; i++) {
+        shim::mqtt.flush();
+        event_loop()->runFor(MQTT_PUMP_MS * 1000ULL);
+    }
+    shim::mqtt.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, q.depth());
+    TEST_ASSERT_EQUAL_UINT32(dropped, q.dropped());
+    TEST_ASSERT_EQUAL_UINT32(q.pushed() - q.dropped(), shim::mqtt.delivered.size());
+
+    const shim::MqttMessage& m = shim::mqtt.delivered.back();
+    TEST_ASSERT_EQUAL_STRING(MQTT_TOPIC, m.topic.c_str());
+    TEST_ASSERT_EQUAL(DEFAULT_MQTT_QOS, m.qos);
+    TEST_ASSERT_EQUAL_HEX8(0xA8, m.payload[0]);   // CBOR map: 6 batch keys + ow + d
+    TEST_ASSERT_EQUAL_HEX8(0x61, m.payload[1]);
+    TEST_ASSERT_EQUAL_HEX8('v', m.payload[2]);
+    TEST_ASSERT_EQUAL_HEX8(TelemetryBatch::kVersion, m.payload[3]);
+
+    // MessagePack and QoS 0 take effect on the next batch
+    sMsgpack.set(true);
+    sQos.set(0);
+    runSeconds(MQTT_PUBLISH_MS / 1000);
+    shim::mqtt.flush();
+    const shim::MqttMessage& mp = shim::mqtt.delivered.back();
+    TEST_ASSERT_EQUAL_HEX8(0x88, mp.payload[0]);  // fixmap of 8
+    TEST_ASSERT_EQUAL(0, mp.qos);
+
+    // Diagnostics
+    runSeconds(INTERVAL_DIAG_MS / 1000);
+    auto* sk = SKOutputRawJson::find("design.halmet.diagnostics.mqtt");
+    TEST_ASSERT_NOT_NULL(sk);
+    TEST_ASSERT_TRUE(sk->sets() > 0);
+
+    // Clearing the URI stops the client
+    sUri.set("");
+    runSeconds(1);
+    TEST_ASSERT_FALSE(shim::mqtt.exists);
+}
+
+// Probes are fresh for ONEWIRE_STALE_INTERVALS of their own read
+// interval, as for PGN 130316 — not STALE_DATA_TIMEOUT_MS
+static void test_exporter_onewire_staleness() {
+    sOneWire.add({ 0x28, 7, 7, 7, 7, 7, 7, 0 }, 0);   // outside air, read every 30 s
+    sOneWire[1].dest     = 4;
+    sOneWire[1].instance = 5;
+    sOneWire[1].value    = &sOutside;
+    sweepEvery(kTempDests[4].intervalMs, 1);
+    sOneWire.add({ 0x28, 9, 9, 9, 9, 9, 9, 0 }, 0);   // engine room probe that stops answering
+    sOneWire[2].dest     = 1;
+    sOneWire[2].instance = 6;
+    sOneWire[2].value    = &sLostProbe;
+    sOneWire[2].sampleMs = millis();
+
+    sMsgpack.set(false);
+    sUri.set("mqtt://127.0.0.1:1883");
+    runSeconds(1);
+    shim::mqtt.connect();
+    runSeconds(35);                                    // the 30 s probe has been read
+    shim::mqtt.flush();
+    size_t first = shim::mqtt.delivered.size();
+
+    runSeconds(120);
+    shim::mqtt.flush();
+    TEST_ASSERT_TRUE(shim::mqtt.delivered.size() - first >= 10);
+    for (size_t i = first; i < shim::mqtt.delivered.size(); i++) {
+        bool isNull = true;
+        int  tenths = 0;
+        TEST_ASSERT_TRUE(owEntry(shim::mqtt.delivered[i], 3, isNull, tenths));
+        TEST_ASSERT_FALSE(isNull);
+        TEST_ASSERT_EQUAL(350, tenths);
+        TEST_ASSERT_TRUE(owEntry(shim::mqtt.delivered[i], 5, isNull, tenths));
+        TEST_ASSERT_FALSE(isNull);
+        TEST_ASSERT_EQUAL(180, tenths);
+    }
+
+    // The probe that stopped is null after three of its read intervals
+    bool isNull = false;
+    int  tenths = 0;
+    TEST_ASSERT_TRUE(owEntry(shim::mqtt.delivered.back(), 6, isNull, tenths));
+    TEST_ASSERT_TRUE(isNull);
+
+    sUri.set("");
+    runSeconds(1);
+}
+
+// A URI the client rejects is tried once, not on every pump, until
+// a new one is saved
+static void test_exporter_bad_uri_not_retried() {
+    int inits = shim::mqtt.inits;
+    sUri.set("127.0.0.1:1883");
+    runSeconds(10);
+    TEST_ASSERT_EQUAL(inits + 1, shim::mqtt.inits);
+    TEST_ASSERT_FALSE(shim::mqtt.exists);
+
+    sUri.set("mqtt://127.0.0.1:1883");
+    runSeconds(1);
+    TEST_ASSERT_EQUAL(inits + 2, shim::mqtt.inits);
+    TEST_ASSERT_TRUE(shim::mqtt.started);
+
+    sUri.set("");
+    runSeconds(1);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cbor_encoding);
+    RUN_TEST(test_msgpack_encoding);
+    RUN_TEST(test_encoder_scaled_and_overflow);
+    RUN_TEST(test_payload_queue);
+    RUN_TEST(test_batch_layout);
+    RUN_TEST(test_size_against_signalk);
+    RUN_TEST(test_exporter_queue_and_broker);
+    RUN_TEST(test_exporter_onewire_staleness);
+    RUN_TEST(test_exporter_bad_uri_not_retried);
+    return UNITY_END();
+}
@@ -0,0 +1,131 @@
+// ============================================================
+//  test_n2k_senders — PGN encoders round-tripped through the
+//  NMEA2000 library's own parsers
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "N2kSenders.h"
+
+void setUp()    {}
+void tearDown() {}
+
+static void test_engine_rapid_update() {
+    tN2kMsg msg;
+    N2kSenders::buildEngineRapidUpdate(msg, 0, 1523.25);
+    TEST_ASSERT_EQUAL_UINT32(127488UL, msg.PGN);
+
+    unsigned char instance;
+    double rpm, boost;
+    int8_t trim;
+    TEST_ASSERT_TRUE(ParseN2kEngineParamRapid(msg, instance, rpm, boost, trim));
+    TEST_ASSERT_EQUAL_UINT8(0, instance);
+    TEST_ASSERT_DOUBLE_WITHIN(0.25, 1523.25, rpm);    // 0.25 RPM resolution
+    TEST_ASSERT_TRUE(N2kIsNA(boost));
+}
+
+static void test_engine_dynamic_fields_and_status() {
+    tN2kMsg msg;
+    N2kSenders::buildEngineDynamic(msg, 0, 358.15, 1234.0 * 3600.0, 2.4, true, false);
+    TEST_ASSERT_EQUAL_UINT32(127489UL, msg.PGN);
+
+    unsigned char instance;
+    double oilP, oilT, coolant, altV, fuelRate, hours, coolP, fuelP;
+    int8_t load, torque;
+    tN2kEngineDiscreteStatus1 s1;
+    tN2kEngineDiscreteStatus2 s2;
+    TEST_ASSERT_TRUE(ParseN2kEngineDynamicParam(msg, instance, oilP, oilT, coolant, altV,
+                                                fuelRate, hours, coolP, fuelP, load, torque,
+                                                s1, s2));
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, 358.15, coolant);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0, 1234.0 * 3600.0, hours);
+    TEST_ASSERT_DOUBLE_WITHIN(0.1, 2.4, fuelRate);     // 0.1 L/h resolution
+    TEST_ASSERT_TRUE(N2kIsNA(oilP));
+    TEST_ASSERT_EQUAL_UINT8(1, s1.Bits.LowOilPressure);
+    TEST_ASSERT_EQUAL_UINT8(0, s1.Bits.OverTemperature);
+    TEST_ASSERT_EQUAL_UINT8(1, s1.Bits.CheckEngine);
+}
+
+static void test_engine_dynamic_hours_not_available() {
+    tN2kMsg msg;
+    N2kSenders::buildEngineDynamic(msg, 0, N2kDoubleNA, N2kDoubleNA, N2kDoubleNA, false, false);
+
+    unsigned char instance;
+    double oilP, oilT, coolant, altV, fuelRate, hours, coolP, fuelP;
+    int8_t load, torque;
+    tN2kEngineDiscreteStatus1 s1;
+    tN2kEngineDiscreteStatus2 s2;
+    ParseN2kEngineDynamicParam(msg, instance, oilP, oilT, coolant, altV,
+                               fuelRate, hours, coolP, fuelP, load, torque, s1, s2);
+    TEST_ASSERT_TRUE(N2kIsNA(coolant));
+    TEST_ASSERT_TRUE(N2kIsNA(hours));
+    TEST_ASSERT_TRUE(N2kIsNA(fuelRate));
+    TEST_ASSERT_EQUAL_UINT8(0, s1.Bits.CheckEngine);
+}
+
+static void test_binary_status_switch_one() {
+    tN2kMsg msg;
+    N2kSenders::buildBinaryStatus(msg, 0, true);
+    TEST_ASSERT_EQUAL_UINT32(127501UL, msg.PGN);
+
+    unsigned char bank;
+    tN2kBinaryStatus status;
+    TEST_ASSERT_TRUE(ParseN2kBinaryStatus(msg, bank, status));
+    TEST_ASSERT_TRUE(N2kGetStatusOnBinaryStatus(status, 1) == N2kOnOff_On);
+
+    N2kSenders::buildBinaryStatus(msg, 0, false);
+    ParseN2kBinaryStatus(msg, bank, status);
+    TEST_ASSERT_TRUE(N2kGetStatusOnBinaryStatus(status, 1) == N2kOnOff_Off);
+}
+
+static void test_fluid_level() {
+    tN2kMsg msg;
+    N2kSenders::buildFluidLevel(msg, 0, N2kft_Fuel, 42.5, 100.0);
+    TEST_ASSERT_EQUAL_UINT32(127505UL, msg.PGN);
+
+    unsigned char instance;
+    tN2kFluidType type;
+    double level, capacity;
+    TEST_ASSERT_TRUE(ParseN2kFluidLevel(msg, instance, type, level, capacity));
+    TEST_ASSERT_TRUE(type == N2kft_Fuel);
+    TEST_ASSERT_DOUBLE_WITHIN(0.01, 42.5, level);
+    TEST_ASSERT_DOUBLE_WITHIN(0.1, 100.0, capacity);
+}
+
+static void test_temperature_extended() {
+    tN2kMsg msg;
+    N2kSenders::buildTemperatureExtended(msg, 42, 7, N2kts_EngineRoomTemperature, 318.15);
+    TEST_ASSERT_EQUAL_UINT32(130316UL, msg.PGN);
+
+    unsigned char sid, instance;
+    tN2kTempSource source;
+    double actual, set;
+    TEST_ASSERT_TRUE(ParseN2kTemperatureExt(msg, sid, instance, source, actual, set));
+    TEST_ASSERT_EQUAL_UINT8(42, sid);
+    TEST_ASSERT_EQUAL_UINT8(7, instance);
+    TEST_ASSERT_TRUE(source == N2kts_EngineRoomTemperature);
+    TEST_ASSERT_DOUBLE_WITHIN(0.001, 318.15, actual);
+    TEST_ASSERT_TRUE(N2kIsNA(set));
+}
+
+static void test_sid_from_acquisition_time() {
+    // One sweep's readings share a SID; the next slot gets the next one
+    TEST_ASSERT_EQUAL_UINT8(N2kSenders::sidFor(10000, 250), N2kSenders::sidFor(10249, 250));
+    TEST_ASSERT_EQUAL_UINT8(N2kSenders::sidFor(10000, 250) + 1, N2kSenders::sidFor(10250, 250));
+    // Never a reserved value (253–255)
+    for (uint32_t t = 0; t < 300 * 250; t += 250) TEST_ASSERT_TRUE(N2kSenders::sidFor(t, 250) <= 252);
+    TEST_ASSERT_EQUAL_UINT8(0, N2kSenders::sidFor(253 * 250, 250));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_engine_rapid_update);
+    RUN_TEST(test_engine_dynamic_fields_and_status);
+    RUN_TEST(test_engine_dynamic_hours_not_available);
+    RUN_TEST(test_binary_status_switch_one);
+    RUN_TEST(test_fluid_level);
+    RUN_TEST(test_temperature_extended);
+    RUN_TEST(test_sid_from_acquisition_time);
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+// ============================================================
+//  test_ota_unpacker — Compressed OTA image decoding & checks
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cstring>
+#include <vector>
+
+#include "OtaUnpacker.h"
+
+void setUp() {}
+void tearDown() {}
+
+// ----------------------------------------------------------
+//  Reference LZSS encoder (same format as tools/ota_pack.py,
+//  greedy, exhaustive window search — fine for test sizes)
+// ----------------------------------------------------------
+static std::vector<uint8_t> lzss(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out;
+    size_t flagsAt = 0;
+    int    bit     = 8;
+    for (size_t i = 0; i < in.size();) {
+        if (bit == 8) {
+            flagsAt = out.size();
+            out.push_back(0);
+            bit = 0;
+        }
+        size_t bestLen = 0, bestDist = 0;
+        size_t limit = std::min<size_t>(18, in.size() - i);
+        for (size_t d = 1; d <= std::min<size_t>(4096, i); d++) {
+            size_t l = 0;
+            while (l < limit && in[i - d + l] == in[i + l]) l++;
+            if (l > bestLen) {
+                bestLen  = l;
+                bestDist = d;
+            }
+        }
+        if (bestLen >= 3) {
+            out.push_back((bestDist - 1) & 0xFF);
+            out.push_back(((bestDist - 1) >> 8) | ((bestLen - 3) << 4));
+            i += bestLen;
+        } else {
+            out[flagsAt] |= 1 << bit;
+            out.push_back(in[i++]);
+        }
+        bit++;
+    }
+    return out;
+}
+
+static uint32_t crc32(const std::vector<uint8_t>& d) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (uint8_t b : d) {
+        crc ^= b;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static std::vector<uint8_t> pack(const std::vector<uint8_t>& image, OtaAlgo algo) {
+    std::vector<uint8_t> payload = algo == OtaAlgo::LZSS ? lzss(image) : image;
+    OtaImageHeader h = {};
+    h.magic      = kOtaImageMagic;
+    h.version    = kOtaImageVersion;
+    h.algo       = static_cast<uint8_t>(algo);
+    h.windowBits = algo == OtaAlgo::LZSS ? 12 : 0;
+    h.imageLen   = image.size();
+    h.payloadLen = payload.size();
+    h.payloadCrc = crc32(payload);
+    std::vector<uint8_t> out(sizeof(h));
+    memcpy(out.data(), &h, sizeof(h));
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+// Code-like bytes: runs of pseudo-random "instructions" with
+// repeated sequences near and far (up to and past the window)
+static std::vector<uint8_t> firmwareLike(size_t len) {
+    std::vector<uint8_t> v;
+    uint32_t x = 0x12345678;
+    auto rnd = [&x]() { x ^= x << 13; x ^= x >> 17; x ^= x << 5; return x; };
+    while (v.size() < len) {
+        uint32_t r = rnd() % 4;
+        if (r == 0 && v.size() > 5000) {
+            size_t dist = (rnd() % 2) ? 4096 : 1 + rnd() % 4095;
+            size_t n    = 3 + rnd() % 40;
+            for (size_t i = 0; i < n; i++) v.push_back(v[v.size() - dist]);
+        } else if (r == 1) {
+            v.insert(v.end(), 1 + rnd() % 30, 0xFF);          // padding
+        } else {
+            for (int i = 0; i < 16; i++) v.push_back(rnd() & 0x3F);
+        }
+    }
+    v.resize(len);
+    return v;
+}
+
+struct Capture {
+    std::vector<uint8_t> out;
+    std::vector<size_t>  blocks;
+    size_t               failAfter = SIZE_MAX;
+};
+
+static bool sink(void* ctx, const uint8_t* data, size_t len) {
+    auto* c = static_cast<Capture*>(ctx);
+    if (c->out.size() + len > c->failAfter) return false;
+    c->out.insert(c->out.end(), data, data + len);
+    c->blocks.push_back(len);
+    return true;
+}
+
+static OtaStatus unpack(const std::vector<uint8_t>& body, Capture& cap, size_t chunk,
+                        uint32_t maxLen = 0x330000) {
+    OtaUnpacker u(sink, &cap, maxLen);
+    for (size_t i = 0; i < body.size(); i += chunk) {
+        OtaStatus st = u.feed(body.data() + i, std::min(chunk, body.size() - i));
+        if (st != OtaStatus::OK) return st;
+    }
+    return u.finish();
+}
+
+// ----------------------------------------------------------
+static void test_lzss_round_trip_any_chunking() {
+    auto image = firmwareLike(40000);
+    auto body  = pack(image, OtaAlgo::LZSS);
+    TEST_ASSERT_TRUE(body.size() < image.size() * 3 / 4);
+
+    for (size_t chunk : { 1, 7, 52, 1024, 1 << 20 }) {
+        Capture cap;
+        TEST_ASSERT_EQUAL_INT((int)OtaStatus::OK, (int)unpack(body, cap, chunk));
+        TEST_ASSERT_TRUE(cap.out == image);
+        // Whole 4 KB sectors to the sink, then the tail
+        for (size_t i = 0; i + 1 < cap.blocks.size(); i++) {
+            TEST_ASSERT_EQUAL_UINT32(OtaUnpacker::kWindow, cap.blocks[i]);
+        }
+        TEST_ASSERT_EQUAL_UINT32(40000 % OtaUnpacker::kWindow, cap.blocks.back());
+    }
+}
+
+static void test_stored_image() {
+    auto image = firmwareLike(10000);
+    Capture cap;
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::OK, (int)unpack(pack(image, OtaAlgo::STORED), cap, 333));
+    TEST_ASSERT_TRUE(cap.out == image);
+}
+
+// Packed by tools/ota_pack.py — keeps the two encoders honest
+static void test_decodes_python_packer_output() {
+    static const uint8_t kPacked[] = {
+        0x48, 0x4F, 0x5A, 0x31, 0x01, 0x01, 0x0C, 0x00, 0x55, 0x00, 0x00, 0x00, 0x2D,
+        0x00, 0x00, 0x00, 0x8C, 0xAD, 0xEB, 0x72, 0x9D, 0x4E, 0xDC, 0x74, 0x87, 0x0E,
+        0xCF, 0x3A, 0x14, 0x47, 0xEC, 0x0B, 0xB5, 0x98, 0x62, 0x8A, 0x48, 0xC8, 0x66,
+        0xF8, 0x25, 0xA0, 0x42, 0x58, 0x84, 0xE5, 0x38, 0x26, 0xE4, 0x78, 0xDE, 0xE6,
+        0xFF, 0x50, 0x47, 0x4E, 0x20, 0x31, 0x32, 0x37, 0x34, 0xD7, 0x38, 0x38, 0x20,
+        0x0A, 0x60, 0x39, 0x0A, 0x50, 0x35, 0x30, 0xFF, 0x35, 0x20, 0x65, 0x6E, 0x67,
+        0x69, 0x6E, 0x65, 0xF2, 0x06, 0xC0, 0x61, 0x00, 0xF0, 0x00, 0x20, 0x20, 0x48,
+        0x41, 0x4C, 0x07, 0x4D, 0x45, 0x54,
+    };
+    const char* expect = "PGN 127488 PGN 127489 PGN 127505 engine engine engine "
+                         "aaaaaaaaaaaaaaaaaaaaaaaa HALMET";
+    Capture cap;
+    OtaUnpacker u(sink, &cap, 0x330000);
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::OK, (int)u.feed(kPacked, sizeof(kPacked)));
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::OK, (int)u.finish());
+    TEST_ASSERT_EQUAL_UINT32(strlen(expect), cap.out.size());
+    TEST_ASSERT_TRUE(memcmp(cap.out.data(), expect, cap.out.size()) == 0);
+    TEST_ASSERT_EQUAL_UINT32(0x72EBAD8C, u.header().payloadCrc);
+    TEST_ASSERT_EQUAL_UINT8(0x9D, u.header().imageSha256[0]);
+}
+
+static void test_damaged_payload_fails_crc_or_stream() {
+    auto image = firmwareLike(20000);
+    auto body  = pack(image, OtaAlgo::LZSS);
+    for (size_t at : { sizeof(OtaImageHeader) + 10, body.size() / 2, body.size() - 1 }) {
+        auto bad = body;
+        bad[at] ^= 0x01;
+        Capture   cap;
+        OtaStatus st = unpack(bad, cap, 512);
+        TEST_ASSERT_TRUE(st != OtaStatus::OK);
+    }
+}
+
+static void test_truncated_body() {
+    auto body = pack(firmwareLike(20000), OtaAlgo::LZSS);
+    body.resize(body.size() - 100);
+    Capture cap;
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::TRUNCATED, (int)unpack(body, cap, 512));
+
+    Capture   cap2;
+    OtaUnpacker u(sink, &cap2, 0x330000);
+    u.feed(body.data(), 20);                              // header cut short
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::TRUNCATED, (int)u.finish());
+}
+
+static void test_header_checks() {
+    auto body = pack(firmwareLike(5000), OtaAlgo::LZSS);
+    {
+        auto bad = body;
+        bad[0] = 0xE9;                                    // a plain ESP32 .bin
+        Capture cap;
+        TEST_ASSERT_EQUAL_INT((int)OtaStatus::BAD_MAGIC, (int)unpack(bad, cap, 64));
+    }
+    {
+        auto bad = body;
+        bad[offsetof(OtaImageHeader, version)] = 2;
+        Capture cap;
+        TEST_ASSERT_EQUAL_INT((int)OtaStatus::BAD_VERSION, (int)unpack(bad, cap, 64));
+    }
+    {
+        Capture cap;
+        TEST_ASSERT_EQUAL_INT((int)OtaStatus::TOO_LARGE, (int)unpack(body, cap, 64, 4999));
+        TEST_ASSERT_TRUE(cap.out.empty());
+    }
+}
+
+static void test_reference_before_start_is_corrupt() {
+    std::vector<uint8_t> image(8, 'x');
+    auto body = pack(image, OtaAlgo::LZSS);
+    // First item becomes a back-reference with nothing behind it
+    size_t p = sizeof(OtaImageHeader);
+    body[p] &= ~1;
+    body.insert(body.begin() + p + 2, 0x00);
+    reinterpret_cast<OtaImageHeader*>(body.data())->payloadLen++;
+    reinterpret_cast<OtaImageHeader*>(body.data())->payloadCrc =
+        crc32(std::vector<uint8_t>(body.begin() + p, body.end()));
+    Capture cap;
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::CORRUPT_STREAM, (int)unpack(body, cap, 64));
+}
+
+static void test_extra_bytes_overrun() {
+    auto body = pack(firmwareLike(5000), OtaAlgo::LZSS);
+    body.push_back(0);
+    Capture cap;
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::OVERRUN, (int)unpack(body, cap, 64));
+}
+
+static void test_sink_failure_stops_stream() {
+    auto body = pack(firmwareLike(20000), OtaAlgo::LZSS);
+    Capture cap;
+    cap.failAfter = 3 * OtaUnpacker::kWindow;
+    TEST_ASSERT_EQUAL_INT((int)OtaStatus::WRITE_FAILED, (int)unpack(body, cap, 512));
+    TEST_ASSERT_EQUAL_UINT32(3 * OtaUnpacker::kWindow, cap.out.size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lzss_round_trip_any_chunking);
+    RUN_TEST(test_stored_image);
+    RUN_TEST(test_decodes_python_packer_output);
+    RUN_TEST(test_damaged_payload_fails_crc_or_stream);
+    RUN_TEST(test_truncated_body);
+    RUN_TEST(test_header_checks);
+    RUN_TEST(test_reference_before_start_is_corrupt);
+    RUN_TEST(test_extra_bytes_overrun);
+    RUN_TEST(test_sink_failure_stops_stream);
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+// ============================================================
+//  test_rev_analysis — FFT, crank-order harmonics, CPU budget
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cmath>
+#include <vector>
+
+#include "CpuBudget.h"
+#include "Fft.h"
+#include "RevAnalyzer.h"
+
+void setUp() {}
+void tearDown() {}
+
+static constexpr float kPpr = 10.0f;
+
+// Edge timestamps for an engine whose speed (RPM) is a function of
+// crank angle in revolutions; micros() rounding as on the board.
+template <typename F>
+static std::vector<uint32_t> edges(int n, F rpmAt, double startUs = 1e6) {
+    std::vector<uint32_t> out;
+    double t = startUs;
+    for (int k = 0; k < n; k++) {
+        out.push_back(static_cast<uint32_t>(std::lround(t)));
+        double mid = (k + 0.5) / kPpr;
+        t += 60.0e6 / (kPpr * rpmAt(mid));
+    }
+    return out;
+}
+
+static constexpr double kTwoPi = 2.0 * M_PI;
+
+// One block plus the edge that opens it
+static bool analyseOne(RevAnalyzer& a, const std::vector<uint32_t>& e) {
+    a.feed(e.data(), static_cast<int>(e.size()));
+    return a.analyze(kPpr);
+}
+
+// ----------------------------------------------------------
+static void test_fft_matches_dft() {
+    constexpr int N = 256;
+    std::vector<float> x(2 * N), ref(2 * N);
+    for (int i = 0; i < N; i++) {
+        x[2 * i]     = std::sin(0.37f * i) + 0.5f * std::cos(1.9f * i) + ((i * 7919) % 13) / 13.0f;
+        x[2 * i + 1] = 0.0f;
+    }
+    for (int k = 0; k < N; k++) {
+        double re = 0, im = 0;
+        for (int i = 0; i < N; i++) {
+            re += x[2 * i] * std::cos(kTwoPi * k * i / N);
+            im -= x[2 * i] * std::sin(kTwoPi * k * i / N);
+        }
+        ref[2 * k]     = static_cast<float>(re);
+        ref[2 * k + 1] = static_cast<float>(im);
+    }
+    TEST_ASSERT_TRUE(fft(x.data(), N));
+    for (int i = 0; i < 2 * N; i++) TEST_ASSERT_FLOAT_WITHIN(2e-3f, ref[i], x[i]);
+
+    float bad[6] = {};
+    TEST_ASSERT_FALSE(fft(bad, 3));
+    TEST_ASSERT_FALSE(fftReference(bad, 1));
+    TEST_ASSERT_FALSE(fft(bad, 2 * kMaxFft));
+}
+
+static void test_steady_speed_is_smooth() {
+    RevAnalyzer a(400.0f);
+    TEST_ASSERT_TRUE(analyseOne(a, edges(RevAnalyzer::kBlock + 1, [](double) { return 1500.0; })));
+    const RevAnalyzer::Result& r = a.result();
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1500.0f, r.rpm);
+    TEST_ASSERT_TRUE(r.roughness < 0.001f);
+    for (int i = 0; i < RevAnalyzer::kOrders; i++) TEST_ASSERT_TRUE(r.orderRpm[i] < 0.5f);
+}
+
+static void test_firing_pulses_at_order_one() {
+    // Two cylinders, 360° apart: one speed dip per revolution
+    RevAnalyzer a(400.0f);
+    analyseOne(a, edges(RevAnalyzer::kBlock + 1, [](double rev) {
+        return 1500.0 + 30.0 * std::sin(kTwoPi * rev);
+    }));
+    const RevAnalyzer::Result& r = a.result();
+    printf("orders 0.5–3: %.2f %.2f %.2f %.2f %.2f %.2f  roughness %.4f\n",
+           r.orderRpm[0], r.orderRpm[1], r.orderRpm[2], r.orderRpm[3],
+           r.orderRpm[4], r.orderRpm[5], r.roughness);
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 30.0f, r.orderRpm[1]);
+    TEST_ASSERT_TRUE(r.orderRpm[0] < 1.0f);
+    TEST_ASSERT_TRUE(r.orderRpm[3] < 1.5f);               // order 2: the 1/rpm nonlinearity only
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f / std::sqrt(2.0f) / 1500.0f, r.roughness);
+}
+
+static void test_weak_cylinder_at_half_order() {
+    // One cylinder down on power: every other firing pulse is weaker
+    RevAnalyzer a(400.0f);
+    analyseOne(a, edges(RevAnalyzer::kBlock + 1, [](double rev) {
+        return 900.0 + 25.0 * std::sin(kTwoPi * rev) + 12.0 * std::sin(kTwoPi * 0.5 * rev + 1.0);
+    }));
+    const RevAnalyzer::Result& r = a.result();
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 12.0f, r.orderRpm[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, 25.0f, r.orderRpm[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 900.0f, r.rpm);
+}
+
+static void test_acceleration_is_not_roughness() {
+    // 1000 → 1500 RPM within the block (~20 revolutions)
+    RevAnalyzer a(400.0f);
+    analyseOne(a, edges(RevAnalyzer::kBlock + 1, [](double rev) {
+        return 1000.0 + 25.0 * rev + 20.0 * std::sin(kTwoPi * rev);
+    }));
+    const RevAnalyzer::Result& r = a.result();
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 20.0f, r.orderRpm[1]);
+    TEST_ASSERT_TRUE(r.orderRpm[0] < 2.0f);
+}
+
+static void test_glitch_and_slow_blocks_rejected() {
+    RevAnalyzer a(400.0f);
+    // A missed edge doubles one interval
+    auto e = edges(RevAnalyzer::kBlock + 2, [](double) { return 1500.0; });
+    e.erase(e.begin() + 100);
+    TEST_ASSERT_FALSE(analyseOne(a, e));
+    TEST_ASSERT_EQUAL_UINT32(1, a.rejected());
+
+    // Cranking speed
+    TEST_ASSERT_FALSE(analyseOne(a, edges(RevAnalyzer::kBlock + 1, [](double) { return 250.0; }, 5e6)));
+    TEST_ASSERT_EQUAL_UINT32(2, a.rejected());
+    TEST_ASSERT_EQUAL_UINT32(0, a.analysed());
+}
+
+static void test_blocks_across_feeds_gaps_and_wrap() {
+    RevAnalyzer a(400.0f);
+    // Fed in 100 ms chunks as the task drains the ring, across the
+    // micros() wrap
+    auto e = edges(2 * RevAnalyzer::kBlock + 1, [](double) { return 1500.0; }, 4294967296.0 - 3e5);
+    for (size_t i = 0; i < e.size(); i += 25) {
+        a.feed(e.data() + i, static_cast<int>(std::min<size_t>(25, e.size() - i)));
+        if (a.pending()) TEST_ASSERT_TRUE(a.analyze(kPpr));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, a.analysed());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1500.0f, a.result().rpm);
+    TEST_ASSERT_EQUAL_UINT32(e.back(), a.result().endUs);
+
+    // Engine stops half-way into a block: the next block starts over
+    auto f = edges(RevAnalyzer::kBlock / 2, [](double) { return 1500.0; }, 10e6);
+    a.feed(f.data(), static_cast<int>(f.size()));
+    auto g = edges(RevAnalyzer::kBlock, [](double) { return 1500.0; }, 20e6);
+    a.feed(g.data(), static_cast<int>(g.size()));
+    TEST_ASSERT_FALSE(a.pending());   // 255 intervals since the restart
+    uint32_t one = g.back() + 4000;
+    a.feed(&one, 1);
+    TEST_ASSERT_TRUE(a.pending());
+
+    // Not analysed before the next one completes: the older is dropped
+    auto h = edges(RevAnalyzer::kBlock, [](double) { return 1500.0; }, one + 4000.0);
+    a.feed(h.data(), static_cast<int>(h.size()));
+    TEST_ASSERT_EQUAL_UINT32(1, a.dropped());
+    a.discard();
+    TEST_ASSERT_EQUAL_UINT32(2, a.dropped());
+    TEST_ASSERT_FALSE(a.analyze(kPpr));
+}
+
+static void test_cpu_budget() {
+    CpuBudget b(2, 20000);   // 2 %, 20 ms burst
+    TEST_ASSERT_TRUE(b.allow(0));
+    b.spend(25000);          // overdrawn by 5 ms: repaid after 250 ms
+    TEST_ASSERT_FALSE(b.allow(200000));
+    TEST_ASSERT_TRUE(b.allow(260000));
+
+    // One block a second costing 30 ms against a 20 ms/s budget:
+    // two of every three are analysed
+    CpuBudget c(2, 20000);
+    int done = 0;
+    for (int s = 1; s <= 300; s++) {
+        if (c.allow(s * 1000000u)) {
+            c.spend(30000);
+            done++;
+        }
+    }
+    printf("analysed %d of 300, %.2f %% CPU\n", done, c.busyUs() / 3e6);
+    TEST_ASSERT_TRUE(done >= 198 && done <= 202);
+    TEST_ASSERT_TRUE(c.busyUs() <= 300 * 20000ULL + 20000 + 30000);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fft_matches_dft);
+    RUN_TEST(test_steady_speed_is_smooth);
+    RUN_TEST(test_firing_pulses_at_order_one);
+    RUN_TEST(test_weak_cylinder_at_half_order);
+    RUN_TEST(test_acceleration_is_not_roughness);
+    RUN_TEST(test_glitch_and_slow_blocks_rejected);
+    RUN_TEST(test_blocks_across_feeds_gaps_and_wrap);
+    RUN_TEST(test_cpu_budget);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+// ============================================================
+//  test_rpm_sensor — RpmSensor counting, smoothing, stop detection
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "RpmSensor.h"
+
+static constexpr uint8_t kPin = 23;
+
+// The pulse counter is static (shared with the ISR): drain it so a
+// stray edge from the previous test does not leak into this one.
+void setUp() {
+    shim::reset(10'000'000);   // start at t = 10 s
+    RpmSensor flush(kPin);
+    flush.begin();
+    shim::advanceMs(1);
+    flush.update();
+}
+void tearDown() {}
+
+// One INTERVAL_RPM_MS tick at `rpm`: pulses spread evenly over the
+// tick, then update().
+static float tick(RpmSensor& s, float rpm, float ppr = 10.0f) {
+    int pulses = static_cast<int>(rpm * ppr / 60.0f * INTERVAL_RPM_MS / 1000.0f + 0.5f);
+    uint64_t step = INTERVAL_RPM_MS * 1000ULL / (pulses + 1);
+    for (int i = 0; i < pulses; i++) {
+        shim::advanceUs(step);
+        shim::fireInterrupt(kPin);
+    }
+    shim::advanceUs(INTERVAL_RPM_MS * 1000ULL - step * pulses);
+    return s.update();
+}
+
+static void test_attaches_falling_edge_isr() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    TEST_ASSERT_NOT_NULL(shim::isrs[kPin]);
+    TEST_ASSERT_EQUAL_INT(FALLING, shim::isrModes[kPin]);
+}
+
+static void test_no_pulses_reads_zero() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    for (int i = 0; i < 30; i++) tick(s, 0.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.getRpm());
+}
+
+static void test_steady_rate() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    for (int i = 0; i < 10; i++) tick(s, 1500.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1500.0f, s.getRpm());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1500.0f, s.getInstantRpm());
+}
+
+static void test_moving_average_window() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    for (int i = 0; i < 5; i++) tick(s, 1500.0f);
+    // One tick at 3000 → (4 × 1500 + 3000) / 5
+    float r = tick(s, 3000.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1800.0f, r);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 3000.0f, s.getInstantRpm());
+}
+
+static void test_pulses_per_rev_scales() {
+    RpmSensor s(kPin, 10.0f, 1);
+    s.begin();
+    tick(s, 1200.0f);                 // 20 pulses per tick
+    s.setPulsesPerRev(12.0f);
+    // Same 20 pulses now mean 1000 RPM
+    for (int i = 0; i < 20; i++) {
+        shim::advanceUs(4'000);
+        shim::fireInterrupt(kPin);
+    }
+    shim::advanceUs(20'000);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1000.0f, s.update());
+}
+
+static void test_stop_clears_history() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    for (int i = 0; i < 10; i++) tick(s, 1500.0f);
+    // > 2 s without an edge: stopped, buffer cleared
+    for (int i = 0; i < 21; i++) tick(s, 0.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.getRpm());
+    // First tick after restart is not diluted by stale samples
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 900.0f, tick(s, 900.0f));
+}
+
+static void test_same_millisecond_update_is_noop() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    float r = tick(s, 1500.0f);
+    shim::fireInterrupt(kPin);
+    TEST_ASSERT_EQUAL_FLOAT(r, s.update());   // dt = 0 → unchanged
+}
+
+static void test_acquired_mid_window() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    uint32_t t0 = millis();
+    tick(s, 1500.0f);
+    TEST_ASSERT_EQUAL_UINT32(t0 + INTERVAL_RPM_MS / 2, s.acquiredMs());
+    // Full window: five intervals, centred 2.5 intervals back
+    for (int i = 0; i < 9; i++) tick(s, 1500.0f);
+    TEST_ASSERT_EQUAL_UINT32(millis() - 5 * INTERVAL_RPM_MS / 2, s.acquiredMs());
+    // Stopped: the zero is current
+    for (int i = 0; i < 21; i++) tick(s, 0.0f);
+    TEST_ASSERT_EQUAL_UINT32(millis(), s.acquiredMs());
+}
+
+static void test_edge_ring() {
+    RpmSensor s(kPin, 10.0f, 5);
+    s.begin();
+    static uint32_t buf[REV_EDGE_RING];
+    uint32_t cursor = 0, lost = 0;
+    while (RpmSensor::readEdges(cursor, buf, REV_EDGE_RING, lost)) {}   // earlier tests' edges
+    lost = 0;
+
+    uint32_t first = micros() + 1000;
+    for (int i = 0; i < 3; i++) {
+        shim::advanceUs(1000);
+        shim::fireInterrupt(kPin);
+    }
+    TEST_ASSERT_EQUAL(3, RpmSensor::readEdges(cursor, buf, 8, lost));
+    TEST_ASSERT_EQUAL_UINT32(first, buf[0]);
+    TEST_ASSERT_EQUAL_UINT32(first + 2000, buf[2]);
+    TEST_ASSERT_EQUAL(0, RpmSensor::readEdges(cursor, buf, 8, lost));
+
+    // The reader falls a ring and ten edges behind: the oldest ten are lost
+    first = micros() + 1000;
+    for (int i = 0; i < REV_EDGE_RING + 10; i++) {
+        shim::advanceUs(1000);
+        shim::fireInterrupt(kPin);
+    }
+    TEST_ASSERT_EQUAL(REV_EDGE_RING, RpmSensor::readEdges(cursor, buf, REV_EDGE_RING, lost));
+    TEST_ASSERT_EQUAL_UINT32(10, lost);
+    TEST_ASSERT_EQUAL_UINT32(first + 10 * 1000, buf[0]);
+    TEST_ASSERT_EQUAL_UINT32(micros(), buf[REV_EDGE_RING - 1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_attaches_falling_edge_isr);
+    RUN_TEST(test_no_pulses_reads_zero);
+    RUN_TEST(test_steady_rate);
+    RUN_TEST(test_moving_average_window);
+    RUN_TEST(test_pulses_per_rev_scales);
+    RUN_TEST(test_stop_clears_history);
+    RUN_TEST(test_same_millisecond_update_is_noop);
+    RUN_TEST(test_acquired_mid_window);
+    RUN_TEST(test_edge_ring);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+// ============================================================
+//  test_static_arena — Setup-time arena, in-place callbacks
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "BilgeFan.h"
+#include "InplaceFunction.h"
+#include "StaticArena.h"
+#include "arena.h"
+
+void setUp() {}
+void tearDown() {}
+
+// ----------------------------------------------------------
+static void test_alignment_and_accounting() {
+    alignas(8) static uint8_t buf[64];
+    StaticArena a(buf, sizeof(buf));
+
+    a.setModule("one");
+    void* p1 = a.allocate(3, 1);
+    void* p2 = a.allocate(8, 8);                 // 5 bytes of padding first
+    TEST_ASSERT_TRUE(p1 == buf);
+    TEST_ASSERT_TRUE(p2 == buf + 8);
+    TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(p2) % 8);
+
+    TEST_ASSERT_EQUAL_STRING("one", a.setModule("two"));
+    a.allocate(4, 4);
+    TEST_ASSERT_EQUAL_UINT32(20, a.used());
+    TEST_ASSERT_EQUAL_UINT32(44, a.available());
+
+    TEST_ASSERT_EQUAL(2, a.modules());
+    const StaticArena::Module* one = a.find("one");
+    TEST_ASSERT_NOT_NULL(one);
+    TEST_ASSERT_EQUAL_UINT32(16, one->bytes);    // padding charged to the module
+    TEST_ASSERT_EQUAL_UINT32(2, one->objects);
+    TEST_ASSERT_EQUAL_UINT32(4, a.find("two")->bytes);
+    TEST_ASSERT_TRUE(a.find("three") == nullptr);
+
+    // Same name again (different pointer) maps to the same entry
+    char name[] = "one";
+    a.setModule(name);
+    a.allocate(4, 4);
+    TEST_ASSERT_EQUAL(2, a.modules());
+    TEST_ASSERT_EQUAL_UINT32(3, one->objects);
+}
+
+static void test_full_arena_fails_and_counts() {
+    alignas(8) static uint8_t buf[32];
+    StaticArena a(buf, sizeof(buf));
+    a.setModule("big");
+    TEST_ASSERT_NOT_NULL(a.allocate(24, 4));
+    TEST_ASSERT_TRUE(a.allocate(16, 4) == nullptr);
+    TEST_ASSERT_TRUE(a.allocate(SIZE_MAX, 1) == nullptr);   // no wrap-around
+    TEST_ASSERT_NOT_NULL(a.allocate(8, 8));                  // what is left still fits
+    TEST_ASSERT_TRUE(a.allocate(1, 1) == nullptr);
+
+    const StaticArena::Module* m = a.find("big");
+    TEST_ASSERT_EQUAL_UINT32(2, m->objects);
+    TEST_ASSERT_EQUAL_UINT32(3, m->failed);
+    TEST_ASSERT_EQUAL_UINT32(32, a.used());
+}
+
+static void test_seal_counts_late_allocations() {
+    alignas(8) static uint8_t buf[64];
+    StaticArena a(buf, sizeof(buf));
+    a.allocate(8, 4);                            // no module set
+    TEST_ASSERT_NOT_NULL(a.find("unassigned"));
+    a.seal();
+    TEST_ASSERT_TRUE(a.sealed());
+    TEST_ASSERT_EQUAL_UINT32(0, a.lateAllocs());
+    a.allocate(12, 4);
+    TEST_ASSERT_EQUAL_UINT32(1, a.lateAllocs());
+    TEST_ASSERT_EQUAL_UINT32(12, a.lateBytes());
+}
+
+static void test_module_table_overflow() {
+    alignas(8) static uint8_t buf[256];
+    StaticArena a(buf, sizeof(buf));
+    static char names[StaticArena::kMaxModules + 4][8];
+    for (int i = 0; i < StaticArena::kMaxModules + 4; i++) {
+        snprintf(names[i], sizeof(names[i]), "m%d", i);
+        a.setModule(names[i]);
+        a.allocate(1, 1);
+    }
+    TEST_ASSERT_EQUAL(StaticArena::kMaxModules, a.modules());
+    const StaticArena::Module* other = a.find("other");
+    TEST_ASSERT_NOT_NULL(other);
+    TEST_ASSERT_EQUAL_UINT32(5, other->objects);
+}
+
+static void test_scope_restores_module() {
+    struct Obj { double d; int n; Obj(double d_, int n_) : d(d_), n(n_) {} };
+    {
+        arena::Scope outer("testOuter");
+        {
+            arena::Scope inner("testInner");
+            Obj* o = arena::make<Obj>(2.5, 7);
+            TEST_ASSERT_EQUAL(7, o->n);
+            TEST_ASSERT_EQUAL_UINT32(0, reinterpret_cast<uintptr_t>(o) % alignof(Obj));
+        }
+        arena::make<Obj>(1.0, 1);
+        arena::make<Obj>(1.0, 2);
+    }
+    const StaticArena& a = arena::get();
+    TEST_ASSERT_EQUAL_UINT32(1, a.find("testInner")->objects);
+    TEST_ASSERT_EQUAL_UINT32(2, a.find("testOuter")->objects);
+}
+
+// ----------------------------------------------------------
+static void test_inplace_function_calls_capture() {
+    int  total = 0;
+    int* sink  = &total;
+    InplaceFunction<int(int)> f = [sink](int v) { *sink += v; return *sink; };
+    TEST_ASSERT_TRUE(static_cast<bool>(f));
+    TEST_ASSERT_EQUAL(3, f(3));
+
+    InplaceFunction<int(int)> g = f;             // copies the capture
+    TEST_ASSERT_EQUAL(7, g(4));
+    TEST_ASSERT_EQUAL(7, total);
+
+    InplaceFunction<int(int)> empty;
+    TEST_ASSERT_FALSE(static_cast<bool>(empty));
+    empty = [](int v) { return -v; };
+    TEST_ASSERT_EQUAL(-5, empty(5));
+    empty = nullptr;
+    TEST_ASSERT_FALSE(static_cast<bool>(empty));
+
+    // Plain function pointers fit too
+    InplaceFunction<int(int)> fp = +[](int v) { return v * 2; };
+    TEST_ASSERT_EQUAL(8, fp(4));
+}
+
+static void test_bilge_fan_callback_in_place() {
+    // Two pointers of capture: what main.cpp and the sim register
+    int  calls = 0;
+    bool last  = false;
+    BilgeFan fan(HALMET_PIN_RELAY);
+    fan.begin();
+    fan.onRelayChange([&calls, &last](bool on) { calls++; last = on; });
+    fan.manualOn();
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_TRUE(last);
+    fan.forceOff();
+    TEST_ASSERT_EQUAL(2, calls);
+    TEST_ASSERT_FALSE(last);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_alignment_and_accounting);
+    RUN_TEST(test_full_arena_fails_and_counts);
+    RUN_TEST(test_seal_counts_late_allocations);
+    RUN_TEST(test_module_table_overflow);
+    RUN_TEST(test_scope_restores_module);
+    RUN_TEST(test_inplace_function_calls_capture);
+    RUN_TEST(test_bilge_fan_callback_in_place);
+    return UNITY_END();
+}
@@ -0,0 +1,155 @@
+// ============================================================
+//  test_strapping_table — Tank strapping table → uniform-grid LUT
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "StrappingTable.h"
+
+void setUp() {}
+void tearDown() {}
+
+using Point = StrappingTable::Point;
+
+// Exact piecewise-linear reference over points sorted by ohms
+static float exactLitres(const std::vector<Point>& pts, float ohms) {
+    if (ohms <= pts.front().ohms) return pts.front().litres;
+    if (ohms >= pts.back().ohms)  return pts.back().litres;
+    for (size_t i = 0; i + 1 < pts.size(); i++) {
+        if (ohms <= pts[i + 1].ohms) {
+            float t = (ohms - pts[i].ohms) / (pts[i + 1].ohms - pts[i].ohms);
+            return pts[i].litres + t * (pts[i + 1].litres - pts[i].litres);
+        }
+    }
+    return pts.back().litres;
+}
+
+// Keel tank: a V section widening upwards (volume ∝ h² at the
+// bottom) under a box — 600 mm deep, 90 L, strapped every 1.5 mm
+// on a 10–180 Ω VDO sender
+static std::vector<Point> keelTank() {
+    std::vector<Point> pts;
+    for (int i = 0; i <= 400; i++) {
+        float h = 600.0f * i / 400.0f;
+        float v = h < 300.0f ? 30.0f * (h / 300.0f) * (h / 300.0f)
+                             : 30.0f + 60.0f * (h - 300.0f) / 300.0f;
+        pts.push_back({ 10.0f + 170.0f * h / 600.0f, h, v });
+    }
+    return pts;
+}
+
+// ----------------------------------------------------------
+static void test_two_point_vdo_table() {
+    Point pts[] = { { 10.0f, 0.0f, 0.0f }, { 180.0f, 300.0f, 100.0f } };
+    StrappingTable t;
+    TEST_ASSERT_TRUE(std::isnan(t.litres(50.0f)));   // nothing compiled yet
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::OK), static_cast<int>(t.compile(pts, 2)));
+    TEST_ASSERT_TRUE(t.valid());
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,   t.litres(10.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f,  t.litres(95.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, t.litres(180.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 150.0f, t.heightMm(95.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,   t.litres(2.0f));     // held at the ends
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 100.0f, t.litres(250.0f));
+    TEST_ASSERT_TRUE(std::isnan(t.litres(NAN)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 95.0f,  t.ohmsFor(50.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f,   t.gridErrorL());
+}
+
+static void test_dense_table_matches_exact_lookup() {
+    std::vector<Point> pts = keelTank();
+    std::vector<Point> shuffled(pts.rbegin(), pts.rend());   // any order is accepted
+    std::swap(shuffled[7], shuffled[300]);
+
+    StrappingTable t;
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::OK),
+                      static_cast<int>(t.compile(shuffled.data(), static_cast<int>(shuffled.size()))));
+    TEST_ASSERT_EQUAL(401, t.points());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, t.maxLitres());
+
+    float worst = 0.0f;
+    for (float r = 5.0f; r <= 185.0f; r += 0.0731f) {
+        worst = std::max(worst, std::fabs(t.litres(r) - exactLitres(pts, r)));
+    }
+    printf("grid error %.4f L (reported %.4f L) over %d points\n", worst, t.gridErrorL(), t.points());
+    TEST_ASSERT_TRUE(worst <= t.gridErrorL() + 1e-4f);
+    TEST_ASSERT_TRUE(t.gridErrorL() < 0.01f);    // ≪ 0.1 % of 90 L
+
+    // Litres → ohms → litres round trip, bottom of the V included
+    for (float v = 0.5f; v < 90.0f; v += 0.37f) {
+        TEST_ASSERT_FLOAT_WITHIN(0.05f, v, t.litres(t.ohmsFor(v)));
+    }
+}
+
+static void test_falling_resistance_sender() {
+    // US sender: 240 Ω empty, 33 Ω full
+    Point pts[] = {
+        { 240.0f, 0.0f,   0.0f  },
+        { 150.0f, 100.0f, 20.0f },
+        { 33.0f,  250.0f, 60.0f },
+    };
+    StrappingTable t;
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::OK), static_cast<int>(t.compile(pts, 3)));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 60.0f,  t.litres(33.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f,  t.litres(195.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 50.0f,  t.heightMm(195.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f,   t.minLitres());
+    TEST_ASSERT_FLOAT_WITHIN(0.2f,  195.0f, t.ohmsFor(10.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.2f,  33.0f,  t.ohmsFor(60.0f));
+}
+
+static void test_bad_table_keeps_previous() {
+    StrappingTable t;
+    Point good[] = { { 10.0f, 0.0f, 0.0f }, { 180.0f, 300.0f, 100.0f } };
+    t.compile(good, 2);
+
+    Point one[] = { { 10.0f, 0.0f, 0.0f } };
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::TOO_FEW_POINTS), static_cast<int>(t.compile(one, 1)));
+
+    Point dup[] = { { 10.0f, 0.0f, 0.0f }, { 50.0f, 10.0f, 5.0f }, { 50.0f, 20.0f, 9.0f } };
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::DUPLICATE_OHMS), static_cast<int>(t.compile(dup, 3)));
+
+    Point back[] = { { 10.0f, 0.0f, 0.0f }, { 50.0f, 10.0f, 5.0f }, { 90.0f, 20.0f, 4.0f } };
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::NOT_MONOTONIC), static_cast<int>(t.compile(back, 3)));
+
+    Point against[] = { { 10.0f, 30.0f, 0.0f }, { 50.0f, 10.0f, 5.0f } };   // height falls as volume rises
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::NOT_MONOTONIC), static_cast<int>(t.compile(against, 2)));
+
+    Point flat[] = { { 10.0f, 0.0f, 7.0f }, { 50.0f, 0.0f, 7.0f } };
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::NOT_MONOTONIC), static_cast<int>(t.compile(flat, 2)));
+
+    Point nan[] = { { 10.0f, 0.0f, 0.0f }, { NAN, 10.0f, 5.0f } };
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::BAD_VALUE), static_cast<int>(t.compile(nan, 2)));
+
+    TEST_ASSERT_TRUE(t.valid());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, t.litres(95.0f));   // still the good table
+}
+
+static void test_dead_band_inverts_to_empty_end() {
+    // Sender travel below the pickup: 10–30 Ω all read as empty
+    Point pts[] = {
+        { 10.0f,  0.0f,   0.0f  },
+        { 30.0f,  0.0f,   0.0f  },
+        { 180.0f, 300.0f, 100.0f },
+    };
+    StrappingTable t;
+    TEST_ASSERT_EQUAL(static_cast<int>(StrappingStatus::OK), static_cast<int>(t.compile(pts, 3)));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,  t.litres(20.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, t.ohmsFor(0.0f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_two_point_vdo_table);
+    RUN_TEST(test_dense_table_matches_exact_lookup);
+    RUN_TEST(test_falling_resistance_sender);
+    RUN_TEST(test_bad_table_keeps_previous);
+    RUN_TEST(test_dead_band_inverts_to_empty_end);
+    return UNITY_END();
+}
@@ -0,0 +1,851 @@
+// ============================================================
+//  test_system_sim — A day of firmware time on a virtual clock
+//
+//  Wires the real modules the way setup() does (engine state
+//  machine, analog inputs, digital alarms, N2K publisher, bilge
+//  fan tick and task supervisor, then engine hours from the first
+//  event-loop tick)
+//  on top of the native shims, and drives a scripted 24 h day:
+//  ADS1115 late on I²C at boot, six hours at anchor, a passage
+//  (chartplotter sending System Time from 07:00) with an
+//  oil-pressure glitch and a real low-oil event, an
+//  overheat, a stop with bilge purge, a restart during the purge
+//  and a final stop.
+//
+//  The NMEA2000 library runs unmodified on a CAN driver that
+//  records every frame; fast packets are reassembled and each
+//  PGN is decoded with the library's own Parse functions.  The
+//  whole day runs in a few seconds of host time.
+//
+//  The tests share the one simulated day and must run in order:
+//  each advances the clock to the end of its phase and checks
+//  what the firmware did in it.
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <Adafruit_ADS1X15.h>
+#include <N2kMessages.h>
+#include <NMEA2000.h>
+#include <Wire.h>
+#include <esp_partition.h>
+#include <esp_task_wdt.h>
+#include <sensesp.h>
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/observablevalue.h>
+
+#include "halmet_config.h"
+#include "engine_state.h"
+#include "BilgeFan.h"
+#include "FlashJournal.h"
+#include "OneWireRegistry.h"
+#include "RpmSensor.h"
+#include "alarm_rules.h"
+#include "AdsScheduler.h"
+#include "arena.h"
+#include "StaticArena.h"
+#include "TankStrapping.h"
+#include "analog_inputs.h"
+#include "boot_profile.h"
+#include "digital_alarms.h"
+#include "dlog.h"
+#include "engine_hours.h"
+#include "engine_state_machine.h"
+#include "LatencyHistogram.h"
+#include "latency.h"
+#include "n2k_publisher.h"
+#include "supervisor.h"
+
+using namespace sensesp;
+
+static constexpr uint64_t kMs  = 1000ULL;
+static constexpr uint64_t kS   = 1000 * kMs;
+static constexpr uint64_t kMin = 60 * kS;
+static constexpr uint64_t kH   = 60 * kMin;
+
+// ============================================================
+//  CAN driver that records what the library puts on the bus
+// ============================================================
+struct Sent {
+    uint64_t us;
+    uint32_t pgn;
+    uint8_t  len;
+    uint8_t  data[32];
+};
+
+struct RapidSample {
+    uint64_t us;
+    float    rpm;
+};
+
+class SimBus : public tNMEA2000 {
+public:
+    std::vector<Sent>        log;     // every PGN except 127488
+    std::vector<RapidSample> rapid;   // 127488, decoded on arrival
+
+    /// Queue a single-frame message from another node on the bus.
+    void receive(const tN2kMsg& m, uint8_t source) {
+        Sent s = { shim::nowUs, static_cast<uint32_t>(m.PGN), static_cast<uint8_t>(m.DataLen), {} };
+        memcpy(s.data, m.Data, m.DataLen);
+        _rx.push_back({ s, source, m.Priority });
+    }
+
+protected:
+    bool CANOpen() override { return true; }
+    bool CANGetFrame(unsigned long& id, unsigned char& len, unsigned char* buf) override {
+        if (_rx.empty()) return false;
+        const Rx& r = _rx.front();
+        id  = (static_cast<unsigned long>(r.priority) << 26) | (r.msg.pgn << 8) | r.source;
+        len = r.msg.len;
+        memcpy(buf, r.msg.data, len);
+        _rx.pop_front();
+        return true;
+    }
+
+    bool CANSendFrame(unsigned long id, unsigned char len, const unsigned char* buf,
+                      bool /*wait_sent*/) override {
+        uint8_t  pf  = (id >> 16) & 0xFF;
+        uint32_t pgn = (id >> 8) & 0x3FFFF;
+        if (pf < 240) pgn &= 0x3FF00;          // PDU1: low byte is the destination
+
+        if (pgn == 127489UL) {                 // the only fast packet we send
+            Fast& f = _fast[pgn];
+            if ((buf[0] & 0x1F) == 0) {
+                f = {};
+                f.msg.us  = shim::nowUs;
+                f.msg.pgn = pgn;
+                f.msg.len = buf[1];
+                f.copy(buf + 2, len - 2);
+            } else {
+                f.copy(buf + 1, len - 1);
+            }
+            if (f.msg.len && f.got >= f.msg.len) {
+                log.push_back(f.msg);
+                f = {};
+            }
+            return true;
+        }
+
+        Sent s = { shim::nowUs, pgn, len, {} };
+        memcpy(s.data, buf, len);
+        if (pgn == 127488UL) {
+            tN2kMsg m = toMsg(s);
+            unsigned char inst;
+            double        rpm, boost;
+            int8_t        trim;
+            if (ParseN2kEngineParamRapid(m, inst, rpm, boost, trim)) {
+                rapid.push_back({ s.us, N2kIsNA(rpm) ? -1.0f : static_cast<float>(rpm) });
+            }
+        } else {
+            log.push_back(s);
+        }
+        return true;
+    }
+
+public:
+    static tN2kMsg toMsg(const Sent& s) {
+        tN2kMsg m;
+        m.SetPGN(s.pgn);
+        m.DataLen = s.len;
+        memcpy(m.Data, s.data, s.len);
+        return m;
+    }
+
+private:
+    struct Fast {
+        Sent   msg = {};
+        size_t got = 0;
+        void copy(const uint8_t* p, size_t n) {
+            for (size_t i = 0; i < n && got < sizeof(msg.data); i++) msg.data[got++] = p[i];
+        }
+    };
+    struct Rx {
+        Sent    msg;
+        uint8_t source;
+        uint8_t priority;
+    };
+    std::map<uint32_t, Fast> _fast;
+    std::deque<Rx>           _rx;
+};
+
+// ============================================================
+//  The board (as in main.cpp) and the boat around it
+// ============================================================
+static SimBus           sNmea;
+static RpmSensor        sRpm(HALMET_PIN_D1);
+static BilgeFan         sFan(HALMET_PIN_RELAY, /*activeHigh=*/true);
+static EngineState      sState;
+static OneWireRegistry  sOneWire;
+static SKOutputRawJson* sSkCoolantNotification = nullptr;
+static PersistingObservableValue<float>* sHoursPreset = nullptr;
+static PersistingObservableValue<float>* sTankCapL    = nullptr;
+static std::chrono::steady_clock::time_point sWallStart;
+
+struct Change {
+    uint64_t us;
+    bool     on;
+};
+static std::vector<Change> sRelayLog;     // BilgeFan::onRelayChange
+static std::vector<Change> sRunningLog;   // EngineState::engineRunning
+
+struct Boat {
+    double rpm        = 0.0;     // crankshaft
+    double coolantC   = 20.0;    // at the sender; the curve bottoms out at 40 °C
+    bool   overheat   = false;   // hold coolantC instead of following the model
+    double tankOhm    = 95.0;    // VDO 10–180 Ω → 50 %
+    double pulses     = 0.0;     // fractional W-terminal pulses carried between ticks
+    bool   running    = false;
+    bool   plotter    = false;   // chartplotter on: PGN 126992 at 1 Hz
+};
+static Boat sBoat;
+
+static constexpr uint32_t kBoatTickMs   = 10;
+static constexpr uint16_t kSimDay       = 20500;   // the day is 2026-02-16 UTC
+static constexpr uint8_t  kPlotterAddr  = 40;
+
+/// Sender voltage for a coolant temperature (inverse of TEMP_CURVE_POINTS).
+static float voltsForCelsius(double c) {
+    struct P { float v; float c; };
+    static const P kCurve[] = { TEMP_CURVE_POINTS };
+    constexpr int  n = sizeof(kCurve) / sizeof(kCurve[0]);
+    if (c <= kCurve[0].c)     return kCurve[0].v;
+    if (c >= kCurve[n - 1].c) return kCurve[n - 1].v;
+    for (int i = 0; i < n - 1; i++) {
+        if (c <= kCurve[i + 1].c) {
+            double r = (c - kCurve[i].c) / (kCurve[i + 1].c - kCurve[i].c);
+            return static_cast<float>(kCurve[i].v + r * (kCurve[i + 1].v - kCurve[i].v));
+        }
+    }
+    return kCurve[n - 1].v;
+}
+
+static void boatTick() {
+    // Alternator W-terminal
+    sBoat.pulses += sBoat.rpm / 60.0 * DEFAULT_PULSES_PER_REVOLUTION * kBoatTickMs / 1000.0;
+    while (sBoat.pulses >= 1.0) {
+        shim::fireInterrupt(HALMET_PIN_D1);
+        sBoat.pulses -= 1.0;
+    }
+
+    // Coolant: warms to the thermostat with τ = 5 min, cools with τ = 30 min
+    if (!sBoat.overheat) {
+        double target = sBoat.rpm > 0 ? 80.0 : 20.0;
+        double tauS   = sBoat.rpm > 0 ? 300.0 : 1800.0;
+        sBoat.coolantC += (target - sBoat.coolantC) * (kBoatTickMs / 1000.0) / tauS;
+    }
+    shim::adsVolts[0]                   = voltsForCelsius(sBoat.coolantC);
+    shim::adsVolts[TANK_SENDER_CHANNEL] = static_cast<float>(sBoat.tankOhm * TANK_MEASUREMENT_CURRENT);
+
+    if (sState.engineRunning.value != sBoat.running) {
+        sBoat.running = sState.engineRunning.value;
+        sRunningLog.push_back({ shim::nowUs, sBoat.running });
+    }
+
+    // Chartplotter System Time, on the second
+    if (sBoat.plotter && shim::nowUs % kS < kBoatTickMs * kMs) {
+        tN2kMsg m;
+        SetN2kSystemTime(m, 0, kSimDay, static_cast<double>(shim::nowUs / kS), N2ktimes_GPS);
+        sNmea.receive(m, kPlotterAddr);
+    }
+}
+
+/// D2/D3 are active-low switches to ground.
+static void setAlarmInput(uint8_t pin, bool active) {
+    shim::pinLevels[pin] = active ? LOW : HIGH;
+    shim::fireInterrupt(pin);
+}
+
+// setup() stage 1 and 2 for the modules under test
+static void boot() {
+    sWallStart = std::chrono::steady_clock::now();
+    shim::reset(0);
+    shim::pinLevels[HALMET_PIN_D2] = HIGH;    // pulled up, switches open
+    shim::pinLevels[HALMET_PIN_D3] = HIGH;
+    shim::adsPresent = false;                 // ADS1115 not answering yet
+
+    sRpm.begin();
+    sFan.begin();
+
+    sNmea.SetMode(tNMEA2000::N2km_NodeOnly, 23);
+    sNmea.Open();
+
+    auto* purgeS    = new PersistingObservableValue<float>(DEFAULT_PURGE_DURATION_S, "/bilge/purge_duration_s");
+    auto* pulses    = new PersistingObservableValue<float>(DEFAULT_PULSES_PER_REVOLUTION, "/rpm/pulses_per_rev");
+    auto* runRpm    = new PersistingObservableValue<float>(DEFAULT_ENGINE_RUNNING_RPM, "/rpm/running_threshold");
+    auto* tankCapL  = new PersistingObservableValue<float>(DEFAULT_TANK_CAPACITY_L, "/tank/capacity_l");
+    auto* warnC     = new PersistingObservableValue<float>(DEFAULT_COOLANT_WARN_C, "/coolant/warn_threshold_c");
+    auto* alarmC    = new PersistingObservableValue<float>(DEFAULT_COOLANT_ALARM_C, "/coolant/alarm_threshold_c");
+    auto* assertMs  = new PersistingObservableValue<float>(DEFAULT_ALARM_ASSERT_MS, "/alarms/assert_ms");
+    auto* releaseMs = new PersistingObservableValue<float>(DEFAULT_ALARM_RELEASE_MS, "/alarms/release_ms");
+    auto* presetH   = new PersistingObservableValue<float>(DEFAULT_ENGINE_HOURS_PRESET_H, "/engine/hours_preset");
+    sHoursPreset    = presetH;
+    sTankCapL       = tankCapL;
+
+    sFan.onRelayChange([](bool on) { sRelayLog.push_back({ shim::nowUs, on }); });
+
+    supervisor::init();
+    engine_state_machine::init({
+        .state            = &sState,
+        .nmea2000         = &sNmea,
+        .rpm              = &sRpm,
+        .pulsesPerRev     = pulses,
+        .runningThreshold = runRpm,
+    });
+    analog_inputs::init({
+        .state         = &sState,
+        .tankCapacityL = tankCapL,
+    });
+    digital_alarms::init({
+        .state     = &sState,
+        .assertMs  = assertMs,
+        .releaseMs = releaseMs,
+        .onChange  = n2k_publisher::publishEngineDynamic,
+    });
+    n2k_publisher::init({
+        .state         = &sState,
+        .nmea2000      = &sNmea,
+        .tankCapacityL = tankCapL,
+        .owRegistry    = &sOneWire,
+        .bilgeFan      = &sFan,
+    });
+    alarm_rules::init({
+        .state         = &sState,
+        .owRegistry    = &sOneWire,
+        .coolantWarnC  = warnC,
+        .coolantAlarmC = alarmC,
+    });
+    sSkCoolantNotification = static_cast<SKOutputRawJson*>(
+        SKOutputRawJson::find("notifications.propulsion.0.coolantTemperature"));
+
+    event_loop()->onRepeat(INTERVAL_FAN_MS, [purgeS]() {
+        sFan.update(sState.engineRunning.value, purgeS->get());
+    });
+
+    event_loop()->onDelay(0, [presetH]() {
+        engine_hours::init({ .state = &sState, .hoursPreset = presetH });
+        dlog::init();
+        latency::init();
+        boot_profile::init();
+        arena::init();
+        arena::seal();
+    });
+    // Stands in for the dlog drain task (not started natively)
+    event_loop()->onRepeat(DLOG_DRAIN_MS, []() { dlog::drain(LogRing::kCapacity); });
+
+    event_loop()->onRepeat(kBoatTickMs, boatTick);
+}
+
+static void runTo(uint64_t us) { event_loop()->runUntil(us); }
+
+// ============================================================
+//  Bus queries
+// ============================================================
+struct Cadence {
+    uint32_t count;
+    uint64_t maxGapUs;
+};
+
+static Cadence cadence(uint32_t pgn, uint64_t t0, uint64_t t1) {
+    Cadence  c    = { 0, 0 };
+    uint64_t prev = 0;
+    for (const auto& s : sNmea.log) {
+        if (s.pgn != pgn || s.us < t0 || s.us >= t1) continue;
+        if (c.count) c.maxGapUs = std::max(c.maxGapUs, s.us - prev);
+        prev = s.us;
+        c.count++;
+    }
+    return c;
+}
+
+static Cadence rapidCadence(uint64_t t0, uint64_t t1) {
+    Cadence  c    = { 0, 0 };
+    uint64_t prev = 0;
+    for (const auto& r : sNmea.rapid) {
+        if (r.us < t0 || r.us >= t1) continue;
+        if (c.count) c.maxGapUs = std::max(c.maxGapUs, r.us - prev);
+        prev = r.us;
+        c.count++;
+    }
+    return c;
+}
+
+/// Smoothed RPM in the last 127488 sent at or before t.
+static float rpmAt(uint64_t t) {
+    float rpm = -1.0f;
+    for (const auto& r : sNmea.rapid) {
+        if (r.us > t) break;
+        rpm = r.rpm;
+    }
+    return rpm;
+}
+
+struct Dynamic {
+    uint64_t us;
+    double   coolantK;
+    double   hoursS;
+    bool     oilLow;
+    bool     overTemp;
+    bool     checkEngine;
+};
+
+static std::vector<Dynamic> dynamics(uint64_t t0, uint64_t t1) {
+    std::vector<Dynamic> out;
+    for (const auto& s : sNmea.log) {
+        if (s.pgn != 127489UL || s.us < t0 || s.us >= t1) continue;
+        unsigned char inst;
+        double oilP, oilT, coolant, altV, fuelRate, hours, coolP, fuelP;
+        int8_t load, torque;
+        tN2kEngineDiscreteStatus1 s1;
+        tN2kEngineDiscreteStatus2 s2;
+        tN2kMsg m = SimBus::toMsg(s);
+        if (!ParseN2kEngineDynamicParam(m, inst, oilP, oilT, coolant, altV, fuelRate, hours,
+                                        coolP, fuelP, load, torque, s1, s2)) {
+            continue;
+        }
+        out.push_back({ s.us, coolant, hours, s1.Bits.LowOilPressure == 1,
+                        s1.Bits.OverTemperature == 1, s1.Bits.CheckEngine == 1 });
+    }
+    return out;
+}
+
+static Dynamic lastDynamic(uint64_t t) {
+    auto d = dynamics(0, t + 1);
+    return d.empty() ? Dynamic{} : d.back();
+}
+
+static std::vector<double> tankLevels(uint64_t t0, uint64_t t1) {
+    std::vector<double> out;
+    for (const auto& s : sNmea.log) {
+        if (s.pgn != 127505UL || s.us < t0 || s.us >= t1) continue;
+        unsigned char inst;
+        tN2kFluidType type;
+        double        level, capacity;
+        tN2kMsg       m = SimBus::toMsg(s);
+        if (ParseN2kFluidLevel(m, inst, type, level, capacity)) out.push_back(level);
+    }
+    return out;
+}
+
+static tN2kOnOff relayOnBusAt(uint64_t t) {
+    tN2kOnOff state = N2kOnOff_Unavailable;
+    for (const auto& s : sNmea.log) {
+        if (s.us > t) break;
+        if (s.pgn != 127501UL) continue;
+        unsigned char    bank;
+        tN2kBinaryStatus status;
+        tN2kMsg          m = SimBus::toMsg(s);
+        if (ParseN2kBinaryStatus(m, bank, status)) state = N2kGetStatusOnBinaryStatus(status, 1);
+    }
+    return state;
+}
+
+static std::vector<Change> between(const std::vector<Change>& log, uint64_t t0, uint64_t t1) {
+    std::vector<Change> out;
+    for (const auto& c : log) {
+        if (c.us >= t0 && c.us < t1) out.push_back(c);
+    }
+    return out;
+}
+
+#define TEST_ASSERT_TIME_WITHIN(lo, hi, actual)                      \
+    do {                                                             \
+        TEST_ASSERT_TRUE_MESSAGE((actual) >= (lo), "too early");     \
+        TEST_ASSERT_TRUE_MESSAGE((actual) <= (hi), "too late");      \
+    } while (0)
+
+void setUp()    {}
+void tearDown() {}
+
+// ============================================================
+//  The day
+// ============================================================
+
+// 00:00:00 – 00:01:00  ADS1115 answers from 12 s; retried every 5 s
+static void test_boot_ads_retry_and_stale_coolant() {
+    runTo(12 * kS);
+    shim::adsPresent = true;
+    runTo(1 * kMin);
+
+    TEST_ASSERT_TRUE(sState.adsOk);
+    TEST_ASSERT_EQUAL_UINT32(3, sState.adsFailCount);      // first scheduler tick, 5 s, 10 s
+    TEST_ASSERT_EQUAL_UINT32(4, shim::adsBegins);          // recovered at 15 s
+    // Scheduled single-shot conversions, never a blocking read:
+    // coolant at 5 Hz + tank sender at 2 Hz since 15 s
+    TEST_ASSERT_EQUAL_UINT32(0, shim::adsBlockingReads);
+    TEST_ASSERT_UINT32_WITHIN(8, 45 * 7, shim::adsReads);
+
+    auto before = dynamics(0, 15 * kS);
+    TEST_ASSERT_TRUE(before.size() >= 13);
+    for (const auto& d : before) TEST_ASSERT_TRUE(N2kIsNA(d.coolantK));
+    // Never sampled: the tank level is N/A too, not a made-up 0 %
+    auto tankBefore = tankLevels(0, 15 * kS);
+    TEST_ASSERT_TRUE(tankBefore.size() >= 13);
+    for (double l : tankBefore) TEST_ASSERT_TRUE(N2kIsNA(l));
+    for (double l : tankLevels(16 * kS, 1 * kMin)) TEST_ASSERT_DOUBLE_WITHIN(0.5, 50.0, l);
+
+    auto after = dynamics(16 * kS, 1 * kMin);
+    TEST_ASSERT_FALSE(after.empty());
+    for (const auto& d : after) {
+        TEST_ASSERT_DOUBLE_WITHIN(0.5, 40.0 + 273.15, d.coolantK);   // cold: curve floor
+        TEST_ASSERT_DOUBLE_WITHIN(0.5, 0.0, d.hoursS);              // empty journal
+    }
+
+    TEST_ASSERT_TRUE(boot_profile::at(BootPhase::FIRST_127488) > 0);
+    TEST_ASSERT_TRUE(boot_profile::at(BootPhase::FIRST_127488) < 2000);
+    TEST_ASSERT_FALSE(sFan.relayOn());
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[HALMET_PIN_RELAY]);
+}
+
+// 00:01 – 06:00  at anchor: steady PGN cadence, nothing switches
+static void test_anchor_cadence_and_quiet_outputs() {
+    runTo(6 * kH);
+
+    Cadence rapid = rapidCadence(1 * kMin, 6 * kH);
+    TEST_ASSERT_UINT32_WITHIN(1, (6 * kH - 1 * kMin) / (INTERVAL_RPM_MS * kMs), rapid.count);
+    TEST_ASSERT_EQUAL_UINT32(INTERVAL_RPM_MS * kMs, rapid.maxGapUs);
+
+    for (uint32_t pgn : { 127489UL, 127501UL, 127505UL }) {
+        Cadence c = cadence(pgn, 1 * kMin, 6 * kH);
+        TEST_ASSERT_UINT32_WITHIN(1, (6 * kH - 1 * kMin) / kS, c.count);
+        TEST_ASSERT_EQUAL_UINT32(kS, c.maxGapUs);
+    }
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rpmAt(6 * kH));
+    TEST_ASSERT_TRUE(sRunningLog.empty());
+    TEST_ASSERT_TRUE(sRelayLog.empty());
+    TEST_ASSERT_TRUE(relayOnBusAt(6 * kH) == N2kOnOff_Off);
+
+    unsigned char inst;
+    tN2kFluidType type;
+    double        level = 0, capacity = 0;
+    for (auto it = sNmea.log.rbegin(); it != sNmea.log.rend(); ++it) {
+        if (it->pgn != 127505UL) continue;
+        tN2kMsg m = SimBus::toMsg(*it);
+        ParseN2kFluidLevel(m, inst, type, level, capacity);
+        break;
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, 50.0, level);
+    TEST_ASSERT_DOUBLE_WITHIN(0.1, DEFAULT_TANK_CAPACITY_L, capacity);
+}
+
+// 06:00 – 08:00  crank, idle, cruise at 1500 RPM
+static void test_engine_start_and_warm_up() {
+    uint64_t t0 = 6 * kH;
+    sBoat.rpm = 250;                          // cranking
+    runTo(t0 + 2 * kS);
+    sBoat.rpm = 850;                          // caught, idling
+    runTo(t0 + 62 * kS);
+    sBoat.rpm = 1500;
+    runTo(7 * kH);
+    sBoat.plotter = true;
+    runTo(8 * kH);
+
+    auto run = between(sRunningLog, t0, 8 * kH);
+    TEST_ASSERT_EQUAL_UINT32(1, run.size());
+    TEST_ASSERT_TRUE(run[0].on);
+    // RPM above threshold within a tick or two, then the 5 s debounce
+    TEST_ASSERT_TIME_WITHIN(t0 + ENGINE_STATE_DEBOUNCE_MS * kMs,
+                            t0 + ENGINE_STATE_DEBOUNCE_MS * kMs + 700 * kMs, run[0].us);
+
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 850.0f, rpmAt(t0 + 30 * kS));
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 1500.0f, rpmAt(8 * kH - 1 * kS));
+
+    Dynamic d = lastDynamic(8 * kH);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0, 80.0 + 273.15, d.coolantK);
+    TEST_ASSERT_DOUBLE_WITHIN(3.0, (8 * kH - run[0].us) / 1e6, d.hoursS);
+    TEST_ASSERT_FALSE(sFan.relayOn());
+}
+
+// 08:00  data age at transmit, bus time from the chartplotter
+//        switched on at 07:00
+static void test_sample_age_and_bus_time() {
+    using latency::histogram;
+    // RPM: the 5-tick average stands 250 ms behind each 127488
+    const LatencyHistogram& rpm = histogram(LatencySignal::RPM);
+    TEST_ASSERT_UINT32_WITHIN(2, 8 * kH / (INTERVAL_RPM_MS * kMs), rpm.count());
+    TEST_ASSERT_EQUAL_UINT32(RPM_SMOOTHING_SAMPLES * INTERVAL_RPM_MS / 2, rpm.maxMs());
+
+    // Coolant (5 Hz, 16 SPS) and tank (2 Hz) in the 1 s PGNs: at
+    // most one read interval plus half a conversion old
+    const LatencyHistogram& coolant = histogram(LatencySignal::COOLANT);
+    const LatencyHistogram& tank    = histogram(LatencySignal::TANK_LEVEL);
+    printf("age at transmit: rpm p95 %u ms, coolant p50 %u p95 %u max %u ms, tank p95 %u max %u ms\n",
+           rpm.percentileMs(0.95f), coolant.percentileMs(0.5f), coolant.percentileMs(0.95f),
+           coolant.maxMs(), tank.percentileMs(0.95f), tank.maxMs());
+    TEST_ASSERT_UINT32_WITHIN(2, (8 * kH - 16 * kS) / kS, coolant.count());
+    TEST_ASSERT_TRUE(coolant.maxMs() <= INTERVAL_ANALOG_MS + 45);
+    TEST_ASSERT_TRUE(coolant.percentileMs(0.5f) >= 30);
+    TEST_ASSERT_TRUE(tank.maxMs() <= INTERVAL_TANK_MS + 45);
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(LatencySignal::ONEWIRE).count());   // no probes here
+
+    // Fuel rate once the estimator settled after the start
+    TEST_ASSERT_TRUE(histogram(LatencySignal::FUEL_RATE).count() > 0);
+
+    // Bus time follows the plotter; a sample stamp converts to UTC
+    uint32_t now = millis();
+    int64_t  utc = static_cast<int64_t>(kSimDay) * 86400000LL + now;
+    TEST_ASSERT_TRUE(latency::utcMs(now) - utc < 5 && utc - latency::utcMs(now) < 5);
+    uint32_t acq = sState.coolantK.sampleMs;
+    TEST_ASSERT_TRUE(latency::utcMs(acq) - (utc - (now - acq)) < 5);
+}
+
+// 08:00 – 10:00  20 ms oil-switch glitch, then a 3 s low-oil event
+static void test_oil_glitch_rejected_and_alarm_sent_at_once() {
+    uint64_t tg = 8 * kH;
+    runTo(tg);
+    setAlarmInput(HALMET_PIN_D2, true);
+    runTo(tg + 20 * kMs);
+    setAlarmInput(HALMET_PIN_D2, false);
+    runTo(tg + 1 * kMin);
+
+    for (const auto& d : dynamics(tg, tg + 1 * kMin)) TEST_ASSERT_FALSE(d.oilLow);
+    TEST_ASSERT_FALSE(sState.oilAlarm.value);
+
+    uint64_t ta = 9 * kH;
+    runTo(ta);
+    setAlarmInput(HALMET_PIN_D2, true);
+    runTo(ta + 1 * kS);
+    TEST_ASSERT_EQUAL_INT(HIGH, shim::pinLevels[HALMET_PIN_WARN_LAMP]);
+    runTo(ta + 3 * kS);
+    setAlarmInput(HALMET_PIN_D2, false);
+    runTo(ta + 10 * kS);
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[HALMET_PIN_WARN_LAMP]);
+
+    // Asserted after DEFAULT_ALARM_ASSERT_MS, sent in the same
+    // integrator tick rather than on the next 1 s publish
+    uint64_t assertedUs = 0, releasedUs = 0;
+    for (const auto& d : dynamics(ta, ta + 10 * kS)) {
+        if (!assertedUs && d.oilLow) {
+            assertedUs = d.us;
+            TEST_ASSERT_TRUE(d.checkEngine);
+        }
+        if (assertedUs && !releasedUs && !d.oilLow) releasedUs = d.us;
+    }
+    TEST_ASSERT_TIME_WITHIN(ta + DEFAULT_ALARM_ASSERT_MS * kMs,
+                            ta + (DEFAULT_ALARM_ASSERT_MS + ALARM_INTEGRATOR_TICK_MS) * kMs,
+                            assertedUs);
+    TEST_ASSERT_TIME_WITHIN(ta + 3 * kS + DEFAULT_ALARM_RELEASE_MS * kMs,
+                            ta + 3 * kS + (DEFAULT_ALARM_RELEASE_MS + ALARM_INTEGRATOR_TICK_MS) * kMs,
+                            releasedUs);
+
+    runTo(10 * kH);
+}
+
+// 10:00 – 11:00  stop: not running after the debounce, purge runs 600 s
+static void test_stop_runs_bilge_purge() {
+    uint64_t t0 = 10 * kH;
+    double   hoursAtStop = lastDynamic(t0).hoursS;
+    sBoat.rpm = 0;
+    runTo(11 * kH);
+
+    auto run = between(sRunningLog, t0, 11 * kH);
+    TEST_ASSERT_EQUAL_UINT32(1, run.size());
+    TEST_ASSERT_FALSE(run[0].on);
+    TEST_ASSERT_TIME_WITHIN(t0 + ENGINE_STATE_DEBOUNCE_MS * kMs,
+                            t0 + ENGINE_STATE_DEBOUNCE_MS * kMs + 1 * kS, run[0].us);
+
+    auto relay = between(sRelayLog, t0, 11 * kH);
+    TEST_ASSERT_EQUAL_UINT32(2, relay.size());
+    TEST_ASSERT_TRUE(relay[0].on);
+    TEST_ASSERT_FALSE(relay[1].on);
+    // One fan tick to enter PURGE, the relay closes on the next
+    TEST_ASSERT_TIME_WITHIN(run[0].us, run[0].us + 2 * INTERVAL_FAN_MS * kMs, relay[0].us);
+    TEST_ASSERT_TIME_WITHIN(relay[0].us + (uint64_t)(DEFAULT_PURGE_DURATION_S - 1) * kS,
+                            relay[0].us + (uint64_t)(DEFAULT_PURGE_DURATION_S + 1) * kS,
+                            relay[1].us);
+
+    TEST_ASSERT_TRUE(relayOnBusAt(relay[0].us + 5 * kMin) == N2kOnOff_On);
+    TEST_ASSERT_TRUE(relayOnBusAt(11 * kH) == N2kOnOff_Off);
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[HALMET_PIN_RELAY]);
+
+    // Hours stop with the engine (plus the stop debounce)
+    TEST_ASSERT_DOUBLE_WITHIN(7.0, hoursAtStop, lastDynamic(11 * kH).hoursS);
+}
+
+// 14:00 – 16:00  second passage at 2200 RPM with a 2-minute overheat
+static void test_overheat_notification_and_status_bit() {
+    runTo(14 * kH);
+    sBoat.rpm = 850;
+    runTo(14 * kH + 1 * kMin);
+    sBoat.rpm = 2200;
+
+    uint64_t t0 = 15 * kH;
+    runTo(t0);
+    sBoat.overheat = true;
+    sBoat.coolantC = 108.0;
+    setAlarmInput(HALMET_PIN_D3, true);
+    runTo(t0 + 1 * kMin);
+
+    const String& notif = sSkCoolantNotification->get();
+    TEST_ASSERT_TRUE(notif.find("\"state\":\"alarm\"") != std::string::npos);
+    Dynamic hot = lastDynamic(t0 + 1 * kMin);
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, 108.0 + 273.15, hot.coolantK);
+    TEST_ASSERT_TRUE(hot.overTemp);
+    TEST_ASSERT_TRUE(sState.coolantAlertState.value == CoolantAlertState::ALARM);
+
+    runTo(t0 + 2 * kMin);
+    sBoat.overheat = false;
+    sBoat.coolantC = 80.0;
+    setAlarmInput(HALMET_PIN_D3, false);
+    runTo(t0 + 3 * kMin);
+
+    TEST_ASSERT_TRUE(sSkCoolantNotification->get() == "null");
+    TEST_ASSERT_EQUAL_UINT32(2, sSkCoolantNotification->sets());   // alarm, then clear — nothing else all day
+    TEST_ASSERT_FALSE(lastDynamic(t0 + 3 * kMin).overTemp);
+    TEST_ASSERT_TRUE(sState.coolantAlertState.value == CoolantAlertState::NORMAL);
+
+    runTo(16 * kH);
+}
+
+// 16:00 – 19:00  stop, restart 3 min into the purge, final stop
+static void test_restart_during_purge_cuts_relay() {
+    uint64_t tStop = 16 * kH, tRestart = 16 * kH + 3 * kMin, tFinal = 18 * kH;
+    sBoat.rpm = 0;
+    runTo(tRestart);
+    TEST_ASSERT_TRUE(sFan.relayOn());
+
+    sBoat.rpm = 850;
+    runTo(tRestart + 1 * kMin);
+    sBoat.rpm = 2200;
+    runTo(tFinal);
+    sBoat.rpm = 0;
+    runTo(19 * kH);
+
+    auto relay = between(sRelayLog, tStop, 19 * kH);
+    TEST_ASSERT_EQUAL_UINT32(4, relay.size());
+    // Off once the restart is debounced, at the next fan tick
+    TEST_ASSERT_FALSE(relay[1].on);
+    TEST_ASSERT_TIME_WITHIN(tRestart + ENGINE_STATE_DEBOUNCE_MS * kMs,
+                            tRestart + ENGINE_STATE_DEBOUNCE_MS * kMs + 1500 * kMs, relay[1].us);
+    // A full purge after the final stop
+    TEST_ASSERT_TRUE(relay[2].on);
+    TEST_ASSERT_TIME_WITHIN(tFinal + ENGINE_STATE_DEBOUNCE_MS * kMs,
+                            tFinal + ENGINE_STATE_DEBOUNCE_MS * kMs + 2 * kS, relay[2].us);
+    TEST_ASSERT_TIME_WITHIN(relay[2].us + (uint64_t)(DEFAULT_PURGE_DURATION_S - 1) * kS,
+                            relay[2].us + (uint64_t)(DEFAULT_PURGE_DURATION_S + 1) * kS,
+                            relay[3].us);
+    TEST_ASSERT_EQUAL_INT(LOW, shim::pinLevels[HALMET_PIN_RELAY]);
+}
+
+// 19:00 – 24:00  quiet evening; day totals and the journal
+static void test_day_totals_and_journal() {
+    runTo(24 * kH);
+
+    // Engine ran 06:00–10:00, 14:00–16:00 and 16:03–18:00
+    const double expectS = (4 * kH + 2 * kH + (2 * kH - 3 * kMin)) / 1e6;
+    Dynamic d = lastDynamic(24 * kH);
+    TEST_ASSERT_DOUBLE_WITHIN(10.0, expectS, d.hoursS);
+
+    class PartitionView : public JournalFlash {
+    public:
+        size_t sectorSize()  const override { return shim::journalPartition.erase_size; }
+        size_t sectorCount() const override { return shim::journalPartition.size / sectorSize(); }
+        bool read(size_t a, void* dst, size_t n) override {
+            return esp_partition_read(&shim::journalPartition, a, dst, n) == ESP_OK;
+        }
+        bool write(size_t, const void*, size_t) override { return false; }
+        bool erase(size_t) override { return false; }
+    } view;
+    FlashJournal      j(view, sizeof(EngineHoursRecord));
+    EngineHoursRecord rec = {};
+    TEST_ASSERT_TRUE(j.recover(&rec));
+    TEST_ASSERT_EQUAL_UINT32(3, rec.starts);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0, d.hoursS, rec.runS);
+    uint32_t bandSum = 0;
+    for (uint32_t s : rec.bandS) bandSum += s;
+    TEST_ASSERT_UINT32_WITHIN(ENGINE_RPM_BANDS, rec.runS, bandSum);
+    // 1500 RPM cruise in band 3, 2200 RPM in band 4
+    TEST_ASSERT_UINT32_WITHIN(30, 4 * 3600 - 62, rec.bandS[1500 / ENGINE_RPM_BAND_WIDTH]);
+    TEST_ASSERT_UINT32_WITHIN(30, (2 * 3600 - 60) + (2 * 3600 - 180 - 60),
+                              rec.bandS[2200 / ENGINE_RPM_BAND_WIDTH]);
+
+    Cadence rapid = rapidCadence(1 * kS, 24 * kH);
+    TEST_ASSERT_EQUAL_UINT32(INTERVAL_RPM_MS * kMs, rapid.maxGapUs);
+    TEST_ASSERT_EQUAL_UINT32(1 * kS, cadence(127505UL, 1 * kS, 24 * kH).maxGapUs);
+    TEST_ASSERT_EQUAL_UINT32(1 * kS, cadence(127501UL, 1 * kS, 24 * kH).maxGapUs);
+
+    // Every critical task met its deadline all day: the watchdog was
+    // fed every supervisor tick and never came near its timeout
+    TEST_ASSERT_TRUE(shim::wdtSubscribed);
+    TEST_ASSERT_EQUAL_UINT32(SUPERVISOR_WDT_TIMEOUT_S * 1000, shim::wdtTimeoutMs);
+    TEST_ASSERT_UINT32_WITHIN(2, 24 * 3600 * 1000 / SUPERVISOR_TICK_MS, shim::wdtFeeds);
+    TEST_ASSERT_EQUAL_UINT32(SUPERVISOR_TICK_MS, shim::wdtMaxStarveMs);
+
+    // Runtime log records (alarm inputs, ADS retries, bus time) all drained
+    TEST_ASSERT_TRUE(dlog::ring().pushed() > 0);
+    TEST_ASSERT_EQUAL_UINT32(dlog::ring().pushed(), dlog::ring().popped());
+    TEST_ASSERT_EQUAL_UINT32(0, dlog::ring().dropped());
+
+    // Setup-time objects came from the arena, charged to their modules;
+    // nothing was built from it once boot was over
+    const StaticArena& arenaUse = arena::get();
+    TEST_ASSERT_TRUE(arenaUse.sealed());
+    const StaticArena::Module* analog = arenaUse.find("analogInputs");
+    TEST_ASSERT_NOT_NULL(analog);
+    TEST_ASSERT_TRUE(analog->bytes >= sizeof(TankStrapping) + sizeof(AdsScheduler));
+    TEST_ASSERT_NOT_NULL(arenaUse.find("engineHours"));
+    TEST_ASSERT_EQUAL_UINT32(0, arenaUse.lateAllocs());
+    auto* skRam = SKOutputRawJson::find("design.halmet.diagnostics.ram");
+    TEST_ASSERT_NOT_NULL(skRam);
+    TEST_ASSERT_TRUE(skRam->sets() > 0);
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - sWallStart).count();
+    printf("24 h simulated in %.2f s host time: %llu events, %zu PGN 127488, "
+           "%zu other PGNs, %u journal erases\n", wallS,
+           (unsigned long long)event_loop()->dispatched(), sNmea.rapid.size(), sNmea.log.size(),
+           (unsigned)shim::journalErases);
+}
+
+// The preset replaces the total once; saving the card again (now
+// showing "no preset") leaves the hours alone
+static void test_hours_preset_applies_once() {
+    double dayS = sState.engineSeconds.value;
+    sHoursPreset->set(DEFAULT_ENGINE_HOURS_PRESET_H);
+    runTo(shim::nowUs + 2 * kS);
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, dayS, sState.engineSeconds.value);
+
+    sHoursPreset->set(1250.0f);
+    runTo(shim::nowUs + 2 * kS);
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, 1250.0 * 3600, sState.engineSeconds.value);
+    TEST_ASSERT_TRUE(sHoursPreset->get() < 0.0f);
+
+    sHoursPreset->set(sHoursPreset->get());
+    runTo(shim::nowUs + 2 * kS);
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, 1250.0 * 3600, sState.engineSeconds.value);
+}
+
+// With no strapping table saved the default one follows the capacity:
+// the same sender reading is the same fraction of a bigger tank
+static void test_tank_capacity_change_without_reboot() {
+    float pct = sState.tankLevelPct.value;
+    TEST_ASSERT_TRUE(pct > 5.0f);
+    sTankCapL->set(2 * DEFAULT_TANK_CAPACITY_L);
+    runTo(shim::nowUs + 5 * kMin);
+    TEST_ASSERT_TRUE(sState.fresh(sState.tankLevelPct, millis()));
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, pct, sState.tankLevelPct.value);
+    sTankCapL->set(DEFAULT_TANK_CAPACITY_L);
+}
+
+int main() {
+    boot();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_ads_retry_and_stale_coolant);
+    RUN_TEST(test_anchor_cadence_and_quiet_outputs);
+    RUN_TEST(test_engine_start_and_warm_up);
+    RUN_TEST(test_sample_age_and_bus_time);
+    RUN_TEST(test_oil_glitch_rejected_and_alarm_sent_at_once);
+    RUN_TEST(test_stop_runs_bilge_purge);
+    RUN_TEST(test_overheat_notification_and_status_bit);
+    RUN_TEST(test_restart_during_purge_cuts_relay);
+    RUN_TEST(test_day_totals_and_journal);
+    RUN_TEST(test_hours_preset_applies_once);
+    RUN_TEST(test_tank_capacity_change_without_reboot);
+    return UNITY_END();
+}
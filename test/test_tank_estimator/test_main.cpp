@@ -0,0 +1,150 @@
+// ============================================================
+//  test_tank_estimator — Median + Kalman tank level & fuel rate
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "halmet_config.h"
+#include "TankEstimator.h"
+
+void setUp() {}
+void tearDown() {}
+
+static const TankEstimator::Tuning kTuning = {
+    TANK_MEDIAN_WINDOW,
+    TANK_LEVEL_SIGMA_PCT,
+    TANK_LEVEL_WALK_PCT,
+    TANK_RATE_WALK_PCT_H,
+    TANK_RATE_INIT_SIGMA_PCT_H,
+    TANK_RATE_SETTLE_S,
+    TANK_JUMP_SIGMA,
+    TANK_JUMP_SAMPLES,
+};
+
+static constexpr float kDtS = INTERVAL_TANK_MS / 1000.0f;
+
+// Sender reading at sea: true level + slosh (two swells) + noise,
+// with an occasional arm bounce of ±15 %
+struct Sea {
+    uint32_t x = 0x2468ACE1;
+    float    t = 0.0f;
+    float    amp;
+    explicit Sea(float amplitude) : amp(amplitude) {}
+    float rnd() {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        return (x & 0xFFFF) / 65535.0f - 0.5f;          // ±0.5
+    }
+    float read(float truth) {
+        t += kDtS;
+        float v = truth + amp * std::sin(t * 1.7f) + 0.5f * amp * std::sin(t * 0.43f + 1.0f)
+                + 2.0f * rnd();
+        if ((x & 0xFF) == 7) v += rnd() > 0 ? 15.0f : -15.0f;
+        return v;
+    }
+};
+
+// ----------------------------------------------------------
+static void test_still_tank_is_steady() {
+    TankEstimator est(kTuning);
+    Sea           sea(0.0f);
+    float         lo = 100, hi = 0;
+    for (int i = 0; i < 3600; i++) {
+        est.update(sea.read(62.0f), false, kDtS);
+        if (i > 20) {
+            lo = std::fmin(lo, est.levelPct());
+            hi = std::fmax(hi, est.levelPct());
+        }
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 62.0f, est.levelPct());
+    TEST_ASSERT_TRUE(hi - lo < 1.0f);
+    TEST_ASSERT_TRUE(est.rateValid());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, est.ratePctH());
+    TEST_ASSERT_TRUE(est.enduranceH(0.1f) < 0.0f);
+}
+
+static void test_slosh_rejected_and_rate_tracked_under_way() {
+    TankEstimator est(kTuning);
+    Sea           sea(6.0f);                 // ±9 % of swell on the sender
+    const float   burn = 2.5f;               // %/h (2.5 L/h on a 100 L tank)
+    float         truth = 80.0f;
+    float         maxErr = 0, maxRawErr = 0;
+    for (int i = 0; i < 6 * 7200; i++) {     // 6 h at 0.5 s
+        truth -= burn * kDtS / 3600.0f;
+        float z = sea.read(truth);
+        est.update(z, true, kDtS);
+        if (i > 600) {
+            maxErr    = std::fmax(maxErr, std::fabs(est.levelPct() - truth));
+            maxRawErr = std::fmax(maxRawErr, std::fabs(z - truth));
+        }
+        if (i == 2 * 60 * 10) TEST_ASSERT_FALSE(est.rateValid());   // 10 min: not settled yet
+    }
+    printf("level err max %.2f %% (raw %.1f %%), rate %.2f ± %.2f %%/h, truth %.2f\n",
+           maxErr, maxRawErr, est.ratePctH(), est.rateSigmaPctH(), burn);
+    TEST_ASSERT_TRUE(maxErr < 1.5f);
+    TEST_ASSERT_TRUE(maxRawErr > 10.0f);
+    TEST_ASSERT_TRUE(est.rateValid());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, burn, est.ratePctH());
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * truth / burn, truth / burn, est.enduranceH(0.1f));
+    TEST_ASSERT_EQUAL_UINT32(0, est.jumps());
+}
+
+static void test_stop_pins_rate_and_restart_begins_again() {
+    TankEstimator est(kTuning);
+    Sea           sea(3.0f);
+    float         truth = 70.0f;
+    for (int i = 0; i < 4 * 7200; i++) {
+        truth -= 3.0f * kDtS / 3600.0f;
+        est.update(sea.read(truth), true, kDtS);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.6f, 3.0f, est.ratePctH());
+
+    for (int i = 0; i < 7200; i++) est.update(sea.read(truth), false, kDtS);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, est.ratePctH());
+    TEST_ASSERT_TRUE(est.rateValid());
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, truth, est.levelPct());
+
+    est.update(sea.read(truth), true, kDtS);
+    TEST_ASSERT_FALSE(est.rateValid());              // settling again
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, est.ratePctH());
+}
+
+static void test_refuel_reseeds_level() {
+    TankEstimator est(kTuning);
+    Sea           sea(2.0f);
+    for (int i = 0; i < 600; i++) est.update(sea.read(25.0f), false, kDtS);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 25.0f, est.levelPct());
+
+    int took = -1;
+    for (int i = 0; i < 600; i++) {
+        est.update(sea.read(95.0f), false, kDtS);
+        if (took < 0 && std::fabs(est.levelPct() - 95.0f) < 2.0f) took = i;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, est.jumps());
+    TEST_ASSERT_TRUE(took >= 0 && took <= TANK_MEDIAN_WINDOW / 2 + TANK_JUMP_SAMPLES + 2);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 95.0f, est.levelPct());
+}
+
+static void test_single_spikes_do_not_reseed() {
+    TankEstimator est(kTuning);
+    for (int i = 0; i < 200; i++) est.update(50.0f, false, kDtS);
+    for (int k = 0; k < 20; k++) {
+        est.update(k & 1 ? 0.0f : 100.0f, false, kDtS);   // arm slams end to end
+        for (int i = 0; i < 3; i++) est.update(50.0f, false, kDtS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, est.jumps());
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 50.0f, est.levelPct());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_still_tank_is_steady);
+    RUN_TEST(test_slosh_rejected_and_rate_tracked_under_way);
+    RUN_TEST(test_stop_pins_rate_and_restart_begins_again);
+    RUN_TEST(test_refuel_reseeds_level);
+    RUN_TEST(test_single_spikes_do_not_reseed);
+    return UNITY_END();
+}
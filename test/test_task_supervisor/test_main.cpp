@@ -0,0 +1,142 @@
+// ============================================================
+//  test_task_supervisor — Per-task deadlines for the watchdog
+// ============================================================
+
+#include <unity.h>
+#include <shim_main.h>
+
+#include "TaskSupervisor.h"
+
+void setUp() {}
+void tearDown() {}
+
+// ----------------------------------------------------------
+static void test_healthy_while_tasks_check_in() {
+    TaskSupervisor s;
+    int a = s.add("rpm", 1000, true, 0);
+    int b = s.add("ads", 2000, true, 0);
+    for (uint32_t t = 0; t <= 60000; t += 500) {
+        s.checkIn(a, t);
+        if (t % 1000 == 0) s.checkIn(b, t);
+        TEST_ASSERT_TRUE(s.check(t));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, s.worstOverdue());
+    TEST_ASSERT_EQUAL_UINT32(0, s.task(a).misses);
+    TEST_ASSERT_EQUAL_UINT32(500, s.task(a).maxGapMs);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.task(b).maxGapMs);
+}
+
+static void test_stalled_critical_task_is_reported() {
+    TaskSupervisor s;
+    int a = s.add("rpm", 1000, true, 0);
+    int b = s.add("ads", 2000, true, 0);
+    s.checkIn(a, 0);
+    s.checkIn(b, 0);
+    for (uint32_t t = 500; t <= 2000; t += 500) {
+        s.checkIn(a, t);                       // ads hangs at t = 0
+        TEST_ASSERT_TRUE(s.check(t));          // exactly at the deadline is still in time
+    }
+    s.checkIn(a, 2500);
+    TEST_ASSERT_FALSE(s.check(2500));
+    TEST_ASSERT_EQUAL_INT(b, s.worstOverdue());
+    TEST_ASSERT_TRUE(s.task(b).overdue);
+    TEST_ASSERT_EQUAL_UINT32(2500, s.ageMs(b, 2500));
+}
+
+static void test_never_started_critical_task_is_caught() {
+    TaskSupervisor s;
+    int a = s.add("n2kPump", 1000, true, 10000);
+    TEST_ASSERT_TRUE(s.check(11000));
+    TEST_ASSERT_FALSE(s.check(11001));
+    TEST_ASSERT_EQUAL_INT(a, s.worstOverdue());
+    TEST_ASSERT_FALSE(s.task(a).started);
+}
+
+static void test_non_critical_task_never_starves() {
+    TaskSupervisor s;
+    int w = s.add("oneWire", 90000, false, 0);
+    // No probes: never checks in, never watched
+    TEST_ASSERT_TRUE(s.check(500000));
+    TEST_ASSERT_EQUAL_UINT32(0, s.task(w).misses);
+
+    // Once it has run it is watched and reported, still healthy overall
+    s.checkIn(w, 500000);
+    TEST_ASSERT_TRUE(s.check(600000));
+    TEST_ASSERT_TRUE(s.task(w).overdue);
+    TEST_ASSERT_EQUAL_UINT32(1, s.task(w).misses);
+    TEST_ASSERT_EQUAL_INT(-1, s.worstOverdue());
+}
+
+static void test_miss_counted_once_per_episode() {
+    TaskSupervisor s;
+    int a = s.add("slowPgns", 3000, true, 0);
+    s.checkIn(a, 0);
+    for (uint32_t t = 3500; t <= 10000; t += 500) TEST_ASSERT_FALSE(s.check(t));
+    TEST_ASSERT_EQUAL_UINT32(1, s.task(a).misses);
+
+    s.checkIn(a, 10000);                       // recovers
+    TEST_ASSERT_TRUE(s.check(10000));
+    TEST_ASSERT_FALSE(s.task(a).overdue);
+    TEST_ASSERT_EQUAL_UINT32(10000, s.task(a).maxGapMs);
+
+    TEST_ASSERT_FALSE(s.check(13001));         // second episode
+    TEST_ASSERT_EQUAL_UINT32(2, s.task(a).misses);
+}
+
+static void test_worst_is_furthest_past_deadline() {
+    TaskSupervisor s;
+    int a = s.add("rpm", 1000, true, 0);
+    int b = s.add("ads", 2000, true, 0);
+    int c = s.add("slowPgns", 3000, true, 0);
+    s.checkIn(a, 4000);
+    s.checkIn(b, 0);                           // 3000 past at t = 5000
+    s.checkIn(c, 1000);                        // 1000 past at t = 5000
+    TEST_ASSERT_FALSE(s.check(5000));
+    TEST_ASSERT_EQUAL_INT(b, s.worstOverdue());
+    (void)c;
+}
+
+static void test_restart_after_suspension() {
+    TaskSupervisor s;
+    int a = s.add("rpm", 1000, true, 0);
+    s.checkIn(a, 0);
+    TEST_ASSERT_FALSE(s.check(60000));         // e.g. a long OTA transfer
+    s.restart(60000);
+    TEST_ASSERT_TRUE(s.check(60500));
+    TEST_ASSERT_EQUAL_INT(-1, s.worstOverdue());
+    s.checkIn(a, 60800);
+    TEST_ASSERT_EQUAL_UINT32(800, s.task(a).maxGapMs);   // the suspension is not a gap
+}
+
+static void test_millis_wrap() {
+    TaskSupervisor s;
+    uint32_t t0 = 0xFFFFFC00u;
+    int a = s.add("rpm", 1000, true, t0);
+    s.checkIn(a, t0 + 500);
+    TEST_ASSERT_TRUE(s.check(t0 + 1400));      // wraps past zero
+    TEST_ASSERT_FALSE(s.check(t0 + 1600));
+    TEST_ASSERT_EQUAL_UINT32(1100, s.ageMs(a, t0 + 1600));
+}
+
+static void test_capacity() {
+    TaskSupervisor s;
+    for (int i = 0; i < TaskSupervisor::kMaxTasks; i++) TEST_ASSERT_EQUAL_INT(i, s.add("t", 1000, true, 0));
+    TEST_ASSERT_EQUAL_INT(-1, s.add("extra", 1000, true, 0));
+    s.checkIn(-1, 0);                          // ignored, no crash
+    s.checkIn(TaskSupervisor::kMaxTasks, 0);
+    TEST_ASSERT_EQUAL_INT(TaskSupervisor::kMaxTasks, s.count());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_while_tasks_check_in);
+    RUN_TEST(test_stalled_critical_task_is_reported);
+    RUN_TEST(test_never_started_critical_task_is_caught);
+    RUN_TEST(test_non_critical_task_never_starves);
+    RUN_TEST(test_miss_counted_once_per_episode);
+    RUN_TEST(test_worst_is_furthest_past_deadline);
+    RUN_TEST(test_restart_after_suspension);
+    RUN_TEST(test_millis_wrap);
+    RUN_TEST(test_capacity);
+    return UNITY_END();
+}
@@ -0,0 +1,231 @@
+// ============================================================
+//  alarm_debounce_sim.cpp — Host comparison of alarm debouncers
+//
+//  Runs the firmware's AlarmIntegrator (edge-captured, 5 ms tick)
+//  and the legacy 4-of-5 shift register (500 ms sampling) against
+//  the same synthetic D2/D3 waveforms and reports:
+//
+//    latency      real switch closure (with contact bounce) at a
+//                 random phase → time until the alarm asserts
+//    false pos.   ignition / cranking noise only (random spikes
+//                 50 µs … 20 ms) → fraction of runs that assert
+//    dropouts     real alarm with brief contact dropouts → fraction
+//                 of runs where the alarm releases spuriously
+//
+//  Build & run from the repo root:
+//    g++ -std=c++17 -O2 -Iinclude -o alarm_sim
+//        tools/alarm_debounce_sim.cpp src/AlarmIntegrator.cpp
+//    ./alarm_sim [trials]
+// ============================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "AlarmIntegrator.h"
+
+// Mirror the firmware defaults without pulling in halmet_config.h
+// (it needs the platformio.ini pin build flags).
+static constexpr uint32_t kAssertUs      = 60 * 1000;    // DEFAULT_ALARM_ASSERT_MS
+static constexpr uint32_t kReleaseUs     = 500 * 1000;   // DEFAULT_ALARM_RELEASE_MS
+static constexpr uint8_t  kDrainRatio    = 4;            // ALARM_DRAIN_RATIO
+static constexpr uint32_t kTickUs        = 5 * 1000;     // ALARM_INTEGRATOR_TICK_MS
+static constexpr uint32_t kSampleUs      = 500 * 1000;   // INTERVAL_DIGITAL_ALARM_MS
+static constexpr int      kShiftSamples  = 5;            // ALARM_DEBOUNCE_SAMPLES
+static constexpr int      kShiftThresh   = 4;            // ALARM_DEBOUNCE_THRESHOLD
+
+struct Edge {
+    uint32_t us;
+    bool     active;
+};
+using Waveform = std::vector<Edge>;   // sorted; level before the first edge = inactive
+
+static bool levelAt(const Waveform& w, uint32_t t) {
+    bool lvl = false;
+    for (const auto& e : w) {
+        if (e.us > t) break;
+        lvl = e.active;
+    }
+    return lvl;
+}
+
+// ----------------------------------------------------------
+//  Scheme runners.  Each returns every output transition time.
+// ----------------------------------------------------------
+struct Transition {
+    uint32_t us;
+    bool     asserted;
+};
+
+static std::vector<Transition> runIntegrator(const Waveform& w, uint32_t endUs) {
+    std::vector<Transition> out;
+    AlarmIntegrator in(kAssertUs, kReleaseUs, kDrainRatio);
+    in.reset(false, 0);
+    size_t next = 0;
+    for (uint32_t t = kTickUs; t <= endUs; t += kTickUs) {
+        bool changed = false;
+        while (next < w.size() && w[next].us <= t) {
+            changed |= in.edge(w[next].active, w[next].us);
+            next++;
+        }
+        changed |= in.update(t);
+        if (changed) out.push_back({t, in.asserted()});   // seen at the tick
+    }
+    return out;
+}
+
+static std::vector<Transition> runShiftRegister(const Waveform& w, uint32_t endUs,
+                                                uint32_t phaseUs) {
+    std::vector<Transition> out;
+    uint8_t hist = 0;
+    bool    asserted = false;
+    for (uint32_t t = phaseUs; t <= endUs; t += kSampleUs) {
+        hist = ((hist << 1) | levelAt(w, t)) & ((1 << kShiftSamples) - 1);
+        bool now = __builtin_popcount(hist) >= kShiftThresh;
+        if (now != asserted) {
+            asserted = now;
+            out.push_back({t, asserted});
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------
+//  Waveform generators
+// ----------------------------------------------------------
+static void addPulse(Waveform& w, uint32_t start, uint32_t width) {
+    w.push_back({start, true});
+    w.push_back({start + width, false});
+}
+
+static void normalise(Waveform& w) {
+    std::sort(w.begin(), w.end(), [](const Edge& a, const Edge& b) { return a.us < b.us; });
+    // Overlapping pulses: recompute the OR of all pulses as clean edges
+    Waveform out;
+    int depth = 0;
+    for (const auto& e : w) {
+        int before = depth;
+        depth += e.active ? 1 : -1;
+        if ((before == 0) != (depth == 0)) out.push_back({e.us, depth > 0});
+    }
+    w.swap(out);
+}
+
+// Switch closes at onset with ~3 ms of contact bounce, then stays closed
+static Waveform realAlarm(std::mt19937& rng, uint32_t onset) {
+    Waveform w;
+    std::uniform_int_distribution<uint32_t> bounce(100, 600);
+    uint32_t t = onset;
+    for (int i = 0; i < 4; i++) {
+        uint32_t on = bounce(rng), off = bounce(rng);
+        addPulse(w, t, on);
+        t += on + off;
+    }
+    w.push_back({t, true});
+    return w;
+}
+
+// Ignition / cranking interference: Poisson spikes, log-uniform widths
+static Waveform ignitionNoise(std::mt19937& rng, uint32_t endUs, double ratePerS) {
+    Waveform w;
+    std::exponential_distribution<double> gap(ratePerS / 1e6);
+    std::uniform_real_distribution<double> logw(std::log(50.0), std::log(20000.0));
+    double t = gap(rng);
+    while (t < endUs) {
+        addPulse(w, static_cast<uint32_t>(t), static_cast<uint32_t>(std::exp(logw(rng))));
+        t += gap(rng);
+    }
+    normalise(w);
+    return w;
+}
+
+// Real alarm with occasional 5–150 ms contact dropouts
+static Waveform alarmWithDropouts(std::mt19937& rng, uint32_t endUs) {
+    Waveform w;
+    std::exponential_distribution<double> gap(2.0 / 1e6);   // ~2 dropouts / s
+    std::uniform_int_distribution<uint32_t> drop(5000, 150000);
+    w.push_back({0, true});
+    double t = gap(rng);
+    while (t < endUs) {
+        uint32_t d = drop(rng);
+        w.push_back({static_cast<uint32_t>(t), false});
+        w.push_back({static_cast<uint32_t>(t) + d, true});
+        t += d + gap(rng);
+    }
+    return w;
+}
+
+// ----------------------------------------------------------
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t i = static_cast<size_t>(p * (v.size() - 1) + 0.5);
+    return v[i];
+}
+
+static double mean(const std::vector<double>& v) {
+    double s = 0;
+    for (double x : v) s += x;
+    return v.empty() ? 0.0 : s / v.size();
+}
+
+int main(int argc, char** argv) {
+    int trials = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> phase(0, kSampleUs - 1);
+
+    // ---- 1: detection latency ----
+    std::vector<double> latInt, latShift;
+    for (int i = 0; i < trials; i++) {
+        uint32_t onset = 1000000 + phase(rng);
+        Waveform w = realAlarm(rng, onset);
+        uint32_t end = onset + 5000000;
+        auto a = runIntegrator(w, end);
+        auto b = runShiftRegister(w, end, phase(rng));
+        if (!a.empty()) latInt.push_back((a[0].us - onset) / 1000.0);
+        if (!b.empty()) latShift.push_back((b[0].us - onset) / 1000.0);
+    }
+
+    // ---- 2: false positives under ignition noise (10 s runs) ----
+    const double rates[] = { 5.0, 20.0, 50.0 };
+    int fpInt[3] = {}, fpShift[3] = {};
+    for (int r = 0; r < 3; r++) {
+        for (int i = 0; i < trials; i++) {
+            Waveform w = ignitionNoise(rng, 10000000, rates[r]);
+            if (!runIntegrator(w, 10000000).empty())             fpInt[r]++;
+            if (!runShiftRegister(w, 10000000, phase(rng)).empty()) fpShift[r]++;
+        }
+    }
+
+    // ---- 3: spurious release on a real alarm with dropouts (10 s) ----
+    int relInt = 0, relShift = 0;
+    for (int i = 0; i < trials; i++) {
+        Waveform w = alarmWithDropouts(rng, 10000000);
+        auto a = runIntegrator(w, 10000000);
+        auto b = runShiftRegister(w, 10000000, phase(rng));
+        if (a.size() > 1) relInt++;
+        if (b.size() > 1) relShift++;
+    }
+
+    printf("trials per scenario: %d\n\n", trials);
+    printf("%-34s %14s %14s\n", "", "integrator", "shift 4-of-5");
+    printf("%-34s %11.1f ms %11.1f ms\n", "latency mean",
+           mean(latInt), mean(latShift));
+    printf("%-34s %11.1f ms %11.1f ms\n", "latency p95",
+           percentile(latInt, 0.95), percentile(latShift, 0.95));
+    printf("%-34s %11.1f ms %11.1f ms\n", "latency max",
+           percentile(latInt, 1.0), percentile(latShift, 1.0));
+    for (int r = 0; r < 3; r++) {
+        char label[64];
+        snprintf(label, sizeof(label), "false positives @ %.0f spikes/s", rates[r]);
+        printf("%-34s %12.2f %% %12.2f %%\n", label,
+               100.0 * fpInt[r] / trials, 100.0 * fpShift[r] / trials);
+    }
+    printf("%-34s %12.2f %% %12.2f %%\n", "spurious release (dropouts)",
+           100.0 * relInt / trials, 100.0 * relShift / trials);
+    return 0;
+}
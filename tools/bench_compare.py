@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Compare two native microbenchmark runs.
+
+Reads the bench_results.json written by `pio test -e native -f test_bench`
+for a baseline and a current run and prints the change per benchmark.
+Exits non-zero if any benchmark got slower than the threshold or now
+allocates more per call than in the baseline.
+
+    python3 tools/bench_compare.py base.json bench_results.json
+    python3 tools/bench_compare.py base.json bench_results.json --threshold 10
+
+Host timings vary between machines and runs: compare results from the
+same machine, and treat small changes as noise.
+"""
+
+import argparse
+import json
+import sys
+
+SCHEMA = 1
+
+
+def load(path: str) -> dict:
+    with open(path) as f:
+        data = json.load(f)
+    if data.get("schema") != SCHEMA:
+        sys.exit(f"{path}: unsupported schema {data.get('schema')!r}")
+    return {r["name"]: r for r in data["results"]}
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=15.0,
+                    help="allowed slowdown in percent (default 15)")
+    args = ap.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    failed = False
+    print(f"{'benchmark':<40} {'base ns':>10} {'now ns':>10} {'change':>8}  allocs")
+    for name, now in cur.items():
+        old = base.get(name)
+        if old is None:
+            print(f"{name:<40} {'-':>10} {now['ns_per_op']:>10.1f} {'new':>8}")
+            continue
+        change = (now["ns_per_op"] / old["ns_per_op"] - 1.0) * 100.0 if old["ns_per_op"] else 0.0
+        notes = []
+        if change > args.threshold:
+            notes.append("SLOWER")
+        if now["allocs_per_op"] > old["allocs_per_op"]:
+            notes.append(f"ALLOCS {old['allocs_per_op']:g} -> {now['allocs_per_op']:g}")
+        failed |= bool(notes)
+        line = (f"{name:<40} {old['ns_per_op']:>10.1f} {now['ns_per_op']:>10.1f} "
+                f"{change:>+7.1f}%  {now['allocs_per_op']:g}  {' '.join(notes)}")
+        print(line.rstrip())
+    for name in base.keys() - cur.keys():
+        print(f"{name:<40} missing from current run")
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,223 @@
+// ============================================================
+//  journal_wear_sim.cpp — Host wear / power-loss test of FlashJournal
+//
+//  Runs the firmware's FlashJournal on a RAM model of the 64 KB
+//  "journal" partition (NOR semantics, per-sector erase counters)
+//  through years of engine use at the engine_hours save policy:
+//  one record per ENGINE_HOURS_SAVE_S while running plus one per
+//  stop.  A fraction of runs end in a power cut in the middle of
+//  a record write or a sector erase; after each cut the journal
+//  is re-opened and must recover exactly the last record that was
+//  completely written, both straight after the cut and after the
+//  next append.
+//
+//  Reports the worst-case sector erase count against the flash
+//  endurance budget and exits non-zero on any failure.
+//
+//  Build & run from the repo root:
+//    g++ -std=c++17 -O2 -Iinclude -o journal_sim
+//        tools/journal_wear_sim.cpp src/FlashJournal.cpp
+//    ./journal_sim [years]
+// ============================================================
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "FlashJournal.h"
+
+// Mirror the firmware without pulling in halmet_config.h
+static constexpr size_t   kSectorSize    = 4096;
+static constexpr size_t   kSectors       = 16;          // 0x10000 journal partition
+static constexpr size_t   kPayloadLen    = 12 + 4 * 8;  // sizeof(EngineHoursRecord)
+static constexpr uint32_t kSaveS         = 60;          // ENGINE_HOURS_SAVE_S
+
+// ESP32 (GD25Q64 / W25Q64-class) NOR: 100 000 erase cycles per sector.
+// Budget: the journal may use at most 10 % of that over the run.
+static constexpr uint32_t kRatedCycles   = 100000;
+static constexpr double   kBudgetFrac    = 0.10;
+
+// ----------------------------------------------------------
+//  RAM NOR flash with erase counters and power-cut injection
+// ----------------------------------------------------------
+class RamFlash : public JournalFlash {
+public:
+    explicit RamFlash(std::mt19937& rng)
+        : _mem(kSectorSize * kSectors, 0xFF), _eraseCount(kSectors, 0), _rng(rng) {}
+
+    size_t sectorSize()  const override { return kSectorSize; }
+    size_t sectorCount() const override { return kSectors; }
+
+    bool read(size_t addr, void* dst, size_t len) override {
+        if (_dead || addr + len > _mem.size()) return false;
+        memcpy(dst, &_mem[addr], len);
+        return true;
+    }
+
+    bool write(size_t addr, const void* src, size_t len) override {
+        if (_dead || addr + len > _mem.size()) return false;
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+        size_t n = len;
+        if (_cutNext) n = std::uniform_int_distribution<size_t>(0, len - 1)(_rng);
+        for (size_t i = 0; i < n; i++) _mem[addr + i] &= s[i];   // NOR: clear bits only
+        if (_cutNext) return die();
+        return true;
+    }
+
+    bool erase(size_t sector) override {
+        if (_dead || sector >= kSectors) return false;
+        _eraseCount[sector]++;
+        uint8_t* p = &_mem[sector * kSectorSize];
+        if (_cutEraseNext) {
+            // Interrupted erase: an arbitrary prefix reaches 0xFF, the
+            // rest keeps (possibly weakened) old contents
+            size_t n = std::uniform_int_distribution<size_t>(0, kSectorSize - 1)(_rng);
+            memset(p, 0xFF, n);
+            for (size_t i = n; i < kSectorSize; i++) p[i] |= static_cast<uint8_t>(_rng());
+            return die();
+        }
+        memset(p, 0xFF, kSectorSize);
+        return true;
+    }
+
+    void armWriteCut()  { _cutNext = true; }
+    void armEraseCut()  { _cutEraseNext = true; }
+    void powerOn()      { _dead = _cutNext = _cutEraseNext = false; }
+    uint32_t maxErases() const { return *std::max_element(_eraseCount.begin(), _eraseCount.end()); }
+    uint32_t minErases() const { return *std::min_element(_eraseCount.begin(), _eraseCount.end()); }
+
+private:
+    bool die() {
+        _dead = true;
+        return false;
+    }
+
+    std::vector<uint8_t>  _mem;
+    std::vector<uint32_t> _eraseCount;
+    std::mt19937&         _rng;
+    bool _cutNext = false, _cutEraseNext = false, _dead = false;
+};
+
+struct SimRecord {
+    uint32_t runS;
+    uint32_t seqCheck;
+    uint8_t  rest[kPayloadLen - 8];
+};
+static_assert(sizeof(SimRecord) == kPayloadLen, "payload size");
+
+struct Profile {
+    const char* name;
+    int    daysPerYear;
+    int    runsPerDay;
+    double hoursPerRun;
+};
+
+struct Result {
+    uint64_t appends = 0, cuts = 0, recoveryFailures = 0;
+    uint32_t maxErases = 0, minErases = 0;
+    double   hours = 0;
+};
+
+static Result simulate(const Profile& pr, int years, double cutProb, std::mt19937& rng) {
+    Result    r;
+    RamFlash  flash(rng);
+    SimRecord rec = {}, committed = {};
+    bool      haveCommitted = false;
+
+    auto open = [&](FlashJournal*& j) {
+        delete j;
+        j = new FlashJournal(flash, kPayloadLen);
+        SimRecord got = {};
+        bool found = j->recover(&got);
+        if (found != haveCommitted ||
+            (found && memcmp(&got, &committed, sizeof(got)) != 0)) {
+            r.recoveryFailures++;
+        }
+        rec = haveCommitted ? committed : SimRecord{};
+    };
+
+    FlashJournal* j = nullptr;
+    open(j);
+    bool verifyNext = false;   // re-open after the first append following a cut
+
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::exponential_distribution<double>  runLen(1.0 / pr.hoursPerRun);
+    long runs = static_cast<long>(years) * pr.daysPerYear * pr.runsPerDay;
+
+    for (long run = 0; run < runs; run++) {
+        uint32_t secs  = static_cast<uint32_t>(runLen(rng) * 3600.0) + 1;
+        uint32_t saves = secs / kSaveS + 1;           // periodic + on stop
+        bool     cut   = u(rng) < cutProb;
+        uint32_t cutAt = cut ? static_cast<uint32_t>(u(rng) * saves) : UINT32_MAX;
+
+        for (uint32_t s = 0; s < saves; s++) {
+            rec.runS     += (s + 1 < saves) ? kSaveS : secs % kSaveS;
+            rec.seqCheck += 1;
+            if (s == cutAt) {
+                // Cut in the erase if this append opens a sector, else in the write
+                if (u(rng) < 0.5) flash.armEraseCut();
+                flash.armWriteCut();
+                j->append(&rec);
+                r.cuts++;
+                flash.powerOn();
+                open(j);
+                verifyNext = true;
+                break;                                 // rest of the run is lost
+            }
+            if (j->append(&rec)) {
+                committed     = rec;
+                haveCommitted = true;
+                r.appends++;
+                if (verifyNext) {
+                    // The head may sit next to the torn slot: the record
+                    // just written must be the one recovered
+                    verifyNext = false;
+                    open(j);
+                }
+            } else {
+                r.recoveryFailures++;
+            }
+        }
+        r.hours += secs / 3600.0;
+    }
+    delete j;
+    r.maxErases = flash.maxErases();
+    r.minErases = flash.minErases();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int years = argc > 1 ? std::atoi(argv[1]) : 20;
+    std::mt19937 rng(4242);
+
+    const Profile profiles[] = {
+        { "weekend cruiser",   60, 2, 1.5 },
+        { "summer liveaboard", 120, 2, 3.0 },
+        { "charter / heavy",   330, 3, 2.5 },
+    };
+
+    RamFlash     probeFlash(rng);
+    FlashJournal probe(probeFlash, kPayloadLen);
+    uint32_t budget = static_cast<uint32_t>(kRatedCycles * kBudgetFrac);
+    printf("journal: %zu sectors x %zu B, %zu B slots, %zu records; "
+           "budget %u erases/sector over %d years\n\n",
+           kSectors, kSectorSize, probe.slotSize(), probe.capacity(), budget, years);
+    printf("%-18s %9s %10s %7s %9s %9s %9s\n",
+           "profile", "eng. h", "appends", "cuts", "erase max", "erase min", "recovery");
+
+    bool ok = true;
+    for (const auto& pr : profiles) {
+        Result r = simulate(pr, years, 0.02, rng);
+        bool pass = r.recoveryFailures == 0 && r.maxErases <= budget;
+        ok &= pass;
+        printf("%-18s %9.0f %10llu %7llu %9u %9u %9s\n",
+               pr.name, r.hours, (unsigned long long)r.appends, (unsigned long long)r.cuts,
+               r.maxErases, r.minErases, r.recoveryFailures ? "FAIL" : "ok");
+    }
+    printf("\n%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
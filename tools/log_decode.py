@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Decode HALMET deferred log frames from a serial capture.
+
+Firmware built with -D DLOG_BINARY_UART writes runtime log records
+as binary frames (LogRecord in include/LogRing.h) on the serial
+port instead of formatting them on the device.  This reads the
+port, a capture file or stdin, formats each frame with the table in
+src/log_formats.cpp (IDs from include/log_formats.h) and passes the
+surrounding ESP_LOG text through unchanged.
+
+    python3 tools/log_decode.py /dev/ttyUSB0            (needs pyserial)
+    python3 tools/log_decode.py capture.bin
+    pio device monitor --raw | python3 tools/log_decode.py -
+"""
+
+import argparse
+import codecs
+import re
+import struct
+import sys
+from pathlib import Path
+
+SYNC = b"\xa5\x4c"
+VERSION = 1
+RECORD = struct.Struct("<IHBB4I")             # LogRecord, 24 bytes
+FRAME_SIZE = 3 + RECORD.size + 2
+
+ROOT = Path(__file__).resolve().parent.parent
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?[lh]*([diuxXcfegB%])")
+
+
+def crc16_ccitt(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def load_formats(root: Path) -> dict:
+    """{id: (level, tag, fmt)} from the enum order and the table."""
+    header = (root / "include" / "log_formats.h").read_text(encoding="utf-8")
+    body = re.search(r"enum class LogFmt[^{]*\{(.*?)\}", header, re.S).group(1)
+    names = [m.group(1) for m in re.finditer(r"^\s*(\w+)\s*(?:=\s*0\s*)?,", body, re.M)]
+    ids = {name: i for i, name in enumerate(names)}
+
+    table = (root / "src" / "log_formats.cpp").read_text(encoding="utf-8")
+    formats = {}
+    for m in re.finditer(r'\{\s*LogFmt::(\w+),\s*\'(\w)\',\s*"([^"]*)",\s*"((?:[^"\\]|\\.)*)"\s*\}', table):
+        formats[ids[m.group(1)]] = (m.group(2), m.group(3), m.group(4))
+    return formats
+
+
+def format_record(fmt: str, args: list) -> str:
+    """Mirror of formatLogRecord() in src/LogRing.cpp."""
+    it = iter(args)
+
+    def conv(m):
+        flags, width, prec, kind = m.groups()
+        if kind == "%":
+            return "%"
+        try:
+            v = next(it)
+        except StopIteration:
+            return "?"
+        spec = "%" + flags + width + (f".{prec}" if prec is not None else "")
+        if kind in "di":
+            return (spec + "d") % struct.unpack("<i", struct.pack("<I", v))[0]
+        if kind in "feg":
+            return (spec + kind) % struct.unpack("<f", struct.pack("<I", v))[0]
+        if kind == "c":
+            return (spec + "c") % chr(v & 0xFF)
+        if kind == "B":
+            return "ON" if v else "OFF"
+        return (spec + ("d" if kind == "u" else kind)) % v
+
+    return CONVERSION.sub(conv, fmt)
+
+
+def decode(frame: bytes, formats: dict) -> str:
+    ms, fmt_id, nargs, _, *args = RECORD.unpack_from(frame, 3)
+    if fmt_id not in formats:
+        return f"? ({ms}) dlog: unknown format {fmt_id} args={args[:nargs]}"
+    level, tag, fmt = formats[fmt_id]
+    return f"{level} ({ms}) {tag}: {format_record(fmt, args[:nargs])}"
+
+
+def chunks(source: str, baud: int):
+    if source == "-":
+        stream, live = sys.stdin.buffer, False
+    elif Path(source).is_file():
+        stream, live = open(source, "rb"), False
+    else:
+        import serial  # pyserial, only needed for a live port
+        stream, live = serial.Serial(source, baud, timeout=0.2), True
+    read = getattr(stream, "read1", stream.read)   # whatever has arrived
+    while True:
+        data = read(4096)
+        if data:
+            yield data
+        elif not live:
+            return
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", help="serial port, capture file, or - for stdin")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--root", type=Path, default=ROOT, help="firmware tree with the format table")
+    args = ap.parse_args()
+
+    formats = load_formats(args.root)
+    out = sys.stdout
+    text = codecs.getincrementaldecoder("utf-8")("replace").decode   # UTF-8 split across reads
+    buf = bytearray()
+    frames = bad_crc = 0
+    try:
+        for data in chunks(args.source, args.baud):
+            buf += data
+            while True:
+                start = buf.find(SYNC)
+                if start < 0:
+                    # Keep a trailing first sync byte; the rest is text
+                    keep = 1 if buf.endswith(SYNC[:1]) else 0
+                    out.write(text(bytes(buf[:len(buf) - keep])))
+                    del buf[:len(buf) - keep]
+                    break
+                out.write(text(bytes(buf[:start])))
+                del buf[:start]
+                if len(buf) < FRAME_SIZE:
+                    break
+                frame = bytes(buf[:FRAME_SIZE])
+                crc_ok = (frame[2] == VERSION and
+                          crc16_ccitt(frame[:-2]) == struct.unpack_from("<H", frame, FRAME_SIZE - 2)[0])
+                if not crc_ok:
+                    # Not a frame after all: pass one byte through and resync
+                    bad_crc += 1
+                    out.write(text(bytes(buf[:1])))
+                    del buf[:1]
+                    continue
+                del buf[:FRAME_SIZE]
+                out.write(decode(frame, formats) + "\n")
+                frames += 1
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(f"# frames={frames} crc_errors={bad_crc}", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""Decode HALMET MQTT telemetry batches (CBOR or MessagePack) to CSV.
+
+The firmware's MQTT export (src/mqtt_export.cpp) publishes one map
+per publish interval: column names and scales once, then rows of
+[dt ms, value x scale ...] (layout in include/TelemetryBatch.h),
+plus the bound 1-Wire probes and a few diagnostics.  This prints one
+CSV line per row, values back in engineering units, and the probes
+and diagnostics as comment lines on stderr.  The format is detected
+from the first byte.
+
+    mosquitto_sub -h <broker> -t 'halmet/#' -F '%t %x' | python3 tools/mqtt_decode.py -
+    python3 tools/mqtt_decode.py batch.cbor batch2.msgpack
+"""
+
+import argparse
+import struct
+import sys
+
+VERSION = 1
+
+
+class Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def take(self, n: int) -> bytes:
+        if self.pos + n > len(self.data):
+            raise ValueError("truncated payload")
+        b = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return b
+
+    def byte(self) -> int:
+        return self.take(1)[0]
+
+    def uint(self, n: int) -> int:
+        return int.from_bytes(self.take(n), "big")
+
+
+def cbor_item(r: Reader):
+    ib = r.byte()
+    major, info = ib >> 5, ib & 0x1F
+    if major == 7:
+        if info == 20:
+            return False
+        if info == 21:
+            return True
+        if info in (22, 23):
+            return None
+        if info == 25:
+            return struct.unpack(">e", r.take(2))[0]
+        if info == 26:
+            return struct.unpack(">f", r.take(4))[0]
+        if info == 27:
+            return struct.unpack(">d", r.take(8))[0]
+        raise ValueError(f"unsupported CBOR simple value {info}")
+    if info < 24:
+        arg = info
+    elif info <= 27:
+        arg = r.uint(1 << (info - 24))
+    else:
+        raise ValueError("indefinite-length CBOR items are not used")
+    if major == 0:
+        return arg
+    if major == 1:
+        return -1 - arg
+    if major == 2:
+        return r.take(arg)
+    if major == 3:
+        return r.take(arg).decode()
+    if major == 4:
+        return [cbor_item(r) for _ in range(arg)]
+    if major == 5:
+        return {cbor_item(r): cbor_item(r) for _ in range(arg)}
+    raise ValueError("CBOR tags are not used")
+
+
+def msgpack_item(r: Reader):
+    b = r.byte()
+    if b <= 0x7F:
+        return b
+    if b >= 0xE0:
+        return b - 0x100
+    if 0x80 <= b <= 0x8F:
+        return {msgpack_item(r): msgpack_item(r) for _ in range(b & 0x0F)}
+    if 0x90 <= b <= 0x9F:
+        return [msgpack_item(r) for _ in range(b & 0x0F)]
+    if 0xA0 <= b <= 0xBF:
+        return r.take(b & 0x1F).decode()
+    fixed = {
+        0xC0: lambda: None, 0xC2: lambda: False, 0xC3: lambda: True,
+        0xCA: lambda: struct.unpack(">f", r.take(4))[0],
+        0xCB: lambda: struct.unpack(">d", r.take(8))[0],
+        0xCC: lambda: r.uint(1), 0xCD: lambda: r.uint(2),
+        0xCE: lambda: r.uint(4), 0xCF: lambda: r.uint(8),
+        0xD0: lambda: struct.unpack(">b", r.take(1))[0],
+        0xD1: lambda: struct.unpack(">h", r.take(2))[0],
+        0xD2: lambda: struct.unpack(">i", r.take(4))[0],
+        0xD3: lambda: struct.unpack(">q", r.take(8))[0],
+        0xD9: lambda: r.take(r.uint(1)).decode(),
+        0xDA: lambda: r.take(r.uint(2)).decode(),
+        0xDB: lambda: r.take(r.uint(4)).decode(),
+        0xDC: lambda: [msgpack_item(r) for _ in range(r.uint(2))],
+        0xDD: lambda: [msgpack_item(r) for _ in range(r.uint(4))],
+        0xDE: lambda: {msgpack_item(r): msgpack_item(r) for _ in range(r.uint(2))},
+        0xDF: lambda: {msgpack_item(r): msgpack_item(r) for _ in range(r.uint(4))},
+    }
+    if b not in fixed:
+        raise ValueError(f"unsupported MessagePack type 0x{b:02x}")
+    return fixed[b]()
+
+
+def decode(payload: bytes) -> dict:
+    """Batch map from either format (CBOR maps start 0xa0-0xbf)."""
+    r = Reader(payload)
+    first = payload[0] if payload else 0
+    if 0xA0 <= first <= 0xBF:
+        batch = cbor_item(r)
+    elif 0x80 <= first <= 0x8F or first in (0xDE, 0xDF):
+        batch = msgpack_item(r)
+    else:
+        raise ValueError(f"not a batch map (first byte 0x{first:02x})")
+    if not isinstance(batch, dict) or batch.get("v") != VERSION:
+        raise ValueError(f"unsupported batch version {batch.get('v') if isinstance(batch, dict) else '?'}")
+    return batch
+
+
+def unscale(v, scale: float):
+    if v is None:
+        return ""
+    x = v / scale
+    return str(int(x)) if scale == 1 else f"{x:g}"
+
+
+def emit(batch: dict, topic: str, header: list) -> None:
+    names, scales = batch["f"], batch["s"]
+    if header != names:
+        print(",".join(["t_ms", "utc_ms"] + names))
+        header[:] = names
+    t0, utc = batch["t0"], batch["utc"]
+    for row in batch["r"]:
+        dt = row[0]
+        cols = [unscale(v, s) for v, s in zip(row[1:], scales)]
+        print(",".join([str(t0 + dt), "" if utc is None else str(utc + dt)] + cols))
+    probes = " ".join(f"{inst}:{'-' if t is None else t / 10:g}C" for inst, t in batch.get("ow", []))
+    diag = " ".join(f"{k}={v}" for k, v in batch.get("d", {}).items())
+    print(f"# {topic} rows={len(batch['r'])} ow {probes or '-'} | {diag}", file=sys.stderr, flush=True)
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("inputs", nargs="+",
+                    help="payload files, or - for 'topic hex' lines from mosquitto_sub -F '%%t %%x'")
+    args = ap.parse_args()
+
+    header: list = []
+    bad = 0
+    for path in args.inputs:
+        if path == "-":
+            for line in sys.stdin:
+                parts = line.split()
+                if len(parts) != 2:
+                    continue
+                try:
+                    emit(decode(bytes.fromhex(parts[1])), parts[0], header)
+                except ValueError as e:
+                    bad += 1
+                    print(f"# {parts[0]}: {e}", file=sys.stderr)
+        else:
+            with open(path, "rb") as f:
+                try:
+                    emit(decode(f.read()), path, header)
+                except ValueError as e:
+                    bad += 1
+                    print(f"# {path}: {e}", file=sys.stderr)
+    return 1 if bad else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
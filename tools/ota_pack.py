@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Pack (and optionally upload) a compressed HALMET OTA image.
+
+Compresses a firmware .bin with LZSS (4 KB window) and prepends the
+OtaImageHeader from include/OtaUnpacker.h: payload CRC-32 and the
+SHA-256 of the uncompressed image.  The device decompresses the
+upload as it arrives and only switches partitions once both match.
+
+    python3 tools/ota_pack.py .pio/build/halmet/firmware.bin
+    python3 tools/ota_pack.py .pio/build/halmet/firmware.bin \\
+        --upload halmet-engine.local --password SomeOTAPassword
+    python3 tools/ota_pack.py firmware.bin --stored -o firmware.hz
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import time
+import urllib.request
+import zlib
+
+MAGIC = 0x315A4F48          # "HOZ1"
+VERSION = 1
+ALGO_STORED = 0
+ALGO_LZSS = 1
+WINDOW_BITS = 12
+WINDOW = 1 << WINDOW_BITS
+MIN_MATCH = 3
+MAX_MATCH = 18
+MAX_CHAIN = 48              # candidates tried per position
+
+HEADER = struct.Struct("<IBBBBIII32s")
+assert HEADER.size == 52
+
+
+def lzss_compress(data: bytes) -> bytes:
+    out = bytearray()
+    chains = {}             # 3-byte prefix → recent positions, newest last
+    n = len(data)
+    i = 0
+    flags_at = -1
+    bit = 8
+
+    def item(is_literal: bool, payload: bytes) -> None:
+        nonlocal flags_at, bit
+        if bit == 8:
+            flags_at = len(out)
+            out.append(0)
+            bit = 0
+        if is_literal:
+            out[flags_at] |= 1 << bit
+        bit += 1
+        out.extend(payload)
+
+    def insert(pos: int) -> None:
+        if pos + MIN_MATCH <= n:
+            chain = chains.setdefault(data[pos:pos + MIN_MATCH], [])
+            chain.append(pos)
+            if len(chain) > 2 * MAX_CHAIN:
+                del chain[:MAX_CHAIN]
+
+    while i < n:
+        best_len, best_dist = 0, 0
+        limit = min(MAX_MATCH, n - i)
+        if limit >= MIN_MATCH:
+            for p in reversed(chains.get(data[i:i + MIN_MATCH], [])[-MAX_CHAIN:]):
+                dist = i - p
+                if dist > WINDOW:
+                    break
+                length = MIN_MATCH
+                while length < limit and data[p + length] == data[i + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_dist = length, dist
+                    if length == limit:
+                        break
+
+        if best_len >= MIN_MATCH:
+            d = best_dist - 1
+            item(False, bytes((d & 0xFF, (d >> 8) | ((best_len - MIN_MATCH) << 4))))
+            for k in range(best_len):
+                insert(i + k)
+            i += best_len
+        else:
+            item(True, data[i:i + 1])
+            insert(i)
+            i += 1
+    return bytes(out)
+
+
+def lzss_decompress(payload: bytes, image_len: int) -> bytes:
+    out = bytearray()
+    i = 0
+    while len(out) < image_len:
+        flags = payload[i]
+        i += 1
+        for bit in range(8):
+            if len(out) >= image_len:
+                break
+            if flags & (1 << bit):
+                out.append(payload[i])
+                i += 1
+            else:
+                b0, b1 = payload[i], payload[i + 1]
+                i += 2
+                dist = (b0 | ((b1 & 0x0F) << 8)) + 1
+                for _ in range((b1 >> 4) + MIN_MATCH):
+                    out.append(out[-dist])
+    return bytes(out)
+
+
+def pack(image: bytes, stored: bool = False) -> bytes:
+    if stored:
+        algo, bits, payload = ALGO_STORED, 0, image
+    else:
+        algo, bits, payload = ALGO_LZSS, WINDOW_BITS, lzss_compress(image)
+        if lzss_decompress(payload, len(image)) != image:
+            raise RuntimeError("LZSS round trip failed")
+    header = HEADER.pack(MAGIC, VERSION, algo, bits, 0, len(image), len(payload),
+                         zlib.crc32(payload) & 0xFFFFFFFF,
+                         hashlib.sha256(image).digest())
+    return header + payload
+
+
+def upload(host: str, packed: bytes, password: str) -> None:
+    req = urllib.request.Request(
+        f"http://{host}/api/ota", data=packed, method="POST",
+        headers={"Content-Type": "application/octet-stream",
+                 "X-OTA-Password": password})
+    t0 = time.monotonic()
+    with urllib.request.urlopen(req, timeout=300) as resp:
+        body = resp.read().decode(errors="replace")
+    print(f"uploaded in {time.monotonic() - t0:.1f} s: {body}", file=sys.stderr)
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("firmware", help="firmware .bin from the PlatformIO build")
+    ap.add_argument("-o", "--output", help="write the packed image here (default: <firmware>.hz)")
+    ap.add_argument("--stored", action="store_true", help="no compression (same container)")
+    ap.add_argument("--upload", metavar="HOST", help="POST the image to http://HOST/api/ota")
+    ap.add_argument("--password", default="SomeOTAPassword", help="OTA_PASSWORD of the device")
+    args = ap.parse_args()
+
+    with open(args.firmware, "rb") as f:
+        image = f.read()
+    t0 = time.monotonic()
+    packed = pack(image, args.stored)
+    print(f"{len(image)} → {len(packed)} bytes ({100.0 * len(packed) / len(image):.1f} %) "
+          f"in {time.monotonic() - t0:.1f} s", file=sys.stderr)
+
+    out = args.output or (args.firmware.rsplit(".", 1)[0] + ".hz")
+    with open(out, "wb") as f:
+        f.write(packed)
+
+    if args.upload:
+        upload(args.upload, packed, args.password)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
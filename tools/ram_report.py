@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Static RAM per module from the firmware link map.
+
+Sums the input sections the linker placed in DRAM (.data, .bss,
+.noinit) and IRAM for every object file, and groups them by firmware
+module (src/<module>.cpp), library, or the Arduino / ESP-IDF framework.
+The static arena (ARENA_BYTES, src/arena.cpp) shows up as part of
+the arena module; what is built in it at boot is reported at run time
+in design.halmet.diagnostics.ram.
+
+    pio run -e halmet
+    python3 tools/ram_report.py                              (default map path)
+    python3 tools/ram_report.py .pio/build/halmet/firmware.map --top 15
+
+The map is written by the espressif32 platform's Arduino builder; if
+it is missing, add  -Wl,-Map=.pio/build/halmet/firmware.map  to the
+build_flags.
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+DEFAULT_MAP = Path(".pio/build/halmet/firmware.map")
+
+# Output sections (ESP-IDF 5 linker script) → column
+REGIONS = (
+    (re.compile(r"^\.dram0\.data$"), "data"),
+    (re.compile(r"^\.dram0\.bss$|^\.noinit$"), "bss"),
+    (re.compile(r"^\.iram0\."), "iram"),
+)
+
+OUTPUT = re.compile(r"^(\.[\w.]+)\s*(?:0x[0-9a-f]+\s+0x[0-9a-f]+)?")
+INPUT = re.compile(r"^\s+(\S+)?\s*0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+\.o\S*)")
+
+
+def module_of(obj: str) -> str:
+    """Firmware module, library or framework an object file belongs to."""
+    obj = obj.replace("\\", "/")
+    m = re.search(r"/build/[^/]+/src/(?:[^/]+/)*([^/]+)\.(?:cpp|c)\.o$", obj)
+    if m:
+        return m.group(1)
+    # lib_archive = no: library objects land in lib<hash>/<Library>/
+    m = re.search(r"/build/[^/]+/lib[0-9a-f]+/([^/]+)/|/libdeps/[^/]+/([^/]+)/", obj)
+    if m:
+        return "lib:" + (m.group(1) or m.group(2))
+    m = re.search(r"lib([\w-]+)\.a\(", obj)
+    if m:
+        return "idf:" + m.group(1)
+    if "framework-arduinoespressif32" in obj:
+        return "arduino-core"
+    return "other"
+
+
+def parse(path: Path) -> dict:
+    """{module: {"data": n, "bss": n, "iram": n}} from the memory map."""
+    sizes = defaultdict(lambda: defaultdict(int))
+    region = None
+    pending = None          # input section name wrapped onto its own line
+    in_map = False
+    for line in path.read_text(errors="replace").splitlines():
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+        if line and not line[0].isspace():
+            m = OUTPUT.match(line)
+            region = None
+            if m:
+                for pat, col in REGIONS:
+                    if pat.match(m.group(1)):
+                        region = col
+            pending = None
+            continue
+        if region is None:
+            continue
+        m = INPUT.match(line)
+        if m:
+            size = int(m.group(3), 16)
+            if size and (m.group(1) or pending) != "*fill*":
+                sizes[module_of(m.group(4))][region] += size
+            pending = None
+        elif re.match(r"^ \S+$", line):
+            pending = line.strip()
+    return sizes
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("map", nargs="?", type=Path, default=DEFAULT_MAP)
+    ap.add_argument("--top", type=int, default=0, help="only the N largest modules")
+    args = ap.parse_args()
+
+    if not args.map.is_file():
+        sys.exit(f"{args.map}: no link map (build first, see --help)")
+    sizes = parse(args.map)
+    if not sizes:
+        sys.exit(f"{args.map}: no DRAM/IRAM sections found")
+
+    rows = sorted(sizes.items(), key=lambda kv: -(kv[1]["data"] + kv[1]["bss"]))
+    if args.top:
+        rows = rows[:args.top]
+
+    print(f"{'module':<28} {'data':>8} {'bss':>8} {'dram':>8} {'iram':>8}")
+    for name, s in rows:
+        print(f"{name:<28} {s['data']:>8} {s['bss']:>8} {s['data'] + s['bss']:>8} {s['iram']:>8}")
+    tot = {c: sum(s[c] for s in sizes.values()) for c in ("data", "bss", "iram")}
+    print(f"{'total':<28} {tot['data']:>8} {tot['bss']:>8} "
+          f"{tot['data'] + tot['bss']:>8} {tot['iram']:>8}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
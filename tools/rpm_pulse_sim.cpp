@@ -0,0 +1,359 @@
+// ============================================================
+//  rpm_pulse_sim.cpp — Host accuracy / latency test of the RPM
+//  estimator against synthetic W-terminal pulse trains
+//
+//  Generates alternator pulse trains from a scripted RPM profile
+//  (crank, catch, idle, throttle steps, ramp, stall) with
+//  per-revolution compression ripple, then degrades them with
+//  timing jitter, dropped edges and ringing (extra falling edges
+//  a few µs after a real one).  The edges are fired into the
+//  firmware's RpmSensor through the native Arduino shim at their
+//  exact virtual times; update() runs every INTERVAL_RPM_MS as on
+//  the target, followed by the engine_state_machine debounce.
+//
+//  Reports, per RPM_SMOOTHING_SAMPLES setting and signal quality:
+//    idle / cruise   RMS and max error on steady segments
+//    t90 / settle    850 → 2000 RPM step: time to 90 % and to stay
+//                    within ±2 % of the settled reading
+//    ramp lag        mean lag behind a 80 RPM/s ramp (ms), net of
+//                    the steady bias
+//    to 0 rpm        engine stopped → smoothed RPM reads 0
+//  and, per ENGINE_STATE_DEBOUNCE_MS setting on the degraded
+//  signal, time to engineRunning after start / to not running
+//  after the stall, and spurious running-state transitions.
+//
+//  Build & run from the repo root:
+//    g++ -std=c++17 -O2 -Itest/shims -Iinclude -o rpm_sim
+//        tools/rpm_pulse_sim.cpp src/RpmSensor.cpp
+//    ./rpm_sim [--csv]
+// ============================================================
+
+#include <shim_main.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "RpmSensor.h"
+
+static constexpr uint8_t kPin       = 23;
+static constexpr uint64_t kStartUs  = 10'000'000;   // virtual t = 0 of the profile
+static constexpr double  kPi        = 3.14159265358979323846;
+
+// ----------------------------------------------------------
+//  Scripted RPM profile
+// ----------------------------------------------------------
+struct Segment {
+    const char* label;
+    double      durS;
+    double      fromRpm;
+    double      toRpm;     // linear from → to over the segment
+    double      ripple;    // per-rev speed variation (fraction)
+};
+
+static const Segment kProfile[] = {
+    { "off",     2.0,    0.0,    0.0, 0.00 },
+    { "crank",   3.0,  250.0,  250.0, 0.30 },
+    { "catch",   1.0,  250.0,  850.0, 0.15 },
+    { "idle",   20.0,  850.0,  850.0, 0.08 },
+    { "step",   20.0, 2000.0, 2000.0, 0.03 },   // cruise
+    { "ramp",   10.0, 2000.0, 2800.0, 0.03 },
+    { "hold",   10.0, 2800.0, 2800.0, 0.03 },
+    { "down",   20.0,  850.0,  850.0, 0.08 },
+    { "stall",   0.8,  850.0,    0.0, 0.20 },
+    { "off",    10.0,    0.0,    0.0, 0.00 },
+};
+
+struct Span {
+    double t0, t1;
+};
+
+static Span segmentSpan(const char* label) {
+    double t = 0;
+    for (const auto& s : kProfile) {
+        if (strcmp(s.label, label) == 0) return { t, t + s.durS };
+        t += s.durS;
+    }
+    return { 0, 0 };
+}
+
+static double profileEnd() {
+    double t = 0;
+    for (const auto& s : kProfile) t += s.durS;
+    return t;
+}
+
+/// Nominal (ripple-free) RPM at t, and the segment it is in.
+static double nominalRpm(double t, const Segment** seg = nullptr) {
+    double t0 = 0;
+    for (const auto& s : kProfile) {
+        if (t < t0 + s.durS) {
+            if (seg) *seg = &s;
+            return s.fromRpm + (s.toRpm - s.fromRpm) * (t - t0) / s.durS;
+        }
+        t0 += s.durS;
+    }
+    if (seg) *seg = &kProfile[sizeof(kProfile) / sizeof(kProfile[0]) - 1];
+    return 0.0;
+}
+
+// ----------------------------------------------------------
+//  Pulse train
+// ----------------------------------------------------------
+struct SignalQuality {
+    const char* name;
+    double      jitter;     // edge timing σ as a fraction of the pulse period
+    double      dropProb;   // probability an edge is missed
+    double      ringProb;   // probability an edge rings (1–2 extra edges)
+};
+
+static const SignalQuality kQualities[] = {
+    { "clean",    0.00, 0.00, 0.00 },
+    { "jitter",   0.10, 0.00, 0.00 },
+    { "dropped",  0.00, 0.02, 0.00 },
+    { "ringing",  0.00, 0.00, 0.03 },
+    { "combined", 0.10, 0.02, 0.03 },
+};
+
+/// Falling-edge times (µs from profile start), sorted.
+static std::vector<uint64_t> makeEdges(const SignalQuality& q, float ppr, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double>       gauss(0.0, 1.0);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+
+    std::vector<uint64_t> edges;
+    const double dt    = 10e-6;     // integration step (s)
+    double       rev   = 0.0;       // crankshaft revolutions
+    double       pulse = 0.0;       // alternator pulses
+    double       end   = profileEnd();
+
+    for (double t = 0; t < end; t += dt) {
+        const Segment* seg;
+        double rpm = nominalRpm(t, &seg);
+        if (rpm <= 0.0) continue;
+        rpm *= 1.0 + seg->ripple * std::sin(2.0 * kPi * rev);   // one compression per rev
+        rev   += rpm / 60.0 * dt;
+        pulse += rpm / 60.0 * ppr * dt;
+        if (pulse < 1.0) continue;
+        pulse -= 1.0;
+
+        if (u(rng) < q.dropProb) continue;
+        double periodS = 60.0 / (rpm * ppr);
+        double te      = t + q.jitter * periodS * gauss(rng);
+        if (te < 0) te = 0;
+        edges.push_back(static_cast<uint64_t>(te * 1e6));
+        if (u(rng) < q.ringProb) {
+            int extra = 1 + (u(rng) < 0.5 ? 1 : 0);
+            for (int i = 1; i <= extra; i++) {
+                edges.push_back(static_cast<uint64_t>(te * 1e6) + 15 * i);
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+// ----------------------------------------------------------
+//  Run the firmware estimator over a pulse train
+// ----------------------------------------------------------
+struct Tick {
+    double t;          // s from profile start
+    double trueRpm;    // nominal
+    float  rpm;        // smoothed
+    bool   running;    // debounced
+};
+
+static std::vector<Tick> run(const std::vector<uint64_t>& edges, int samples,
+                             uint32_t debounceMs, float ppr) {
+    shim::reset(kStartUs);
+    RpmSensor s(kPin, ppr, samples);
+    s.begin();
+    shim::advanceMs(1);
+    s.update();                      // flush the shared static counter
+
+    // engine_state_machine::updateEngineState()
+    bool     raw = false, running = false;
+    uint32_t stateMs = millis();
+
+    std::vector<Tick> ticks;
+    size_t   next = 0;
+    uint64_t end  = static_cast<uint64_t>(profileEnd() * 1e6);
+    for (uint64_t tick = INTERVAL_RPM_MS * 1000ULL; tick <= end; tick += INTERVAL_RPM_MS * 1000ULL) {
+        while (next < edges.size() && edges[next] < tick) {
+            shim::nowUs = kStartUs + edges[next++];
+            shim::fireInterrupt(kPin);
+        }
+        shim::nowUs = kStartUs + tick;
+        float rpm = s.update();
+
+        bool rawRunning = rpm > DEFAULT_ENGINE_RUNNING_RPM;
+        if (rawRunning != raw) {
+            raw     = rawRunning;
+            stateMs = millis();
+        }
+        if (millis() - stateMs >= debounceMs) running = raw;
+
+        double t = tick / 1e6;
+        ticks.push_back({ t, nominalRpm(t - 1e-9), rpm, running });
+    }
+    return ticks;
+}
+
+// ----------------------------------------------------------
+//  Metrics
+// ----------------------------------------------------------
+struct Metrics {
+    double idleRms = 0, idleMax = 0, cruiseRms = 0, cruiseMax = 0;
+    double t90 = NAN, settle = NAN, rampLagMs = NAN, toZero = NAN;
+    double toRunning = NAN, toStopped = NAN;
+    int    transitions = 0;
+};
+
+static void steadyError(const std::vector<Tick>& ticks, const char* label,
+                        double& rms, double& mx) {
+    Span   sp = segmentSpan(label);
+    double sum = 0;
+    int    n   = 0;
+    mx = 0;
+    for (const auto& k : ticks) {
+        if (k.t < sp.t0 + 3.0 || k.t > sp.t1) continue;   // skip the settling window
+        double e = k.rpm - k.trueRpm;
+        sum += e * e;
+        mx   = std::max(mx, std::fabs(e));
+        n++;
+    }
+    rms = n ? std::sqrt(sum / n) : NAN;
+}
+
+static double meanOutput(const std::vector<Tick>& ticks, double t0, double t1) {
+    double sum = 0;
+    int    n   = 0;
+    for (const auto& k : ticks) {
+        if (k.t < t0 || k.t > t1) continue;
+        sum += k.rpm;
+        n++;
+    }
+    return n ? sum / n : NAN;
+}
+
+static Metrics score(const std::vector<Tick>& ticks) {
+    Metrics m;
+    steadyError(ticks, "idle", m.idleRms, m.idleMax);
+    steadyError(ticks, "step", m.cruiseRms, m.cruiseMax);
+
+    // 850 → 2000 step.  Settling is judged against the estimator's
+    // own steady value (second half of the segment) so a constant
+    // bias from dropped or extra edges does not count as lag.
+    Span   step = segmentSpan("step");
+    double final = meanOutput(ticks, (step.t0 + step.t1) / 2, step.t1);
+    double lastOut = step.t0;
+    for (const auto& k : ticks) {
+        if (k.t < step.t0 || k.t > step.t1) continue;
+        if (std::isnan(m.t90) && k.rpm >= 850.0 + 0.9 * (final - 850.0)) m.t90 = k.t - step.t0;
+        if (std::fabs(k.rpm - final) > 0.02 * final) lastOut = k.t;
+    }
+    m.settle = lastOut - step.t0 + INTERVAL_RPM_MS / 1000.0;
+
+    // Ramp lag in time: RPM deficit / slope after the first 3 s, less
+    // the steady bias measured on the following hold
+    Span   ramp  = segmentSpan("ramp");
+    Span   hold  = segmentSpan("hold");
+    double bias  = meanOutput(ticks, hold.t0 + 3.0, hold.t1) - 2800.0;
+    double slope = (2800.0 - 2000.0) / (ramp.t1 - ramp.t0);
+    double lag   = 0;
+    int    n     = 0;
+    for (const auto& k : ticks) {
+        if (k.t < ramp.t0 + 3.0 || k.t > ramp.t1) continue;
+        lag += (k.trueRpm + bias - k.rpm) / slope;
+        n++;
+    }
+    m.rampLagMs = n ? lag / n * 1000.0 : NAN;
+
+    // Stall: engine physically stopped at the end of the stall segment
+    Span stall = segmentSpan("stall");
+    for (const auto& k : ticks) {
+        if (k.t < stall.t1) continue;
+        if (std::isnan(m.toZero) && k.rpm == 0.0f) m.toZero = k.t - stall.t1;
+        if (std::isnan(m.toStopped) && !k.running) m.toStopped = k.t - stall.t1;
+    }
+
+    // Start: true RPM first crosses the running threshold
+    double crossed = NAN;
+    bool   prev    = false;
+    for (const auto& k : ticks) {
+        if (std::isnan(crossed) && k.trueRpm > DEFAULT_ENGINE_RUNNING_RPM) crossed = k.t;
+        if (std::isnan(m.toRunning) && k.running && !std::isnan(crossed)) m.toRunning = k.t - crossed;
+        if (k.running != prev) m.transitions++;
+        prev = k.running;
+    }
+    return m;
+}
+
+// ----------------------------------------------------------
+int main(int argc, char** argv) {
+    bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+    const float    ppr        = DEFAULT_PULSES_PER_REVOLUTION;
+    const int      samples[]  = { 1, 3, 5, 10, 20 };
+    const uint32_t debounce[] = { 1000, 2000, 3000, ENGINE_STATE_DEBOUNCE_MS };
+
+    std::vector<std::vector<uint64_t>> trains;
+    for (size_t i = 0; i < sizeof(kQualities) / sizeof(kQualities[0]); i++) {
+        trains.push_back(makeEdges(kQualities[i], ppr, 1234 + static_cast<uint32_t>(i)));
+    }
+
+    if (csv) {
+        printf("signal,samples,debounce_ms,idle_rms,idle_max,cruise_rms,cruise_max,"
+               "t90_s,settle_s,ramp_lag_ms,to_zero_s,to_running_s,to_stopped_s,transitions\n");
+    } else {
+        printf("RPM estimator: %.0f pulses/rev, update every %d ms, running > %.0f RPM\n"
+               "firmware defaults: RPM_SMOOTHING_SAMPLES %d, ENGINE_STATE_DEBOUNCE_MS %d\n\n",
+               ppr, INTERVAL_RPM_MS, DEFAULT_ENGINE_RUNNING_RPM,
+               RPM_SMOOTHING_SAMPLES, ENGINE_STATE_DEBOUNCE_MS);
+        printf("%-9s %4s | %8s %8s | %8s %8s | %6s %7s | %9s | %8s\n",
+               "signal", "avg", "idle rms", "idle max", "crz rms", "crz max",
+               "t90 s", "settle", "ramp lag", "to 0 rpm");
+    }
+
+    for (size_t q = 0; q < trains.size(); q++) {
+        for (int n : samples) {
+            Metrics m = score(run(trains[q], n, ENGINE_STATE_DEBOUNCE_MS, ppr));
+            if (csv) {
+                printf("%s,%d,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f,%.2f,%.2f,%.2f,%d\n",
+                       kQualities[q].name, n, (unsigned)ENGINE_STATE_DEBOUNCE_MS,
+                       m.idleRms, m.idleMax, m.cruiseRms, m.cruiseMax, m.t90, m.settle,
+                       m.rampLagMs, m.toZero, m.toRunning, m.toStopped, m.transitions);
+                continue;
+            }
+            printf("%-9s %3d%s | %8.1f %8.1f | %8.1f %8.1f | %6.1f %7.1f | %6.0f ms | %6.1f s\n",
+                   kQualities[q].name, n, n == RPM_SMOOTHING_SAMPLES ? "*" : " ",
+                   m.idleRms, m.idleMax, m.cruiseRms, m.cruiseMax,
+                   m.t90, m.settle, m.rampLagMs, m.toZero);
+        }
+        if (!csv) printf("\n");
+    }
+
+    // Running detection on the degraded signal with the default window
+    const std::vector<uint64_t>& worst = trains.back();
+    if (!csv) {
+        printf("running detection (%s signal, %d-sample average)\n", kQualities[trains.size() - 1].name,
+               RPM_SMOOTHING_SAMPLES);
+        printf("%-11s | %10s | %10s | %11s\n", "debounce ms", "to running", "to stopped", "transitions");
+    }
+    for (uint32_t d : debounce) {
+        Metrics m = score(run(worst, RPM_SMOOTHING_SAMPLES, d, ppr));
+        if (csv) {
+            printf("%s,%d,%u,,,,,,,,%.2f,%.2f,%.2f,%d\n", kQualities[trains.size() - 1].name,
+                   RPM_SMOOTHING_SAMPLES, (unsigned)d, m.toZero, m.toRunning, m.toStopped,
+                   m.transitions);
+            continue;
+        }
+        printf("%10u%s | %8.1f s | %8.1f s | %11d\n", (unsigned)d,
+               d == ENGINE_STATE_DEBOUNCE_MS ? "*" : " ", m.toRunning, m.toStopped, m.transitions);
+    }
+    if (!csv) printf("\n* = firmware default.  One start and one stop: 2 transitions expected.\n");
+    return 0;
+}
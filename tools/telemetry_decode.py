@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Decode the HALMET commissioning telemetry stream.
+
+Connects to the device's telemetry port (TELEMETRY_STREAM_PORT in
+halmet_config.h), resynchronises on the frame header, verifies the
+CRC and prints one CSV row per frame.  The frame layout mirrors
+TelemetryFrame in include/telemetry_stream.h.
+
+    python3 tools/telemetry_decode.py halmet-engine.local > run.csv
+    python3 tools/telemetry_decode.py 192.168.1.50 --port 8765 --count 600
+"""
+
+import argparse
+import socket
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+VERSION = 1
+FRAME = struct.Struct("<2sBBHIfff4h4fffBBH")
+
+COLUMNS = [
+    "seq", "ms", "rpm_instant", "rpm_smoothed", "pulses_per_rev",
+    "raw0", "raw1", "raw2", "raw3", "v0", "v1", "v2", "v3",
+    "coolant_c", "tank_ohm", "oil_alarm", "temp_alarm", "coolant_alert",
+    "engine_running", "ads_ok", "oil_history", "temp_history",
+]
+
+
+def crc16_ccitt(data: bytes) -> int:
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def decode(frame: bytes) -> dict:
+    (sync, version, flags, seq, ms, rpm_i, rpm_s, ppr,
+     r0, r1, r2, r3, v0, v1, v2, v3,
+     coolant_c, tank_ohm, oil_hist, temp_hist, crc) = FRAME.unpack(frame)
+    return {
+        "version": version, "seq": seq, "ms": ms,
+        "rpm_instant": rpm_i, "rpm_smoothed": rpm_s, "pulses_per_rev": ppr,
+        "raw0": r0, "raw1": r1, "raw2": r2, "raw3": r3,
+        "v0": v0, "v1": v1, "v2": v2, "v3": v3,
+        "coolant_c": coolant_c, "tank_ohm": tank_ohm,
+        "oil_alarm": flags & 0x01, "temp_alarm": (flags >> 1) & 0x01,
+        "coolant_alert": (flags >> 2) & 0x03,
+        "engine_running": (flags >> 4) & 0x01, "ads_ok": (flags >> 5) & 0x01,
+        "oil_history": f"{oil_hist:05b}", "temp_history": f"{temp_hist:05b}",
+        "crc": crc,
+    }
+
+
+def frames(sock):
+    """Yield (frame_bytes, crc_ok) from the byte stream."""
+    buf = bytearray()
+    while True:
+        chunk = sock.recv(4096)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(SYNC)
+            if start < 0:
+                del buf[:-1]
+                break
+            if len(buf) - start < FRAME.size:
+                del buf[:start]
+                break
+            frame = bytes(buf[start:start + FRAME.size])
+            crc_ok = crc16_ccitt(frame[:-2]) == struct.unpack_from("<H", frame, FRAME.size - 2)[0]
+            # On a CRC miss advance one byte and resync
+            del buf[:start + (FRAME.size if crc_ok else 1)]
+            yield frame, crc_ok
+
+
+def main() -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("host")
+    ap.add_argument("--port", type=int, default=8765)
+    ap.add_argument("--count", type=int, default=0, help="stop after N frames (0 = forever)")
+    args = ap.parse_args()
+
+    sock = socket.create_connection((args.host, args.port), timeout=10)
+    sock.settimeout(None)
+
+    print(",".join(COLUMNS))
+    received = gaps = bad_crc = 0
+    last_seq = None
+    try:
+        for frame, crc_ok in frames(sock):
+            if not crc_ok:
+                bad_crc += 1
+                continue
+            row = decode(frame)
+            if row["version"] != VERSION:
+                print(f"# unsupported frame version {row['version']}", file=sys.stderr)
+                return 1
+            if last_seq is not None:
+                gaps += (row["seq"] - last_seq - 1) & 0xFFFF
+            last_seq = row["seq"]
+            print(",".join(str(row[c]) for c in COLUMNS), flush=True)
+            received += 1
+            if args.count and received >= args.count:
+                break
+    except KeyboardInterrupt:
+        pass
+    finally:
+        sock.close()
+        print(f"# frames={received} dropped={gaps} crc_errors={bad_crc}", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())